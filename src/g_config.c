@@ -85,6 +85,26 @@ video_mode_t mode_1024x768_60Hz_d4 = {
     .div = 4,
 };
 
+#ifdef DVI_HSTX_ENABLE
+// CEA-861 720p, DVI (HSTX) only
+video_mode_t mode_1280x720_60Hz = {
+    .sys_freq = 372000,
+    .pixel_freq = 74250000.0,
+    .h_visible_area = 1280,
+    .v_visible_area = 720,
+    .whole_line = 1650,
+    .whole_frame = 750,
+    .h_front_porch = 110,
+    .h_sync_pulse = 40,
+    .h_back_porch = 220,
+    .v_front_porch = 5,
+    .v_sync_pulse = 5,
+    .v_back_porch = 20,
+    .sync_polarity = 0b00000000, // positive
+    .div = 2,
+};
+#endif
+
 video_mode_t mode_1280x1024_60Hz_d3 = {
     .sys_freq = 252000,
     .pixel_freq = 108000000.0,
@@ -125,6 +145,9 @@ video_mode_t *video_modes[] = {
     &mode_800x600_60Hz,
     &mode_1024x768_60Hz_d3,
     &mode_1024x768_60Hz_d4,
+#ifdef DVI_HSTX_ENABLE
+    &mode_1280x720_60Hz,
+#endif
     &mode_1280x1024_60Hz_d3,
     &mode_1280x1024_60Hz_d4,
 };
@@ -188,6 +188,25 @@
 #define SM_DVI 0
 #define SM_DVI_CONV (SM_DVI + 1)
 
+#ifdef DVI_HSTX_ENABLE
+
+// DVI through the RP2350 HSTX peripheral and its TMDS encoder (no PIO), HSTX outputs are fixed to GPIO 12-19
+#if !PICO_RP2350
+#error "DVI_HSTX_ENABLE requires an RP2350 board (board = rpipico2)."
+#endif
+
+#if DVI_PIN_D0 < 12 || DVI_PIN_D0 + 5 > 19 || DVI_PIN_CLK0 < 12 || DVI_PIN_CLK0 + 1 > 19
+#error "DVI_HSTX_ENABLE requires the DVI pins to be wired to GPIO 12-19."
+#endif
+
+#elif PICO_RP2350
+// feed the DVI serializer with pre-serialised TMDS symbols straight from the line buffer
+// (no conv SM, 2 DMA channels), fast enough for 800x600 at 400MHz system clock.
+// 1024x768 DVI stays unsupported on this path: 65MHz x 10 bits per pixel needs a 650MHz system
+// clock for a PIO serializer, beyond the RP2350 (use the HSTX build, DVI_HSTX_ENABLE)
+#define DVI_DIRECT_ENABLE
+#endif
+
 // PIO and SM for VGA
 #define PIO_VGA pio0
 #define DREQ_PIO_VGA DREQ_PIO0_TX0
@@ -204,6 +223,10 @@
 #define SM_PS2 1
 
 #define PIO_CH446Q pio1
+// IRQ index 0 (PIO1_IRQ_0): the CH446Q SM raises it when a batch is shifted out
+// PIO1 memory is at 30 of 32 instructions: PS/2 5 + CH446Q 8 + capture up to 17
+// (loaded last by rgb_capture.c); any PIO1 program growth must come out of this margin
+#define PIO_CH446Q_IRQ PIO1_IRQ_0
 #define SM_CH446Q 2
 
 #define PIO_SPI pio1
@@ -226,10 +249,26 @@ typedef enum video_out_mode_t
   VIDEO_MODE_MIN,
   MODE_640x480_60Hz = VIDEO_MODE_MIN,
   MODE_720x576_50Hz,
+#if defined(DVI_HSTX_ENABLE)
+  MODE_800x600_60Hz,
+  MODE_1024x768_60Hz_d3,
+  MODE_1024x768_60Hz_d4,
+  MODE_1280x720_60Hz, // DVI only
+  VIDEO_MODE_DVI_MAX = MODE_1280x720_60Hz,
+  VIDEO_MODE_BLEND_MAX = MODE_1280x720_60Hz, // HSTX renders once per scaled line, VGA on the Cortex-M33
+  VIDEO_MODE_BLEND_DIM_MAX = MODE_720x576_50Hz, // HSTX with SCANLINES_DIM renders every line of the div 2 modes
+#elif defined(DVI_DIRECT_ENABLE)
+  MODE_800x600_60Hz,
+  VIDEO_MODE_DVI_MAX = MODE_800x600_60Hz,
+#else
   VIDEO_MODE_DVI_MAX = MODE_720x576_50Hz,
   MODE_800x600_60Hz,
+#endif
+#ifndef DVI_HSTX_ENABLE
   MODE_1024x768_60Hz_d3,
   MODE_1024x768_60Hz_d4,
+  VIDEO_MODE_BLEND_MAX = MODE_1024x768_60Hz_d4, // OSD blending fits the line time, see test/host/test_render.c
+#endif
   MODE_1280x1024_60Hz_d3,
   MODE_1280x1024_60Hz_d4,
   VIDEO_MODE_MAX = MODE_1280x1024_60Hz_d4,
@@ -243,6 +282,31 @@ typedef enum cap_sync_mode_t
   SYNC_MODE_MAX = EXT,
 } cap_sync_mode_t;
 
+typedef enum scanlines_mode_t
+{
+  SCANLINES_MODE_MIN,
+  SCANLINES_OFF = SCANLINES_MODE_MIN,
+  SCANLINES_BLACK, // blank lines between image lines
+  SCANLINES_DIM,   // image lines repeated with the dimmed palette
+  SCANLINES_MODE_MAX = SCANLINES_DIM,
+} scanlines_mode_t;
+
+typedef enum osd_blend_mode_t
+{
+  OSD_BLEND_MIN,
+  OSD_BLEND_OPAQUE = OSD_BLEND_MIN, // OSD replaces the image
+  OSD_BLEND_KEY,                    // OSD background color shows the image
+  OSD_BLEND_SHADE,                  // OSD background color shows the image with every second pixel black
+  OSD_BLEND_MAX = OSD_BLEND_SHADE,
+} osd_blend_mode_t;
+
+typedef enum osd_font_id_t
+{
+  OSD_FONT_BOLD, // bold, with Cyrillic letters
+  OSD_FONT_ZX,   // ZX Spectrum ROM
+  OSD_FONTS,
+} osd_font_id_t;
+
 #ifdef OSD_FF_ENABLE
 typedef struct ff_osd_config_t
 {
@@ -252,6 +316,8 @@ typedef struct ff_osd_config_t
   uint16_t rows;
   uint8_t h_position; // 1=left, 2=left-center, 3=center, 4=center-right, 5=right
   bool v_position;    // false = at the top, true = at the bottom of the screen
+  uint8_t blend;      // osd_blend_mode_t
+  uint8_t font;       // osd_font_id_t
 } ff_osd_config_t;
 
 #define FF_OSD_COLUMNS_MIN 16
@@ -259,6 +325,46 @@ typedef struct ff_osd_config_t
 #define FF_OSD_ROWS_MIN 2
 #define FF_OSD_ROWS_MAX 4
 
+// I2C receive rings (powers of 2): bytes and transaction starts waiting to be decoded.
+// Decoding starts at the end of each transaction or when the data ring is half full.
+#define FF_OSD_DATA_RING_SIZE 1024
+#define FF_OSD_TRANSACTION_RING_SIZE 8
+
+#endif
+
+#if defined(PS2_KBD_ENABLE) || defined(USB_KBD_ENABLE)
+#ifdef USB_KBD_ENABLE
+typedef enum joystick_profile_t
+{
+  JOYSTICK_OFF,
+  JOYSTICK_SINCLAIR, // first gamepad: Sinclair 1 (6-0), second gamepad: Sinclair 2 (1-5)
+  JOYSTICK_CURSOR,   // 5 6 7 8, fire 0
+  JOYSTICK_QAOP,     // Q A O P, fire SPACE
+  JOYSTICK_PROFILES,
+} joystick_profile_t;
+
+typedef enum mouse_profile_t
+{
+  MOUSE_1_1,       // mouse counts as they come
+  MOUSE_1_2,       // half the counts: high-DPI mice
+  MOUSE_1_4,       // a quarter of the counts
+  MOUSE_1_2_ACCEL, // half the counts, up to 4 times that on fast moves
+  MOUSE_1_4_ACCEL,
+  MOUSE_PROFILES,
+} mouse_profile_t;
+#endif
+
+// user key layouts kept in the flash sector below the settings, 0 selects the built-in layout
+#define KEYMAP_USER_MAX 4
+
+typedef struct input_config_t
+{
+  uint8_t keymap; // 0: built-in, 1 - KEYMAP_USER_MAX: user layout
+#ifdef USB_KBD_ENABLE
+  uint8_t joystick; // joystick_profile_t, gamepad directions and fire as ZX keys
+  uint8_t mouse;    // mouse_profile_t, Kempston mouse speed
+#endif
+} input_config_t;
 #endif
 
 #if defined(BOARD_LEO_V3) || defined(BOARD_LEO_V3_2040BT)
@@ -284,7 +390,7 @@ typedef struct settings_t
 {
   video_out_type_t video_out_type;
   video_out_mode_t video_out_mode;
-  bool scanlines_mode;
+  uint8_t scanlines_mode; // scanlines_mode_t, kept 1 byte wide to preserve the saved settings layout
   bool buffering_mode;
   bool video_sync_mode;
   cap_sync_mode_t cap_sync_mode;
@@ -299,6 +405,9 @@ typedef struct settings_t
 #endif
 #if defined(BOARD_LEO_V3) || defined(BOARD_LEO_V3_2040BT)
   hw_config_t hw_config;
+#endif
+#if defined(PS2_KBD_ENABLE) || defined(USB_KBD_ENABLE)
+  input_config_t input_config;
 #endif
   uint32_t crc;
 } settings_t;
@@ -326,6 +435,9 @@ extern video_mode_t mode_720x576_50Hz;
 extern video_mode_t mode_800x600_60Hz;
 extern video_mode_t mode_1024x768_60Hz_d3;
 extern video_mode_t mode_1024x768_60Hz_d4;
+#ifdef DVI_HSTX_ENABLE
+extern video_mode_t mode_1280x720_60Hz;
+#endif
 extern video_mode_t mode_1280x1024_60Hz_d3;
 extern video_mode_t mode_1280x1024_60Hz_d4;
 
@@ -384,6 +496,17 @@ extern uint8_t g_v_buf[];
 // thick - show scanline twice in four lines
 #define SCANLINES_USE_THIN
 
+// brightness of the SCANLINES_DIM lines in percent of the normal image
+// VGA has 2-bit DAC per color channel, so levels are rounded to the nearest DAC step
+#define SCANLINES_DIM_LEVEL 50
+
+// OSD character generator: the line renderers expand glyph rows from the text grid instead of reading
+// a pre-rendered osd_buffer, saves about 11 KB of RAM
+// #define OSD_CHARGEN_ENABLE
+
+// performance counters in the capture and output ISRs, shown once per second on the STATS page of the OSD menu
+// #define PERF_STATS_ENABLE
+
 #if defined(OSD_MENU_ENABLE) || defined(OSD_FF_ENABLE)
 #define OSD_ENABLE
 #endif
@@ -391,4 +514,14 @@ extern uint8_t g_v_buf[];
 // Keyboard subsystem meta-flag: enabled if any keyboard backend is enabled
 #if defined(PS2_KBD_ENABLE) || defined(USB_KBD_ENABLE)
 #define KBD_ENABLE
+#endif
+
+// key event journal with input to ZX matrix latencies, kept with the other performance counters
+#if defined(KBD_ENABLE) && defined(PERF_STATS_ENABLE)
+#define KBD_JOURNAL_ENABLE
+#endif
+
+// text typed on the ZX keyboard matrix, sent from the serial menu
+#if defined(KBD_ENABLE) && defined(SERIAL_MENU_ENABLE)
+#define KBD_PASTE_ENABLE
 #endif
\ No newline at end of file
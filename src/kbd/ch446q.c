@@ -8,9 +8,18 @@
  *   OUT pin:    KBD_PIN_DATA
  *   Sideset[0]: KBD_PIN_CLK
  *   Sideset[1]: KBD_PIN_STB  (= CLK + 1)
+ *
+ * The wanted switch states are kept as a 128-bit map. A flush sends the
+ * switches that differ from the last batch as one byte-wide DMA transfer
+ * (8-bit writes to the TX FIFO are replicated to bits 31:24, shifted out
+ * first). While a batch is still going out, changes wait for the SM to
+ * drain its FIFO and raise PIO_CH446Q_IRQ, which flushes them.
  */
 
 #include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 
 #include "g_config.h"
 #include "ch446q.h"
@@ -18,24 +27,104 @@
 
 #ifndef SPI_KB_ENABLE
 
+#define CH446Q_SWITCHES 128 // Y[2:0] X[3:0]
+
+static uint32_t ch446q_target[CH446Q_SWITCHES / 32]; // wanted states, bit Y * 16 + X
+static uint32_t ch446q_sent[CH446Q_SWITCHES / 32];   // states of the commands handed to DMA
+static uint8_t ch446q_cmds[CH446Q_SWITCHES];          // batch being sent, one command per switch at most
+static int ch446q_dma_chan = -1;
+static ch446q_stats_t ch446q_stats;
+
 void __not_in_flash_func(ch446q_set_switch)(int Y, int X, bool state)
 {
-    // Pack Y[2:0] X[3:0] state into bits [31:24] (MSB first shift)
-    uint32_t data = ((uint32_t)(Y & 0x7) << 5) |
-                    ((uint32_t)(X & 0xF) << 1) |
-                    (state ? 1u : 0u);
-    data <<= 24;
+    uint32_t i = ((Y & 0x7) << 4) | (X & 0xF);
+
+    if (state)
+        ch446q_target[i >> 5] |= 1u << (i & 31);
+    else
+        ch446q_target[i >> 5] &= ~(1u << (i & 31));
+}
+
+void __not_in_flash_func(ch446q_flush)(void)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t count = 0;
+
+    for (int w = 0; w < CH446Q_SWITCHES / 32; w++)
+        if (ch446q_target[w] != ch446q_sent[w])
+            count++;
+
+    if (!count)
+    {
+        restore_interrupts(irq_state);
+        return;
+    }
+
+    // the buffer is DMA's until the channel is done, PIO_CH446Q_IRQ comes back for the rest
+    if (dma_channel_is_busy(ch446q_dma_chan))
+    {
+        ch446q_stats.busy++;
+        restore_interrupts(irq_state);
+        return;
+    }
+
+    if (pio_sm_is_tx_fifo_full(PIO_CH446Q, SM_CH446Q))
+        ch446q_stats.fifo_full++;
+
+    count = 0;
+
+    for (int w = 0; w < CH446Q_SWITCHES / 32; w++)
+    {
+        uint32_t changed = ch446q_target[w] ^ ch446q_sent[w];
+
+        while (changed)
+        {
+            uint32_t bit = __builtin_ctz(changed);
+            uint32_t i = w * 32 + bit;
+
+            // Pack Y[2:0] X[3:0] state
+            ch446q_cmds[count++] = (i << 1) | ((ch446q_target[w] >> bit) & 1);
+            changed &= changed - 1;
+        }
+
+        ch446q_sent[w] = ch446q_target[w];
+    }
+
+    dma_channel_transfer_from_buffer_now(ch446q_dma_chan, ch446q_cmds, count);
 
-    while (PIO_CH446Q->fstat & (1u << (PIO_FSTAT_TXFULL_LSB + SM_CH446Q)))
-        ;
+    ch446q_stats.batches++;
+    ch446q_stats.commands += count;
 
-    PIO_CH446Q->txf[SM_CH446Q] = data;
+    restore_interrupts(irq_state);
+}
+
+static void __not_in_flash_func(ch446q_irq_handler)(void)
+{
+    pio_interrupt_clear(PIO_CH446Q, SM_CH446Q); // irq 0 rel
+    ch446q_flush();
 }
 
 void ch446q_reset(void)
 {
-    for (int i = 0; i < 128; i++)
-        ch446q_set_switch(i >> 4, i & 0xF, false);
+    // every switch differs from the last batch: all 128 are sent open
+    for (int w = 0; w < CH446Q_SWITCHES / 32; w++)
+    {
+        ch446q_target[w] = 0;
+        ch446q_sent[w] = ~0u;
+    }
+
+    ch446q_flush();
+}
+
+void ch446q_get_stats(ch446q_stats_t *stats)
+{
+    *stats = ch446q_stats;
+}
+
+void ch446q_set_clock(void)
+{
+    // Target ~2.5 MHz PIO clock (~0.4µs per cycle), safe for CH446Q (max ~20 MHz)
+    pio_sm_set_clkdiv(PIO_CH446Q, SM_CH446Q, (float)clock_get_hz(clk_sys) / 2500000.0f);
 }
 
 void ch446q_init(void)
@@ -48,6 +137,7 @@ void ch446q_init(void)
     sm_config_set_wrap(&c, offset, offset + pio_ch446q_program.length - 1);
     sm_config_set_out_shift(&c, false, false, 32); // MSB first, no autopull
     sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    sm_config_set_mov_status(&c, STATUS_TX_LESSTHAN, 1); // x = ~0 when the TX FIFO is empty
 
     // Data pin (OUT)
     pio_gpio_init(PIO_CH446Q, KBD_PIN_DATA);
@@ -64,13 +154,27 @@ void ch446q_init(void)
     sm_config_set_sideset_pins(&c, KBD_PIN_CLK);
     sm_config_set_sideset(&c, 2, false, false);
 
-    // Target ~2.5 MHz PIO clock (~0.4µs per cycle), safe for CH446Q (max ~20 MHz)
-    float fdiv = (float)clock_get_hz(clk_sys) / 2500000.0f;
-    sm_config_set_clkdiv(&c, fdiv);
-
     pio_sm_init(PIO_CH446Q, SM_CH446Q, offset, &c);
+    ch446q_set_clock();
     pio_sm_set_enabled(PIO_CH446Q, SM_CH446Q, true);
 
+    // Byte commands to the TX FIFO, paced by its DREQ
+    ch446q_dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config dc = dma_channel_get_default_config(ch446q_dma_chan);
+
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_8);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    channel_config_set_dreq(&dc, pio_get_dreq(PIO_CH446Q, SM_CH446Q, true));
+    dma_channel_configure(ch446q_dma_chan, &dc, &PIO_CH446Q->txf[SM_CH446Q], ch446q_cmds, 0, false);
+
+    // Batch shifted out: flush what came in meanwhile. Runs on this core (core 1),
+    // at the PS/2 IRQ priority so it does not split a batch of kbd_on_event()
+    pio_set_irqn_source_enabled(PIO_CH446Q, 0, pis_interrupt0 + SM_CH446Q, true);
+    irq_set_exclusive_handler(PIO_CH446Q_IRQ, ch446q_irq_handler);
+    irq_set_priority(PIO_CH446Q_IRQ, PICO_DEFAULT_IRQ_PRIORITY);
+    irq_set_enabled(PIO_CH446Q_IRQ, true);
+
     ch446q_reset();
 }
 
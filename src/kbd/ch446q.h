@@ -3,10 +3,24 @@
  *
  * 3-wire serial interface: DATA, CLK, STB.
  * Pins defined per-board in g_config.h.
+ *
+ * Switch changes are collected by ch446q_set_switch() and sent as one
+ * batch by ch446q_flush(): DMA feeds the PIO, the caller never waits.
  */
 
 #pragma once
 
+typedef struct
+{
+    uint32_t batches;   // DMA transfers started
+    uint32_t commands;  // switch commands sent
+    uint32_t busy;      // flushes deferred until the batch before was shifted out
+    uint32_t fifo_full; // flushes that found the PIO TX FIFO full (the CPU would have stalled)
+} ch446q_stats_t;
+
 void ch446q_init(void);
+void ch446q_set_clock(void); // after clk_sys changed
 void ch446q_reset(void);
 void __not_in_flash_func(ch446q_set_switch)(int Y, int X, bool state);
+void __not_in_flash_func(ch446q_flush)(void);
+void ch446q_get_stats(ch446q_stats_t *stats);
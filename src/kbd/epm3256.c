@@ -7,9 +7,19 @@
  * Data format (MSB first):
  *   Word 0 (31 data bits + 1 pad): keyboard_activity[1] | special_keys[2] | mouse_keys[2] | mouse_x[8] | mouse_y[8] | row7[5] | row6[5]
  *   Word 1 (30 data bits + 2 pad):  row5[5] | row4[5] | row3[5] | row2[5] | row1[5] | row0[5]
+ *
+ * Frames are streamed by DMA at EPM3256_REFRESH_HZ, no CPU involved:
+ * a control channel paced by a DMA timer writes the current frame address
+ * to the read address trigger of the data channel, which feeds both words
+ * to the PIO and chains back to the control channel. epm3256_send() builds
+ * the frame in the spare buffer, once the data channel is not reading it,
+ * and swaps the frame address. epm3256_set_clock() keeps the refresh rate
+ * and the PIO clock when the video output changes clk_sys.
  */
 
 #include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
 
 #include "g_config.h"
 #include "epm3256.h"
@@ -17,6 +27,58 @@
 
 #ifdef SPI_KB_ENABLE
 
+// Frames per second sent to the CPLD (override in g_config.h if needed).
+// DMA timer range: clk_sys / 65535 (about 2 kHz at 125 MHz) to about 20 kHz (a frame is ~50 us)
+#ifndef EPM3256_REFRESH_HZ
+#define EPM3256_REFRESH_HZ 8000
+#endif
+
+static uint32_t epm3256_frames[2][2];
+static const uint32_t *volatile epm3256_frame = epm3256_frames[0]; // read by the control channel
+static int epm3256_dma_data = -1;
+static int epm3256_dma_ctrl = -1;
+static int epm3256_dma_timer = -1;
+
+void epm3256_set_clock(void)
+{
+    if (epm3256_dma_timer < 0)
+        return; // epm3256_init() takes clk_sys as it is
+
+    // Pacing: clk_sys * 1 / div per second, div is 16 bits
+    uint32_t div = clock_get_hz(clk_sys) / EPM3256_REFRESH_HZ;
+    dma_timer_set_fraction(epm3256_dma_timer, 1, div > 0xFFFF ? 0xFFFF : (div ? div : 1));
+
+    // Target ~2.5 MHz PIO clock, safe for shift registers
+    pio_sm_set_clkdiv(PIO_SPI, SM_SPI, (float)clock_get_hz(clk_sys) / 2500000.0f);
+}
+
+static void epm3256_dma_init(void)
+{
+    epm3256_dma_data = dma_claim_unused_channel(true);
+    epm3256_dma_ctrl = dma_claim_unused_channel(true);
+    epm3256_dma_timer = dma_claim_unused_timer(true);
+
+    epm3256_set_clock();
+
+    // Data: the 2 words of a frame, as the PIO takes them
+    dma_channel_config c = dma_channel_get_default_config(epm3256_dma_data);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(PIO_SPI, SM_SPI, true));
+    channel_config_set_chain_to(&c, epm3256_dma_ctrl);
+    dma_channel_configure(epm3256_dma_data, &c, &PIO_SPI->txf[SM_SPI], NULL, 2, false);
+
+    // Control: one frame address per timer tick, written to the data channel's trigger
+    c = dma_channel_get_default_config(epm3256_dma_ctrl);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, dma_get_timer_dreq(epm3256_dma_timer));
+    dma_channel_configure(epm3256_dma_ctrl, &c, &dma_hw->ch[epm3256_dma_data].al3_read_addr_trig, &epm3256_frame, 1,
+                          true);
+}
+
 void epm3256_init(void)
 {
     // Load at fixed offset right after PS2 program (static — never unloaded)
@@ -37,10 +99,6 @@ void epm3256_init(void)
     sm_config_set_sideset_pins(&c, KBD_PIN_CLK);
     sm_config_set_sideset(&c, 2, false, false);
 
-    // Target ~2.5 MHz PIO clock, safe for shift registers
-    float fdiv = (float)clock_get_hz(clk_sys) / 2500000.0f;
-    sm_config_set_clkdiv(&c, fdiv);
-
     pio_sm_init(PIO_SPI, SM_SPI, offset, &c);
 
     // Set pin directions after pio_sm_init (restart clears SM pindir state)
@@ -48,6 +106,8 @@ void epm3256_init(void)
                                  (1u << KBD_PIN_DATA) | (1u << KBD_PIN_CLK) | (1u << KBD_PIN_STB),
                                  (1u << KBD_PIN_DATA) | (1u << KBD_PIN_CLK) | (1u << KBD_PIN_STB));
 
+    epm3256_dma_init(); // sets the PIO clock too
+
     pio_sm_set_enabled(PIO_SPI, SM_SPI, true);
 }
 
@@ -55,6 +115,9 @@ void __not_in_flash_func(epm3256_send)(uint8_t special_keys, uint8_t mouse_keys,
                                        uint8_t mouse_y,
                                        zx_kbd_state_t *zx_keys_matrix)
 {
+    // The buffer not published. The control channel may have taken its address just before the last swap.
+    uint32_t *frame = epm3256_frame == epm3256_frames[0] ? epm3256_frames[1] : epm3256_frames[0];
+
     // Word 0: keyboard_activity[1] | special_keys[2] | mouse_keys[2] | mouse_x[8] | mouse_y[8] | row7[5] | row6[5] | pad[1]
     uint32_t data0 = 0;
     data0 |= special_keys & 0x03;
@@ -88,16 +151,19 @@ void __not_in_flash_func(epm3256_send)(uint8_t special_keys, uint8_t mouse_keys,
     if ((data0 & 0x000007FE) || (data1 & 0xFFFFFFFC)) // keyboard activity (except pad bits)
         data0 |= (1u << 31);
 
-    // Wait for FIFO space and send
-    while (PIO_SPI->fstat & (1u << (PIO_FSTAT_TXFULL_LSB + SM_SPI)))
-        ;
+    // Wait until the data channel is not reading the spare buffer (at most 2 words into the PIO FIFO).
+    // The control channel writes the address it read within a few cycles, long before this point,
+    // so a channel that is idle or reading the other buffer cannot pick this one up any more.
+    while (dma_channel_is_busy(epm3256_dma_data) &&
+           dma_hw->ch[epm3256_dma_data].read_addr - (uintptr_t)frame < sizeof(epm3256_frames[0]))
+        tight_loop_contents();
 
-    PIO_SPI->txf[SM_SPI] = data0;
+    frame[0] = data0;
+    frame[1] = data1;
 
-    while (PIO_SPI->fstat & (1u << (PIO_FSTAT_TXFULL_LSB + SM_SPI)))
-        ;
+    __dmb(); // frame /then/ swap
 
-    PIO_SPI->txf[SM_SPI] = data1;
+    epm3256_frame = frame; // sent from the next timer tick on
 }
 
 #endif // SPI_KB_ENABLE
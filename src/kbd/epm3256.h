@@ -7,6 +7,9 @@
  *
  * Pins: KBD_PIN_DATA (data), KBD_PIN_CLK (clock), KBD_PIN_STB (latch)
  * defined per-board in g_config.h.
+ *
+ * The current frame is sent continuously by DMA, epm3256_send() only
+ * replaces it and returns.
  */
 
 #pragma once
@@ -14,6 +17,7 @@
 #include "zx_kbd.h"
 
 void epm3256_init(void);
+void epm3256_set_clock(void); // after clk_sys changed
 void __not_in_flash_func(epm3256_send)(uint8_t special_keys,
                                        uint8_t mouse_keys,
                                        uint8_t mouse_x,
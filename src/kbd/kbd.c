@@ -10,6 +10,7 @@
 #include "key_codes.h"
 #include "led.h"
 #include "zx_kbd.h"
+#include "zx_keymap.h"
 
 // Hotkey for mouse button swap (override in g_config.h if needed)
 #ifndef KBD_HOTKEY_MOUSE_SWAP
@@ -23,6 +24,8 @@
 #define KBD_HOTKEY_RESET KEY_F12
 #endif
 
+#include "hardware/irq.h"
+
 #ifndef SPI_KB_ENABLE
 #include "ch446q.h"
 #else
@@ -48,6 +51,15 @@
 #include "hw_config.h"
 #endif
 
+#ifdef KBD_JOURNAL_ENABLE
+#include "hardware/timer.h"
+#include "kbd_journal.h"
+#endif
+
+#ifdef KBD_PASTE_ENABLE
+#include "zx_paste.h"
+#endif
+
 #ifdef KBD_ENABLE
 
 extern settings_t settings;
@@ -59,6 +71,7 @@ static zx_kbd_state_t kbd_zx_state;
 static zx_kbd_state_t kbd_zx_state_old;
 
 #ifndef SPI_KB_ENABLE
+// Collects the changed switches, ch446q_flush() sends them
 static void __not_in_flash_func(kbd_apply_output)(zx_kbd_state_t *zx_new, zx_kbd_state_t *zx_old)
 {
     for (int row = 0; row < 8; row++)
@@ -83,8 +96,13 @@ static void __not_in_flash_func(kbd_apply_output)(zx_kbd_state_t *zx_new, zx_kbd
 static bool mouse_buttons_swapped = false;
 #endif
 
-static void __not_in_flash_func(kbd_on_event)(void)
+static void __not_in_flash_func(kbd_on_event)(kbd_source_t source, uint32_t time_us)
 {
+#ifdef KBD_JOURNAL_ENABLE
+    uint32_t dispatch_time_us = time_us_32();
+    uint32_t output_time_us = 0;
+#endif
+
     kbd_activity_cnt++;
     led_put(LED_B, (kbd_activity_cnt & 1) ? 32 : 0);
 
@@ -148,10 +166,24 @@ static void __not_in_flash_func(kbd_on_event)(void)
     osd_kbd_intercept(&kbd_state.new_state);
 #endif
 
-    if (!osd_kbd_active)
+    bool zx_output = !osd_kbd_active;
+
+    if (zx_output)
     {
         zx_kbd_set_state(&kbd_zx_state, &kbd_state.new_state);
 
+#ifdef USB_KBD_ENABLE
+        for (uint8_t player = 0; player < ZX_JOY_PLAYERS; player++)
+            zx_kbd_set_joystick(&kbd_zx_state, settings.input_config.joystick, player, usb_joystick_get_state(player));
+#endif
+
+#ifdef KBD_PASTE_ENABLE
+        const zx_kbd_state_t *paste = zx_paste_get_state();
+
+        kbd_zx_state.u[0] |= paste->u[0];
+        kbd_zx_state.u[1] |= paste->u[1];
+#endif
+
 #ifdef SPI_KB_ENABLE
         usb_mouse_state_t *mouse = usb_mouse_get_state();
         uint8_t btn = mouse->buttons;
@@ -175,6 +207,77 @@ static void __not_in_flash_func(kbd_on_event)(void)
         kbd_zx_state_old = kbd_zx_state;
 #endif
     }
+
+#ifndef SPI_KB_ENABLE
+    // ZX keys and NMI / RESET in one batch, DMA shifts it out
+    ch446q_flush();
+#endif
+
+#ifdef KBD_JOURNAL_ENABLE
+    if (zx_output)
+        output_time_us = time_us_32();
+#endif
+
+#ifdef KBD_JOURNAL_ENABLE
+    if (source < KBD_SOURCES)
+        kbd_journal_record(source, time_us, dispatch_time_us, output_time_us, &kbd_state.old_state, &merged);
+#endif
+}
+
+#ifdef PS2_KBD_ENABLE
+static void __not_in_flash_func(kbd_on_ps2_event)(uint32_t time_us)
+{
+    kbd_on_event(KBD_SOURCE_PS2, time_us);
+}
+#endif
+
+#ifdef KBD_PASTE_ENABLE
+// Alarm IRQ at the PS/2 IRQ priority, on core 1
+static void __not_in_flash_func(kbd_on_paste_event)(uint32_t time_us)
+{
+    kbd_on_event(KBD_SOURCE_PASTE, time_us);
+}
+#endif
+
+#ifdef USB_KBD_ENABLE
+static void __not_in_flash_func(kbd_on_usb_event)(uint32_t time_us)
+{
+#ifdef PS2_KBD_ENABLE
+    // The USB host task runs on core 1 too, keep the PS/2 IRQ out of kbd_on_event() meanwhile
+    // (the scancode waits in the PIO FIFO)
+    irq_set_enabled(PIO_PS2_IRQ, false);
+#endif
+#ifdef KBD_PASTE_ENABLE
+    zx_paste_irq_set_enabled(false);
+#endif
+#ifndef SPI_KB_ENABLE
+    irq_set_enabled(PIO_CH446Q_IRQ, false);
+#endif
+
+    kbd_on_event(KBD_SOURCE_USB, time_us);
+
+#ifndef SPI_KB_ENABLE
+    irq_set_enabled(PIO_CH446Q_IRQ, true);
+#endif
+#ifdef KBD_PASTE_ENABLE
+    zx_paste_irq_set_enabled(true);
+#endif
+#ifdef PS2_KBD_ENABLE
+    irq_set_enabled(PIO_PS2_IRQ, true);
+#endif
+}
+#endif
+
+void kbd_set_sys_clock(void)
+{
+#ifdef SPI_KB_ENABLE
+    epm3256_set_clock();
+#else
+    ch446q_set_clock();
+#endif
+#ifdef PS2_KBD_ENABLE
+    ps2_kbd_set_clock();
+#endif
 }
 
 void kbd_init(void)
@@ -183,6 +286,8 @@ void kbd_init(void)
     memset(&kbd_zx_state, 0, sizeof(kbd_zx_state));
     memset(&kbd_zx_state_old, 0, sizeof(kbd_zx_state_old));
 
+    zx_keymap_init(settings.input_config.keymap);
+
 #ifdef SPI_KB_ENABLE
     epm3256_init();
 #else
@@ -190,13 +295,19 @@ void kbd_init(void)
 #endif
 
 #ifdef PS2_KBD_ENABLE
-    ps2_kbd_set_event_callback(kbd_on_event);
+    ps2_kbd_set_event_callback(kbd_on_ps2_event);
     ps2_kbd_pio_init();
 #endif
 
 #ifdef USB_KBD_ENABLE
     usb_kbd_init();
-    usb_kbd_set_event_callback(kbd_on_event);
+    usb_mouse_set_profile(settings.input_config.mouse);
+    usb_kbd_set_event_callback(kbd_on_usb_event);
+#endif
+
+#ifdef KBD_PASTE_ENABLE
+    zx_paste_set_event_callback(kbd_on_paste_event);
+    zx_paste_init();
 #endif
 }
 
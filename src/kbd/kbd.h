@@ -9,7 +9,17 @@
 
 #include <stdint.h>
 
+// Input backends
+typedef enum
+{
+    KBD_SOURCE_PS2,
+    KBD_SOURCE_USB,
+    KBD_SOURCES,
+    KBD_SOURCE_PASTE = KBD_SOURCES, // typed text (zx_paste.c), presses ZX keys only, not journaled
+} kbd_source_t;
+
 void kbd_init(void);
+void kbd_set_sys_clock(void); // PIO and DMA timer dividers after the video output changed clk_sys
 
 // Toggles on each keyboard/mouse event (odd = active)
 extern volatile uint32_t kbd_activity_cnt;
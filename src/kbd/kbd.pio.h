@@ -52,7 +52,7 @@ static inline pio_sm_config pio_ps2_program_get_default_config(uint offset) {
 // ---------- //
 
 #define pio_ch446q_wrap_target 0
-#define pio_ch446q_wrap 5
+#define pio_ch446q_wrap 7
 #define pio_ch446q_pio_version 0
 
 static const uint16_t pio_ch446q_program_instructions[] = {
@@ -62,14 +62,16 @@ static const uint16_t pio_ch446q_program_instructions[] = {
     0x6001, //  2: out    pins, 1         side 0
     0x0842, //  3: jmp    x--, 2          side 1
     0x6001, //  4: out    pins, 1         side 0
-    0xb042, //  5: nop                    side 2
+    0xb025, //  5: mov    x, status       side 2
+    0x0020, //  6: jmp    !x, 0           side 0
+    0xc010, //  7: irq    nowait 0 rel    side 0
             //     .wrap
 };
 
 #if !PICO_NO_HARDWARE
 static const struct pio_program pio_ch446q_program = {
     .instructions = pio_ch446q_program_instructions,
-    .length = 6,
+    .length = 8,
     .origin = -1,
     .pio_version = pio_ch446q_pio_version,
 #if PICO_PIO_VERSION > 0
@@ -0,0 +1,157 @@
+/**
+ * kbd_journal.c - Keyboard event journal
+ *
+ * Each source has one writer (its input IRQ or the USB host task),
+ * so a ring needs no lock: an event is written, then the head is advanced.
+ * Readers copy the ring and drop what the writer may have reused meanwhile.
+ */
+
+#include <string.h>
+
+#include "hardware/sync.h"
+
+#include "kbd_journal.h"
+
+#ifdef KBD_JOURNAL_ENABLE
+
+typedef struct
+{
+    kbd_journal_event_t events[KBD_JOURNAL_SIZE];
+    volatile uint32_t head; // events written since power on
+    volatile uint32_t histogram[KBD_JOURNAL_BUCKETS];
+} kbd_journal_ring_t;
+
+static kbd_journal_ring_t kbd_journal[KBD_SOURCES];
+
+static uint16_t kbd_journal_us(uint32_t from, uint32_t to)
+{
+    uint32_t us = to - from;
+
+    return us < KBD_JOURNAL_NO_OUTPUT ? us : KBD_JOURNAL_NO_OUTPUT - 1;
+}
+
+static uint8_t kbd_journal_bucket(uint16_t us)
+{
+    uint32_t units = us / KBD_JOURNAL_BUCKET_US;
+    uint32_t bucket = units ? 32 - __builtin_clz(units) : 0;
+
+    return bucket < KBD_JOURNAL_BUCKETS ? bucket : KBD_JOURNAL_BUCKETS - 1;
+}
+
+void __not_in_flash_func(kbd_journal_record)(kbd_source_t source, uint32_t time_us, uint32_t dispatch_time_us,
+                                             uint32_t output_time_us, const kbd_state_t *old_state,
+                                             const kbd_state_t *new_state)
+{
+    kbd_journal_ring_t *ring = &kbd_journal[source];
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t changed = old_state->u[i] ^ new_state->u[i];
+
+        while (changed)
+        {
+            int bit = __builtin_ctz(changed);
+            uint32_t head = ring->head;
+            kbd_journal_event_t *event = &ring->events[head & (KBD_JOURNAL_SIZE - 1)];
+
+            changed &= changed - 1;
+            event->time_us = time_us;
+            event->dispatch_us = kbd_journal_us(time_us, dispatch_time_us);
+            event->output_us = output_time_us ? kbd_journal_us(time_us, output_time_us) : KBD_JOURNAL_NO_OUTPUT;
+            event->key = i * 32 + bit;
+            event->pressed = (new_state->u[i] >> bit) & 1;
+
+            if (output_time_us)
+                ring->histogram[kbd_journal_bucket(event->output_us)]++;
+
+            __dmb(); // event /then/ head
+            ring->head = head + 1;
+        }
+    }
+}
+
+uint16_t kbd_journal_read(kbd_source_t source, kbd_journal_event_t *events, uint16_t max_events)
+{
+    kbd_journal_ring_t *ring = &kbd_journal[source];
+    uint32_t head = ring->head;
+    uint32_t count = head < KBD_JOURNAL_SIZE ? head : KBD_JOURNAL_SIZE;
+
+    if (count > max_events)
+        count = max_events;
+
+    __dmb();
+
+    for (uint32_t i = 0; i < count; i++)
+        events[i] = ring->events[(head - count + i) & (KBD_JOURNAL_SIZE - 1)];
+
+    __dmb();
+
+    // the oldest events may have been reused by the events written meanwhile and the one being written
+    uint32_t written = ring->head - head + 1;
+    uint32_t overwritten = count + written > KBD_JOURNAL_SIZE ? count + written - KBD_JOURNAL_SIZE : 0;
+
+    if (overwritten >= count)
+        return 0;
+
+    if (overwritten)
+        memmove(events, &events[overwritten], (count - overwritten) * sizeof(events[0]));
+
+    return count - overwritten;
+}
+
+static void kbd_journal_sort(uint16_t *values, uint16_t count)
+{
+    for (uint16_t i = 1; i < count; i++)
+    {
+        uint16_t value = values[i];
+        uint16_t j = i;
+
+        for (; j > 0 && values[j - 1] > value; j--)
+            values[j] = values[j - 1];
+
+        values[j] = value;
+    }
+}
+
+static uint16_t kbd_journal_percentile(const uint16_t *sorted, uint16_t count, uint8_t percent)
+{
+    return count ? sorted[(count - 1) * percent / 100] : 0;
+}
+
+void kbd_journal_latency(kbd_source_t source, kbd_latency_t *latency)
+{
+    static kbd_journal_event_t events[KBD_JOURNAL_SIZE];
+    static uint16_t output[KBD_JOURNAL_SIZE];
+    static uint16_t dispatch[KBD_JOURNAL_SIZE];
+    uint16_t count = kbd_journal_read(source, events, KBD_JOURNAL_SIZE);
+    uint16_t n = 0;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (events[i].output_us == KBD_JOURNAL_NO_OUTPUT)
+            continue;
+
+        output[n] = events[i].output_us;
+        dispatch[n] = events[i].dispatch_us;
+        n++;
+    }
+
+    kbd_journal_sort(output, n);
+    kbd_journal_sort(dispatch, n);
+
+    latency->count = n;
+    latency->p50 = kbd_journal_percentile(output, n, 50);
+    latency->p90 = kbd_journal_percentile(output, n, 90);
+    latency->p99 = kbd_journal_percentile(output, n, 99);
+    latency->max = n ? output[n - 1] : 0;
+    latency->dispatch_p50 = kbd_journal_percentile(dispatch, n, 50);
+    latency->dispatch_p99 = kbd_journal_percentile(dispatch, n, 99);
+}
+
+void kbd_journal_histogram(kbd_source_t source, uint32_t counts[KBD_JOURNAL_BUCKETS])
+{
+    for (int i = 0; i < KBD_JOURNAL_BUCKETS; i++)
+        counts[i] = kbd_journal[source].histogram[i];
+}
+
+#endif // KBD_JOURNAL_ENABLE
\ No newline at end of file
@@ -0,0 +1,59 @@
+/**
+ * kbd_journal.h - Keyboard event journal
+ *
+ * Timestamped key events from the input IRQ to the ZX matrix output,
+ * one lock-free ring per input backend (PS/2 events come from its IRQ,
+ * USB events from the host task), read by the serial menu.
+ */
+
+#pragma once
+
+#include "g_config.h"
+
+#ifdef KBD_JOURNAL_ENABLE
+
+#include "key_codes.h"
+#include "kbd.h"
+
+#define KBD_JOURNAL_SIZE 128 // events per source, power of 2
+
+#define KBD_JOURNAL_NO_OUTPUT 0xFFFF // the OSD had the keyboard, nothing was sent
+
+#define KBD_JOURNAL_BUCKETS 8 // latency histogram, bucket i < (KBD_JOURNAL_BUCKET_US << i)
+#define KBD_JOURNAL_BUCKET_US 125 // the last bucket takes everything above 8 ms
+
+typedef struct
+{
+    uint32_t time_us;     // input IRQ: PS/2 byte received, USB transfer complete
+    uint16_t dispatch_us; // input IRQ -> key states merged (USB: waiting for the host task)
+    uint16_t output_us;   // input IRQ -> ZX matrix handed to the output (CH446Q: DMA, SPI: PIO FIFO)
+    uint8_t key;          // universal key code
+    bool pressed;
+} kbd_journal_event_t;
+
+typedef struct
+{
+    uint16_t count; // events with an output
+    uint16_t p50;   // input IRQ -> output, us
+    uint16_t p90;
+    uint16_t p99;
+    uint16_t max;
+    uint16_t dispatch_p50; // input IRQ -> key states merged, us
+    uint16_t dispatch_p99;
+} kbd_latency_t;
+
+// Called by kbd_on_event() once the output is written, output_time_us = 0 for no output
+void __not_in_flash_func(kbd_journal_record)(kbd_source_t source, uint32_t time_us, uint32_t dispatch_time_us,
+                                             uint32_t output_time_us, const kbd_state_t *old_state,
+                                             const kbd_state_t *new_state);
+
+// Last events of a source, oldest first, returns their number
+uint16_t kbd_journal_read(kbd_source_t source, kbd_journal_event_t *events, uint16_t max_events);
+
+// Percentiles of the events in the journal of a source
+void kbd_journal_latency(kbd_source_t source, kbd_latency_t *latency);
+
+// Input IRQ -> output latencies of all events of a source since power on
+void kbd_journal_histogram(kbd_source_t source, uint32_t counts[KBD_JOURNAL_BUCKETS]);
+
+#endif // KBD_JOURNAL_ENABLE
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include "hardware/clocks.h"
 #include "hardware/irq.h"
+#include "hardware/timer.h"
 
 #include "g_config.h"
 #include "ps2_kbd.h"
@@ -231,9 +232,11 @@ static bool __not_in_flash_func(ps2_decode_scancode)(void)
 
 static void __not_in_flash_func(ps2_pio_irq_handler)(void)
 {
+    uint32_t time_us = time_us_32();
+
     while (ps2_decode_scancode())
         if (ps2_kbd_event_cb)
-            ps2_kbd_event_cb();
+            ps2_kbd_event_cb(time_us);
 }
 
 void ps2_kbd_set_event_callback(ps2_kbd_event_fn cb)
@@ -251,6 +254,12 @@ void ps2_kbd_clear_state(void)
     memset(&ps2_kbd_state, 0, sizeof(ps2_kbd_state));
 }
 
+void ps2_kbd_set_clock(void)
+{
+    // Set state machine clock to 200 kHz for reliable PS/2 sampling
+    pio_sm_set_clkdiv(PIO_PS2, SM_PS2, (float)clock_get_hz(clk_sys) / 200000.0f);
+}
+
 void ps2_kbd_pio_init(void)
 {
     // Add PIO program at offset 0 (static — never unloaded, first in PIO1 memory)
@@ -277,9 +286,7 @@ void ps2_kbd_pio_init(void)
     pio_sm_init(PIO_PS2, SM_PS2, offset, &c);
     pio_sm_set_enabled(PIO_PS2, SM_PS2, true);
 
-    // Set state machine clock to 200 kHz for reliable PS/2 sampling
-    float fdiv = (float)clock_get_hz(clk_sys) / 200000.0f;
-    pio_sm_set_clkdiv(PIO_PS2, SM_PS2, fdiv);
+    ps2_kbd_set_clock();
 
     // Enable PIO IRQ for RX FIFO not empty — immediate scancode processing
     pio_set_irqn_source_enabled(PIO_PS2, 1,
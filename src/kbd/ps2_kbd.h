@@ -9,9 +9,10 @@
 
 #include "key_codes.h"
 
-typedef void (*ps2_kbd_event_fn)(void);
+typedef void (*ps2_kbd_event_fn)(uint32_t time_us); // time_us: when the IRQ was entered
 
 void ps2_kbd_pio_init(void);
+void ps2_kbd_set_clock(void); // after clk_sys changed
 void ps2_kbd_set_event_callback(ps2_kbd_event_fn cb);
 kbd_state_t *ps2_kbd_get_state(void);
 void ps2_kbd_clear_state(void);
@@ -0,0 +1,429 @@
+/**
+ * usb_hid.c - USB HID report descriptor parser
+ *
+ * Walks the short items of a report descriptor, keeps the global and local
+ * item state the HID spec defines, and at each Input item checks whether it
+ * is one of the fields the keyboard, mouse and gamepad drivers need. Only the first
+ * field of each kind is kept. Input bit offsets are counted per report ID.
+ */
+
+#include <string.h>
+
+#include "usb_hid.h"
+
+#ifdef USB_KBD_ENABLE
+
+// Item tags, (tag << 4) | (type << 2)
+#define HID_MAIN_INPUT 0x80
+#define HID_MAIN_COLLECTION 0xA0
+#define HID_MAIN_END_COLLECTION 0xC0
+#define HID_GLOBAL_USAGE_PAGE 0x04
+#define HID_GLOBAL_LOGICAL_MIN 0x14
+#define HID_GLOBAL_LOGICAL_MAX 0x24
+#define HID_GLOBAL_REPORT_SIZE 0x74
+#define HID_GLOBAL_REPORT_ID 0x84
+#define HID_GLOBAL_REPORT_COUNT 0x94
+#define HID_GLOBAL_PUSH 0xA4
+#define HID_GLOBAL_POP 0xB4
+#define HID_LOCAL_USAGE 0x08
+#define HID_LOCAL_USAGE_MIN 0x18
+#define HID_LOCAL_USAGE_MAX 0x28
+#define HID_LONG_ITEM 0xFE
+
+#define HID_INPUT_CONSTANT 0x01
+#define HID_INPUT_VARIABLE 0x02
+
+// Usages, (page << 16) | id
+#define HID_PAGE_KEYBOARD 0x07
+#define HID_PAGE_BUTTON 0x09
+#define HID_USAGE_MOUSE 0x00010002
+#define HID_USAGE_JOYSTICK 0x00010004
+#define HID_USAGE_GAMEPAD 0x00010005
+#define HID_USAGE_KEYBOARD 0x00010006
+#define HID_USAGE_KEYPAD 0x00010007
+#define HID_USAGE_X 0x00010030
+#define HID_USAGE_Y 0x00010031
+#define HID_USAGE_WHEEL 0x00010038
+#define HID_USAGE_HAT 0x00010039
+#define HID_KEY_MODIFIERS 0xE0
+
+#define USB_HID_USAGES_MAX 8
+#define USB_HID_REPORTS_MAX 8
+#define USB_HID_STACK_MAX 2
+
+typedef struct
+{
+    uint16_t page;
+    int32_t logical_min;
+    int32_t logical_max;
+    uint8_t report_size;
+    uint8_t report_id;
+    uint16_t report_count;
+} usb_hid_global_t;
+
+typedef struct
+{
+    usb_hid_global_t global;
+    usb_hid_global_t stack[USB_HID_STACK_MAX];
+    uint8_t stack_depth;
+
+    uint32_t usages[USB_HID_USAGES_MAX]; // < 0x10000: page still to be added
+    uint8_t usage_count;
+    uint32_t usage_min;
+    uint32_t usage_max;
+
+    uint8_t collection_depth;
+    uint32_t application; // usage of the top level collection
+
+    struct
+    {
+        uint8_t id;
+        uint16_t bits;
+    } reports[USB_HID_REPORTS_MAX];
+    uint8_t report_count;
+} usb_hid_parser_t;
+
+const usb_hid_layout_t usb_hid_boot_keyboard = {
+    .modifiers = {.bit = 0, .size = 1, .count = 8},
+    .keys = {.bit = 16, .size = 8, .count = 6},
+};
+
+const usb_hid_layout_t usb_hid_boot_mouse = {
+    .buttons = {.bit = 0, .size = 1, .count = 3},
+    .x = {.bit = 8, .size = 8, .count = 1, .is_signed = true},
+    .y = {.bit = 16, .size = 8, .count = 1, .is_signed = true},
+};
+
+static uint32_t usb_hid_item_value(const uint8_t *data, uint8_t size)
+{
+    uint32_t value = 0;
+
+    for (uint8_t i = 0; i < size; i++)
+        value |= (uint32_t)data[i] << (8 * i);
+
+    return value;
+}
+
+static int32_t usb_hid_item_signed(const uint8_t *data, uint8_t size)
+{
+    uint32_t value = usb_hid_item_value(data, size);
+
+    if (size == 1)
+        return (int8_t)value;
+
+    if (size == 2)
+        return (int16_t)value;
+
+    return (int32_t)value;
+}
+
+static uint32_t usb_hid_full_usage(const usb_hid_parser_t *parser, uint32_t usage)
+{
+    return usage > 0xFFFF ? usage : ((uint32_t)parser->global.page << 16) | usage;
+}
+
+// Usage of value n of the current main item, 0 if there is none
+static uint32_t usb_hid_usage(const usb_hid_parser_t *parser, uint8_t n)
+{
+    if (parser->usage_count)
+        return usb_hid_full_usage(parser, parser->usages[n < parser->usage_count ? n : parser->usage_count - 1]);
+
+    if (parser->usage_max && parser->usage_min + n <= parser->usage_max)
+        return usb_hid_full_usage(parser, parser->usage_min + n);
+
+    return 0;
+}
+
+static uint16_t *usb_hid_report_bits(usb_hid_parser_t *parser)
+{
+    uint8_t id = parser->global.report_id;
+
+    for (uint8_t i = 0; i < parser->report_count; i++)
+        if (parser->reports[i].id == id)
+            return &parser->reports[i].bits;
+
+    if (parser->report_count == USB_HID_REPORTS_MAX)
+        return NULL;
+
+    parser->reports[parser->report_count].id = id;
+    parser->reports[parser->report_count].bits = 0;
+
+    return &parser->reports[parser->report_count++].bits;
+}
+
+static void usb_hid_set_field(const usb_hid_parser_t *parser, usb_hid_field_t *field, uint16_t bit,
+                              uint8_t count)
+{
+    if (field->size)
+        return;
+
+    field->bit = bit;
+    field->size = parser->global.report_size;
+    field->count = count;
+    field->report_id = parser->global.report_id;
+    field->is_signed = parser->global.logical_min < 0;
+    field->logical_min = parser->global.logical_min;
+    field->logical_max = parser->global.logical_max;
+}
+
+static void usb_hid_input(usb_hid_parser_t *parser, uint8_t flags, uint16_t bit, usb_hid_layout_t *layout)
+{
+    uint8_t size = parser->global.report_size;
+    uint8_t count = parser->global.report_count < 255 ? parser->global.report_count : 255;
+    uint32_t usage = usb_hid_usage(parser, 0);
+    uint16_t page = usage ? usage >> 16 : parser->global.page;
+    bool variable = flags & HID_INPUT_VARIABLE;
+
+    if ((flags & HID_INPUT_CONSTANT) || size == 0 || size > 32 || count == 0)
+        return;
+
+    if (parser->application == HID_USAGE_KEYBOARD || parser->application == HID_USAGE_KEYPAD)
+    {
+        if (page != HID_PAGE_KEYBOARD)
+            return;
+
+        if (!variable)
+            usb_hid_set_field(parser, &layout->keys, bit, count);
+        else if (size == 1 && (usage & 0xFFFF) == HID_KEY_MODIFIERS)
+            usb_hid_set_field(parser, &layout->modifiers, bit, count < 8 ? count : 8);
+        else if (size == 1 && !layout->bitmap.size)
+        {
+            usb_hid_set_field(parser, &layout->bitmap, bit, count);
+            layout->bitmap_first = usage & 0xFF;
+        }
+    }
+    else if (parser->application == HID_USAGE_MOUSE && variable)
+    {
+        if (page == HID_PAGE_BUTTON)
+        {
+            usb_hid_set_field(parser, &layout->buttons, bit, count < 8 ? count : 8);
+            return;
+        }
+
+        for (uint8_t n = 0; n < count; n++)
+        {
+            usb_hid_field_t *field = NULL;
+
+            switch (usb_hid_usage(parser, n))
+            {
+            case HID_USAGE_X:
+                field = &layout->x;
+                break;
+
+            case HID_USAGE_Y:
+                field = &layout->y;
+                break;
+
+            case HID_USAGE_WHEEL:
+                field = &layout->wheel;
+                break;
+
+            default:
+                break;
+            }
+
+            if (field)
+                usb_hid_set_field(parser, field, bit + n * size, 1);
+        }
+    }
+    else if ((parser->application == HID_USAGE_GAMEPAD || parser->application == HID_USAGE_JOYSTICK) && variable)
+    {
+        if (page == HID_PAGE_BUTTON)
+        {
+            usb_hid_set_field(parser, &layout->pad_buttons, bit, count < 16 ? count : 16);
+            return;
+        }
+
+        for (uint8_t n = 0; n < count; n++)
+        {
+            usb_hid_field_t *field = NULL;
+
+            switch (usb_hid_usage(parser, n))
+            {
+            case HID_USAGE_X:
+                field = &layout->pad_x;
+                break;
+
+            case HID_USAGE_Y:
+                field = &layout->pad_y;
+                break;
+
+            case HID_USAGE_HAT:
+                field = &layout->pad_hat;
+                break;
+
+            default:
+                break;
+            }
+
+            if (field)
+                usb_hid_set_field(parser, field, bit + n * size, 1);
+        }
+    }
+}
+
+bool usb_hid_parse(const uint8_t *desc, uint16_t len, usb_hid_layout_t *layout)
+{
+    static usb_hid_parser_t parser;
+    uint16_t pos = 0;
+
+    memset(&parser, 0, sizeof(parser));
+    memset(layout, 0, sizeof(*layout));
+
+    while (desc && pos < len)
+    {
+        uint8_t prefix = desc[pos];
+
+        if (prefix == HID_LONG_ITEM)
+        { // [prefix, data size, tag, data]
+            if (pos + 1 >= len)
+                break;
+
+            pos += 3 + desc[pos + 1];
+            continue;
+        }
+
+        uint8_t size = (prefix & 0x03) == 3 ? 4 : prefix & 0x03;
+        uint8_t item = prefix & 0xFC;
+        const uint8_t *data = &desc[pos + 1];
+
+        if (pos + 1 + size > len)
+            break;
+
+        pos += 1 + size;
+
+        uint32_t value = usb_hid_item_value(data, size);
+
+        switch (item)
+        {
+        case HID_MAIN_INPUT:
+        {
+            uint16_t *bits = usb_hid_report_bits(&parser);
+
+            if (!bits)
+                break;
+
+            usb_hid_input(&parser, value, *bits, layout);
+            *bits += parser.global.report_size * parser.global.report_count;
+            break;
+        }
+
+        case HID_MAIN_COLLECTION:
+            if (parser.collection_depth++ == 0)
+                parser.application = usb_hid_usage(&parser, 0);
+            break;
+
+        case HID_MAIN_END_COLLECTION:
+            if (parser.collection_depth)
+                parser.collection_depth--;
+            break;
+
+        case HID_GLOBAL_USAGE_PAGE:
+            parser.global.page = value;
+            break;
+
+        case HID_GLOBAL_LOGICAL_MIN:
+            parser.global.logical_min = usb_hid_item_signed(data, size);
+            break;
+
+        case HID_GLOBAL_LOGICAL_MAX: // unsigned if the minimum is not negative, e.g. 0..255 in one byte
+            parser.global.logical_max =
+                parser.global.logical_min < 0 ? usb_hid_item_signed(data, size) : (int32_t)value;
+            break;
+
+        case HID_GLOBAL_REPORT_SIZE:
+            parser.global.report_size = value;
+            break;
+
+        case HID_GLOBAL_REPORT_ID:
+            parser.global.report_id = value;
+            layout->report_ids = true;
+            break;
+
+        case HID_GLOBAL_REPORT_COUNT:
+            parser.global.report_count = value;
+            break;
+
+        case HID_GLOBAL_PUSH:
+            if (parser.stack_depth < USB_HID_STACK_MAX)
+                parser.stack[parser.stack_depth++] = parser.global;
+            break;
+
+        case HID_GLOBAL_POP:
+            if (parser.stack_depth)
+                parser.global = parser.stack[--parser.stack_depth];
+            break;
+
+        case HID_LOCAL_USAGE:
+            if (parser.usage_count < USB_HID_USAGES_MAX)
+                parser.usages[parser.usage_count++] = value;
+            break;
+
+        case HID_LOCAL_USAGE_MIN:
+            parser.usage_min = value;
+            break;
+
+        case HID_LOCAL_USAGE_MAX:
+            parser.usage_max = value;
+            break;
+
+        default:
+            break;
+        }
+
+        // Local items only apply to the next main item
+        if ((prefix & 0x0C) == 0)
+        {
+            parser.usage_count = 0;
+            parser.usage_min = 0;
+            parser.usage_max = 0;
+        }
+    }
+
+    return usb_hid_is_keyboard(layout) || usb_hid_is_mouse(layout) || usb_hid_is_gamepad(layout);
+}
+
+bool usb_hid_is_keyboard(const usb_hid_layout_t *layout)
+{
+    return layout->keys.size || layout->bitmap.size;
+}
+
+bool usb_hid_is_mouse(const usb_hid_layout_t *layout)
+{
+    return layout->x.size && layout->y.size;
+}
+
+bool usb_hid_is_gamepad(const usb_hid_layout_t *layout)
+{
+    return (layout->pad_x.size && layout->pad_y.size) || layout->pad_hat.size;
+}
+
+uint32_t __not_in_flash_func(usb_hid_get)(const uint8_t *report, uint16_t len, const usb_hid_field_t *field,
+                                          uint8_t n)
+{
+    uint32_t bit = field->bit + n * field->size;
+    uint32_t end = bit + field->size;
+    uint64_t value = 0;
+
+    if (!field->size || end > len * 8u)
+        return 0;
+
+    for (uint32_t byte = bit / 8; byte * 8 < end; byte++)
+        value |= (uint64_t)report[byte] << (byte * 8 - bit / 8 * 8);
+
+    value >>= bit % 8;
+
+    return field->size < 32 ? (uint32_t)value & ((1u << field->size) - 1) : (uint32_t)value;
+}
+
+int32_t __not_in_flash_func(usb_hid_get_signed)(const uint8_t *report, uint16_t len, const usb_hid_field_t *field)
+{
+    uint32_t value = usb_hid_get(report, len, field, 0);
+
+    if (field->is_signed && field->size < 32 && (value >> (field->size - 1)) & 1)
+        value |= ~0u << field->size;
+
+    return (int32_t)value;
+}
+
+#endif // USB_KBD_ENABLE
\ No newline at end of file
@@ -0,0 +1,58 @@
+/**
+ * usb_hid.h - USB HID report descriptor parser
+ *
+ * Finds the keyboard, mouse and gamepad fields of a HID interface once, when
+ * it is mounted, so its reports are decoded by extracting bits at known offsets.
+ * No TinyUSB dependency: descriptors can be checked on the host.
+ */
+
+#pragma once
+
+#include "g_config.h"
+
+#ifdef USB_KBD_ENABLE
+
+typedef struct
+{
+    uint16_t bit;      // first value in the report, after the report ID
+    uint8_t size;      // bits per value, 0: no such field
+    uint8_t count;     // values
+    uint8_t report_id; // 0: the interface has no report IDs
+    bool is_signed;
+    int32_t logical_min;
+    int32_t logical_max;
+} usb_hid_field_t;
+
+typedef struct
+{
+    bool report_ids;           // reports start with their report ID byte
+    usb_hid_field_t modifiers; // 1 bit per modifier, usages 0xE0 (left ctrl) upwards
+    usb_hid_field_t keys;      // array of key usages, boot: 6 x 8 bits
+    usb_hid_field_t bitmap;    // 1 bit per key usage from bitmap_first on (NKRO)
+    uint8_t bitmap_first;
+    usb_hid_field_t buttons; // 1 bit per button, left first
+    usb_hid_field_t x;       // relative moves
+    usb_hid_field_t y;
+    usb_hid_field_t wheel;
+    usb_hid_field_t pad_x; // absolute, gamepads and joysticks
+    usb_hid_field_t pad_y;
+    usb_hid_field_t pad_hat; // 8 directions clockwise from up, out of range: centered
+    usb_hid_field_t pad_buttons;
+} usb_hid_layout_t;
+
+extern const usb_hid_layout_t usb_hid_boot_keyboard;
+extern const usb_hid_layout_t usb_hid_boot_mouse;
+
+// Returns false if the descriptor has no keyboard, mouse or gamepad fields
+bool usb_hid_parse(const uint8_t *desc, uint16_t len, usb_hid_layout_t *layout);
+
+bool usb_hid_is_keyboard(const usb_hid_layout_t *layout);
+bool usb_hid_is_mouse(const usb_hid_layout_t *layout);
+bool usb_hid_is_gamepad(const usb_hid_layout_t *layout);
+
+// Value n of a field, 0 if the report is too short
+uint32_t __not_in_flash_func(usb_hid_get)(const uint8_t *report, uint16_t len, const usb_hid_field_t *field,
+                                          uint8_t n);
+int32_t __not_in_flash_func(usb_hid_get_signed)(const uint8_t *report, uint16_t len, const usb_hid_field_t *field);
+
+#endif // USB_KBD_ENABLE
\ No newline at end of file
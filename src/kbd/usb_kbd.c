@@ -1,15 +1,24 @@
 /**
  * usb_kbd.c - USB HID keyboard and mouse driver using TinyUSB Host
  *
- * Converts 8-byte boot keyboard reports to universal key state.
- * Converts mouse reports to Kempston-compatible accumulated state.
+ * Decodes keyboard reports (key array or NKRO bitmap) to universal key state,
+ * mouse reports to Kempston-compatible accumulated state and gamepad reports
+ * to joystick directions, using the fields usb_hid.c found in each
+ * interface's report descriptor.
+ *
+ * Mouse moves are scaled by the selected profile in 8.8 fixed point; the
+ * fractions are carried to the next report, so slow moves are not lost.
  */
 
 #include "tusb.h"
 #include "class/hid/hid.h"
+#include "host/hcd.h"
+#include "hardware/sync.h"
 
 #include "g_config.h"
+#include "usb_hid.h"
 #include "usb_kbd.h"
+#include "zx_kbd.h"
 
 #ifdef USB_KBD_ENABLE
 
@@ -152,67 +161,91 @@ static const uint8_t usb_hid_to_universal[] = {
 
 #define USB_HID_TO_UNIVERSAL_SIZE (count_of(usb_hid_to_universal))
 
-static kbd_state_t usb_kbd_state;
-static usb_mouse_state_t usb_mouse_state;
-static usb_kbd_event_fn usb_kbd_event_cb = NULL;
-static uint8_t usb_dev_addr = 0;
-static uint8_t usb_hid_idx = 0;
-static bool usb_keyboard_mounted = false;
-static uint8_t usb_mouse_dev_addr = 0;
-static uint8_t usb_mouse_hid_idx = 0;
-static bool usb_mouse_mounted = false;
-
-static void process_kbd_report(uint8_t const *report, uint16_t len)
+// Modifier usages 0xE0..0xE7 → universal key codes
+static const uint8_t usb_hid_modifier_to_universal[8] = {
+    KEY_L_CTRL, KEY_L_SHIFT, KEY_L_ALT, KEY_L_WIN, KEY_R_CTRL, KEY_R_SHIFT, KEY_R_ALT, KEY_R_WIN,
+};
+
+// A mounted HID interface and the fields found in its report descriptor
+typedef struct
 {
-    if (len < 8)
-        return;
+    bool mounted;
+    uint8_t dev_addr;
+    uint8_t idx;
+    usb_hid_layout_t layout;
+    kbd_state_t kbd_state; // keys held on this interface
+    uint8_t mouse_buttons; // buttons held on this interface, bit 0: left
+    uint8_t joystick;      // gamepad directions and fire, ZX_JOY bits
+} usb_hid_itf_t;
+
+static usb_hid_itf_t usb_hid_itfs[CFG_TUH_HID];
+
+static kbd_state_t usb_kbd_state; // keys held on all interfaces
+static usb_mouse_state_t usb_mouse_state; // moves of all mice, buttons held on any of them
+static usb_kbd_event_fn usb_kbd_event_cb = NULL;
 
-    // Boot keyboard report: [modifier, reserved, key1..key6]
-    uint8_t modifier = report[0];
+#define USB_MOUSE_ACCEL_THRESHOLD 4 // counts per report moved at the profile speed
+#define USB_MOUSE_ACCEL_MAX 4       // times the profile speed
 
-    // Build new state from scratch
-    kbd_state_t new_state;
-
-    memset(&new_state, 0, sizeof(new_state));
+typedef struct
+{
+    int32_t gain;  // 8.8, scale of the mouse counts
+    int32_t accel; // 8.8, gain added per count per report above USB_MOUSE_ACCEL_THRESHOLD
+} usb_mouse_profile_t;
+
+static const usb_mouse_profile_t usb_mouse_profiles[MOUSE_PROFILES] = {
+    [MOUSE_1_1] = {256, 0},
+    [MOUSE_1_2] = {128, 0},
+    [MOUSE_1_4] = {64, 0},
+    [MOUSE_1_2_ACCEL] = {128, 16},
+    [MOUSE_1_4_ACCEL] = {64, 16},
+};
 
-    // Map modifier bits to universal keys
-    if (modifier & KEYBOARD_MODIFIER_LEFTCTRL)
-        SET_STATE_KEY(new_state, KEY_L_CTRL);
+static const usb_mouse_profile_t *usb_mouse_profile = &usb_mouse_profiles[MOUSE_1_1];
+#define USB_MOUSE_FRAC_HALF 0x80 // fractions start at half a step: moves round to the nearest step
 
-    if (modifier & KEYBOARD_MODIFIER_LEFTSHIFT)
-        SET_STATE_KEY(new_state, KEY_L_SHIFT);
+static int32_t usb_mouse_frac_x = USB_MOUSE_FRAC_HALF; // fractions of a Kempston step not sent yet, 0.8
+static int32_t usb_mouse_frac_y = USB_MOUSE_FRAC_HALF;
 
-    if (modifier & KEYBOARD_MODIFIER_LEFTALT)
-        SET_STATE_KEY(new_state, KEY_L_ALT);
+// Last transfer completion seen by the host controller IRQ, the report being handled
+// by tuh_task() completed no later than this
+static volatile uint32_t usb_xfer_time_us = 0;
 
-    if (modifier & KEYBOARD_MODIFIER_LEFTGUI)
-        SET_STATE_KEY(new_state, KEY_L_WIN);
+static usb_hid_itf_t *usb_hid_itf_find(uint8_t dev_addr, uint8_t idx)
+{
+    for (int i = 0; i < CFG_TUH_HID; i++)
+        if (usb_hid_itfs[i].mounted && usb_hid_itfs[i].dev_addr == dev_addr && usb_hid_itfs[i].idx == idx)
+            return &usb_hid_itfs[i];
 
-    if (modifier & KEYBOARD_MODIFIER_RIGHTCTRL)
-        SET_STATE_KEY(new_state, KEY_R_CTRL);
+    return NULL;
+}
 
-    if (modifier & KEYBOARD_MODIFIER_RIGHTSHIFT)
-        SET_STATE_KEY(new_state, KEY_R_SHIFT);
+static inline uint8_t usb_hid_key(uint32_t hid_code)
+{
+    if (hid_code < USB_HID_TO_UNIVERSAL_SIZE)
+        return usb_hid_to_universal[hid_code];
 
-    if (modifier & KEYBOARD_MODIFIER_RIGHTALT)
-        SET_STATE_KEY(new_state, KEY_R_ALT);
+    if (hid_code >= 0xE0 && hid_code <= 0xE7)
+        return usb_hid_modifier_to_universal[hid_code - 0xE0];
 
-    if (modifier & KEYBOARD_MODIFIER_RIGHTGUI)
-        SET_STATE_KEY(new_state, KEY_R_WIN);
+    return NO_KEY;
+}
 
-    // Map key array (up to 6 simultaneous keys)
-    for (int i = 2; i < 8; i++)
-    {
-        uint8_t hid_code = report[i];
+// Field of the report that came in, NULL if it belongs to another report ID
+static inline const usb_hid_field_t *usb_hid_in_report(const usb_hid_field_t *field, uint8_t report_id)
+{
+    return field->size && field->report_id == report_id ? field : NULL;
+}
 
-        if (hid_code == 0 || hid_code >= USB_HID_TO_UNIVERSAL_SIZE)
-            continue;
+static void usb_kbd_update(uint32_t time_us)
+{
+    kbd_state_t new_state;
 
-        uint8_t ucode = usb_hid_to_universal[hid_code];
+    memset(&new_state, 0, sizeof(new_state));
 
-        if (ucode != NO_KEY)
-            SET_STATE_KEY(new_state, ucode);
-    }
+    for (int i = 0; i < CFG_TUH_HID; i++)
+        for (int j = 0; j < 4; j++)
+            new_state.u[j] |= usb_hid_itfs[i].kbd_state.u[j];
 
     // Check if state actually changed
     if (memcmp(&usb_kbd_state, &new_state, sizeof(kbd_state_t)) == 0)
@@ -221,137 +254,331 @@ static void process_kbd_report(uint8_t const *report, uint16_t len)
     usb_kbd_state = new_state;
 
     if (usb_kbd_event_cb)
-        usb_kbd_event_cb();
+        usb_kbd_event_cb(time_us);
 }
 
-static void __not_in_flash_func(process_mouse_report)(uint8_t const *report, uint16_t len)
+static void process_kbd_report(usb_hid_itf_t *itf, uint8_t report_id, uint8_t const *report, uint16_t len)
 {
-    // Boot mouse: [buttons, dx, dy] (3 bytes)
-    // Boot mouse with wheel: [buttons, dx, dy, wheel] (4 bytes)
-    // Some mice send [report_id, buttons, dx, dy, ...] (5+ bytes)
-    int d = 0;
+    const usb_hid_layout_t *layout = &itf->layout;
+    const usb_hid_field_t *modifiers = usb_hid_in_report(&layout->modifiers, report_id);
+    const usb_hid_field_t *keys = usb_hid_in_report(&layout->keys, report_id);
+    const usb_hid_field_t *bitmap = usb_hid_in_report(&layout->bitmap, report_id);
 
-    if (len > 4)
-        d = 1;
-
-    if (len < (3 + d))
+    if (!modifiers && !keys && !bitmap)
         return;
 
-    uint8_t buttons = report[0 + d];
-    int8_t dx = (int8_t)report[1 + d];
-    int8_t dy = (int8_t)report[2 + d];
+    // Build new state from scratch
+    kbd_state_t new_state;
 
-    // TODO: wheel support (use later)
-    // if (len >= (4 + d))
-    // {
-    //     int8_t dw = (int8_t)report[3 + d];
-    //     usb_mouse_state.has_wheel = true;
-    //     usb_mouse_state.wheel = (usb_mouse_state.wheel + dw) & 0x0F;
-    // }
+    memset(&new_state, 0, sizeof(new_state));
 
-    // Accumulate position (Kempston mouse wraps 0-255)
-    int x = usb_mouse_state.x + dx;
-    int y = usb_mouse_state.y - dy; // Y inverted for Kempston
+    if (modifiers)
+        for (uint8_t i = 0; i < modifiers->count; i++)
+            if (usb_hid_get(report, len, modifiers, i))
+                SET_STATE_KEY(new_state, usb_hid_modifier_to_universal[i]);
+
+    // Key array (boot: up to 6 simultaneous keys)
+    if (keys)
+        for (uint8_t i = 0; i < keys->count; i++)
+        {
+            uint8_t ucode = usb_hid_key(usb_hid_get(report, len, keys, i));
+
+            if (ucode != NO_KEY)
+                SET_STATE_KEY(new_state, ucode);
+        }
 
-    if (x > 255)
-        x &= 255;
+    // One bit per key (NKRO)
+    if (bitmap && bitmap->bit + bitmap->count <= len * 8u)
+        for (uint16_t i = 0; i < bitmap->count; i++)
+        {
+            uint16_t bit = bitmap->bit + i;
 
-    if (x < 0)
-        x += 256;
+            if (!((report[bit / 8] >> (bit % 8)) & 1))
+                continue;
 
-    if (y > 255)
-        y &= 255;
+            uint8_t ucode = usb_hid_key(layout->bitmap_first + i);
 
-    if (y < 0)
-        y += 256;
+            if (ucode != NO_KEY)
+                SET_STATE_KEY(new_state, ucode);
+        }
+
+    itf->kbd_state = new_state;
+    usb_kbd_update(usb_xfer_time_us);
+}
+
+static void __not_in_flash_func(usb_mouse_update)(uint32_t time_us)
+{
+    uint8_t buttons = 0;
+
+    for (int i = 0; i < CFG_TUH_HID; i++)
+        buttons |= usb_hid_itfs[i].mouse_buttons;
 
     // Build buttons byte: bits 0-2 inverted buttons, bit 3 always 1,
-    // bits 4-7: 0xF (no wheel support yet)
+    // bits 4-7: wheel position, 0xF if no wheel
     uint8_t btn = (buttons ^ 0xFF) & 0x07;
     btn |= 0x08; // bit 3 always 1
-    btn |= 0xF0; // bits 4-7 = 1111 (no wheel)
 
-    // TODO: wheel support (use later)
-    // if (usb_mouse_state.has_wheel)
-    //     btn |= (usb_mouse_state.wheel << 4);
-    // else
-    //     btn |= 0xF0;
+    if (usb_mouse_state.has_wheel)
+        btn |= usb_mouse_state.wheel << 4;
+    else
+        btn |= 0xF0;
 
     usb_mouse_state.buttons = btn;
-    usb_mouse_state.x = (uint8_t)x;
-    usb_mouse_state.y = (uint8_t)y;
 
     if (usb_kbd_event_cb)
-        usb_kbd_event_cb();
+        usb_kbd_event_cb(time_us);
 }
 
-// TinyUSB Host HID Callbacks
+// Scaled move in Kempston steps, the remainder stays in frac
+static inline int32_t usb_mouse_scale(int32_t d, int32_t gain, int32_t *frac)
+{
+    int32_t v = *frac + d * gain;
 
-void tuh_hid_mount_cb(uint8_t dev_addr, uint8_t idx, uint8_t const *desc_report, uint16_t desc_len)
+    *frac = v & 0xFF;
+
+    return v >> 8; // arithmetic shift: rounds down, frac stays positive (half a step ahead: to the nearest)
+}
+
+static void __not_in_flash_func(process_mouse_report)(usb_hid_itf_t *itf, uint8_t report_id, uint8_t const *report,
+                                                      uint16_t len)
 {
-    (void)desc_report;
-    (void)desc_len;
+    const usb_hid_layout_t *layout = &itf->layout;
+
+    if (!usb_hid_in_report(&layout->x, report_id))
+        return;
+
+    uint8_t buttons = 0;
+
+    for (uint8_t i = 0; i < layout->buttons.count && i < 3; i++)
+        buttons |= usb_hid_get(report, len, &layout->buttons, i) << i;
 
-    uint8_t const protocol = tuh_hid_interface_protocol(dev_addr, idx);
+    int32_t dx = usb_hid_get_signed(report, len, &layout->x);
+    int32_t dy = usb_hid_get_signed(report, len, &layout->y);
 
-    if (protocol == HID_ITF_PROTOCOL_KEYBOARD)
+    if (layout->wheel.size)
     {
-        usb_dev_addr = dev_addr;
-        usb_hid_idx = idx;
-        usb_keyboard_mounted = true;
+        int32_t dw = usb_hid_get_signed(report, len, &layout->wheel);
+        usb_mouse_state.has_wheel = true;
+        usb_mouse_state.wheel = (usb_mouse_state.wheel + dw) & 0x0F;
+    }
 
-        // Use boot protocol for simplicity
-        if (tuh_hid_get_protocol(dev_addr, idx) != HID_PROTOCOL_BOOT)
-            tuh_hid_set_protocol(dev_addr, idx, HID_PROTOCOL_BOOT);
+    const usb_mouse_profile_t *profile = usb_mouse_profile;
+    int32_t gain = profile->gain;
+
+    if (profile->accel)
+    {
+        int32_t speed = dx < 0 ? -dx : dx;
+        int32_t speed_y = dy < 0 ? -dy : dy;
+
+        if (speed_y > speed)
+            speed = speed_y;
+
+        if (speed > USB_MOUSE_ACCEL_THRESHOLD)
+        {
+            gain += (gain * profile->accel * (speed - USB_MOUSE_ACCEL_THRESHOLD)) >> 8;
+
+            if (gain > profile->gain * USB_MOUSE_ACCEL_MAX)
+                gain = profile->gain * USB_MOUSE_ACCEL_MAX;
+        }
+    }
+
+    // Accumulate position (Kempston mouse wraps 0-255)
+    usb_mouse_state.x += usb_mouse_scale(dx, gain, &usb_mouse_frac_x);
+    usb_mouse_state.y -= usb_mouse_scale(dy, gain, &usb_mouse_frac_y); // Y inverted for Kempston
+
+    itf->mouse_buttons = buttons;
+    usb_mouse_update(usb_xfer_time_us);
+}
+
+// Hat switch positions clockwise from up
+static const uint8_t usb_hat_to_joystick[8] = {
+    ZX_JOY_UP,
+    ZX_JOY_UP | ZX_JOY_RIGHT,
+    ZX_JOY_RIGHT,
+    ZX_JOY_DOWN | ZX_JOY_RIGHT,
+    ZX_JOY_DOWN,
+    ZX_JOY_DOWN | ZX_JOY_LEFT,
+    ZX_JOY_LEFT,
+    ZX_JOY_UP | ZX_JOY_LEFT,
+};
 
-        // Start receiving reports
-        tuh_hid_receive_report(dev_addr, idx);
+// An analog axis counts as pushed beyond a quarter of its range from the center
+static uint8_t usb_pad_axis(uint8_t const *report, uint16_t len, const usb_hid_field_t *field, uint8_t low,
+                            uint8_t high)
+{
+    int32_t range = field->logical_max - field->logical_min;
+    int32_t offset = usb_hid_get_signed(report, len, field) - field->logical_min - range / 2;
+
+    if (range <= 0)
+        return 0;
+
+    if (offset < -range / 4)
+        return low;
+
+    if (offset > range / 4)
+        return high;
+
+    return 0;
+}
+
+static void process_gamepad_report(usb_hid_itf_t *itf, uint8_t report_id, uint8_t const *report, uint16_t len)
+{
+    const usb_hid_layout_t *layout = &itf->layout;
+    const usb_hid_field_t *pad_x = usb_hid_in_report(&layout->pad_x, report_id);
+    const usb_hid_field_t *pad_y = usb_hid_in_report(&layout->pad_y, report_id);
+    const usb_hid_field_t *hat = usb_hid_in_report(&layout->pad_hat, report_id);
+    const usb_hid_field_t *buttons = usb_hid_in_report(&layout->pad_buttons, report_id);
+    uint8_t joystick = 0;
+
+    if (!pad_x && !pad_y && !hat && !buttons)
+        return;
+
+    if (pad_x)
+        joystick |= usb_pad_axis(report, len, pad_x, ZX_JOY_LEFT, ZX_JOY_RIGHT);
+
+    if (pad_y)
+        joystick |= usb_pad_axis(report, len, pad_y, ZX_JOY_UP, ZX_JOY_DOWN);
+
+    if (hat)
+    {
+        uint32_t position = usb_hid_get_signed(report, len, hat) - hat->logical_min;
+
+        if (position < count_of(usb_hat_to_joystick))
+            joystick |= usb_hat_to_joystick[position];
     }
-    else if (protocol == HID_ITF_PROTOCOL_MOUSE)
+
+    // Fire: any of the 4 face buttons
+    if (buttons)
+        for (uint8_t i = 0; i < buttons->count && i < 4; i++)
+            if (usb_hid_get(report, len, buttons, i))
+                joystick |= ZX_JOY_FIRE;
+
+    if (joystick == itf->joystick)
+        return;
+
+    itf->joystick = joystick;
+
+    if (usb_kbd_event_cb)
+        usb_kbd_event_cb(usb_xfer_time_us);
+}
+
+// TinyUSB Host HID Callbacks
+
+void tuh_event_hook_cb(uint8_t rhport, uint32_t eventid, bool in_isr)
+{ // an event was queued for tuh_task()
+    (void)rhport;
+
+    if (in_isr && eventid == HCD_EVENT_XFER_COMPLETE)
+        usb_xfer_time_us = time_us_32();
+
+    __sev(); // the host task waits in WFE on core 1, don't let it miss an event queued just before
+}
+
+void tuh_hid_mount_cb(uint8_t dev_addr, uint8_t idx, uint8_t const *desc_report, uint16_t desc_len)
+{
+    usb_hid_itf_t *itf = NULL;
+
+    for (int i = 0; i < CFG_TUH_HID && !itf; i++)
+        if (!usb_hid_itfs[i].mounted)
+            itf = &usb_hid_itfs[i];
+
+    if (!itf)
+        return;
+
+    if (desc_len == 0)
+        TU_LOG1("HID %u:%u: no report descriptor (longer than CFG_TUH_ENUMERATION_BUFSIZE?), boot protocol\r\n",
+                dev_addr, idx);
+
+    // Report protocol with the fields from the report descriptor (NKRO keyboards,
+    // receivers and combo devices), boot protocol if the descriptor makes no sense
+    if (!usb_hid_parse(desc_report, desc_len, &itf->layout))
     {
-        usb_mouse_dev_addr = dev_addr;
-        usb_mouse_hid_idx = idx;
-        usb_mouse_mounted = true;
+        uint8_t const protocol = tuh_hid_interface_protocol(dev_addr, idx);
+
+        if (protocol == HID_ITF_PROTOCOL_KEYBOARD)
+            itf->layout = usb_hid_boot_keyboard;
+        else if (protocol == HID_ITF_PROTOCOL_MOUSE)
+            itf->layout = usb_hid_boot_mouse;
+        else
+            return;
 
         if (tuh_hid_get_protocol(dev_addr, idx) != HID_PROTOCOL_BOOT)
             tuh_hid_set_protocol(dev_addr, idx, HID_PROTOCOL_BOOT);
-
-        tuh_hid_receive_report(dev_addr, idx);
     }
+    else if (tuh_hid_get_protocol(dev_addr, idx) != HID_PROTOCOL_REPORT)
+        tuh_hid_set_protocol(dev_addr, idx, HID_PROTOCOL_REPORT);
+
+    itf->dev_addr = dev_addr;
+    itf->idx = idx;
+    memset(&itf->kbd_state, 0, sizeof(itf->kbd_state));
+    itf->mouse_buttons = 0;
+    itf->joystick = 0;
+    itf->mounted = true;
+
+    // Start receiving reports
+    tuh_hid_receive_report(dev_addr, idx);
 }
 
 void tuh_hid_umount_cb(uint8_t dev_addr, uint8_t idx)
 {
-    if (dev_addr == usb_dev_addr && idx == usb_hid_idx)
-    {
-        usb_keyboard_mounted = false;
-        usb_dev_addr = 0;
-        usb_hid_idx = 0;
-        memset(&usb_kbd_state, 0, sizeof(usb_kbd_state));
+    usb_hid_itf_t *itf = usb_hid_itf_find(dev_addr, idx);
 
-        if (usb_kbd_event_cb)
-            usb_kbd_event_cb();
-    }
-    else if (dev_addr == usb_mouse_dev_addr && idx == usb_mouse_hid_idx)
+    if (!itf)
+        return;
+
+    // Only what this interface held is released, other devices carry on
+    itf->mounted = false;
+    memset(&itf->kbd_state, 0, sizeof(itf->kbd_state));
+    itf->mouse_buttons = 0;
+    itf->joystick = 0;
+
+    if (usb_hid_is_gamepad(&itf->layout) && usb_kbd_event_cb)
+        usb_kbd_event_cb(time_us_32());
+
+    if (usb_hid_is_mouse(&itf->layout))
     {
-        usb_mouse_mounted = false;
-        usb_mouse_dev_addr = 0;
-        usb_mouse_hid_idx = 0;
-        memset(&usb_mouse_state, 0, sizeof(usb_mouse_state));
-        usb_mouse_state.buttons = 0xFF; // all buttons released (active-low)
-
-        if (usb_kbd_event_cb)
-            usb_kbd_event_cb();
+        bool other_mouse = false;
+
+        for (int i = 0; i < CFG_TUH_HID; i++)
+            if (usb_hid_itfs[i].mounted && usb_hid_is_mouse(&usb_hid_itfs[i].layout))
+                other_mouse = true;
+
+        if (!other_mouse)
+        {
+            usb_mouse_state.x = 0;
+            usb_mouse_state.y = 0;
+            usb_mouse_state.has_wheel = false;
+            usb_mouse_state.wheel = 0;
+            usb_mouse_frac_x = USB_MOUSE_FRAC_HALF;
+            usb_mouse_frac_y = USB_MOUSE_FRAC_HALF;
+        }
+
+        usb_mouse_update(time_us_32());
     }
+
+    if (usb_hid_is_keyboard(&itf->layout))
+        usb_kbd_update(time_us_32());
 }
 
 void tuh_hid_report_received_cb(uint8_t dev_addr, uint8_t idx,
                                 uint8_t const *report, uint16_t len)
 {
-    if (dev_addr == usb_dev_addr && idx == usb_hid_idx)
-        process_kbd_report(report, len);
-    else if (dev_addr == usb_mouse_dev_addr && idx == usb_mouse_hid_idx)
-        process_mouse_report(report, len);
+    usb_hid_itf_t *itf = usb_hid_itf_find(dev_addr, idx);
+    uint8_t report_id = 0;
+
+    if (itf && itf->layout.report_ids && len)
+    {
+        report_id = report[0];
+        report++;
+        len--;
+    }
+
+    if (itf)
+    {
+        process_kbd_report(itf, report_id, report, len);
+        process_mouse_report(itf, report_id, report, len);
+        process_gamepad_report(itf, report_id, report, len);
+    }
 
     // Continue receiving
     tuh_hid_receive_report(dev_addr, idx);
@@ -361,15 +588,14 @@ void tuh_hid_report_received_cb(uint8_t dev_addr, uint8_t idx,
 
 void usb_kbd_init(void)
 {
+    memset(usb_hid_itfs, 0, sizeof(usb_hid_itfs));
     memset(&usb_kbd_state, 0, sizeof(usb_kbd_state));
     memset(&usb_mouse_state, 0, sizeof(usb_mouse_state));
     usb_mouse_state.buttons = 0xFF; // all buttons released (active-low)
-    usb_keyboard_mounted = false;
-    usb_dev_addr = 0;
-    usb_hid_idx = 0;
-    usb_mouse_mounted = false;
-    usb_mouse_dev_addr = 0;
-    usb_mouse_hid_idx = 0;
+
+    // Boot interfaces are switched to boot protocol while enumerating by default,
+    // the report descriptor describes report protocol
+    tuh_hid_set_default_protocol(HID_PROTOCOL_REPORT);
 }
 
 void usb_kbd_task(void)
@@ -392,4 +618,20 @@ usb_mouse_state_t *usb_mouse_get_state(void)
     return &usb_mouse_state;
 }
 
+void usb_mouse_set_profile(uint8_t profile)
+{
+    usb_mouse_profile = &usb_mouse_profiles[profile < MOUSE_PROFILES ? profile : MOUSE_1_1];
+    usb_mouse_frac_x = USB_MOUSE_FRAC_HALF;
+    usb_mouse_frac_y = USB_MOUSE_FRAC_HALF;
+}
+
+uint8_t usb_joystick_get_state(uint8_t player)
+{ // players are the gamepads in interface table order
+    for (int i = 0; i < CFG_TUH_HID; i++)
+        if (usb_hid_itfs[i].mounted && usb_hid_is_gamepad(&usb_hid_itfs[i].layout) && player-- == 0)
+            return usb_hid_itfs[i].joystick;
+
+    return 0;
+}
+
 #endif // USB_KBD_ENABLE
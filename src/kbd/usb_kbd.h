@@ -6,7 +6,7 @@
 
 #include "key_codes.h"
 
-typedef void (*usb_kbd_event_fn)(void);
+typedef void (*usb_kbd_event_fn)(uint32_t time_us); // time_us: when the transfer completed
 
 typedef struct
 {
@@ -14,12 +14,14 @@ typedef struct
                      // bits 4-7: wheel position (4-bit) or 0xF if no wheel
     uint8_t x;       // accumulated X position (wraps 0-255)
     uint8_t y;       // accumulated Y position (wraps 0-255)
-    // bool has_wheel;  // true if mouse reported wheel data
-    // uint8_t wheel;   // accumulated wheel position (4-bit, wraps 0-15)
+    bool has_wheel;  // true if mouse reported wheel data
+    uint8_t wheel;   // accumulated wheel position (4-bit, wraps 0-15)
 } usb_mouse_state_t;
 
 void usb_kbd_init(void);
-void usb_kbd_task(void);
+void usb_kbd_task(void); // tuh_task(), core 1 runs it whenever an interrupt wakes it up
 void usb_kbd_set_event_callback(usb_kbd_event_fn cb);
 kbd_state_t *usb_kbd_get_state(void);
 usb_mouse_state_t *usb_mouse_get_state(void);
+void usb_mouse_set_profile(uint8_t profile); // mouse_profile_t: speed and acceleration of X/Y moves
+uint8_t usb_joystick_get_state(uint8_t player); // ZX_JOY bits of the gamepad of a player, 0 if none
@@ -12,25 +12,14 @@
  * Row 7: SPACE(0), SYM_SHIFT(1), M(2), N(3), B(4)
  */
 
-#include "g_config.h"
-#include "zx_kbd.h"
-
-// Pack row (0-7) and column bitmask into one byte: bits 7..5 = row, bits 4..0 = bitmask
-
-#define ZX(row, col) (((row) << 5) | (1 << (col)))
-#define ZX_NONE 0
+#include <string.h>
 
-#define ZX_CS ZX(0, 0) // CAPS SHIFT
-#define ZX_SS ZX(7, 1) // SYMBOL SHIFT
+#include "hardware/sync.h"
 
-// Mapping table: universal key code → ZX matrix position(s)
+#include "g_config.h"
+#include "zx_kbd.h"
 
-typedef struct
-{
-    uint8_t key_code;
-    uint8_t zx1; // First ZX key (or modifier)
-    uint8_t zx2; // Second ZX key (ZX_NONE if single)
-} zx_key_map_t;
+// Built-in mapping table: universal key code → ZX matrix position(s)
 
 static const zx_key_map_t zx_key_map[] = {
     // Letters
@@ -130,42 +119,63 @@ static const zx_key_map_t zx_key_map[] = {
 
 #define ZX_KEY_MAP_SIZE (count_of(zx_key_map))
 
-// Fast lookup: key_code → index into zx_key_map (+1), 0 = unmapped
+// Fast lookup: key_code → ZX keys, built from zx_key_map and the keys of the selected user layout.
+// Two tables: a new layout is built in the one not published, then published by swapping the pointer.
+// zx_kbd_set_state() counts itself in zx_key_lut_readers while it uses a table, so the table that was
+// published before is only rebuilt once no reader can still hold it.
 
 #define ZX_LUT_SIZE 106
 
-static uint8_t zx_key_lut[ZX_LUT_SIZE];
-static bool zx_lut_ready = false;
-
-static void zx_build_lut(void)
+typedef struct
 {
-    for (int i = 0; i < ZX_LUT_SIZE; i++)
-        zx_key_lut[i] = 0;
+    uint8_t zx1;
+    uint8_t zx2;
+} zx_keys_t;
+
+static zx_keys_t zx_key_luts[2][ZX_LUT_SIZE];
+static const zx_keys_t *volatile zx_key_lut = zx_key_luts[0]; // all ZX_NONE until kbd_init()
+static volatile uint8_t zx_key_lut_readers;
 
-    for (int i = 0; i < (int)ZX_KEY_MAP_SIZE; i++)
+static void zx_lut_set(zx_keys_t *lut, const zx_key_map_t *keys, uint8_t count)
+{
+    for (int i = 0; i < count; i++)
     {
-        uint8_t kc = zx_key_map[i].key_code;
+        uint8_t kc = keys[i].key_code;
 
         if (kc < ZX_LUT_SIZE)
-            zx_key_lut[kc] = i + 1; // +1 so 0 means "not mapped"
+        {
+            lut[kc].zx1 = keys[i].zx1;
+            lut[kc].zx2 = keys[i].zx2;
+        }
     }
-
-    zx_lut_ready = true;
 }
 
-static inline void apply_zx_entry(zx_kbd_state_t *zx, const zx_key_map_t *e)
+void zx_kbd_set_keymap(const zx_key_map_t *keys, uint8_t count)
 {
-    // Decode packed position: bits 7..5 = row, bits 4..0 = bitmask
-    zx->a[e->zx1 >> 5] |= (e->zx1 & 0x1F);
+    zx_keys_t *lut = zx_key_lut == zx_key_luts[0] ? zx_key_luts[1] : zx_key_luts[0];
+
+    // a reader that started before the last swap may still use this table
+    while (zx_key_lut_readers)
+        tight_loop_contents();
+
+    __dmb();
+    memset(lut, 0, sizeof(zx_key_luts[0])); // ZX_NONE
+
+    zx_lut_set(lut, zx_key_map, ZX_KEY_MAP_SIZE);
 
-    if (e->zx2 != ZX_NONE)
-        zx->a[e->zx2 >> 5] |= (e->zx2 & 0x1F);
+    if (keys)
+        zx_lut_set(lut, keys, count);
+
+    __dmb(); // table /then/ pointer
+    zx_key_lut = lut;
 }
 
 void __not_in_flash_func(zx_kbd_set_state)(zx_kbd_state_t *zx_keys_matrix, kbd_state_t *kb_state)
 {
-    if (!zx_lut_ready)
-        zx_build_lut();
+    zx_key_lut_readers++;
+    __dmb(); // count /then/ pointer
+
+    const zx_keys_t *lut = zx_key_lut;
 
     // Clear output matrix
     zx_keys_matrix->u[0] = 0;
@@ -189,17 +199,51 @@ void __not_in_flash_func(zx_kbd_set_state)(zx_kbd_state_t *zx_keys_matrix, kbd_s
             int bit = __builtin_ctz(mask);
             int key_code = base + bit;
 
-            // Look up in LUT
+            // Look up in LUT, unmapped keys are ZX_NONE: row 0, no bits
             if (key_code < ZX_LUT_SIZE)
             {
-                uint8_t idx = zx_key_lut[key_code];
+                zx_keys_t keys = lut[key_code];
 
-                if (idx)
-                    apply_zx_entry(zx_keys_matrix, &zx_key_map[idx - 1]);
+                zx_keys_matrix->a[keys.zx1 >> 5] |= keys.zx1 & 0x1F;
+                zx_keys_matrix->a[keys.zx2 >> 5] |= keys.zx2 & 0x1F;
             }
 
             // Clear lowest set bit
             mask &= mask - 1;
         }
     }
+
+    __dmb(); // table /then/ count
+    zx_key_lut_readers--;
+}
+
+#ifdef USB_KBD_ENABLE
+// Joystick profile → ZX keys per player, in ZX_JOY bit order: right, left, down, up, fire
+static const uint8_t zx_joystick_map[JOYSTICK_PROFILES][ZX_JOY_PLAYERS][5] = {
+    [JOYSTICK_SINCLAIR] = {
+        {ZX(4, 3), ZX(4, 4), ZX(4, 2), ZX(4, 1), ZX(4, 0)}, // Sinclair 1: 7 6 8 9, 0
+        {ZX(3, 1), ZX(3, 0), ZX(3, 2), ZX(3, 3), ZX(3, 4)}, // Sinclair 2: 2 1 3 4, 5
+    },
+    [JOYSTICK_CURSOR] = {
+        {ZX(4, 2), ZX(3, 4), ZX(4, 4), ZX(4, 3), ZX(4, 0)}, // 8 5 6 7, 0
+        {ZX(4, 2), ZX(3, 4), ZX(4, 4), ZX(4, 3), ZX(4, 0)},
+    },
+    [JOYSTICK_QAOP] = {
+        {ZX(5, 0), ZX(5, 1), ZX(1, 0), ZX(2, 0), ZX(7, 0)}, // P O A Q, SPACE
+        {ZX(5, 0), ZX(5, 1), ZX(1, 0), ZX(2, 0), ZX(7, 0)},
+    },
+};
+
+void __not_in_flash_func(zx_kbd_set_joystick)(zx_kbd_state_t *zx_keys_matrix, uint8_t profile, uint8_t player,
+                                              uint8_t joystick)
+{
+    if (profile >= JOYSTICK_PROFILES || player >= ZX_JOY_PLAYERS)
+        return;
+
+    const uint8_t *keys = zx_joystick_map[profile][player];
+
+    for (int i = 0; i < 5; i++)
+        if ((joystick & (1 << i)) && keys[i] != ZX_NONE)
+            zx_keys_matrix->a[keys[i] >> 5] |= keys[i] & 0x1F;
 }
+#endif
@@ -17,4 +17,36 @@ typedef struct
     };
 } zx_kbd_state_t;
 
+// Pack row (0-7) and column bitmask into one byte: bits 7..5 = row, bits 4..0 = bitmask
+#define ZX(row, col) (((row) << 5) | (1 << (col)))
+#define ZX_NONE 0
+
+#define ZX_CS ZX(0, 0) // CAPS SHIFT
+#define ZX_SS ZX(7, 1) // SYMBOL SHIFT
+
+// Universal key code → ZX matrix position(s)
+typedef struct
+{
+    uint8_t key_code;
+    uint8_t zx1; // First ZX key (or modifier)
+    uint8_t zx2; // Second ZX key (ZX_NONE if single)
+} zx_key_map_t;
+
 void __not_in_flash_func(zx_kbd_set_state)(zx_kbd_state_t *zx_keys_matrix, kbd_state_t *kb_state);
+
+// Rebuilds the key lookup table: the built-in mapping, then keys (a user layout, may be NULL) on top of it
+void zx_kbd_set_keymap(const zx_key_map_t *keys, uint8_t count);
+
+// Joystick directions and fire, Kempston bit order
+#define ZX_JOY_RIGHT 0x01
+#define ZX_JOY_LEFT 0x02
+#define ZX_JOY_DOWN 0x04
+#define ZX_JOY_UP 0x08
+#define ZX_JOY_FIRE 0x10
+#define ZX_JOY_PLAYERS 2
+
+#ifdef USB_KBD_ENABLE
+// Adds the keys a joystick profile (joystick_profile_t) assigns to the joystick of a player
+void __not_in_flash_func(zx_kbd_set_joystick)(zx_kbd_state_t *zx_keys_matrix, uint8_t profile, uint8_t player,
+                                              uint8_t joystick);
+#endif
@@ -0,0 +1,218 @@
+/**
+ * zx_keymap.c - User key layouts
+ *
+ * The layouts live in the flash sector below the settings and are copied
+ * to RAM at startup; edits apply to the RAM copy and are written back by
+ * zx_keymap_save(). Selecting a layout rebuilds the zx_kbd lookup table,
+ * so the key path stays a single table lookup per pressed key.
+ */
+
+#include <string.h>
+#include <strings.h>
+
+#include "hardware/flash.h"
+
+#include "g_config.h"
+#include "settings.h"
+#include "zx_keymap.h"
+
+#ifdef KBD_ENABLE
+
+#define ZX_KEYMAP_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - 2 * FLASH_SECTOR_SIZE) // below the settings
+#define ZX_KEYMAP_MAGIC 0x3150414D // "MAP1"
+
+typedef union
+{
+    struct
+    {
+        uint32_t magic;
+        zx_keymap_t keymaps[KEYMAP_USER_MAX];
+    };
+    uint8_t pages[2 * FLASH_PAGE_SIZE]; // written as whole flash pages
+} zx_keymap_flash_t;
+
+static_assert(sizeof(zx_keymap_flash_t) == 2 * FLASH_PAGE_SIZE, "user layouts do not fit in 2 flash pages");
+
+static zx_keymap_flash_t zx_keymaps;
+static uint8_t zx_keymap_current = 0;
+
+// Presets: PC arrows as the joystick keys most games accept, right Alt as fire
+static const zx_keymap_t zx_keymap_presets[KEYMAP_USER_MAX] = {
+    {5, {{KEY_UP, ZX(4, 1), ZX_NONE}, {KEY_DOWN, ZX(4, 2), ZX_NONE}, {KEY_LEFT, ZX(4, 4), ZX_NONE}, {KEY_RIGHT, ZX(4, 3), ZX_NONE}, {KEY_R_ALT, ZX(4, 0), ZX_NONE}}}, // Sinclair 1: 9 8 6 7, 0
+    {5, {{KEY_UP, ZX(4, 3), ZX_NONE}, {KEY_DOWN, ZX(4, 4), ZX_NONE}, {KEY_LEFT, ZX(3, 4), ZX_NONE}, {KEY_RIGHT, ZX(4, 2), ZX_NONE}, {KEY_R_ALT, ZX(4, 0), ZX_NONE}}}, // Cursor: 7 6 5 8, 0
+    {5, {{KEY_UP, ZX(2, 0), ZX_NONE}, {KEY_DOWN, ZX(1, 0), ZX_NONE}, {KEY_LEFT, ZX(5, 1), ZX_NONE}, {KEY_RIGHT, ZX(5, 0), ZX_NONE}, {KEY_R_ALT, ZX(7, 0), ZX_NONE}}}, // Q A O P, SPACE
+    {0},
+};
+
+static const char *const zx_key_names[8][5] = {
+    {"CS", "Z", "X", "C", "V"},
+    {"A", "S", "D", "F", "G"},
+    {"Q", "W", "E", "R", "T"},
+    {"1", "2", "3", "4", "5"},
+    {"0", "9", "8", "7", "6"},
+    {"P", "O", "I", "U", "Y"},
+    {"ENTER", "L", "K", "J", "H"},
+    {"SPACE", "SS", "M", "N", "B"},
+};
+
+// ZX_NONE or one matrix key: any row, exactly one column bit
+static bool zx_keymap_valid_key(uint8_t zx)
+{
+    uint8_t cols = zx & 0x1F;
+
+    return zx == ZX_NONE || (cols && !(cols & (cols - 1)));
+}
+
+static bool zx_keymap_valid(const zx_keymap_t *keymap)
+{
+    if (keymap->count > ZX_KEYMAP_KEYS)
+        return false;
+
+    for (int i = 0; i < keymap->count; i++)
+    {
+        const zx_key_map_t *key = &keymap->keys[i];
+
+        if (key->key_code == NO_KEY || key->key_code > KEY_F12)
+            return false;
+
+        if (!zx_keymap_valid_key(key->zx1) || !zx_keymap_valid_key(key->zx2))
+            return false;
+
+        if (key->zx1 == ZX_NONE && key->zx2 != ZX_NONE)
+            return false;
+    }
+
+    return true;
+}
+
+static zx_keymap_t *zx_keymap_user(uint8_t keymap)
+{
+    return keymap >= 1 && keymap <= KEYMAP_USER_MAX ? &zx_keymaps.keymaps[keymap - 1] : NULL;
+}
+
+static void zx_keymap_apply_if_selected(uint8_t keymap)
+{
+    if (keymap == zx_keymap_current)
+        zx_keymap_select(keymap);
+}
+
+void zx_keymap_init(uint8_t keymap)
+{
+    const zx_keymap_flash_t *saved = (const zx_keymap_flash_t *)(XIP_BASE + ZX_KEYMAP_FLASH_OFFSET);
+
+    memcpy(&zx_keymaps, saved, sizeof(zx_keymaps));
+
+    for (int i = 0; i < KEYMAP_USER_MAX; i++)
+        if (zx_keymaps.magic != ZX_KEYMAP_MAGIC || !zx_keymap_valid(&zx_keymaps.keymaps[i]))
+            zx_keymaps.keymaps[i] = zx_keymap_presets[i];
+
+    zx_keymaps.magic = ZX_KEYMAP_MAGIC;
+
+    zx_keymap_select(keymap);
+}
+
+void zx_keymap_select(uint8_t keymap)
+{
+    const zx_keymap_t *user = zx_keymap_user(keymap);
+
+    zx_keymap_current = user ? keymap : 0;
+
+    if (user)
+        zx_kbd_set_keymap(user->keys, user->count);
+    else
+        zx_kbd_set_keymap(NULL, 0);
+}
+
+uint8_t zx_keymap_selected(void)
+{
+    return zx_keymap_current;
+}
+
+const zx_keymap_t *zx_keymap_get(uint8_t keymap)
+{
+    return zx_keymap_user(keymap);
+}
+
+bool zx_keymap_set_key(uint8_t keymap, uint8_t key_code, uint8_t zx1, uint8_t zx2)
+{
+    zx_keymap_t *user = zx_keymap_user(keymap);
+    int i;
+
+    if (!user || key_code == NO_KEY || key_code > KEY_F12)
+        return false;
+
+    for (i = 0; i < user->count; i++)
+        if (user->keys[i].key_code == key_code)
+            break;
+
+    if (i == ZX_KEYMAP_KEYS)
+        return false;
+
+    if (i == user->count)
+        user->count++;
+
+    user->keys[i].key_code = key_code;
+    user->keys[i].zx1 = zx1;
+    user->keys[i].zx2 = zx1 != ZX_NONE ? zx2 : ZX_NONE;
+
+    zx_keymap_apply_if_selected(keymap);
+
+    return true;
+}
+
+void zx_keymap_clear_key(uint8_t keymap, uint8_t key_code)
+{
+    zx_keymap_t *user = zx_keymap_user(keymap);
+
+    if (!user)
+        return;
+
+    for (int i = 0; i < user->count; i++)
+    {
+        if (user->keys[i].key_code != key_code)
+            continue;
+
+        user->count--;
+        memmove(&user->keys[i], &user->keys[i + 1], (user->count - i) * sizeof(user->keys[0]));
+        break;
+    }
+
+    zx_keymap_apply_if_selected(keymap);
+}
+
+void zx_keymap_reset(uint8_t keymap)
+{
+    zx_keymap_t *user = zx_keymap_user(keymap);
+
+    if (!user)
+        return;
+
+    *user = zx_keymap_presets[keymap - 1];
+
+    zx_keymap_apply_if_selected(keymap);
+}
+
+void zx_keymap_save(void)
+{
+    write_flash_sector(ZX_KEYMAP_FLASH_OFFSET, &zx_keymaps, sizeof(zx_keymaps));
+}
+
+const char *zx_keymap_key_name(uint8_t zx)
+{
+    if (zx == ZX_NONE)
+        return "-";
+
+    return zx_key_names[zx >> 5][__builtin_ctz(zx & 0x1F)];
+}
+
+uint8_t zx_keymap_parse_key(const char *name)
+{
+    for (int row = 0; row < 8; row++)
+        for (int col = 0; col < 5; col++)
+            if (!strcasecmp(name, zx_key_names[row][col]))
+                return ZX(row, col);
+
+    return ZX_NONE;
+}
+
+#endif // KBD_ENABLE
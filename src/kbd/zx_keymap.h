@@ -0,0 +1,50 @@
+/**
+ * zx_keymap.h - User key layouts
+ *
+ * Up to KEYMAP_USER_MAX layouts, each a short list of keys mapped
+ * differently from the built-in table, kept in flash and compiled
+ * into the zx_kbd lookup table when selected.
+ */
+
+#pragma once
+
+#include "g_config.h"
+
+#ifdef KBD_ENABLE
+
+#include "zx_kbd.h"
+
+#define ZX_KEYMAP_KEYS 32 // keys a user layout can change
+
+typedef struct
+{
+    uint8_t count;
+    zx_key_map_t keys[ZX_KEYMAP_KEYS];
+} zx_keymap_t;
+
+// Loads the user layouts from flash (presets if there are none) and selects a layout
+void zx_keymap_init(uint8_t keymap);
+
+// 0: built-in layout, 1 - KEYMAP_USER_MAX: user layout
+void zx_keymap_select(uint8_t keymap);
+uint8_t zx_keymap_selected(void);
+
+// User layout 1 - KEYMAP_USER_MAX, NULL for others
+const zx_keymap_t *zx_keymap_get(uint8_t keymap);
+
+// Maps a key of a user layout, zx1 = ZX_NONE: the key does nothing. Returns false if the layout is full
+bool zx_keymap_set_key(uint8_t keymap, uint8_t key_code, uint8_t zx1, uint8_t zx2);
+
+// Returns the key to the built-in mapping
+void zx_keymap_clear_key(uint8_t keymap, uint8_t key_code);
+
+// Restores the preset of a user layout
+void zx_keymap_reset(uint8_t keymap);
+
+void zx_keymap_save(void);
+
+// ZX key names as on the keyboard, CS and SS for the shifts
+const char *zx_keymap_key_name(uint8_t zx);
+uint8_t zx_keymap_parse_key(const char *name); // ZX_NONE if unknown
+
+#endif // KBD_ENABLE
\ No newline at end of file
@@ -0,0 +1,596 @@
+/**
+ * zx_paste.c - Typed text for the ZX Spectrum keyboard matrix
+ *
+ * Core 0 turns text into chords in a single producer / single consumer queue,
+ * a line at a time: the line is only published when all of it fits.
+ * A hardware alarm on core 1 plays them back: shift down, shift + key held,
+ * key up, shift up, pause. The ROM reads the keyboard once per frame
+ * interrupt and the CH446Q switches change one at a time, so the shift is
+ * held alone for a whole read before and after its key.
+ *
+ * 48K BASIC listings are typed the way the Spectrum expects them: a keyword
+ * is one key in the cursor mode it needs (K: statements, L: SYMBOL SHIFT
+ * keywords, E: functions), everything else letter by letter.
+ */
+
+#include <ctype.h>
+#include <string.h>
+
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+#include "g_config.h"
+#include "zx_paste.h"
+
+#ifdef OSD_ENABLE
+#include "osd_kbd.h"
+#else
+#define osd_kbd_active false
+#endif
+
+#ifdef KBD_PASTE_ENABLE
+
+#define ZX_ENTER ZX(6, 0)
+
+zx_paste_timing_t zx_paste_timing = {
+    .hold_ms = 2 * ZX_PASTE_SCAN_MS,
+    .release_ms = 2 * ZX_PASTE_SCAN_MS,
+    .repeat_ms = 6 * ZX_PASTE_SCAN_MS,
+    .enter_ms = 15 * ZX_PASTE_SCAN_MS,
+};
+
+// Queue
+
+#define ZX_PASTE_CHORD_ENTER 0x01 // the ROM takes the line in, longer pause
+
+typedef struct
+{
+    uint8_t shift; // ZX_CS, ZX_SS or ZX_NONE, pressed first
+    uint8_t key;
+    uint8_t flags;
+} zx_paste_chord_t;
+
+static zx_paste_chord_t zx_paste_queue[ZX_PASTE_QUEUE_SIZE];
+static volatile uint32_t zx_paste_head;  // chords queued, written by core 0
+static volatile uint32_t zx_paste_tail;  // chords typed, written by core 1
+static uint32_t zx_paste_next;           // core 0: the next chord of the line being converted
+static bool zx_paste_full;               // core 0: the line being converted does not fit
+static volatile bool zx_paste_running;   // the alarm is set
+static volatile bool zx_paste_cancelled; // core 0 asks core 1 to empty the queue
+
+static int zx_paste_alarm_num = -1;
+static zx_paste_event_fn zx_paste_event_cb = NULL;
+
+// Text to chords (core 0)
+
+// ZX keys by column, 0: keys with no character
+static const char zx_paste_rows[8][6] = {
+    "\0ZXCV", "ASDFG", "QWERT", "12345", "09876", "POIUY", "\0LKJH", " \0MNB",
+};
+
+// Keyword kinds: the cursor mode and shift the keyword needs
+#define ZX_KW_K 0x00        // K mode key: statements
+#define ZX_KW_SS 0x01       // SYMBOL SHIFT + key
+#define ZX_KW_E 0x02        // E mode (CAPS + SYMBOL SHIFT first) + key
+#define ZX_KW_E_SS 0x03     // E mode + SYMBOL SHIFT + key
+#define ZX_KW_KIND 0x03
+#define ZX_KW_STATEMENT 0x10 // E mode and SYMBOL SHIFT keywords valid at the start of a statement
+#define ZX_KW_THEN 0x20      // a statement follows: K mode
+#define ZX_KW_REM 0x40       // the rest of the line is typed as it is
+
+typedef struct
+{
+    const char *name; // spaces match any number of spaces, "GO TO" matches "GOTO"
+    char key;
+    uint8_t flags;
+} zx_paste_keyword_t;
+
+static const zx_paste_keyword_t zx_paste_keywords[] = {
+    // K mode
+    {"PLOT", 'Q', ZX_KW_K},
+    {"DRAW", 'W', ZX_KW_K},
+    {"REM", 'E', ZX_KW_K | ZX_KW_REM},
+    {"RUN", 'R', ZX_KW_K},
+    {"RANDOMIZE", 'T', ZX_KW_K},
+    {"RETURN", 'Y', ZX_KW_K},
+    {"IF", 'U', ZX_KW_K},
+    {"INPUT", 'I', ZX_KW_K},
+    {"POKE", 'O', ZX_KW_K},
+    {"PRINT", 'P', ZX_KW_K},
+    {"NEW", 'A', ZX_KW_K},
+    {"SAVE", 'S', ZX_KW_K},
+    {"DIM", 'D', ZX_KW_K},
+    {"FOR", 'F', ZX_KW_K},
+    {"GO TO", 'G', ZX_KW_K},
+    {"GO SUB", 'H', ZX_KW_K},
+    {"LOAD", 'J', ZX_KW_K},
+    {"LIST", 'K', ZX_KW_K},
+    {"LET", 'L', ZX_KW_K},
+    {"COPY", 'Z', ZX_KW_K},
+    {"CLEAR", 'X', ZX_KW_K},
+    {"CONTINUE", 'C', ZX_KW_K},
+    {"CLS", 'V', ZX_KW_K},
+    {"BORDER", 'B', ZX_KW_K},
+    {"NEXT", 'N', ZX_KW_K},
+    {"PAUSE", 'M', ZX_KW_K},
+
+    // SYMBOL SHIFT
+    {"STOP", 'A', ZX_KW_SS | ZX_KW_STATEMENT},
+    {"NOT", 'S', ZX_KW_SS},
+    {"STEP", 'D', ZX_KW_SS},
+    {"TO", 'F', ZX_KW_SS},
+    {"THEN", 'G', ZX_KW_SS | ZX_KW_THEN},
+    {"AND", 'Y', ZX_KW_SS},
+    {"OR", 'U', ZX_KW_SS},
+    {"AT", 'I', ZX_KW_SS},
+    {"<=", 'Q', ZX_KW_SS},
+    {"<>", 'W', ZX_KW_SS},
+    {">=", 'E', ZX_KW_SS},
+
+    // E mode
+    {"SIN", 'Q', ZX_KW_E},
+    {"COS", 'W', ZX_KW_E},
+    {"TAN", 'E', ZX_KW_E},
+    {"INT", 'R', ZX_KW_E},
+    {"RND", 'T', ZX_KW_E},
+    {"STR$", 'Y', ZX_KW_E},
+    {"CHR$", 'U', ZX_KW_E},
+    {"CODE", 'I', ZX_KW_E},
+    {"PEEK", 'O', ZX_KW_E},
+    {"TAB", 'P', ZX_KW_E},
+    {"READ", 'A', ZX_KW_E | ZX_KW_STATEMENT},
+    {"RESTORE", 'S', ZX_KW_E | ZX_KW_STATEMENT},
+    {"DATA", 'D', ZX_KW_E | ZX_KW_STATEMENT},
+    {"SGN", 'F', ZX_KW_E},
+    {"ABS", 'G', ZX_KW_E},
+    {"SQR", 'H', ZX_KW_E},
+    {"VAL", 'J', ZX_KW_E},
+    {"LEN", 'K', ZX_KW_E},
+    {"USR", 'L', ZX_KW_E},
+    {"LN", 'Z', ZX_KW_E},
+    {"EXP", 'X', ZX_KW_E},
+    {"LPRINT", 'C', ZX_KW_E | ZX_KW_STATEMENT},
+    {"LLIST", 'V', ZX_KW_E | ZX_KW_STATEMENT},
+    {"BIN", 'B', ZX_KW_E},
+    {"INKEY$", 'N', ZX_KW_E},
+    {"PI", 'M', ZX_KW_E},
+
+    // E mode + SYMBOL SHIFT
+    {"DEF FN", '1', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"FN", '2', ZX_KW_E_SS},
+    {"LINE", '3', ZX_KW_E_SS},
+    {"OPEN #", '4', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"CLOSE #", '5', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"MOVE", '6', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"ERASE", '7', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"POINT", '8', ZX_KW_E_SS},
+    {"CAT", '9', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"FORMAT", '0', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"ASN", 'Q', ZX_KW_E_SS},
+    {"ACS", 'W', ZX_KW_E_SS},
+    {"ATN", 'E', ZX_KW_E_SS},
+    {"VERIFY", 'R', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"MERGE", 'T', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"IN", 'I', ZX_KW_E_SS},
+    {"OUT", 'O', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"CIRCLE", 'H', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"VAL$", 'J', ZX_KW_E_SS},
+    {"SCREEN$", 'K', ZX_KW_E_SS},
+    {"ATTR", 'L', ZX_KW_E_SS},
+    {"BEEP", 'Z', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"INK", 'X', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"PAPER", 'C', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"FLASH", 'V', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"BRIGHT", 'B', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"OVER", 'N', ZX_KW_E_SS | ZX_KW_STATEMENT},
+    {"INVERSE", 'M', ZX_KW_E_SS | ZX_KW_STATEMENT},
+};
+
+// Characters typed with SYMBOL SHIFT (ZX_KW_SS) or in E mode (ZX_KW_E_SS), ` is the pound sign
+static const zx_paste_keyword_t zx_paste_symbols[] = {
+    {"!", '1', ZX_KW_SS},
+    {"@", '2', ZX_KW_SS},
+    {"#", '3', ZX_KW_SS},
+    {"$", '4', ZX_KW_SS},
+    {"%", '5', ZX_KW_SS},
+    {"&", '6', ZX_KW_SS},
+    {"'", '7', ZX_KW_SS},
+    {"(", '8', ZX_KW_SS},
+    {")", '9', ZX_KW_SS},
+    {"_", '0', ZX_KW_SS},
+    {"<", 'R', ZX_KW_SS},
+    {">", 'T', ZX_KW_SS},
+    {";", 'O', ZX_KW_SS},
+    {"\"", 'P', ZX_KW_SS},
+    {"^", 'H', ZX_KW_SS},
+    {"-", 'J', ZX_KW_SS},
+    {"+", 'K', ZX_KW_SS},
+    {"=", 'L', ZX_KW_SS},
+    {":", 'Z', ZX_KW_SS},
+    {"`", 'X', ZX_KW_SS},
+    {"?", 'C', ZX_KW_SS},
+    {"/", 'V', ZX_KW_SS},
+    {"*", 'B', ZX_KW_SS},
+    {",", 'N', ZX_KW_SS},
+    {".", 'M', ZX_KW_SS},
+    {"[", 'Y', ZX_KW_E_SS},
+    {"]", 'U', ZX_KW_E_SS},
+    {"~", 'A', ZX_KW_E_SS},
+    {"|", 'S', ZX_KW_E_SS},
+    {"\\", 'D', ZX_KW_E_SS},
+    {"{", 'F', ZX_KW_E_SS},
+    {"}", 'G', ZX_KW_E_SS},
+};
+
+static uint8_t zx_paste_key(char c)
+{
+    if (!c)
+        return ZX_NONE;
+
+    for (int row = 0; row < 8; row++)
+    {
+        const char *col = memchr(zx_paste_rows[row], c, 5);
+
+        if (col)
+            return ZX(row, col - zx_paste_rows[row]);
+    }
+
+    return ZX_NONE;
+}
+
+static void zx_paste_kick(void)
+{
+    __dmb(); // queue /then/ running
+
+    if (zx_paste_running || zx_paste_alarm_num < 0)
+        return;
+
+    zx_paste_running = true;
+
+    if (hardware_alarm_set_target(zx_paste_alarm_num, make_timeout_time_us(1000)))
+        hardware_alarm_force_irq(zx_paste_alarm_num);
+}
+
+// Chords past zx_paste_head are not read by core 1 until zx_paste_line() publishes them
+static void zx_paste_push(uint8_t shift, uint8_t key, uint8_t flags)
+{
+    if (zx_paste_next - zx_paste_tail >= ZX_PASTE_QUEUE_SIZE)
+    {
+        zx_paste_full = true;
+        return;
+    }
+
+    zx_paste_chord_t *chord = &zx_paste_queue[zx_paste_next & (ZX_PASTE_QUEUE_SIZE - 1)];
+
+    chord->shift = shift;
+    chord->key = key;
+    chord->flags = flags;
+
+    zx_paste_next++;
+}
+
+static void zx_paste_type(const zx_paste_keyword_t *keyword)
+{
+    uint8_t kind = keyword->flags & ZX_KW_KIND;
+
+    if (kind & ZX_KW_E)
+        zx_paste_push(ZX_CS, ZX_SS, 0);
+
+    zx_paste_push((kind & ZX_KW_SS) ? ZX_SS : ZX_NONE, zx_paste_key(keyword->key), 0);
+}
+
+static bool zx_paste_type_char(char c)
+{
+    if (c == '\t')
+        c = ' ';
+
+    if (c >= 'a' && c <= 'z')
+    {
+        zx_paste_push(ZX_NONE, zx_paste_key(c - 'a' + 'A'), 0); // L mode: lower case
+        return true;
+    }
+
+    if (c >= 'A' && c <= 'Z')
+    {
+        zx_paste_push(ZX_CS, zx_paste_key(c), 0);
+        return true;
+    }
+
+    if ((c >= '0' && c <= '9') || c == ' ')
+    {
+        zx_paste_push(ZX_NONE, zx_paste_key(c), 0);
+        return true;
+    }
+
+    for (int i = 0; i < count_of(zx_paste_symbols); i++)
+        if (zx_paste_symbols[i].name[0] == c)
+        {
+            zx_paste_type(&zx_paste_symbols[i]);
+            return true;
+        }
+
+    return false;
+}
+
+// Length of the keyword name at text, 0 if it is not there.
+// K mode: any case, the keyword may follow the line number directly; L mode: upper case words only.
+static uint16_t zx_paste_match(const char *line, const char *text, const char *name, bool k_mode)
+{
+    const char *t = text;
+    size_t len = strlen(name);
+
+    if (!k_mode && isalpha((unsigned char)name[0]) && t > line && isalnum((unsigned char)t[-1]))
+        return 0;
+
+    for (const char *n = name; *n; n++)
+    {
+        if (*n == ' ')
+        {
+            while (*t == ' ')
+                t++;
+
+            continue;
+        }
+
+        if ((k_mode ? toupper((unsigned char)*t) : *t) != *n)
+            return 0;
+
+        t++;
+    }
+
+    if (isalpha((unsigned char)name[len - 1]) && isalpha((unsigned char)*t))
+        return 0;
+
+    return t - text;
+}
+
+// Longest keyword the cursor mode accepts at text
+static uint16_t zx_paste_keyword(const char *line, const char *text, bool k_mode, const zx_paste_keyword_t **keyword)
+{
+    uint16_t best = 0;
+
+    for (int i = 0; i < count_of(zx_paste_keywords); i++)
+    {
+        const zx_paste_keyword_t *kw = &zx_paste_keywords[i];
+        bool statement = (kw->flags & ZX_KW_KIND) == ZX_KW_K || (kw->flags & ZX_KW_STATEMENT);
+
+        // K mode takes statements only, and a K mode key in L mode is a letter
+        if (k_mode ? !statement : (kw->flags & ZX_KW_KIND) == ZX_KW_K)
+            continue;
+
+        uint16_t len = zx_paste_match(line, text, kw->name, k_mode);
+
+        if (len > best)
+        {
+            best = len;
+            *keyword = kw;
+        }
+    }
+
+    return best;
+}
+
+int zx_paste_line(const char *line, zx_paste_mode_t mode)
+{
+    bool k_mode = mode == ZX_PASTE_BASIC48; // start of a statement
+    bool literal = mode == ZX_PASTE_TEXT;   // plain text, REM: every character as it is
+    bool quoted = false;
+    int skipped = 0;
+    const char *end = line + strnlen(line, ZX_PASTE_LINE_MAX);
+    const char *p = line;
+
+    zx_paste_next = zx_paste_head;
+    zx_paste_full = false;
+
+    while (p < end)
+    {
+        if (!literal && !quoted)
+        {
+            // The ROM lists its own spaces around keywords, others are only kept in strings and REM
+            if (*p == ' ')
+            {
+                p++;
+                continue;
+            }
+
+            const zx_paste_keyword_t *keyword;
+            uint16_t len = zx_paste_keyword(line, p, k_mode, &keyword);
+
+            if (len)
+            {
+                zx_paste_type(keyword);
+                p += len;
+                k_mode = keyword->flags & ZX_KW_THEN;
+
+                if (keyword->flags & ZX_KW_REM)
+                {
+                    literal = true;
+
+                    if (*p == ' ')
+                        p++;
+                }
+
+                continue;
+            }
+        }
+
+        if (*p == '"' && !literal)
+            quoted = !quoted;
+
+        if (!zx_paste_type_char(*p))
+            skipped++;
+
+        // the line number keeps K mode, ':' starts a statement
+        if (!literal && !quoted)
+            k_mode = *p == ':' || (k_mode && isdigit((unsigned char)*p));
+
+        p++;
+    }
+
+    zx_paste_push(ZX_NONE, ZX_ENTER, ZX_PASTE_CHORD_ENTER);
+
+    if (zx_paste_full)
+        return ZX_PASTE_BUSY;
+
+    __dmb(); // chords /then/ head
+    zx_paste_head = zx_paste_next;
+
+    zx_paste_kick();
+
+    return skipped + strlen(p); // past ZX_PASTE_LINE_MAX
+}
+
+void zx_paste_cancel(void)
+{
+    zx_paste_cancelled = true;
+    zx_paste_kick();
+}
+
+uint16_t zx_paste_pending(void)
+{
+    return zx_paste_head - zx_paste_tail;
+}
+
+// Playback (core 1)
+
+typedef enum
+{
+    ZX_PASTE_UP,         // all keys up: next chord
+    ZX_PASTE_SHIFT_DOWN, // shift alone
+    ZX_PASTE_DOWN,       // shift + key
+    ZX_PASTE_SHIFT_UP,   // key up, shift still down
+} zx_paste_phase_t;
+
+static zx_kbd_state_t zx_paste_state;
+static zx_paste_phase_t zx_paste_phase = ZX_PASTE_UP;
+static zx_paste_chord_t zx_paste_chord;
+static uint8_t zx_paste_last_key = ZX_NONE;
+static bool zx_paste_repeat_waited = false;
+
+static void __not_in_flash_func(zx_paste_press)(uint8_t zx1, uint8_t zx2)
+{
+    zx_paste_state.u[0] = 0;
+    zx_paste_state.u[1] = 0;
+    zx_paste_state.a[zx1 >> 5] |= zx1 & 0x1F;
+    zx_paste_state.a[zx2 >> 5] |= zx2 & 0x1F;
+
+    if (zx_paste_event_cb)
+        zx_paste_event_cb(time_us_32());
+}
+
+// Next change of the keys, returns ms until the one after it, 0 when the queue is empty
+static uint32_t __not_in_flash_func(zx_paste_step)(void)
+{
+    if (zx_paste_cancelled)
+    {
+        zx_paste_tail = zx_paste_head;
+        zx_paste_cancelled = false;
+        zx_paste_phase = ZX_PASTE_UP;
+        zx_paste_last_key = ZX_NONE;
+        zx_paste_press(ZX_NONE, ZX_NONE);
+        return 0;
+    }
+
+    switch (zx_paste_phase)
+    {
+    case ZX_PASTE_UP:
+        if (zx_paste_tail == zx_paste_head)
+            return 0;
+
+        // the OSD has the keyboard, ZX output is off
+        if (osd_kbd_active)
+            return ZX_PASTE_SCAN_MS;
+
+        __dmb(); // head /then/ chord
+        zx_paste_chord = zx_paste_queue[zx_paste_tail & (ZX_PASTE_QUEUE_SIZE - 1)];
+
+        // the same key again (any shift) is only new to the ROM some reads after its release
+        if (zx_paste_chord.key == zx_paste_last_key && !zx_paste_repeat_waited &&
+            zx_paste_timing.repeat_ms > zx_paste_timing.release_ms)
+        {
+            zx_paste_repeat_waited = true;
+            return zx_paste_timing.repeat_ms - zx_paste_timing.release_ms;
+        }
+
+        zx_paste_repeat_waited = false;
+
+        if (zx_paste_chord.shift != ZX_NONE)
+        {
+            zx_paste_press(zx_paste_chord.shift, ZX_NONE);
+            zx_paste_phase = ZX_PASTE_SHIFT_DOWN;
+            return ZX_PASTE_SCAN_MS;
+        }
+        // fall through
+
+    case ZX_PASTE_SHIFT_DOWN:
+        zx_paste_press(zx_paste_chord.shift, zx_paste_chord.key);
+        zx_paste_phase = ZX_PASTE_DOWN;
+        return zx_paste_timing.hold_ms;
+
+    case ZX_PASTE_DOWN:
+        if (zx_paste_chord.shift != ZX_NONE)
+        {
+            zx_paste_press(zx_paste_chord.shift, ZX_NONE);
+            zx_paste_phase = ZX_PASTE_SHIFT_UP;
+            return ZX_PASTE_SCAN_MS;
+        }
+        // fall through
+
+    case ZX_PASTE_SHIFT_UP:
+    default:
+        zx_paste_press(ZX_NONE, ZX_NONE);
+        zx_paste_phase = ZX_PASTE_UP;
+        zx_paste_last_key = zx_paste_chord.key;
+        zx_paste_tail++;
+        return (zx_paste_chord.flags & ZX_PASTE_CHORD_ENTER) ? zx_paste_timing.enter_ms : zx_paste_timing.release_ms;
+    }
+}
+
+static void __not_in_flash_func(zx_paste_alarm)(uint alarm_num)
+{
+    uint32_t ms = zx_paste_step();
+
+    if (!ms)
+    {
+        zx_paste_running = false;
+
+        __dmb(); // running /then/ head: core 0 restarts the alarm for chords queued from now on
+
+        if (zx_paste_head == zx_paste_tail && !zx_paste_cancelled)
+            return;
+
+        zx_paste_running = true;
+        ms = 1;
+    }
+
+    if (hardware_alarm_set_target(alarm_num, make_timeout_time_us(ms * 1000)))
+        hardware_alarm_force_irq(alarm_num);
+}
+
+void zx_paste_init(void)
+{
+    zx_paste_alarm_num = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(zx_paste_alarm_num, zx_paste_alarm);
+
+    // the PS/2 IRQ priority: neither interrupts the other inside kbd_on_event()
+    irq_set_priority(hardware_alarm_get_irq_num(zx_paste_alarm_num), PICO_DEFAULT_IRQ_PRIORITY);
+}
+
+void zx_paste_set_event_callback(zx_paste_event_fn cb)
+{
+    zx_paste_event_cb = cb;
+}
+
+void zx_paste_irq_set_enabled(bool enabled)
+{
+    if (zx_paste_alarm_num >= 0)
+        irq_set_enabled(hardware_alarm_get_irq_num(zx_paste_alarm_num), enabled);
+}
+
+const zx_kbd_state_t *zx_paste_get_state(void)
+{
+    return &zx_paste_state;
+}
+
+#endif // KBD_PASTE_ENABLE
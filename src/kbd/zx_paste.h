@@ -0,0 +1,58 @@
+/**
+ * zx_paste.h - Typed text for the ZX Spectrum keyboard matrix
+ *
+ * Text lines become key chords (CAPS/SYMBOL SHIFT + key) on core 0,
+ * a hardware alarm on core 1 presses and releases them at the pace
+ * the ROM reads the keyboard, through the usual keyboard output path.
+ */
+
+#pragma once
+
+#include "g_config.h"
+
+#ifdef KBD_PASTE_ENABLE
+
+#include "zx_kbd.h"
+
+#define ZX_PASTE_LINE_MAX 255   // characters typed per line, the rest are skipped
+#define ZX_PASTE_QUEUE_SIZE 512 // chords, power of 2, at most 2 per character + ENTER: a whole line fits
+#define ZX_PASTE_SCAN_MS 20     // the ROM reads the keyboard once per 50 Hz frame interrupt
+#define ZX_PASTE_BUSY (-1)      // zx_paste_line(): no room for the line yet
+
+typedef enum
+{
+    ZX_PASTE_TEXT,    // characters as they are
+    ZX_PASTE_BASIC48, // 48K BASIC listing: keywords typed as keyword keys, K/L/E cursor modes followed
+} zx_paste_mode_t;
+
+typedef struct
+{
+    uint16_t hold_ms;    // chord pressed, at least one keyboard read
+    uint16_t release_ms; // all keys up before the next chord
+    uint16_t repeat_ms;  // all keys up before the same chord again, the ROM takes a key as new 5 reads after release
+    uint16_t enter_ms;   // all keys up after ENTER, while the ROM checks and stores the line
+} zx_paste_timing_t;
+
+extern zx_paste_timing_t zx_paste_timing;
+
+typedef void (*zx_paste_event_fn)(uint32_t time_us); // time_us: when the alarm IRQ was entered
+
+// Core 1: the alarm IRQ runs on the core that sets it up
+void zx_paste_init(void);
+void zx_paste_set_event_callback(zx_paste_event_fn cb);
+
+// Keep the alarm IRQ out while the keyboard output is updated from thread mode
+void zx_paste_irq_set_enabled(bool enabled);
+
+// Keys pressed by the typed text, ORed into the ZX matrix
+const zx_kbd_state_t *zx_paste_get_state(void);
+
+// Core 0: queues a line (without line end, ENTER follows) as a whole. Returns the number of characters
+// that have no ZX key, or ZX_PASTE_BUSY with nothing queued while the queue has no room for the line:
+// the caller tries again later, e.g. from the next loop().
+int zx_paste_line(const char *line, zx_paste_mode_t mode);
+
+void zx_paste_cancel(void);
+uint16_t zx_paste_pending(void); // chords left to type
+
+#endif // KBD_PASTE_ENABLE
\ No newline at end of file
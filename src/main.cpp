@@ -36,6 +36,10 @@ extern "C"
 #ifdef USB_KBD_ENABLE
 #include "usb_kbd.h"
 #endif
+
+#ifdef PERF_STATS_ENABLE
+#include "perf_stats.h"
+#endif
 }
 
 #ifdef SERIAL_MENU_ENABLE
@@ -57,14 +61,12 @@ void setup()
   vreg_set_voltage(VREG_VOLTAGE_1_25);
   sleep_ms(100);
 
-#ifdef SERIAL_MENU_ENABLE
-  Serial.begin(115200);
+#ifdef PERF_STATS_ENABLE
+  perf_stats_init();
 #endif
 
-#ifdef USB_KBD_ENABLE
-  // Initialize TinyUSB Host directly (not tusb_init() which comes from
-  // pre-compiled libpico.a and is device-mode only).
-  tuh_init(0);
+#ifdef SERIAL_MENU_ENABLE
+  Serial.begin(115200);
 #endif
 
   load_settings(&settings);
@@ -95,6 +97,10 @@ void setup()
 
 void loop()
 {
+#ifdef PERF_STATS_ENABLE
+  perf_stats_update();
+#endif
+
 #ifdef OSD_ENABLE
   osd_update();
 #endif
@@ -105,19 +111,6 @@ void loop()
 #endif
     handle_serial_menu();
 #endif
-
-#ifdef USB_KBD_ENABLE
-  {
-    static uint32_t last_usb_us = 0;
-    uint32_t now_us = time_us_32();
-
-    if (now_us - last_usb_us >= 500)
-    {
-      usb_kbd_task();
-      last_usb_us = now_us;
-    }
-  }
-#endif
 }
 
 void setup1()
@@ -125,6 +118,10 @@ void setup1()
   while (!start_core0)
     sleep_ms(10);
 
+#ifdef PERF_STATS_ENABLE
+  perf_stats_init();
+#endif
+
 #ifdef OSD_FF_ENABLE
   if (settings.ff_osd_config.enabled)
     ff_osd_i2c_init();
@@ -134,9 +131,31 @@ void setup1()
   kbd_init();
 #endif
 
+#ifdef USB_KBD_ENABLE
+  // Initialize TinyUSB Host directly (not tusb_init() which comes from
+  // pre-compiled libpico.a and is device-mode only).
+  // On core 1: the host controller IRQ and tuh_task() must not wait for the OSD on core 0.
+  tuh_init(0);
+#endif
+
   start_capture();
 }
 
+// Core 1 thread mode is free between the housekeeping in loop1(), the USB host task runs
+// there whenever an interrupt (the host controller's in particular) wakes the core up
+static void __not_in_flash_func(core1_sleep_ms)(uint32_t ms)
+{
+#ifdef USB_KBD_ENABLE
+  absolute_time_t until = make_timeout_time_ms(ms);
+
+  do
+    usb_kbd_task();
+  while (!best_effort_wfe_or_timeout(until));
+#else
+  sleep_ms(ms);
+#endif
+}
+
 void __not_in_flash_func(loop1())
 {
   uint32_t frame_count_tmp1 = frame_count;
@@ -148,21 +167,13 @@ void __not_in_flash_func(loop1())
     ff_osd_needs_i2c_init = false;
   }
 
-  //  Call osd_process frequently to keep up with I2C data
+  // I2C data is decoded by interrupts, this publishes settings changes made on core 0
   if (settings.ff_osd_config.enabled)
-  {
-    for (int i = 0; i < 100; i++)
-    {
-      ff_osd_i2c_process();
-      sleep_ms(1);
-    }
-  }
-  else
-    sleep_ms(100);
-#else
-  sleep_ms(100);
+    ff_osd_i2c_refresh();
 #endif
 
+  core1_sleep_ms(100);
+
 #ifdef KBD_ENABLE
   // Timeout: turn off blue LED if no keyboard activity for this cycle
   {
@@ -1,10 +1,10 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/irq.h"
 #include "i2c_slave.h"
 
 #include "g_config.h"
 #include "ff_osd.h"
-#include "font.h"
 #include "osd.h"
 #include "video_output.h"
 
@@ -53,11 +53,13 @@ static const uint I2C_SLAVE_SCL_PIN = I2C_PIN_SCL;
 
 #define FF_OSD_KBD_TIMEOUT_US 10000000 // 10 seconds — same as OSD menu timeout
 
+#define FF_OSD_ALL_ROWS 0x0F
+
 extern settings_t settings;
 
 const char ff_osd_fw_ver[] = FF_OSD_FW_VER;
 
-// Display state, exported to display routines
+// Display state as decoded from I2C on core 1, settings changes write it too
 ff_osd_display_t ff_osd_display = {
     .cols = 20,
     .rows = 4,
@@ -66,6 +68,29 @@ ff_osd_display_t ff_osd_display = {
     .text = {},
 };
 
+// Snapshot of ff_osd_display published by the decoder under a sequence lock: the sequence is odd
+// while the decoder writes the snapshot and even after, ff_osd_update() copies it again if the
+// sequence was odd or changed while copying
+typedef struct
+{
+    ff_osd_display_t display;
+    uint8_t changed_rows; // since the previous snapshot
+} ff_osd_snapshot_t;
+
+static ff_osd_snapshot_t ff_osd_snapshot;
+static volatile uint32_t ff_osd_sequence; // +2 per published snapshot
+
+// Decoding runs in a low priority IRQ of core 1, raised by the I2C handler
+static int ff_osd_decode_irq = -1;
+
+// Last snapshot shown by ff_osd_update()
+static ff_osd_display_t ff_osd_shown;
+static uint32_t ff_osd_shown_sequence;
+static uint8_t ff_osd_dirty_rows = FF_OSD_ALL_ROWS; // rows to print to the text buffer again
+static uint8_t ff_osd_printed_columns;
+static uint8_t ff_osd_printed_rows;
+static uint8_t ff_osd_printed_color;
+
 uint8_t ff_osd_buttons_rx;      // button state: Gotek -> OSD
 bool ff_osd_kbd_active = false; // F12 toggle: keyboard controls Gotek
 
@@ -74,7 +99,9 @@ bool ff_osd_kbd_active = false; // F12 toggle: keyboard controls Gotek
 // - long hold: reserved for opening local OSD menu, not forwarded to Gotek
 static bool ff_btn_prev_held = false;
 static uint8_t ff_btn_pulse_frames = 0;
+#ifdef KBD_ENABLE
 static bool ff_osd_display_was_on = false; // Track display on→off transition
+#endif
 
 // state: OSD -> Gotek
 ff_osd_info_t ff_osd_info = {
@@ -83,14 +110,22 @@ ff_osd_info_t ff_osd_info = {
     .fw_minor = ff_osd_fw_ver[2],
     .buttons = 0};
 
+static_assert((FF_OSD_DATA_RING_SIZE & (FF_OSD_DATA_RING_SIZE - 1)) == 0 && FF_OSD_DATA_RING_SIZE <= 32768, "");
+static_assert((FF_OSD_TRANSACTION_RING_SIZE & (FF_OSD_TRANSACTION_RING_SIZE - 1)) == 0, "");
+
 // I2C data ring
-static uint8_t d_ring[1024];
+static uint8_t d_ring[FF_OSD_DATA_RING_SIZE];
 static uint16_t d_cons, d_prod; // data ring buffer consumer / producer pointers
 
 // Transaction ring: Data-ring offset of each transaction start
-static uint16_t t_ring[8];
+static uint16_t t_ring[FF_OSD_TRANSACTION_RING_SIZE];
 static uint16_t t_cons, t_prod; // transactions ring buffer consumer / producer pointers
 
+// A transaction that found a ring full is dropped up to its end
+static bool t_dropping;
+
+volatile ff_osd_i2c_stats_t ff_osd_i2c_stats;
+
 // Current position in FF OSD I2C Protocol character data.
 static uint8_t ff_osd_x, ff_osd_y;
 
@@ -250,6 +285,7 @@ static void __not_in_flash_func(lcd_process)(void)
     }
 
     d_cons = d_c;
+    t_cons = t_prod; // transaction boundaries mean nothing to the LCD
 }
 
 static void __not_in_flash_func(ffosd_process)(void)
@@ -266,6 +302,7 @@ static void __not_in_flash_func(ffosd_process)(void)
     if ((uint16_t)(t_p - t_c) >= 2)
     {
         // Discard older transactions, and in-progress old transaction.
+        ff_osd_i2c_stats.discarded += (uint16_t)(t_p - 2 - t_c);
         t_c = t_p - 2;
         d_c = t_ring[MASK(t_ring, t_c)];
         ff_osd_x = 0;
@@ -316,8 +353,11 @@ static void __not_in_flash_func(ffosd_process)(void)
                     break;
 
                 case FF_OSD_ROWS:
-                    // 0-3
-                    ff_osd_display.rows = x & 0x03;
+                    // 0-4
+                    if ((x & 0x0f) > FF_OSD_ROWS_MAX)
+                        ff_osd_display.rows = FF_OSD_ROWS_MAX;
+                    else
+                        ff_osd_display.rows = x & 0x0f;
                     break;
 
                 case FF_OSD_HEIGHTS:
@@ -349,6 +389,45 @@ static void __not_in_flash_func(ffosd_process)(void)
     t_cons = t_c;
 }
 
+static void __not_in_flash_func(ff_osd_publish)(void)
+{
+    // the decoder is the only writer, so it reads the snapshot without the lock
+    const ff_osd_display_t *last = &ff_osd_snapshot.display;
+    uint8_t changed_rows = 0;
+
+    if (last->cols != ff_osd_display.cols || last->rows != ff_osd_display.rows ||
+        last->heights != ff_osd_display.heights || last->on != ff_osd_display.on)
+    {
+        changed_rows = FF_OSD_ALL_ROWS;
+    }
+    else
+    {
+        for (int row = 0; row < 4; row++)
+            if (memcmp(last->text[row], ff_osd_display.text[row], sizeof(last->text[row])) != 0)
+                changed_rows |= 1 << row;
+    }
+
+    if (!changed_rows)
+        return;
+
+    ff_osd_sequence++; // odd: writing
+    __dmb();
+    ff_osd_snapshot.display = ff_osd_display;
+    ff_osd_snapshot.changed_rows = changed_rows;
+    __dmb();
+    ff_osd_sequence++; // even: published
+}
+
+static void __not_in_flash_func(ff_osd_decode_irq_handler)(void)
+{
+    if (settings.ff_osd_config.i2c_protocol)
+        ffosd_process();
+    else
+        lcd_process();
+
+    ff_osd_publish();
+}
+
 static void __not_in_flash_func(i2c_slave_handler)(i2c_inst_t *i2c, i2c_slave_event_t event)
 {
     static uint8_t rp = 0;
@@ -360,12 +439,41 @@ static void __not_in_flash_func(i2c_slave_handler)(i2c_inst_t *i2c, i2c_slave_ev
         // On address match (first RECEIVE after FINISH), mark transaction start
         if (!addr_matched)
         {
-            t_ring[MASK(t_ring, t_prod++)] = d_prod;
+            ff_osd_i2c_stats.transactions++;
+            t_dropping = (uint16_t)(t_prod - t_cons) >= count_of(t_ring);
+
+            if (t_dropping)
+                ff_osd_i2c_stats.transaction_overflows++;
+            else
+                t_ring[MASK(t_ring, t_prod++)] = d_prod;
+
             rp = 0;
             addr_matched = true;
         }
         // Read incoming byte - ISR is called for each byte received
-        d_ring[MASK(d_ring, d_prod++)] = i2c_read_byte_raw(i2c);
+        uint8_t data = i2c_read_byte_raw(i2c);
+        uint16_t fill = d_prod - d_cons;
+
+        if (!t_dropping && fill >= sizeof(d_ring))
+        { // the rest of the transaction would be decoded out of place
+            t_dropping = true;
+            ff_osd_i2c_stats.data_overflows++;
+        }
+
+        if (t_dropping)
+        {
+            ff_osd_i2c_stats.dropped_bytes++;
+            break;
+        }
+
+        d_ring[MASK(d_ring, d_prod++)] = data;
+
+        if (fill + 1 > ff_osd_i2c_stats.data_peak)
+            ff_osd_i2c_stats.data_peak = fill + 1;
+
+        // Long transactions are decoded before they fill the ring
+        if (fill + 1 >= sizeof(d_ring) / 2)
+            irq_set_pending(ff_osd_decode_irq);
         break;
 
     case I2C_SLAVE_REQUEST: // master is requesting data
@@ -381,8 +489,9 @@ static void __not_in_flash_func(i2c_slave_handler)(i2c_inst_t *i2c, i2c_slave_ev
         break;
 
     case I2C_SLAVE_FINISH: // master has signalled Stop / Restart
-        // Transaction complete - reset for next transaction
+        // Transaction complete - reset for next transaction, decode it
         addr_matched = false;
+        irq_set_pending(ff_osd_decode_irq);
         break;
 
     default:
@@ -396,6 +505,15 @@ void ff_osd_i2c_init()
     if (ff_osd_i2c_initialized)
         i2c_slave_deinit(I2C_INST);
 
+    // Below the DMA IRQs: decoding can wait for the capture ISR, the I2C ISR can't
+    if (ff_osd_decode_irq < 0)
+    {
+        ff_osd_decode_irq = user_irq_claim_unused(true);
+        irq_set_exclusive_handler(ff_osd_decode_irq, ff_osd_decode_irq_handler);
+        irq_set_priority(ff_osd_decode_irq, PICO_LOWEST_IRQ_PRIORITY);
+        irq_set_enabled(ff_osd_decode_irq, true);
+    }
+
     // Apply config to display (important for LCD mode)
     lcd_display_update();
 
@@ -430,9 +548,42 @@ void ff_osd_set_address()
     I2C_INST->hw->sar = settings.ff_osd_config.i2c_protocol ? 0x10 : 0x27;
 }
 
-void ff_osd_i2c_process(void)
+void ff_osd_i2c_refresh()
+{
+    // Settings changes to ff_osd_display are published without I2C traffic
+    if (ff_osd_decode_irq >= 0)
+        irq_set_pending(ff_osd_decode_irq);
+}
+
+void ff_osd_invalidate()
 {
-    return settings.ff_osd_config.i2c_protocol ? ffosd_process() : lcd_process();
+    ff_osd_dirty_rows = FF_OSD_ALL_ROWS;
+}
+
+static void ff_osd_latch()
+{
+    uint32_t sequence;
+    uint8_t changed_rows;
+
+    do
+    {
+        sequence = ff_osd_sequence;
+
+        if (sequence == ff_osd_shown_sequence)
+            return;
+
+        if (sequence & 1)
+            continue; // the decoder is writing
+
+        __dmb(); // sequence /then/ snapshot
+        ff_osd_shown = ff_osd_snapshot.display;
+        changed_rows = ff_osd_snapshot.changed_rows;
+        __dmb(); // snapshot /then/ sequence
+    } while ((sequence & 1) || ff_osd_sequence != sequence); // written while copying
+
+    // a skipped snapshot may have changed any row
+    ff_osd_dirty_rows |= (sequence - ff_osd_shown_sequence == 2) ? changed_rows : FF_OSD_ALL_ROWS;
+    ff_osd_shown_sequence = sequence;
 }
 
 void ff_osd_update()
@@ -447,6 +598,7 @@ void ff_osd_update()
         return;
     }
 
+    ff_osd_latch();
     osd_buttons_update();
     // Map OSD button presses to FF OSD button codes
     uint8_t buttons = 0;
@@ -464,7 +616,7 @@ void ff_osd_update()
     }
 
     // Deactivate keyboard control on host display on→off transition
-    if (ff_osd_kbd_active && ff_osd_display_was_on && !ff_osd_display.on)
+    if (ff_osd_kbd_active && ff_osd_display_was_on && !ff_osd_shown.on)
         ff_osd_kbd_active = false;
 
     // Timeout: deactivate keyboard control after inactivity
@@ -476,7 +628,7 @@ void ff_osd_update()
             ff_osd_kbd_active = false;
     }
 
-    ff_osd_display_was_on = ff_osd_display.on;
+    ff_osd_display_was_on = ff_osd_shown.on;
 #endif
 
     bool block_ff_buttons = osd_buttons_blocked();
@@ -557,44 +709,58 @@ void ff_osd_update()
 
     ff_osd_set_buttons(buttons);
 
-    if (ff_osd_display.on || ff_osd_kbd_active)
+    if (ff_osd_shown.on || ff_osd_kbd_active)
     {
-        osd_font = osd_font_style_2;
+        osd_set_font(settings.ff_osd_config.font);
 
         const uint8_t fg_color = ff_osd_kbd_active ? 0x3 : 7; // Cyan when keyboard controls Gotek
         const uint8_t bg_color = 0;
 
         osd_mode.x = settings.ff_osd_config.h_position;
         osd_mode.y = settings.ff_osd_config.v_position ? 2 : 1; // 1 = top, 2 = bottom
-        osd_mode.columns = ff_osd_display.cols;
+        osd_mode.columns = ff_osd_shown.cols;
 
         uint8_t double_height_rows = 0;
 
-        for (int i = 0; i < ff_osd_display.rows; i++)
-            if ((ff_osd_display.heights >> i) & 1)
+        for (int i = 0; i < ff_osd_shown.rows; i++)
+            if ((ff_osd_shown.heights >> i) & 1)
                 double_height_rows++;
 
-        osd_mode.rows = ff_osd_display.rows + double_height_rows;
+        osd_mode.rows = ff_osd_shown.rows + double_height_rows;
         osd_mode.border_enabled = false;
         osd_mode.full_width = true;
+        osd_set_blend(settings.ff_osd_config.blend);
         osd_mode.width = osd_mode.columns * OSD_FONT_WIDTH;
         osd_mode.height = osd_mode.rows * OSD_FONT_HEIGHT;
         osd_mode.buffer_size = osd_mode.width * osd_mode.height / 2;
 
         osd_set_position();
 
+        // The text buffer layout follows the OSD size, a new layout or colour prints every row
+        if (osd_mode.columns != ff_osd_printed_columns || osd_mode.rows != ff_osd_printed_rows ||
+            fg_color != ff_osd_printed_color)
+        {
+            ff_osd_dirty_rows = FF_OSD_ALL_ROWS;
+            ff_osd_printed_columns = osd_mode.columns;
+            ff_osd_printed_rows = osd_mode.rows;
+            ff_osd_printed_color = fg_color;
+        }
+
         uint8_t start_row = 0;
 
-        // Render each row from ff_osd_display
-        for (uint8_t row = 0; (row < ff_osd_display.rows) && (row < 4); row++)
+        // Render each changed row from the snapshot
+        for (uint8_t row = 0; (row < ff_osd_shown.rows) && (row < 4); row++)
         {
             uint8_t osd_row = start_row + row;
 
             if (osd_row >= osd_mode.rows)
                 break;
 
+            if (!(ff_osd_dirty_rows & (1 << row)))
+                continue;
+
             // Check if this row should be double-height
-            uint8_t is_double_height = settings.ff_osd_config.i2c_protocol && ((ff_osd_display.heights >> row) & 1);
+            uint8_t is_double_height = settings.ff_osd_config.i2c_protocol && ((ff_osd_shown.heights >> row) & 1);
 
             osd_text_heights[osd_row] = is_double_height;
 
@@ -603,9 +769,9 @@ void ff_osd_update()
 
             uint8_t out_pos = 0;
 
-            for (uint8_t col = 0; col < ff_osd_display.cols && col < osd_mode.columns; col++)
+            for (uint8_t col = 0; col < ff_osd_shown.cols && col < osd_mode.columns; col++)
             {
-                uint8_t glyph = (uint8_t)ff_osd_display.text[row][col];
+                uint8_t glyph = (uint8_t)ff_osd_shown.text[row][col];
 
                 if (glyph < 32)
                     glyph = ' ';
@@ -617,6 +783,8 @@ void ff_osd_update()
             // Print the entire row at once with the appropriate height
             osd_text_print(osd_row, 0, row_text, fg_color, bg_color, is_double_height);
         }
+
+        ff_osd_dirty_rows = 0;
     }
 
     // Always mark that text buffer needs to be rendered
@@ -625,7 +793,7 @@ void ff_osd_update()
 
     osd_render_text_to_buffer();
 
-    osd_state.visible = ff_osd_display.on || ff_osd_kbd_active;
+    osd_state.visible = ff_osd_shown.on || ff_osd_kbd_active;
 }
 
 #endif // OSD_FF_ENABLE
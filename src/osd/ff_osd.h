@@ -16,13 +16,26 @@ typedef struct __attribute__((packed)) ff_osd_info_t
     uint8_t buttons;
 } ff_osd_info_t;
 
+// I2C receive counters, since power on
+typedef struct ff_osd_i2c_stats_t
+{
+    uint32_t transactions;
+    uint32_t transaction_overflows; // dropped, the transaction ring was full
+    uint32_t data_overflows;        // cut short, the data ring was full
+    uint32_t dropped_bytes;         // of the transactions above
+    uint32_t discarded;             // skipped by the decoder for a newer one (FlashFloppy protocol)
+    uint16_t data_peak;             // most bytes waiting in the data ring
+} ff_osd_i2c_stats_t;
+
 extern ff_osd_display_t ff_osd_display;
+extern volatile ff_osd_i2c_stats_t ff_osd_i2c_stats;
 extern uint8_t ff_osd_buttons_rx;
 extern volatile bool ff_osd_needs_i2c_init;
 extern bool ff_osd_kbd_active; // F12 toggle: keyboard controls Gotek
 
 void ff_osd_update();
-void ff_osd_i2c_process();
+void ff_osd_invalidate(); // the text buffer was used by someone else
+void ff_osd_i2c_refresh(); // core 1, I2C data needs no polling
 void ff_osd_i2c_init();
 void ff_osd_set_address();
 void ff_osd_set_buttons(uint8_t buttons);
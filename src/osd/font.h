@@ -12,309 +12,314 @@
 #define OSD_CHAR_BORDER_VL 0xb3 // 0xba // Vertical line - left
 #define OSD_CHAR_BORDER_VR 0xb3 // 0xba // Vertical line - right
 
-static const uint8_t osd_font_style_1[256][8] = {
+// Fonts are packed per glyph as: character code, mask of the non-blank rows (bit 7 = top row),
+// then only the non-blank rows. osd_set_font() unpacks one into the RAM glyph cache.
+
+// ZX Spectrum ROM font
+static const uint8_t osd_font_zx_packed[] = {
     // Symbols
-    [0x20] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, /* ' ' */
-    [0x21] = {0x00, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x00}, /* '!' */
-    [0x22] = {0x00, 0x24, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00}, /* '"' */
-    [0x23] = {0x00, 0x24, 0x7e, 0x24, 0x24, 0x7e, 0x24, 0x00}, /* '#' */
-    [0x24] = {0x00, 0x08, 0x3e, 0x28, 0x3e, 0x0a, 0x3e, 0x08}, /* '$' */
-    [0x25] = {0x00, 0x62, 0x64, 0x08, 0x10, 0x26, 0x46, 0x00}, /* '%' */
-    [0x26] = {0x00, 0x10, 0x28, 0x10, 0x2a, 0x44, 0x3a, 0x00}, /* '&' */
-    [0x27] = {0x00, 0x08, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00}, /* ''' */
-    [0x28] = {0x00, 0x04, 0x08, 0x08, 0x08, 0x08, 0x04, 0x00}, /* '(' */
-    [0x29] = {0x00, 0x20, 0x10, 0x10, 0x10, 0x10, 0x20, 0x00}, /* ')' */
-    [0x2a] = {0x00, 0x00, 0x14, 0x08, 0x3e, 0x08, 0x14, 0x00}, /* '*' */
-    [0x2b] = {0x00, 0x00, 0x08, 0x08, 0x3e, 0x08, 0x08, 0x00}, /* '+' */
-    [0x2c] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x10}, /* ',' */
-    [0x2d] = {0x00, 0x00, 0x00, 0x00, 0x3e, 0x00, 0x00, 0x00}, /* '-' */
-    [0x2e] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x00}, /* '.' */
-    [0x2f] = {0x00, 0x00, 0x02, 0x04, 0x08, 0x10, 0x20, 0x00}, /* '/' */
+    0x20, 0x00, /* ' ' */
+    0x21, 0x7a, 0x10, 0x10, 0x10, 0x10, 0x10, /* '!' */
+    0x22, 0x60, 0x24, 0x24, /* '"' */
+    0x23, 0x7e, 0x24, 0x7e, 0x24, 0x24, 0x7e, 0x24, /* '#' */
+    0x24, 0x7f, 0x08, 0x3e, 0x28, 0x3e, 0x0a, 0x3e, 0x08, /* '$' */
+    0x25, 0x7e, 0x62, 0x64, 0x08, 0x10, 0x26, 0x46, /* '%' */
+    0x26, 0x7e, 0x10, 0x28, 0x10, 0x2a, 0x44, 0x3a, /* '&' */
+    0x27, 0x60, 0x08, 0x10, /* ''' */
+    0x28, 0x7e, 0x04, 0x08, 0x08, 0x08, 0x08, 0x04, /* '(' */
+    0x29, 0x7e, 0x20, 0x10, 0x10, 0x10, 0x10, 0x20, /* ')' */
+    0x2a, 0x3e, 0x14, 0x08, 0x3e, 0x08, 0x14, /* '*' */
+    0x2b, 0x3e, 0x08, 0x08, 0x3e, 0x08, 0x08, /* '+' */
+    0x2c, 0x07, 0x08, 0x08, 0x10, /* ',' */
+    0x2d, 0x08, 0x3e, /* '-' */
+    0x2e, 0x06, 0x18, 0x18, /* '.' */
+    0x2f, 0x3e, 0x02, 0x04, 0x08, 0x10, 0x20, /* '/' */
     // Digits
-    [0x30] = {0x00, 0x3c, 0x46, 0x4a, 0x52, 0x62, 0x3c, 0x00}, /* '0' */
-    [0x31] = {0x00, 0x18, 0x28, 0x08, 0x08, 0x08, 0x3e, 0x00}, /* '1' */
-    [0x32] = {0x00, 0x3c, 0x42, 0x02, 0x3c, 0x40, 0x7e, 0x00}, /* '2' */
-    [0x33] = {0x00, 0x3c, 0x42, 0x0c, 0x02, 0x42, 0x3c, 0x00}, /* '3' */
-    [0x34] = {0x00, 0x08, 0x18, 0x28, 0x48, 0x7e, 0x08, 0x00}, /* '4' */
-    [0x35] = {0x00, 0x7e, 0x40, 0x7c, 0x02, 0x42, 0x3c, 0x00}, /* '5' */
-    [0x36] = {0x00, 0x3c, 0x40, 0x7c, 0x42, 0x42, 0x3c, 0x00}, /* '6' */
-    [0x37] = {0x00, 0x7e, 0x02, 0x04, 0x08, 0x10, 0x10, 0x00}, /* '7' */
-    [0x38] = {0x00, 0x3c, 0x42, 0x3c, 0x42, 0x42, 0x3c, 0x00}, /* '8' */
-    [0x39] = {0x00, 0x3c, 0x42, 0x42, 0x3e, 0x02, 0x3c, 0x00}, /* '9' */
+    0x30, 0x7e, 0x3c, 0x46, 0x4a, 0x52, 0x62, 0x3c, /* '0' */
+    0x31, 0x7e, 0x18, 0x28, 0x08, 0x08, 0x08, 0x3e, /* '1' */
+    0x32, 0x7e, 0x3c, 0x42, 0x02, 0x3c, 0x40, 0x7e, /* '2' */
+    0x33, 0x7e, 0x3c, 0x42, 0x0c, 0x02, 0x42, 0x3c, /* '3' */
+    0x34, 0x7e, 0x08, 0x18, 0x28, 0x48, 0x7e, 0x08, /* '4' */
+    0x35, 0x7e, 0x7e, 0x40, 0x7c, 0x02, 0x42, 0x3c, /* '5' */
+    0x36, 0x7e, 0x3c, 0x40, 0x7c, 0x42, 0x42, 0x3c, /* '6' */
+    0x37, 0x7e, 0x7e, 0x02, 0x04, 0x08, 0x10, 0x10, /* '7' */
+    0x38, 0x7e, 0x3c, 0x42, 0x3c, 0x42, 0x42, 0x3c, /* '8' */
+    0x39, 0x7e, 0x3c, 0x42, 0x42, 0x3e, 0x02, 0x3c, /* '9' */
     // Symbols
-    [0x3a] = {0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x00}, /* ':' */
-    [0x3b] = {0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x20}, /* ';' */
-    [0x3c] = {0x00, 0x00, 0x04, 0x08, 0x10, 0x08, 0x04, 0x00}, /* '<' */
-    [0x3d] = {0x00, 0x00, 0x00, 0x3e, 0x00, 0x3e, 0x00, 0x00}, /* '=' */
-    [0x3e] = {0x00, 0x00, 0x10, 0x08, 0x04, 0x08, 0x10, 0x00}, /* '>' */
-    [0x3f] = {0x00, 0x3c, 0x42, 0x04, 0x08, 0x00, 0x08, 0x00}, /* '?' */
-    [0x40] = {0x00, 0x3c, 0x4a, 0x56, 0x5e, 0x40, 0x3c, 0x00}, /* '@' */
+    0x3a, 0x12, 0x10, 0x10, /* ':' */
+    0x3b, 0x27, 0x10, 0x10, 0x10, 0x20, /* ';' */
+    0x3c, 0x3e, 0x04, 0x08, 0x10, 0x08, 0x04, /* '<' */
+    0x3d, 0x14, 0x3e, 0x3e, /* '=' */
+    0x3e, 0x3e, 0x10, 0x08, 0x04, 0x08, 0x10, /* '>' */
+    0x3f, 0x7a, 0x3c, 0x42, 0x04, 0x08, 0x08, /* '?' */
+    0x40, 0x7e, 0x3c, 0x4a, 0x56, 0x5e, 0x40, 0x3c, /* '@' */
     // Uppercase letters
-    [0x41] = {0x00, 0x3c, 0x42, 0x42, 0x7e, 0x42, 0x42, 0x00}, /* 'A' */
-    [0x42] = {0x00, 0x7c, 0x42, 0x7c, 0x42, 0x42, 0x7c, 0x00}, /* 'B' */
-    [0x43] = {0x00, 0x3c, 0x42, 0x40, 0x40, 0x42, 0x3c, 0x00}, /* 'C' */
-    [0x44] = {0x00, 0x78, 0x44, 0x42, 0x42, 0x44, 0x78, 0x00}, /* 'D' */
-    [0x45] = {0x00, 0x7e, 0x40, 0x7c, 0x40, 0x40, 0x7e, 0x00}, /* 'E' */
-    [0x46] = {0x00, 0x7e, 0x40, 0x7c, 0x40, 0x40, 0x40, 0x00}, /* 'F' */
-    [0x47] = {0x00, 0x3c, 0x42, 0x40, 0x4e, 0x42, 0x3c, 0x00}, /* 'G' */
-    [0x48] = {0x00, 0x42, 0x42, 0x7e, 0x42, 0x42, 0x42, 0x00}, /* 'H' */
-    [0x49] = {0x00, 0x3e, 0x08, 0x08, 0x08, 0x08, 0x3e, 0x00}, /* 'I' */
-    [0x4a] = {0x00, 0x02, 0x02, 0x02, 0x42, 0x42, 0x3c, 0x00}, /* 'J' */
-    [0x4b] = {0x00, 0x44, 0x48, 0x70, 0x48, 0x44, 0x42, 0x00}, /* 'K' */
-    [0x4c] = {0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7e, 0x00}, /* 'L' */
-    [0x4d] = {0x00, 0x42, 0x66, 0x5a, 0x42, 0x42, 0x42, 0x00}, /* 'M' */
-    [0x4e] = {0x00, 0x42, 0x62, 0x52, 0x4a, 0x46, 0x42, 0x00}, /* 'N' */
-    [0x4f] = {0x00, 0x3c, 0x42, 0x42, 0x42, 0x42, 0x3c, 0x00}, /* 'O' */
-    [0x50] = {0x00, 0x7c, 0x42, 0x42, 0x7c, 0x40, 0x40, 0x00}, /* 'P' */
-    [0x51] = {0x00, 0x3c, 0x42, 0x42, 0x52, 0x4a, 0x3c, 0x00}, /* 'Q' */
-    [0x52] = {0x00, 0x7c, 0x42, 0x42, 0x7c, 0x44, 0x42, 0x00}, /* 'R' */
-    [0x53] = {0x00, 0x3c, 0x40, 0x3c, 0x02, 0x42, 0x3c, 0x00}, /* 'S' */
-    [0x54] = {0x00, 0xfe, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00}, /* 'T' */
-    [0x55] = {0x00, 0x42, 0x42, 0x42, 0x42, 0x42, 0x3c, 0x00}, /* 'U' */
-    [0x56] = {0x00, 0x42, 0x42, 0x42, 0x42, 0x24, 0x18, 0x00}, /* 'V' */
-    [0x57] = {0x00, 0x42, 0x42, 0x42, 0x42, 0x5a, 0x24, 0x00}, /* 'W' */
-    [0x58] = {0x00, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x00}, /* 'X' */
-    [0x59] = {0x00, 0x82, 0x44, 0x28, 0x10, 0x10, 0x10, 0x00}, /* 'Y' */
-    [0x5a] = {0x00, 0x7e, 0x04, 0x08, 0x10, 0x20, 0x7e, 0x00}, /* 'Z' */
+    0x41, 0x7e, 0x3c, 0x42, 0x42, 0x7e, 0x42, 0x42, /* 'A' */
+    0x42, 0x7e, 0x7c, 0x42, 0x7c, 0x42, 0x42, 0x7c, /* 'B' */
+    0x43, 0x7e, 0x3c, 0x42, 0x40, 0x40, 0x42, 0x3c, /* 'C' */
+    0x44, 0x7e, 0x78, 0x44, 0x42, 0x42, 0x44, 0x78, /* 'D' */
+    0x45, 0x7e, 0x7e, 0x40, 0x7c, 0x40, 0x40, 0x7e, /* 'E' */
+    0x46, 0x7e, 0x7e, 0x40, 0x7c, 0x40, 0x40, 0x40, /* 'F' */
+    0x47, 0x7e, 0x3c, 0x42, 0x40, 0x4e, 0x42, 0x3c, /* 'G' */
+    0x48, 0x7e, 0x42, 0x42, 0x7e, 0x42, 0x42, 0x42, /* 'H' */
+    0x49, 0x7e, 0x3e, 0x08, 0x08, 0x08, 0x08, 0x3e, /* 'I' */
+    0x4a, 0x7e, 0x02, 0x02, 0x02, 0x42, 0x42, 0x3c, /* 'J' */
+    0x4b, 0x7e, 0x44, 0x48, 0x70, 0x48, 0x44, 0x42, /* 'K' */
+    0x4c, 0x7e, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7e, /* 'L' */
+    0x4d, 0x7e, 0x42, 0x66, 0x5a, 0x42, 0x42, 0x42, /* 'M' */
+    0x4e, 0x7e, 0x42, 0x62, 0x52, 0x4a, 0x46, 0x42, /* 'N' */
+    0x4f, 0x7e, 0x3c, 0x42, 0x42, 0x42, 0x42, 0x3c, /* 'O' */
+    0x50, 0x7e, 0x7c, 0x42, 0x42, 0x7c, 0x40, 0x40, /* 'P' */
+    0x51, 0x7e, 0x3c, 0x42, 0x42, 0x52, 0x4a, 0x3c, /* 'Q' */
+    0x52, 0x7e, 0x7c, 0x42, 0x42, 0x7c, 0x44, 0x42, /* 'R' */
+    0x53, 0x7e, 0x3c, 0x40, 0x3c, 0x02, 0x42, 0x3c, /* 'S' */
+    0x54, 0x7e, 0xfe, 0x10, 0x10, 0x10, 0x10, 0x10, /* 'T' */
+    0x55, 0x7e, 0x42, 0x42, 0x42, 0x42, 0x42, 0x3c, /* 'U' */
+    0x56, 0x7e, 0x42, 0x42, 0x42, 0x42, 0x24, 0x18, /* 'V' */
+    0x57, 0x7e, 0x42, 0x42, 0x42, 0x42, 0x5a, 0x24, /* 'W' */
+    0x58, 0x7e, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, /* 'X' */
+    0x59, 0x7e, 0x82, 0x44, 0x28, 0x10, 0x10, 0x10, /* 'Y' */
+    0x5a, 0x7e, 0x7e, 0x04, 0x08, 0x10, 0x20, 0x7e, /* 'Z' */
     // Symbols
-    [0x5b] = {0x00, 0x0e, 0x08, 0x08, 0x08, 0x08, 0x0e, 0x00}, /* '[' */
-    [0x5c] = {0x00, 0x00, 0x40, 0x20, 0x10, 0x08, 0x04, 0x00}, /* '\' */
-    [0x5d] = {0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x70, 0x00}, /* ']' */
-    [0x5e] = {0x00, 0x10, 0x38, 0x54, 0x10, 0x10, 0x10, 0x00}, /* '^' */
-    [0x5f] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff}, /* '_' */
-    [0x60] = {0x00, 0x1c, 0x22, 0x78, 0x20, 0x20, 0x7e, 0x00}, /* '`' */
+    0x5b, 0x7e, 0x0e, 0x08, 0x08, 0x08, 0x08, 0x0e, /* '[' */
+    0x5c, 0x3e, 0x40, 0x20, 0x10, 0x08, 0x04, /* '\' */
+    0x5d, 0x7e, 0x70, 0x10, 0x10, 0x10, 0x10, 0x70, /* ']' */
+    0x5e, 0x7e, 0x10, 0x38, 0x54, 0x10, 0x10, 0x10, /* '^' */
+    0x5f, 0x01, 0xff, /* '_' */
+    0x60, 0x7e, 0x1c, 0x22, 0x78, 0x20, 0x20, 0x7e, /* '`' */
     // Lowercase letters
-    [0x61] = {0x00, 0x00, 0x38, 0x04, 0x3c, 0x44, 0x3c, 0x00}, /* 'a' */
-    [0x62] = {0x00, 0x20, 0x20, 0x3c, 0x22, 0x22, 0x3c, 0x00}, /* 'b' */
-    [0x63] = {0x00, 0x00, 0x1c, 0x20, 0x20, 0x20, 0x1c, 0x00}, /* 'c' */
-    [0x64] = {0x00, 0x04, 0x04, 0x3c, 0x44, 0x44, 0x3c, 0x00}, /* 'd' */
-    [0x65] = {0x00, 0x00, 0x38, 0x44, 0x78, 0x40, 0x3c, 0x00}, /* 'e' */
-    [0x66] = {0x00, 0x0c, 0x10, 0x18, 0x10, 0x10, 0x10, 0x00}, /* 'f' */
-    [0x67] = {0x00, 0x00, 0x3c, 0x44, 0x44, 0x3c, 0x04, 0x38}, /* 'g' */
-    [0x68] = {0x00, 0x40, 0x40, 0x78, 0x44, 0x44, 0x44, 0x00}, /* 'h' */
-    [0x69] = {0x00, 0x10, 0x00, 0x30, 0x10, 0x10, 0x38, 0x00}, /* 'i' */
-    [0x6a] = {0x00, 0x04, 0x00, 0x04, 0x04, 0x04, 0x24, 0x18}, /* 'j' */
-    [0x6b] = {0x00, 0x20, 0x28, 0x30, 0x30, 0x28, 0x24, 0x00}, /* 'k' */
-    [0x6c] = {0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x0c, 0x00}, /* 'l' */
-    [0x6d] = {0x00, 0x00, 0x68, 0x54, 0x54, 0x54, 0x54, 0x00}, /* 'm' */
-    [0x6e] = {0x00, 0x00, 0x78, 0x44, 0x44, 0x44, 0x44, 0x00}, /* 'n' */
-    [0x6f] = {0x00, 0x00, 0x38, 0x44, 0x44, 0x44, 0x38, 0x00}, /* 'o' */
-    [0x70] = {0x00, 0x00, 0x78, 0x44, 0x44, 0x78, 0x40, 0x40}, /* 'p' */
-    [0x71] = {0x00, 0x00, 0x3c, 0x44, 0x44, 0x3c, 0x04, 0x06}, /* 'q' */
-    [0x72] = {0x00, 0x00, 0x1c, 0x20, 0x20, 0x20, 0x20, 0x00}, /* 'r' */
-    [0x73] = {0x00, 0x00, 0x38, 0x40, 0x38, 0x04, 0x78, 0x00}, /* 's' */
-    [0x74] = {0x00, 0x10, 0x38, 0x10, 0x10, 0x10, 0x0c, 0x00}, /* 't' */
-    [0x75] = {0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00}, /* 'u' */
-    [0x76] = {0x00, 0x00, 0x44, 0x44, 0x28, 0x28, 0x10, 0x00}, /* 'v' */
-    [0x77] = {0x00, 0x00, 0x44, 0x54, 0x54, 0x54, 0x28, 0x00}, /* 'w' */
-    [0x78] = {0x00, 0x00, 0x44, 0x28, 0x10, 0x28, 0x44, 0x00}, /* 'x' */
-    [0x79] = {0x00, 0x00, 0x44, 0x44, 0x44, 0x3c, 0x04, 0x38}, /* 'y' */
-    [0x7a] = {0x00, 0x00, 0x7c, 0x08, 0x10, 0x20, 0x7c, 0x00}, /* 'z' */
+    0x61, 0x3e, 0x38, 0x04, 0x3c, 0x44, 0x3c, /* 'a' */
+    0x62, 0x7e, 0x20, 0x20, 0x3c, 0x22, 0x22, 0x3c, /* 'b' */
+    0x63, 0x3e, 0x1c, 0x20, 0x20, 0x20, 0x1c, /* 'c' */
+    0x64, 0x7e, 0x04, 0x04, 0x3c, 0x44, 0x44, 0x3c, /* 'd' */
+    0x65, 0x3e, 0x38, 0x44, 0x78, 0x40, 0x3c, /* 'e' */
+    0x66, 0x7e, 0x0c, 0x10, 0x18, 0x10, 0x10, 0x10, /* 'f' */
+    0x67, 0x3f, 0x3c, 0x44, 0x44, 0x3c, 0x04, 0x38, /* 'g' */
+    0x68, 0x7e, 0x40, 0x40, 0x78, 0x44, 0x44, 0x44, /* 'h' */
+    0x69, 0x5e, 0x10, 0x30, 0x10, 0x10, 0x38, /* 'i' */
+    0x6a, 0x5f, 0x04, 0x04, 0x04, 0x04, 0x24, 0x18, /* 'j' */
+    0x6b, 0x7e, 0x20, 0x28, 0x30, 0x30, 0x28, 0x24, /* 'k' */
+    0x6c, 0x7e, 0x10, 0x10, 0x10, 0x10, 0x10, 0x0c, /* 'l' */
+    0x6d, 0x3e, 0x68, 0x54, 0x54, 0x54, 0x54, /* 'm' */
+    0x6e, 0x3e, 0x78, 0x44, 0x44, 0x44, 0x44, /* 'n' */
+    0x6f, 0x3e, 0x38, 0x44, 0x44, 0x44, 0x38, /* 'o' */
+    0x70, 0x3f, 0x78, 0x44, 0x44, 0x78, 0x40, 0x40, /* 'p' */
+    0x71, 0x3f, 0x3c, 0x44, 0x44, 0x3c, 0x04, 0x06, /* 'q' */
+    0x72, 0x3e, 0x1c, 0x20, 0x20, 0x20, 0x20, /* 'r' */
+    0x73, 0x3e, 0x38, 0x40, 0x38, 0x04, 0x78, /* 's' */
+    0x74, 0x7e, 0x10, 0x38, 0x10, 0x10, 0x10, 0x0c, /* 't' */
+    0x75, 0x3e, 0x44, 0x44, 0x44, 0x44, 0x38, /* 'u' */
+    0x76, 0x3e, 0x44, 0x44, 0x28, 0x28, 0x10, /* 'v' */
+    0x77, 0x3e, 0x44, 0x54, 0x54, 0x54, 0x28, /* 'w' */
+    0x78, 0x3e, 0x44, 0x28, 0x10, 0x28, 0x44, /* 'x' */
+    0x79, 0x3f, 0x44, 0x44, 0x44, 0x3c, 0x04, 0x38, /* 'y' */
+    0x7a, 0x3e, 0x7c, 0x08, 0x10, 0x20, 0x7c, /* 'z' */
     // Symbols
-    [0x7b] = {0x00, 0x00, 0x08, 0x08, 0x76, 0x42, 0x42, 0x00}, /* '{' */
-    [0x7c] = {0x00, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x00}, /* '|' */
-    [0x7d] = {0x00, 0x42, 0x42, 0x76, 0x08, 0x08, 0x00, 0x00}, /* '}' */
-    [0x7e] = {0x00, 0x14, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00}, /* '~' */
-    [0x7f] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, /* DEL */
+    0x7b, 0x3e, 0x08, 0x08, 0x76, 0x42, 0x42, /* '{' */
+    0x7c, 0x7e, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, /* '|' */
+    0x7d, 0x7c, 0x42, 0x42, 0x76, 0x08, 0x08, /* '}' */
+    0x7e, 0x60, 0x14, 0x28, /* '~' */
+    0x7f, 0x00, /* DEL */
     // Box drawing characters
-    [0xb3] = {0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08}, /* '│' */
-    [0xba] = {0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24}, /* '║' */
-    [0xbb] = {0x00, 0x00, 0xfc, 0x04, 0x04, 0xe4, 0x24, 0x24}, /* '╗' */
-    [0xbc] = {0x24, 0x24, 0xe4, 0x04, 0x04, 0xfc, 0x00, 0x00}, /* '╝' */
-    [0xbf] = {0x00, 0x00, 0x00, 0xf8, 0x08, 0x08, 0x08, 0x08}, /* '┐' */
-    [0xc0] = {0x08, 0x08, 0x08, 0x0f, 0x00, 0x00, 0x00, 0x00}, /* '└' */
-    [0xc4] = {0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00}, /* '─' */
-    [0xc8] = {0x24, 0x24, 0x27, 0x20, 0x20, 0x3f, 0x00, 0x00}, /* '╚' */
-    [0xc9] = {0x00, 0x00, 0x3f, 0x20, 0x20, 0x27, 0x24, 0x24}, /* '╔' */
-    [0xcd] = {0x00, 0x00, 0xff, 0x00, 0x00, 0xff, 0x00, 0x00}, /* '═' */
-    [0xd9] = {0x08, 0x08, 0x08, 0xf8, 0x00, 0x00, 0x00, 0x00}, /* '┘' */
-    [0xda] = {0x00, 0x00, 0x00, 0x0f, 0x08, 0x08, 0x08, 0x08}, /* '┌' */
+    0xb3, 0xff, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, /* '│' */
+    0xba, 0xff, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, /* '║' */
+    0xbb, 0x3f, 0xfc, 0x04, 0x04, 0xe4, 0x24, 0x24, /* '╗' */
+    0xbc, 0xfc, 0x24, 0x24, 0xe4, 0x04, 0x04, 0xfc, /* '╝' */
+    0xbf, 0x1f, 0xf8, 0x08, 0x08, 0x08, 0x08, /* '┐' */
+    0xc0, 0xf0, 0x08, 0x08, 0x08, 0x0f, /* '└' */
+    0xc4, 0x10, 0xff, /* '─' */
+    0xc8, 0xfc, 0x24, 0x24, 0x27, 0x20, 0x20, 0x3f, /* '╚' */
+    0xc9, 0x3f, 0x3f, 0x20, 0x20, 0x27, 0x24, 0x24, /* '╔' */
+    0xcd, 0x24, 0xff, 0xff, /* '═' */
+    0xd9, 0xf0, 0x08, 0x08, 0x08, 0xf8, /* '┘' */
+    0xda, 0x1f, 0x0f, 0x08, 0x08, 0x08, 0x08, /* '┌' */
 };
 
-static const uint8_t osd_font_style_2[256][8] = {
+// Bold font with Cyrillic letters
+static const uint8_t osd_font_bold_packed[] = {
     // Symbols
-    [0x20] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, /* ' ' */
-    [0x21] = {0x00, 0x18, 0x18, 0x18, 0x18, 0x00, 0x18, 0x00}, /* '!' */
-    [0x22] = {0x00, 0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00}, /* '"' */
-    [0x23] = {0x00, 0x6c, 0xfe, 0x6c, 0x6c, 0xfe, 0x6c, 0x00}, /* '#' */
-    [0x24] = {0x00, 0x18, 0x7e, 0x58, 0x7e, 0x1a, 0x7e, 0x18}, /* '$' */
-    [0x25] = {0x00, 0x63, 0x66, 0x0c, 0x18, 0x33, 0x63, 0x00}, /* '%' */
-    [0x26] = {0x00, 0x18, 0x24, 0x18, 0x3d, 0x66, 0x3d, 0x00}, /* '&' */
-    [0x27] = {0x00, 0x0c, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00}, /* ''' */
-    [0x28] = {0x00, 0x18, 0x30, 0x30, 0x30, 0x30, 0x18, 0x00}, /* '(' */
-    [0x29] = {0x00, 0x18, 0x0c, 0x0c, 0x0c, 0x0c, 0x18, 0x00}, /* ')' */
-    [0x2a] = {0x00, 0x00, 0x24, 0x18, 0x7e, 0x18, 0x24, 0x00}, /* '*' */
-    [0x2b] = {0x00, 0x00, 0x08, 0x08, 0x3e, 0x08, 0x08, 0x00}, /* '+' */
-    [0x2c] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x30}, /* ',' */
-    [0x2d] = {0x00, 0x00, 0x00, 0x00, 0x7e, 0x00, 0x00, 0x00}, /* '-' */
-    [0x2e] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18}, /* '.' */
-    [0x2f] = {0x00, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x00}, /* '/' */
+    0x20, 0x00, /* ' ' */
+    0x21, 0x7a, 0x18, 0x18, 0x18, 0x18, 0x18, /* '!' */
+    0x22, 0x60, 0x36, 0x36, /* '"' */
+    0x23, 0x7e, 0x6c, 0xfe, 0x6c, 0x6c, 0xfe, 0x6c, /* '#' */
+    0x24, 0x7f, 0x18, 0x7e, 0x58, 0x7e, 0x1a, 0x7e, 0x18, /* '$' */
+    0x25, 0x7e, 0x63, 0x66, 0x0c, 0x18, 0x33, 0x63, /* '%' */
+    0x26, 0x7e, 0x18, 0x24, 0x18, 0x3d, 0x66, 0x3d, /* '&' */
+    0x27, 0x60, 0x0c, 0x18, /* ''' */
+    0x28, 0x7e, 0x18, 0x30, 0x30, 0x30, 0x30, 0x18, /* '(' */
+    0x29, 0x7e, 0x18, 0x0c, 0x0c, 0x0c, 0x0c, 0x18, /* ')' */
+    0x2a, 0x3e, 0x24, 0x18, 0x7e, 0x18, 0x24, /* '*' */
+    0x2b, 0x3e, 0x08, 0x08, 0x3e, 0x08, 0x08, /* '+' */
+    0x2c, 0x07, 0x18, 0x18, 0x30, /* ',' */
+    0x2d, 0x08, 0x7e, /* '-' */
+    0x2e, 0x03, 0x18, 0x18, /* '.' */
+    0x2f, 0x7e, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, /* '/' */
     // Digits
-    [0x30] = {0x00, 0x7c, 0xce, 0xde, 0xf6, 0xe6, 0x7c, 0x00}, /* '0' */
-    [0x31] = {0x00, 0x38, 0x78, 0x18, 0x18, 0x18, 0x7e, 0x00}, /* '1' */
-    [0x32] = {0x00, 0x7c, 0xc6, 0x06, 0x7c, 0xc0, 0xfe, 0x00}, /* '2' */
-    [0x33] = {0x00, 0x7c, 0xc6, 0x1c, 0x06, 0xc6, 0x7c, 0x00}, /* '3' */
-    [0x34] = {0x00, 0x1c, 0x3c, 0x6c, 0xcc, 0xfe, 0x0c, 0x00}, /* '4' */
-    [0x35] = {0x00, 0xfe, 0xc0, 0xfc, 0x06, 0xc6, 0x7c, 0x00}, /* '5' */
-    [0x36] = {0x00, 0x7c, 0xc0, 0xfc, 0xc6, 0xc6, 0x7c, 0x00}, /* '6' */
-    [0x37] = {0x00, 0xfe, 0x06, 0x0c, 0x18, 0x30, 0x30, 0x00}, /* '7' */
-    [0x38] = {0x00, 0x7c, 0xc6, 0x7c, 0xc6, 0xc6, 0x7c, 0x00}, /* '8' */
-    [0x39] = {0x00, 0x7c, 0xc6, 0xc6, 0x7e, 0x06, 0x7c, 0x00}, /* '9' */
+    0x30, 0x7e, 0x7c, 0xce, 0xde, 0xf6, 0xe6, 0x7c, /* '0' */
+    0x31, 0x7e, 0x38, 0x78, 0x18, 0x18, 0x18, 0x7e, /* '1' */
+    0x32, 0x7e, 0x7c, 0xc6, 0x06, 0x7c, 0xc0, 0xfe, /* '2' */
+    0x33, 0x7e, 0x7c, 0xc6, 0x1c, 0x06, 0xc6, 0x7c, /* '3' */
+    0x34, 0x7e, 0x1c, 0x3c, 0x6c, 0xcc, 0xfe, 0x0c, /* '4' */
+    0x35, 0x7e, 0xfe, 0xc0, 0xfc, 0x06, 0xc6, 0x7c, /* '5' */
+    0x36, 0x7e, 0x7c, 0xc0, 0xfc, 0xc6, 0xc6, 0x7c, /* '6' */
+    0x37, 0x7e, 0xfe, 0x06, 0x0c, 0x18, 0x30, 0x30, /* '7' */
+    0x38, 0x7e, 0x7c, 0xc6, 0x7c, 0xc6, 0xc6, 0x7c, /* '8' */
+    0x39, 0x7e, 0x7c, 0xc6, 0xc6, 0x7e, 0x06, 0x7c, /* '9' */
     // Symbols
-    [0x3a] = {0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x18, 0x00}, /* ':' */
-    [0x3b] = {0x00, 0x00, 0x18, 0x00, 0x00, 0x18, 0x18, 0x30}, /* ';' */
-    [0x3c] = {0x00, 0x00, 0x0c, 0x18, 0x30, 0x18, 0x0c, 0x00}, /* '<' */
-    [0x3d] = {0x00, 0x00, 0x00, 0x7e, 0x00, 0x7e, 0x00, 0x00}, /* '=' */
-    [0x3e] = {0x00, 0x00, 0x30, 0x18, 0x0c, 0x18, 0x30, 0x00}, /* '>' */
-    [0x3f] = {0x00, 0x7c, 0xc6, 0x0c, 0x18, 0x00, 0x18, 0x00}, /* '?' */
-    [0x40] = {0x00, 0x7c, 0xce, 0xd6, 0xde, 0xc0, 0x7e, 0x00}, /* '@' */
+    0x3a, 0x12, 0x18, 0x18, /* ':' */
+    0x3b, 0x27, 0x18, 0x18, 0x18, 0x30, /* ';' */
+    0x3c, 0x3e, 0x0c, 0x18, 0x30, 0x18, 0x0c, /* '<' */
+    0x3d, 0x14, 0x7e, 0x7e, /* '=' */
+    0x3e, 0x3e, 0x30, 0x18, 0x0c, 0x18, 0x30, /* '>' */
+    0x3f, 0x7a, 0x7c, 0xc6, 0x0c, 0x18, 0x18, /* '?' */
+    0x40, 0x7e, 0x7c, 0xce, 0xd6, 0xde, 0xc0, 0x7e, /* '@' */
     // Uppercase letters
-    [0x41] = {0x00, 0x7c, 0xc6, 0xc6, 0xfe, 0xc6, 0xc6, 0x00}, /* 'A' */
-    [0x42] = {0x00, 0xfc, 0xc6, 0xfc, 0xc6, 0xc6, 0xfc, 0x00}, /* 'B' */
-    [0x43] = {0x00, 0x7c, 0xc6, 0xc0, 0xc0, 0xc6, 0x7c, 0x00}, /* 'C' */
-    [0x44] = {0x00, 0xf8, 0xcc, 0xc6, 0xc6, 0xcc, 0xf8, 0x00}, /* 'D' */
-    [0x45] = {0x00, 0xfe, 0xc0, 0xf8, 0xc0, 0xc0, 0xfe, 0x00}, /* 'E' */
-    [0x46] = {0x00, 0xfe, 0xc0, 0xf8, 0xc0, 0xc0, 0xc0, 0x00}, /* 'F' */
-    [0x47] = {0x00, 0x7c, 0xc6, 0xc0, 0xde, 0xc6, 0x7c, 0x00}, /* 'G' */
-    [0x48] = {0x00, 0xc6, 0xc6, 0xfe, 0xc6, 0xc6, 0xc6, 0x00}, /* 'H' */
-    [0x49] = {0x00, 0x7e, 0x18, 0x18, 0x18, 0x18, 0x7e, 0x00}, /* 'I' */
-    [0x4a] = {0x00, 0x06, 0x06, 0x06, 0x06, 0xc6, 0x7c, 0x00}, /* 'J' */
-    [0x4b] = {0x00, 0xcc, 0xd8, 0xf0, 0xd8, 0xcc, 0xc6, 0x00}, /* 'K' */
-    [0x4c] = {0x00, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xfe, 0x00}, /* 'L' */
-    [0x4d] = {0x00, 0xc6, 0xee, 0xd6, 0xd6, 0xc6, 0xc6, 0x00}, /* 'M' */
-    [0x4e] = {0x00, 0xc6, 0xe6, 0xf6, 0xde, 0xce, 0xc6, 0x00}, /* 'N' */
-    [0x4f] = {0x00, 0x7c, 0xc6, 0xc6, 0xc6, 0xc6, 0x7c, 0x00}, /* 'O' */
-    [0x50] = {0x00, 0xfc, 0xc6, 0xc6, 0xfc, 0xc0, 0xc0, 0x00}, /* 'P' */
-    [0x51] = {0x00, 0x7c, 0xc6, 0xc6, 0xd6, 0xce, 0x7c, 0x00}, /* 'Q' */
-    [0x52] = {0x00, 0xfc, 0xc6, 0xc6, 0xfc, 0xcc, 0xc6, 0x00}, /* 'R' */
-    [0x53] = {0x00, 0x7c, 0xc0, 0x7c, 0x06, 0xc6, 0x7c, 0x00}, /* 'S' */
-    [0x54] = {0x00, 0x7e, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00}, /* 'T' */
-    [0x55] = {0x00, 0xc6, 0xc6, 0xc6, 0xc6, 0xc6, 0x7c, 0x00}, /* 'U' */
-    [0x56] = {0x00, 0xc6, 0xc6, 0xc6, 0xc6, 0x6c, 0x38, 0x00}, /* 'V' */
-    [0x57] = {0x00, 0xc6, 0xc6, 0xc6, 0xd6, 0xfe, 0x6c, 0x00}, /* 'W' */
-    [0x58] = {0x00, 0xc6, 0x6c, 0x38, 0x38, 0x6c, 0xc6, 0x00}, /* 'X' */
-    [0x59] = {0x00, 0x66, 0x66, 0x3c, 0x18, 0x18, 0x18, 0x00}, /* 'Y' */
-    [0x5a] = {0x00, 0xfe, 0x0c, 0x18, 0x30, 0x60, 0xfe, 0x00}, /* 'Z' */
+    0x41, 0x7e, 0x7c, 0xc6, 0xc6, 0xfe, 0xc6, 0xc6, /* 'A' */
+    0x42, 0x7e, 0xfc, 0xc6, 0xfc, 0xc6, 0xc6, 0xfc, /* 'B' */
+    0x43, 0x7e, 0x7c, 0xc6, 0xc0, 0xc0, 0xc6, 0x7c, /* 'C' */
+    0x44, 0x7e, 0xf8, 0xcc, 0xc6, 0xc6, 0xcc, 0xf8, /* 'D' */
+    0x45, 0x7e, 0xfe, 0xc0, 0xf8, 0xc0, 0xc0, 0xfe, /* 'E' */
+    0x46, 0x7e, 0xfe, 0xc0, 0xf8, 0xc0, 0xc0, 0xc0, /* 'F' */
+    0x47, 0x7e, 0x7c, 0xc6, 0xc0, 0xde, 0xc6, 0x7c, /* 'G' */
+    0x48, 0x7e, 0xc6, 0xc6, 0xfe, 0xc6, 0xc6, 0xc6, /* 'H' */
+    0x49, 0x7e, 0x7e, 0x18, 0x18, 0x18, 0x18, 0x7e, /* 'I' */
+    0x4a, 0x7e, 0x06, 0x06, 0x06, 0x06, 0xc6, 0x7c, /* 'J' */
+    0x4b, 0x7e, 0xcc, 0xd8, 0xf0, 0xd8, 0xcc, 0xc6, /* 'K' */
+    0x4c, 0x7e, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xfe, /* 'L' */
+    0x4d, 0x7e, 0xc6, 0xee, 0xd6, 0xd6, 0xc6, 0xc6, /* 'M' */
+    0x4e, 0x7e, 0xc6, 0xe6, 0xf6, 0xde, 0xce, 0xc6, /* 'N' */
+    0x4f, 0x7e, 0x7c, 0xc6, 0xc6, 0xc6, 0xc6, 0x7c, /* 'O' */
+    0x50, 0x7e, 0xfc, 0xc6, 0xc6, 0xfc, 0xc0, 0xc0, /* 'P' */
+    0x51, 0x7e, 0x7c, 0xc6, 0xc6, 0xd6, 0xce, 0x7c, /* 'Q' */
+    0x52, 0x7e, 0xfc, 0xc6, 0xc6, 0xfc, 0xcc, 0xc6, /* 'R' */
+    0x53, 0x7e, 0x7c, 0xc0, 0x7c, 0x06, 0xc6, 0x7c, /* 'S' */
+    0x54, 0x7e, 0x7e, 0x18, 0x18, 0x18, 0x18, 0x18, /* 'T' */
+    0x55, 0x7e, 0xc6, 0xc6, 0xc6, 0xc6, 0xc6, 0x7c, /* 'U' */
+    0x56, 0x7e, 0xc6, 0xc6, 0xc6, 0xc6, 0x6c, 0x38, /* 'V' */
+    0x57, 0x7e, 0xc6, 0xc6, 0xc6, 0xd6, 0xfe, 0x6c, /* 'W' */
+    0x58, 0x7e, 0xc6, 0x6c, 0x38, 0x38, 0x6c, 0xc6, /* 'X' */
+    0x59, 0x7e, 0x66, 0x66, 0x3c, 0x18, 0x18, 0x18, /* 'Y' */
+    0x5a, 0x7e, 0xfe, 0x0c, 0x18, 0x30, 0x60, 0xfe, /* 'Z' */
     // Symbols
-    [0x5b] = {0x00, 0x3c, 0x30, 0x30, 0x30, 0x30, 0x3c, 0x00}, /* '[' */
-    [0x5c] = {0x00, 0xc0, 0x60, 0x30, 0x18, 0x0c, 0x06, 0x00}, /* '\' */
-    [0x5d] = {0x00, 0x3c, 0x0c, 0x0c, 0x0c, 0x0c, 0x3c, 0x00}, /* ']' */
-    [0x5e] = {0x00, 0x18, 0x3c, 0x5a, 0x18, 0x18, 0x18, 0x00}, /* '^' */
-    [0x5f] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff}, /* '_' */
-    [0x60] = {0x00, 0x18, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00}, /* '`' */
+    0x5b, 0x7e, 0x3c, 0x30, 0x30, 0x30, 0x30, 0x3c, /* '[' */
+    0x5c, 0x7e, 0xc0, 0x60, 0x30, 0x18, 0x0c, 0x06, /* '\' */
+    0x5d, 0x7e, 0x3c, 0x0c, 0x0c, 0x0c, 0x0c, 0x3c, /* ']' */
+    0x5e, 0x7e, 0x18, 0x3c, 0x5a, 0x18, 0x18, 0x18, /* '^' */
+    0x5f, 0x01, 0xff, /* '_' */
+    0x60, 0x60, 0x18, 0x0c, /* '`' */
     // Lowercase letters
-    [0x61] = {0x00, 0x00, 0x3c, 0x06, 0x3e, 0x66, 0x3e, 0x00}, /* 'a' */
-    [0x62] = {0x00, 0x60, 0x60, 0x7c, 0x66, 0x66, 0x7c, 0x00}, /* 'b' */
-    [0x63] = {0x00, 0x00, 0x3c, 0x60, 0x60, 0x60, 0x3c, 0x00}, /* 'c' */
-    [0x64] = {0x00, 0x06, 0x06, 0x3e, 0x66, 0x66, 0x3e, 0x00}, /* 'd' */
-    [0x65] = {0x00, 0x00, 0x3c, 0x66, 0x7c, 0x60, 0x3e, 0x00}, /* 'e' */
-    [0x66] = {0x00, 0x0e, 0x18, 0x1c, 0x18, 0x18, 0x18, 0x00}, /* 'f' */
-    [0x67] = {0x00, 0x00, 0x3e, 0x66, 0x66, 0x3e, 0x06, 0x3c}, /* 'g' */
-    [0x68] = {0x00, 0x60, 0x60, 0x7c, 0x66, 0x66, 0x66, 0x00}, /* 'h' */
-    [0x69] = {0x00, 0x18, 0x00, 0x38, 0x18, 0x18, 0x3c, 0x00}, /* 'i' */
-    [0x6a] = {0x00, 0x06, 0x00, 0x06, 0x06, 0x06, 0x36, 0x1c}, /* 'j' */
-    [0x6b] = {0x00, 0x60, 0x6c, 0x78, 0x78, 0x6c, 0x66, 0x00}, /* 'k' */
-    [0x6c] = {0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x0c, 0x00}, /* 'l' */
-    [0x6d] = {0x00, 0x00, 0xfc, 0xd6, 0xd6, 0xd6, 0xd6, 0x00}, /* 'm' */
-    [0x6e] = {0x00, 0x00, 0x7c, 0x66, 0x66, 0x66, 0x66, 0x00}, /* 'n' */
-    [0x6f] = {0x00, 0x00, 0x3c, 0x66, 0x66, 0x66, 0x3c, 0x00}, /* 'o' */
-    [0x70] = {0x00, 0x00, 0x7c, 0x66, 0x66, 0x7c, 0x60, 0x60}, /* 'p' */
-    [0x71] = {0x00, 0x00, 0x3e, 0x66, 0x66, 0x3e, 0x06, 0x07}, /* 'q' */
-    [0x72] = {0x00, 0x00, 0x3c, 0x60, 0x60, 0x60, 0x60, 0x00}, /* 'r' */
-    [0x73] = {0x00, 0x00, 0x3c, 0x60, 0x3c, 0x06, 0x7c, 0x00}, /* 's' */
-    [0x74] = {0x00, 0x18, 0x3c, 0x18, 0x18, 0x18, 0x0c, 0x00}, /* 't' */
-    [0x75] = {0x00, 0x00, 0x66, 0x66, 0x66, 0x66, 0x3c, 0x00}, /* 'u' */
-    [0x76] = {0x00, 0x00, 0x66, 0x66, 0x66, 0x3c, 0x18, 0x00}, /* 'v' */
-    [0x77] = {0x00, 0x00, 0xd6, 0xd6, 0xd6, 0xd6, 0x7c, 0x00}, /* 'w' */
-    [0x78] = {0x00, 0x00, 0x66, 0x3c, 0x18, 0x3c, 0x66, 0x00}, /* 'x' */
-    [0x79] = {0x00, 0x00, 0x66, 0x66, 0x66, 0x3e, 0x06, 0x3c}, /* 'y' */
-    [0x7a] = {0x00, 0x00, 0x7e, 0x0c, 0x18, 0x30, 0x7e, 0x00}, /* 'z' */
+    0x61, 0x3e, 0x3c, 0x06, 0x3e, 0x66, 0x3e, /* 'a' */
+    0x62, 0x7e, 0x60, 0x60, 0x7c, 0x66, 0x66, 0x7c, /* 'b' */
+    0x63, 0x3e, 0x3c, 0x60, 0x60, 0x60, 0x3c, /* 'c' */
+    0x64, 0x7e, 0x06, 0x06, 0x3e, 0x66, 0x66, 0x3e, /* 'd' */
+    0x65, 0x3e, 0x3c, 0x66, 0x7c, 0x60, 0x3e, /* 'e' */
+    0x66, 0x7e, 0x0e, 0x18, 0x1c, 0x18, 0x18, 0x18, /* 'f' */
+    0x67, 0x3f, 0x3e, 0x66, 0x66, 0x3e, 0x06, 0x3c, /* 'g' */
+    0x68, 0x7e, 0x60, 0x60, 0x7c, 0x66, 0x66, 0x66, /* 'h' */
+    0x69, 0x5e, 0x18, 0x38, 0x18, 0x18, 0x3c, /* 'i' */
+    0x6a, 0x5f, 0x06, 0x06, 0x06, 0x06, 0x36, 0x1c, /* 'j' */
+    0x6b, 0x7e, 0x60, 0x6c, 0x78, 0x78, 0x6c, 0x66, /* 'k' */
+    0x6c, 0x7e, 0x18, 0x18, 0x18, 0x18, 0x18, 0x0c, /* 'l' */
+    0x6d, 0x3e, 0xfc, 0xd6, 0xd6, 0xd6, 0xd6, /* 'm' */
+    0x6e, 0x3e, 0x7c, 0x66, 0x66, 0x66, 0x66, /* 'n' */
+    0x6f, 0x3e, 0x3c, 0x66, 0x66, 0x66, 0x3c, /* 'o' */
+    0x70, 0x3f, 0x7c, 0x66, 0x66, 0x7c, 0x60, 0x60, /* 'p' */
+    0x71, 0x3f, 0x3e, 0x66, 0x66, 0x3e, 0x06, 0x07, /* 'q' */
+    0x72, 0x3e, 0x3c, 0x60, 0x60, 0x60, 0x60, /* 'r' */
+    0x73, 0x3e, 0x3c, 0x60, 0x3c, 0x06, 0x7c, /* 's' */
+    0x74, 0x7e, 0x18, 0x3c, 0x18, 0x18, 0x18, 0x0c, /* 't' */
+    0x75, 0x3e, 0x66, 0x66, 0x66, 0x66, 0x3c, /* 'u' */
+    0x76, 0x3e, 0x66, 0x66, 0x66, 0x3c, 0x18, /* 'v' */
+    0x77, 0x3e, 0xd6, 0xd6, 0xd6, 0xd6, 0x7c, /* 'w' */
+    0x78, 0x3e, 0x66, 0x3c, 0x18, 0x3c, 0x66, /* 'x' */
+    0x79, 0x3f, 0x66, 0x66, 0x66, 0x3e, 0x06, 0x3c, /* 'y' */
+    0x7a, 0x3e, 0x7e, 0x0c, 0x18, 0x30, 0x7e, /* 'z' */
     // Symbols
-    [0x7b] = {0x00, 0x1c, 0x18, 0x30, 0x18, 0x18, 0x1c, 0x00}, /* '{' */
-    [0x7c] = {0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00}, /* '|' */
-    [0x7d] = {0x00, 0x38, 0x18, 0x0c, 0x18, 0x18, 0x38, 0x00}, /* '}' */
-    [0x7e] = {0x00, 0x34, 0x58, 0x00, 0x00, 0x00, 0x00, 0x00}, /* '~' */
-    [0x7f] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, /* DEL */
+    0x7b, 0x7e, 0x1c, 0x18, 0x30, 0x18, 0x18, 0x1c, /* '{' */
+    0x7c, 0x7e, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, /* '|' */
+    0x7d, 0x7e, 0x38, 0x18, 0x0c, 0x18, 0x18, 0x38, /* '}' */
+    0x7e, 0x60, 0x34, 0x58, /* '~' */
+    0x7f, 0x00, /* DEL */
     // Cyrillic Uppercase letters
-    [0x80] = {0x00, 0x7c, 0xc6, 0xc6, 0xfe, 0xc6, 0xc6, 0x00}, /* 'А' */
-    [0x81] = {0x00, 0xfe, 0xc0, 0xfc, 0xc6, 0xc6, 0xfc, 0x00}, /* 'Б' */
-    [0x82] = {0x00, 0xfc, 0xc6, 0xfc, 0xc6, 0xc6, 0xfc, 0x00}, /* 'В' */
-    [0x83] = {0x00, 0x7e, 0x60, 0x60, 0x60, 0x60, 0x60, 0x00}, /* 'Г' */
-    [0x84] = {0x00, 0x3c, 0x6c, 0x6c, 0x6c, 0x6c, 0xfe, 0xc6}, /* 'Д' */
-    [0x85] = {0x00, 0xfe, 0xc0, 0xf8, 0xc0, 0xc0, 0xfe, 0x00}, /* 'Е' */
-    [0x86] = {0x00, 0xd6, 0xd6, 0x7c, 0xd6, 0xd6, 0xd6, 0x00}, /* 'Ж' */
-    [0x87] = {0x00, 0x7c, 0xc6, 0x1c, 0x06, 0xc6, 0x7c, 0x00}, /* 'З' */
-    [0x88] = {0x00, 0xc6, 0xce, 0xde, 0xf6, 0xe6, 0xc6, 0x00}, /* 'И' */
-    [0x89] = {0x38, 0xc6, 0xce, 0xde, 0xf6, 0xe6, 0xc6, 0x00}, /* 'Й' */
-    [0x8a] = {0x00, 0xcc, 0xd8, 0xf0, 0xd8, 0xcc, 0xc6, 0x00}, /* 'К' */
-    [0x8b] = {0x00, 0x3e, 0x66, 0x66, 0x66, 0x66, 0xc6, 0x00}, /* 'Л' */
-    [0x8c] = {0x00, 0xc6, 0xee, 0xd6, 0xd6, 0xc6, 0xc6, 0x00}, /* 'М' */
-    [0x8d] = {0x00, 0xc6, 0xc6, 0xfe, 0xc6, 0xc6, 0xc6, 0x00}, /* 'Н' */
-    [0x8e] = {0x00, 0x7c, 0xc6, 0xc6, 0xc6, 0xc6, 0x7c, 0x00}, /* 'О' */
-    [0x8f] = {0x00, 0xfe, 0xc6, 0xc6, 0xc6, 0xc6, 0xc6, 0x00}, /* 'П' */
-    [0x90] = {0x00, 0xfc, 0xc6, 0xc6, 0xfc, 0xc0, 0xc0, 0x00}, /* 'Р' */
-    [0x91] = {0x00, 0x7c, 0xc6, 0xc0, 0xc0, 0xc6, 0x7c, 0x00}, /* 'С' */
-    [0x92] = {0x00, 0x7e, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00}, /* 'Т' */
-    [0x93] = {0x00, 0xc6, 0xc6, 0xc6, 0x7e, 0x06, 0x7c, 0x00}, /* 'У' */
-    [0x94] = {0x00, 0x7c, 0xd6, 0xd6, 0xd6, 0x7c, 0x10, 0x00}, /* 'Ф' */
-    [0x95] = {0x00, 0xc6, 0x6c, 0x38, 0x38, 0x6c, 0xc6, 0x00}, /* 'Х' */
-    [0x96] = {0x00, 0xc6, 0xc6, 0xc6, 0xc6, 0xc6, 0xff, 0x03}, /* 'Ц' */
-    [0x97] = {0x00, 0xc6, 0xc6, 0xc6, 0x7e, 0x06, 0x06, 0x00}, /* 'Ч' */
-    [0x98] = {0x00, 0xd6, 0xd6, 0xd6, 0xd6, 0xd6, 0xfe, 0x00}, /* 'Ш' */
-    [0x99] = {0x00, 0xd6, 0xd6, 0xd6, 0xd6, 0xd6, 0xff, 0x03}, /* 'Щ' */
-    [0x9a] = {0x00, 0xe0, 0x60, 0x7c, 0x66, 0x66, 0x7c, 0x00}, /* 'Ъ' */
-    [0x9b] = {0x00, 0xc6, 0xc6, 0xe6, 0xd6, 0xd6, 0xe6, 0x00}, /* 'Ы' */
-    [0x9c] = {0x00, 0xc0, 0xc0, 0xf8, 0xcc, 0xcc, 0xf8, 0x00}, /* 'Ь' */
-    [0x9d] = {0x00, 0x7c, 0xc6, 0x1e, 0x06, 0xc6, 0x7c, 0x00}, /* 'Э' */
-    [0x9e] = {0x00, 0xcc, 0xd6, 0xf6, 0xd6, 0xd6, 0xcc, 0x00}, /* 'Ю' */
-    [0x9f] = {0x00, 0x7e, 0xc6, 0xc6, 0x7e, 0xc6, 0xc6, 0x00}, /* 'Я' */
+    0x80, 0x7e, 0x7c, 0xc6, 0xc6, 0xfe, 0xc6, 0xc6, /* 'А' */
+    0x81, 0x7e, 0xfe, 0xc0, 0xfc, 0xc6, 0xc6, 0xfc, /* 'Б' */
+    0x82, 0x7e, 0xfc, 0xc6, 0xfc, 0xc6, 0xc6, 0xfc, /* 'В' */
+    0x83, 0x7e, 0x7e, 0x60, 0x60, 0x60, 0x60, 0x60, /* 'Г' */
+    0x84, 0x7f, 0x3c, 0x6c, 0x6c, 0x6c, 0x6c, 0xfe, 0xc6, /* 'Д' */
+    0x85, 0x7e, 0xfe, 0xc0, 0xf8, 0xc0, 0xc0, 0xfe, /* 'Е' */
+    0x86, 0x7e, 0xd6, 0xd6, 0x7c, 0xd6, 0xd6, 0xd6, /* 'Ж' */
+    0x87, 0x7e, 0x7c, 0xc6, 0x1c, 0x06, 0xc6, 0x7c, /* 'З' */
+    0x88, 0x7e, 0xc6, 0xce, 0xde, 0xf6, 0xe6, 0xc6, /* 'И' */
+    0x89, 0xfe, 0x38, 0xc6, 0xce, 0xde, 0xf6, 0xe6, 0xc6, /* 'Й' */
+    0x8a, 0x7e, 0xcc, 0xd8, 0xf0, 0xd8, 0xcc, 0xc6, /* 'К' */
+    0x8b, 0x7e, 0x3e, 0x66, 0x66, 0x66, 0x66, 0xc6, /* 'Л' */
+    0x8c, 0x7e, 0xc6, 0xee, 0xd6, 0xd6, 0xc6, 0xc6, /* 'М' */
+    0x8d, 0x7e, 0xc6, 0xc6, 0xfe, 0xc6, 0xc6, 0xc6, /* 'Н' */
+    0x8e, 0x7e, 0x7c, 0xc6, 0xc6, 0xc6, 0xc6, 0x7c, /* 'О' */
+    0x8f, 0x7e, 0xfe, 0xc6, 0xc6, 0xc6, 0xc6, 0xc6, /* 'П' */
+    0x90, 0x7e, 0xfc, 0xc6, 0xc6, 0xfc, 0xc0, 0xc0, /* 'Р' */
+    0x91, 0x7e, 0x7c, 0xc6, 0xc0, 0xc0, 0xc6, 0x7c, /* 'С' */
+    0x92, 0x7e, 0x7e, 0x18, 0x18, 0x18, 0x18, 0x18, /* 'Т' */
+    0x93, 0x7e, 0xc6, 0xc6, 0xc6, 0x7e, 0x06, 0x7c, /* 'У' */
+    0x94, 0x7e, 0x7c, 0xd6, 0xd6, 0xd6, 0x7c, 0x10, /* 'Ф' */
+    0x95, 0x7e, 0xc6, 0x6c, 0x38, 0x38, 0x6c, 0xc6, /* 'Х' */
+    0x96, 0x7f, 0xc6, 0xc6, 0xc6, 0xc6, 0xc6, 0xff, 0x03, /* 'Ц' */
+    0x97, 0x7e, 0xc6, 0xc6, 0xc6, 0x7e, 0x06, 0x06, /* 'Ч' */
+    0x98, 0x7e, 0xd6, 0xd6, 0xd6, 0xd6, 0xd6, 0xfe, /* 'Ш' */
+    0x99, 0x7f, 0xd6, 0xd6, 0xd6, 0xd6, 0xd6, 0xff, 0x03, /* 'Щ' */
+    0x9a, 0x7e, 0xe0, 0x60, 0x7c, 0x66, 0x66, 0x7c, /* 'Ъ' */
+    0x9b, 0x7e, 0xc6, 0xc6, 0xe6, 0xd6, 0xd6, 0xe6, /* 'Ы' */
+    0x9c, 0x7e, 0xc0, 0xc0, 0xf8, 0xcc, 0xcc, 0xf8, /* 'Ь' */
+    0x9d, 0x7e, 0x7c, 0xc6, 0x1e, 0x06, 0xc6, 0x7c, /* 'Э' */
+    0x9e, 0x7e, 0xcc, 0xd6, 0xf6, 0xd6, 0xd6, 0xcc, /* 'Ю' */
+    0x9f, 0x7e, 0x7e, 0xc6, 0xc6, 0x7e, 0xc6, 0xc6, /* 'Я' */
     // Cyrillic lowercase letters
-    [0xa0] = {0x00, 0x00, 0x3c, 0x06, 0x3e, 0x46, 0x3e, 0x00}, /* 'а' */
-    [0xa1] = {0x3e, 0x60, 0x3c, 0x66, 0x66, 0x66, 0x3c, 0x00}, /* 'б' */
-    [0xa2] = {0x00, 0x00, 0x7c, 0x66, 0x7c, 0x66, 0x7c, 0x00}, /* 'в' */
-    [0xa3] = {0x00, 0x00, 0x7c, 0x60, 0x60, 0x60, 0x60, 0x00}, /* 'г' */
-    [0xa4] = {0x00, 0x00, 0x3c, 0x6c, 0x6c, 0x6c, 0xfe, 0xc6}, /* 'д' */
-    [0xa5] = {0x00, 0x00, 0x3c, 0x66, 0x7c, 0x60, 0x3e, 0x00}, /* 'е' */
-    [0xa6] = {0x00, 0x00, 0xd6, 0xd6, 0x7c, 0xd6, 0xd6, 0x00}, /* 'ж' */
-    [0xa7] = {0x00, 0x00, 0x7c, 0x06, 0x1c, 0x06, 0x7c, 0x00}, /* 'з' */
-    [0xa8] = {0x00, 0x00, 0x66, 0x6e, 0x7e, 0x76, 0x66, 0x00}, /* 'и' */
-    [0xa9] = {0x18, 0x00, 0x66, 0x6e, 0x7e, 0x76, 0x66, 0x00}, /* 'й' */
-    [0xaa] = {0x00, 0x00, 0x66, 0x6c, 0x78, 0x6c, 0x66, 0x00}, /* 'к' */
-    [0xab] = {0x00, 0x00, 0x1e, 0x36, 0x66, 0x66, 0x66, 0x00}, /* 'л' */
-    [0xac] = {0x00, 0x00, 0xc6, 0xee, 0xd6, 0xc6, 0xc6, 0x00}, /* 'м' */
-    [0xad] = {0x00, 0x00, 0x66, 0x66, 0x7e, 0x66, 0x66, 0x00}, /* 'н' */
-    [0xae] = {0x00, 0x00, 0x3c, 0x66, 0x66, 0x66, 0x3c, 0x00}, /* 'о' */
-    [0xaf] = {0x00, 0x00, 0x7e, 0x66, 0x66, 0x66, 0x66, 0x00}, /* 'п' */
+    0xa0, 0x3e, 0x3c, 0x06, 0x3e, 0x46, 0x3e, /* 'а' */
+    0xa1, 0xfe, 0x3e, 0x60, 0x3c, 0x66, 0x66, 0x66, 0x3c, /* 'б' */
+    0xa2, 0x3e, 0x7c, 0x66, 0x7c, 0x66, 0x7c, /* 'в' */
+    0xa3, 0x3e, 0x7c, 0x60, 0x60, 0x60, 0x60, /* 'г' */
+    0xa4, 0x3f, 0x3c, 0x6c, 0x6c, 0x6c, 0xfe, 0xc6, /* 'д' */
+    0xa5, 0x3e, 0x3c, 0x66, 0x7c, 0x60, 0x3e, /* 'е' */
+    0xa6, 0x3e, 0xd6, 0xd6, 0x7c, 0xd6, 0xd6, /* 'ж' */
+    0xa7, 0x3e, 0x7c, 0x06, 0x1c, 0x06, 0x7c, /* 'з' */
+    0xa8, 0x3e, 0x66, 0x6e, 0x7e, 0x76, 0x66, /* 'и' */
+    0xa9, 0xbe, 0x18, 0x66, 0x6e, 0x7e, 0x76, 0x66, /* 'й' */
+    0xaa, 0x3e, 0x66, 0x6c, 0x78, 0x6c, 0x66, /* 'к' */
+    0xab, 0x3e, 0x1e, 0x36, 0x66, 0x66, 0x66, /* 'л' */
+    0xac, 0x3e, 0xc6, 0xee, 0xd6, 0xc6, 0xc6, /* 'м' */
+    0xad, 0x3e, 0x66, 0x66, 0x7e, 0x66, 0x66, /* 'н' */
+    0xae, 0x3e, 0x3c, 0x66, 0x66, 0x66, 0x3c, /* 'о' */
+    0xaf, 0x3e, 0x7e, 0x66, 0x66, 0x66, 0x66, /* 'п' */
     // Box drawing characters
-    [0xb3] = {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18}, /* '│' */
-    [0xba] = {0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66}, /* '║' */
-    [0xbb] = {0x00, 0xfe, 0xfe, 0x06, 0x06, 0xe6, 0xe6, 0x66}, /* '╗' */
-    [0xbc] = {0x66, 0xe6, 0xe6, 0x06, 0x06, 0xfe, 0xfe, 0x00}, /* '╝' */
-    [0xbf] = {0x00, 0x00, 0x00, 0xf8, 0xf8, 0x18, 0x18, 0x18}, /* '┐' */
-    [0xc0] = {0x18, 0x18, 0x18, 0x1f, 0x1f, 0x00, 0x00, 0x00}, /* '└' */
-    [0xc4] = {0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0x00}, /* '─' */
-    [0xc8] = {0x66, 0x67, 0x67, 0x60, 0x60, 0x7f, 0x7f, 0x00}, /* '╚' */
-    [0xc9] = {0x00, 0x7f, 0x7f, 0x60, 0x60, 0x67, 0x67, 0x66}, /* '╔' */
-    [0xcd] = {0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0x00}, /* '═' */
-    [0xd9] = {0x18, 0x18, 0x18, 0xf8, 0xf8, 0x00, 0x00, 0x00}, /* '┘' */
-    [0xda] = {0x00, 0x00, 0x00, 0x1f, 0x1f, 0x18, 0x18, 0x18}, /* '┌' */
+    0xb3, 0xff, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, /* '│' */
+    0xba, 0xff, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, /* '║' */
+    0xbb, 0x7f, 0xfe, 0xfe, 0x06, 0x06, 0xe6, 0xe6, 0x66, /* '╗' */
+    0xbc, 0xfe, 0x66, 0xe6, 0xe6, 0x06, 0x06, 0xfe, 0xfe, /* '╝' */
+    0xbf, 0x1f, 0xf8, 0xf8, 0x18, 0x18, 0x18, /* '┐' */
+    0xc0, 0xf8, 0x18, 0x18, 0x18, 0x1f, 0x1f, /* '└' */
+    0xc4, 0x18, 0xff, 0xff, /* '─' */
+    0xc8, 0xfe, 0x66, 0x67, 0x67, 0x60, 0x60, 0x7f, 0x7f, /* '╚' */
+    0xc9, 0x7f, 0x7f, 0x7f, 0x60, 0x60, 0x67, 0x67, 0x66, /* '╔' */
+    0xcd, 0x66, 0xff, 0xff, 0xff, 0xff, /* '═' */
+    0xd9, 0xf8, 0x18, 0x18, 0x18, 0xf8, 0xf8, /* '┘' */
+    0xda, 0x1f, 0x1f, 0x1f, 0x18, 0x18, 0x18, /* '┌' */
     // Cyrillic lowercase letters (continued)
-    [0xe0] = {0x00, 0x00, 0x7c, 0x66, 0x66, 0x7c, 0x60, 0x60}, /* 'р' */
-    [0xe1] = {0x00, 0x00, 0x3c, 0x60, 0x60, 0x60, 0x3c, 0x00}, /* 'с' */
-    [0xe2] = {0x00, 0x00, 0x7e, 0x18, 0x18, 0x18, 0x18, 0x00}, /* 'т' */
-    [0xe3] = {0x00, 0x00, 0x66, 0x66, 0x66, 0x3e, 0x06, 0x3c}, /* 'у' */
-    [0xe4] = {0x00, 0x10, 0x7c, 0xd6, 0xd6, 0xd6, 0x7c, 0x10}, /* 'ф' */
-    [0xe5] = {0x00, 0x00, 0x66, 0x3c, 0x18, 0x3c, 0x66, 0x00}, /* 'х' */
-    [0xe6] = {0x00, 0x00, 0x66, 0x66, 0x66, 0x66, 0x7f, 0x03}, /* 'ц' */
-    [0xe7] = {0x00, 0x00, 0x66, 0x66, 0x3e, 0x06, 0x06, 0x00}, /* 'ч' */
-    [0xe8] = {0x00, 0x00, 0xd6, 0xd6, 0xd6, 0xd6, 0xfe, 0x00}, /* 'ш' */
-    [0xe9] = {0x00, 0x00, 0xd6, 0xd6, 0xd6, 0xd6, 0xff, 0x03}, /* 'щ' */
-    [0xea] = {0x00, 0x00, 0xe0, 0x60, 0x7c, 0x66, 0x7c, 0x00}, /* 'ъ' */
-    [0xeb] = {0x00, 0x00, 0xc6, 0xc6, 0xe6, 0xd6, 0xe6, 0x00}, /* 'ы' */
-    [0xec] = {0x00, 0x00, 0x60, 0x60, 0x7c, 0x66, 0x7c, 0x00}, /* 'ь' */
-    [0xed] = {0x00, 0x00, 0x3c, 0x46, 0x1e, 0x46, 0x3c, 0x00}, /* 'э' */
-    [0xee] = {0x00, 0x00, 0xcc, 0xd6, 0xf6, 0xd6, 0xcc, 0x00}, /* 'ю' */
-    [0xef] = {0x00, 0x00, 0x3e, 0x66, 0x3e, 0x36, 0x66, 0x00}, /* 'я' */
-    [0xf0] = {0x44, 0xfe, 0xc0, 0xf8, 0xc0, 0xc0, 0xfe, 0x00}, /* 'Ё' */
-    [0xf1] = {0x24, 0x00, 0x3c, 0x66, 0x7c, 0x60, 0x3e, 0x00}, /* 'ё' */
+    0xe0, 0x3f, 0x7c, 0x66, 0x66, 0x7c, 0x60, 0x60, /* 'р' */
+    0xe1, 0x3e, 0x3c, 0x60, 0x60, 0x60, 0x3c, /* 'с' */
+    0xe2, 0x3e, 0x7e, 0x18, 0x18, 0x18, 0x18, /* 'т' */
+    0xe3, 0x3f, 0x66, 0x66, 0x66, 0x3e, 0x06, 0x3c, /* 'у' */
+    0xe4, 0x7f, 0x10, 0x7c, 0xd6, 0xd6, 0xd6, 0x7c, 0x10, /* 'ф' */
+    0xe5, 0x3e, 0x66, 0x3c, 0x18, 0x3c, 0x66, /* 'х' */
+    0xe6, 0x3f, 0x66, 0x66, 0x66, 0x66, 0x7f, 0x03, /* 'ц' */
+    0xe7, 0x3e, 0x66, 0x66, 0x3e, 0x06, 0x06, /* 'ч' */
+    0xe8, 0x3e, 0xd6, 0xd6, 0xd6, 0xd6, 0xfe, /* 'ш' */
+    0xe9, 0x3f, 0xd6, 0xd6, 0xd6, 0xd6, 0xff, 0x03, /* 'щ' */
+    0xea, 0x3e, 0xe0, 0x60, 0x7c, 0x66, 0x7c, /* 'ъ' */
+    0xeb, 0x3e, 0xc6, 0xc6, 0xe6, 0xd6, 0xe6, /* 'ы' */
+    0xec, 0x3e, 0x60, 0x60, 0x7c, 0x66, 0x7c, /* 'ь' */
+    0xed, 0x3e, 0x3c, 0x46, 0x1e, 0x46, 0x3c, /* 'э' */
+    0xee, 0x3e, 0xcc, 0xd6, 0xf6, 0xd6, 0xcc, /* 'ю' */
+    0xef, 0x3e, 0x3e, 0x66, 0x3e, 0x36, 0x66, /* 'я' */
+    0xf0, 0xfe, 0x44, 0xfe, 0xc0, 0xf8, 0xc0, 0xc0, 0xfe, /* 'Ё' */
+    0xf1, 0xbe, 0x24, 0x3c, 0x66, 0x7c, 0x60, 0x3e, /* 'ё' */
 };
\ No newline at end of file
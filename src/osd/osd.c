@@ -3,9 +3,11 @@
 
 #include "hardware/timer.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
 
 #include "g_config.h"
 #include "osd.h"
+#include "osd_layers.h"
 #include "font.h"
 
 #ifdef OSD_FF_ENABLE
@@ -24,9 +26,13 @@
 #define REPEAT_DELAY_US 400000  // 400ms initial repeat delay
 #define REPEAT_RATE_US 80000    // 80ms repeat rate
 
+extern settings_t settings;
 extern video_mode_t video_mode;
 extern int16_t h_visible_area;
 extern int16_t v_margin;
+#ifdef DVI_HSTX_ENABLE
+extern video_out_type_t active_video_output;
+#endif
 
 osd_state_t osd_state = {
     .enabled = false,
@@ -48,9 +54,13 @@ osd_mode_t osd_mode = {
     .rows = OSD_ROWS,
     .border_enabled = true,
     .full_width = false,
+    .blend = OSD_BLEND_OPAQUE,
+    .scale = 1,
     .text_buffer_size = OSD_TEXT_BUFFER_SIZE};
 
+#ifndef OSD_CHARGEN_ENABLE
 uint8_t osd_buffer[OSD_BUFFER_SIZE];
+#endif
 char osd_text_buffer[OSD_TEXT_BUFFER_SIZE];
 uint8_t osd_text_colors[OSD_TEXT_BUFFER_SIZE];
 uint8_t osd_text_heights[OSD_ROWS];
@@ -58,12 +68,223 @@ uint8_t osd_text_heights[OSD_ROWS];
 osd_buttons_t osd_buttons = {0};
 static bool osd_buttons_block_until_release = false;
 
-const uint8_t (*osd_font)[8] = osd_font_style_1;
+typedef struct
+{
+    const uint8_t *packed;
+    uint16_t size;
+} osd_font_data_t;
+
+static const osd_font_data_t osd_fonts[OSD_FONTS] = {
+    [OSD_FONT_BOLD] = {osd_font_bold_packed, sizeof(osd_font_bold_packed)},
+    [OSD_FONT_ZX] = {osd_font_zx_packed, sizeof(osd_font_zx_packed)},
+};
+
+// Glyphs of the selected font, unpacked from flash by osd_set_font()
+// (with OSD_CHARGEN_ENABLE read by the video ISR: a font is unpacked into the other cache and swapped in)
+#ifdef OSD_CHARGEN_ENABLE
+#define OSD_FONT_CACHES 2
+#else
+#define OSD_FONT_CACHES 1
+#endif
+
+static uint8_t osd_font_caches[OSD_FONT_CACHES][256][OSD_FONT_HEIGHT];
+static uint8_t osd_font_cache; // the cache osd_font points to
+static uint8_t (*volatile osd_font)[OSD_FONT_HEIGHT] = osd_font_caches[0];
+static uint8_t osd_font_id = OSD_FONTS; // OSD_FONTS = none unpacked yet
+
+// Text grid as last rendered to osd_buffer, only changed cells are drawn again
+// (with OSD_CHARGEN_ENABLE the grid the character generator shows)
+static char osd_text_shadow[OSD_TEXT_BUFFER_SIZE];
+static uint8_t osd_colors_shadow[OSD_TEXT_BUFFER_SIZE];
+static uint8_t osd_font_shadow = OSD_FONTS; // OSD_FONTS forces a full render
+static uint8_t osd_columns_shadow;
+#ifndef OSD_CHARGEN_ENABLE
+static uint8_t osd_heights_shadow[OSD_ROWS];
+static uint16_t osd_width_shadow;
+static uint8_t osd_rows_shadow;
+#endif
+
+#ifdef OSD_CHARGEN_ENABLE
+#define OSD_CHARGEN_NO_ROW 0xFF
+
+uint8_t osd_chargen_line[OSD_WIDTH / 2];
+static uint8_t osd_chargen_pairs[256][4];    // packed colour, 2 font bits -> image byte
+static uint8_t osd_chargen_rows[OSD_HEIGHT]; // OSD line -> text row << 3 | glyph row
+
+static void osd_init_chargen_pairs()
+{
+    for (int color = 0; color < 256; color++)
+    {
+        uint8_t fg = color >> 4;
+        uint8_t bg = color & 0x0F;
+
+        // the left pixel (higher font bit) goes to the low nibble
+        for (int bits = 0; bits < 4; bits++)
+            osd_chargen_pairs[color][bits] = ((bits & 2) ? fg : bg) | (((bits & 1) ? fg : bg) << 4);
+    }
+
+    memset(osd_chargen_rows, OSD_CHARGEN_NO_ROW, sizeof(osd_chargen_rows));
+}
+
+static void __not_in_flash_func(osd_chargen_expand)(uint16_t line)
+{ // one OSD line from the published text grid, a glyph row is 4 image bytes
+    uint8_t *dst = osd_chargen_line;
+    uint8_t row_line = line < OSD_HEIGHT ? osd_chargen_rows[line] : OSD_CHARGEN_NO_ROW;
+
+    if (row_line == OSD_CHARGEN_NO_ROW)
+    {
+        for (uint8_t x = 0; x < sizeof(osd_chargen_line); x++)
+            *dst++ = OSD_COLOR_BACKGROUND * 0x11;
+
+        return;
+    }
+
+    uint8_t columns = osd_columns_shadow;
+    uint16_t pos = (row_line >> 3) * columns;
+    uint8_t glyph_row = row_line & 7;
+    const uint8_t(*font)[OSD_FONT_HEIGHT] = osd_font;
+
+    for (uint8_t col = 0; col < columns; col++, pos++)
+    {
+        uint8_t bits = font[(uint8_t)osd_text_shadow[pos]][glyph_row];
+        const uint8_t *pairs = osd_chargen_pairs[osd_colors_shadow[pos]];
+
+        *dst++ = pairs[bits >> 6];
+        *dst++ = pairs[(bits >> 4) & 3];
+        *dst++ = pairs[(bits >> 2) & 3];
+        *dst++ = pairs[bits & 3];
+    }
+}
+
+void __not_in_flash_func(osd_chargen_prepare)(uint16_t scaled_y)
+{ // called by the line renderers before an OSD line is drawn
+    if (osd_state.visible && scaled_y >= osd_mode.start_y && scaled_y < osd_mode.end_y)
+        osd_chargen_expand((scaled_y - osd_mode.start_y) / osd_mode.scale);
+}
+#endif
+
+// Compositor tables for OSD_BLEND_KEY/OSD_BLEND_SHADE: pixel = osd | (image & osd_blend_keep[osd]),
+// OSD background pixels are 0 and take the image pixel under them
+static_assert(OSD_COLOR_BACKGROUND == 0, "the blend renderers OR the OSD byte over the image");
+
+static uint8_t osd_blend_keep_key[256];   // image pixel unchanged
+static uint8_t osd_blend_keep_shade[256]; // second pixel of each byte black
+const uint8_t *osd_blend_keep = osd_blend_keep_key;
+static uint8_t osd_blend_setting = OSD_BLEND_OPAQUE;
+
+static void osd_init_blend_tables()
+{
+    for (int i = 0; i < 256; i++)
+    {
+        osd_blend_keep_key[i] = (((i & 0x0F) == OSD_COLOR_BACKGROUND) ? 0x0F : 0) |
+                                (((i >> 4) == OSD_COLOR_BACKGROUND) ? 0xF0 : 0);
+        osd_blend_keep_shade[i] = osd_blend_keep_key[i] & 0x0F;
+    }
+}
+
+// The blend renderers do not fit the line time of the modes above VIDEO_MODE_BLEND_MAX
+// (docs/VGA_TIMINGS.md), the OSD is opaque there
+void osd_apply_blend()
+{
+    uint8_t blend = (settings.video_out_mode <= VIDEO_MODE_BLEND_MAX) ? osd_blend_setting : OSD_BLEND_OPAQUE;
+
+#ifdef DVI_HSTX_ENABLE
+    // nor on HSTX DVI when SCANLINES_DIM renders every line of a div 2 mode above VIDEO_MODE_BLEND_DIM_MAX
+    if (active_video_output == DVI && settings.scanlines_mode == SCANLINES_DIM && video_mode.div == 2 &&
+        settings.video_out_mode > VIDEO_MODE_BLEND_DIM_MAX)
+        blend = OSD_BLEND_OPAQUE;
+#endif
+
+    osd_blend_keep = (blend == OSD_BLEND_SHADE) ? osd_blend_keep_shade : osd_blend_keep_key;
+    osd_mode.blend = blend;
+}
+
+void osd_set_blend(uint8_t blend)
+{
+    osd_blend_setting = blend;
+    osd_apply_blend();
+}
+
+// OSD byte -> the two image bytes of the OSD at scale 2 (each pixel doubled)
+uint8_t osd_scale2[256][2];
+
+static void osd_init_scale_table()
+{
+    for (int i = 0; i < 256; i++)
+    {
+        osd_scale2[i][0] = (i & 0x0F) * 0x11;
+        osd_scale2[i][1] = (i >> 4) * 0x11;
+    }
+}
+
+uint8_t osd_get_scale(uint16_t width, uint16_t height)
+{ // the largest integer scale that fits a width x height pixel OSD in the image area of the mode
+    uint16_t v_display_lines = (video_mode.v_visible_area - 2 * v_margin) / video_mode.div;
+    uint8_t scale = 1;
+
+    while (scale < OSD_SCALE_MAX && (width / 2) * (scale + 1) <= h_visible_area && height * (scale + 1) <= v_display_lines)
+        scale++;
+
+    return scale;
+}
+
+// Font byte -> nibble mask of 8 pixels (0xF for set pixels, leftmost pixel in the low nibble)
+static uint32_t osd_glyph_masks[256];
+
+static void osd_init_glyph_masks()
+{
+    for (int i = 0; i < 256; i++)
+    {
+        uint32_t mask = 0;
+
+        for (int col = 0; col < OSD_FONT_WIDTH; col++)
+            if (i & (0x80 >> col))
+                mask |= 0xFu << (col * 4);
+
+        osd_glyph_masks[i] = mask;
+    }
+}
+
+void osd_set_font(uint8_t font)
+{ // Unpack a font into the glyph cache, the text is rendered again with it
+    if (font >= OSD_FONTS)
+        font = OSD_FONT_BOLD;
+
+    if (font == osd_font_id)
+        return;
+
+    const uint8_t *src = osd_fonts[font].packed;
+    const uint8_t *end = src + osd_fonts[font].size;
+    uint8_t cache = (osd_font_cache + 1) % OSD_FONT_CACHES;
+    uint8_t (*glyphs)[OSD_FONT_HEIGHT] = osd_font_caches[cache];
+
+    memset(glyphs, 0, sizeof(osd_font_caches[0]));
+
+    while (src < end)
+    {
+        uint8_t *glyph = glyphs[*src++];
+        uint8_t row_mask = *src++;
+
+        for (int row = 0; row < OSD_FONT_HEIGHT; row++)
+            if (row_mask & (0x80 >> row))
+                glyph[row] = *src++;
+    }
+
+    __dmb(); // the glyphs before the cache that has them
+    osd_font = glyphs;
+    osd_font_cache = cache;
+    osd_font_id = font;
+}
 
 static void osd_clear_buffer()
-{ // Fill with background color (2 pixels per byte)
+{
+#ifndef OSD_CHARGEN_ENABLE
+    // Fill with background color (2 pixels per byte)
     uint8_t bg_color_pair = OSD_COLOR_BACKGROUND | (OSD_COLOR_BACKGROUND << 4);
     memset(osd_buffer, bg_color_pair, OSD_BUFFER_SIZE);
+#endif
+    // Text has to be rendered again
+    osd_font_shadow = OSD_FONTS;
 }
 
 static void osd_draw_border()
@@ -97,7 +318,7 @@ void osd_init()
 { // Initialize OSD state
     memset(&osd_state, 0, sizeof(osd_state));
 
-    osd_font = osd_font_style_1;
+    osd_set_font(OSD_FONT_ZX);
     osd_state.enabled = true;
     osd_state.needs_redraw = true;
     osd_state.text_updated = true;
@@ -105,6 +326,12 @@ void osd_init()
     osd_clear_text_buffer();
     // Clear overlay buffer
     osd_clear_buffer();
+    osd_init_glyph_masks();
+    osd_init_blend_tables();
+    osd_init_scale_table();
+#ifdef OSD_CHARGEN_ENABLE
+    osd_init_chargen_pairs();
+#endif
 
     // Initialize buttons
     osd_buttons_init();
@@ -154,8 +381,12 @@ void osd_set_position()
     }
 
     osd_mode.text_buffer_size = osd_mode.columns * osd_mode.rows;
+    osd_mode.scale = osd_get_scale(osd_mode.width, osd_mode.height);
+    osd_apply_blend();
 
-    uint16_t osd_half_w = osd_mode.width / 2;
+    // extents on the image are scaled, the buffer is not
+    uint16_t osd_half_w = osd_mode.width / 2 * osd_mode.scale;
+    uint16_t osd_lines = osd_mode.height * osd_mode.scale;
 
     switch (osd_mode.x)
     {
@@ -189,7 +420,7 @@ void osd_set_position()
     switch (osd_mode.y)
     {
     case 0: // Center vertically
-        osd_mode.start_y = (v_display_lines - osd_mode.height) / 2;
+        osd_mode.start_y = (v_display_lines - osd_lines) / 2;
         break;
 
     case 1: // Top
@@ -197,11 +428,11 @@ void osd_set_position()
         break;
 
     case 2: // Bottom
-        osd_mode.start_y = v_display_lines - osd_mode.height;
+        osd_mode.start_y = v_display_lines - osd_lines;
         break;
     }
 
-    osd_mode.end_y = osd_mode.start_y + osd_mode.height;
+    osd_mode.end_y = osd_mode.start_y + osd_lines;
 
     if (osd_mode.end_y > v_display_lines)
         osd_mode.end_y = v_display_lines;
@@ -339,32 +570,103 @@ void osd_text_printf(uint8_t row, uint8_t col, uint8_t fg_color, uint8_t bg_colo
     osd_text_print(row, col, temp, fg_color, bg_color, height);
 }
 
+// Draw one text cell: each glyph row is one 32-bit colour word written as 4 bytes (8 pixels)
+void osd_draw_cell(uint8_t *buffer, uint16_t stride, uint16_t buf_height, uint16_t x, uint16_t y,
+                   uint8_t c, uint8_t packed_color, uint8_t height)
+{
+    const uint8_t *char_data = osd_font[c];
+    uint32_t fg_word = ((packed_color >> 4) & 0x0F) * 0x11111111u;
+    uint32_t bg_word = (packed_color & 0x0F) * 0x11111111u;
+    uint8_t *dst = &buffer[y * stride + x / 2];
+    uint8_t height_multiplier = height ? 2 : 1;
+
+    for (int row = 0; row < OSD_FONT_HEIGHT; row++)
+    {
+        uint32_t mask = osd_glyph_masks[char_data[row]];
+        uint32_t pixels = (fg_word & mask) | (bg_word & ~mask);
+
+        for (int pixel_row = 0; pixel_row < height_multiplier; pixel_row++, y++)
+        {
+            if (y >= buf_height)
+                return;
+
+            dst[0] = pixels;
+            dst[1] = pixels >> 8;
+            dst[2] = pixels >> 16;
+            dst[3] = pixels >> 24;
+            dst += stride;
+        }
+    }
+}
+
+#ifdef OSD_CHARGEN_ENABLE
+void osd_render_text_to_buffer()
+{ // Publish the text grid to the character generator, nothing is rasterised here
+    memcpy(osd_text_shadow, osd_text_buffer, osd_mode.text_buffer_size);
+    memcpy(osd_colors_shadow, osd_text_colors, osd_mode.text_buffer_size);
+    osd_columns_shadow = osd_mode.columns;
+
+    // Double-height rows use each glyph row for 2 OSD lines and move all rows below them
+    uint16_t line = 0;
+
+    for (uint8_t row = 0; row < osd_mode.rows && line < osd_mode.height; row++)
+    {
+        uint8_t height_multiplier = osd_text_heights[row] ? 2 : 1;
+
+        for (uint8_t i = 0; i < OSD_FONT_HEIGHT * height_multiplier && line < osd_mode.height; i++)
+            osd_chargen_rows[line++] = (row << 3) | (i / height_multiplier);
+    }
+
+    for (; line < OSD_HEIGHT; line++)
+        osd_chargen_rows[line] = OSD_CHARGEN_NO_ROW;
+}
+#else
 void osd_render_text_to_buffer()
-{                          // Render text buffer to pixel buffer
+{ // Render changed cells of the text buffer to the pixel buffer
+    bool full_render = osd_font_id != osd_font_shadow ||
+                       osd_mode.width != osd_width_shadow ||
+                       osd_mode.columns != osd_columns_shadow ||
+                       osd_mode.rows != osd_rows_shadow;
+
+    osd_font_shadow = osd_font_id;
+    osd_width_shadow = osd_mode.width;
+    osd_columns_shadow = osd_mode.columns;
+    osd_rows_shadow = osd_mode.rows;
+
     uint16_t y_offset = 0; // Accumulated Y offset for double-height rows
 
     for (uint8_t row = 0; row < osd_mode.rows; row++)
     {
         uint8_t height = osd_text_heights[row];
 
+        // Row height change moves all rows below it
+        if (height != osd_heights_shadow[row])
+        {
+            osd_heights_shadow[row] = height;
+            full_render = true;
+        }
+
         for (uint8_t col = 0; col < osd_mode.columns; col++)
         {
             uint16_t pos = row * osd_mode.columns + col;
             uint8_t c = (uint8_t)osd_text_buffer[pos];
             uint8_t packed_color = osd_text_colors[pos];
-            uint8_t fg_color = (packed_color >> 4) & 0x0F;
-            uint8_t bg_color = packed_color & 0x0F;
 
-            uint16_t x = col * OSD_FONT_WIDTH;
-            uint16_t y = row * OSD_FONT_HEIGHT + y_offset;
+            if (!full_render && c == (uint8_t)osd_text_shadow[pos] && packed_color == osd_colors_shadow[pos])
+                continue;
+
+            osd_text_shadow[pos] = c;
+            osd_colors_shadow[pos] = packed_color;
 
-            osd_draw_char(osd_buffer, osd_mode.width, x, y, c, fg_color, bg_color, height);
+            osd_draw_cell(osd_buffer, osd_mode.width / 2, osd_mode.height,
+                          col * OSD_FONT_WIDTH, row * OSD_FONT_HEIGHT + y_offset, c, packed_color, height);
         }
         // Add extra vertical space for double-height rows
         if (height)
             y_offset += OSD_FONT_HEIGHT;
     }
 }
+#endif
 
 void osd_draw_char(uint8_t *buffer, uint16_t buf_width, uint16_t x, uint16_t y,
                    uint8_t c, uint8_t fg_color, uint8_t bg_color, uint8_t height)
@@ -407,7 +709,7 @@ void osd_draw_char(uint8_t *buffer, uint16_t buf_width, uint16_t x, uint16_t y,
     }
 }
 
-void osd_update()
+static void osd_update_main_layer()
 {
 #ifdef OSD_MENU_ENABLE
     // Menu OSD has higher priority
@@ -417,6 +719,7 @@ void osd_update()
     {
 #ifdef OSD_FF_ENABLE
         ff_osd_set_buttons(0);
+        ff_osd_invalidate();
 #endif
         return;
     }
@@ -427,6 +730,13 @@ void osd_update()
 #endif
 }
 
+void osd_update()
+{
+    osd_update_main_layer();
+    // Toast timeout and span list rebuild see the main layer as it will be shown
+    osd_layers_update();
+}
+
 void osd_buttons_init()
 {
 #ifndef HW_CONFIG_ENABLE
@@ -9,6 +9,7 @@
 #define OSD_COLUMNS (OSD_WIDTH / OSD_FONT_WIDTH)
 #define OSD_ROWS (OSD_HEIGHT / OSD_FONT_HEIGHT)
 #define OSD_TEXT_BUFFER_SIZE (OSD_COLUMNS * OSD_ROWS)
+#define OSD_SCALE_MAX 2 // largest integer OSD scale, see osd_get_scale()
 
 #define OSD_COLOR_BACKGROUND 0x0 // Black
 #define OSD_COLOR_TEXT 0xB       // Bright cyan
@@ -34,6 +35,8 @@ typedef struct
     uint8_t columns;
     bool border_enabled;
     bool full_width;
+    uint8_t blend; // osd_blend_mode_t, OSD_BLEND_KEY/SHADE ignore full_width, opaque above VIDEO_MODE_BLEND_MAX
+    uint8_t scale; // OSD pixel -> scale x scale image pixels, the OSD is opaque at scale 2
     uint16_t text_buffer_size;
 } osd_mode_t;
 
@@ -64,22 +67,41 @@ typedef struct
 extern osd_state_t osd_state;
 extern osd_mode_t osd_mode;
 extern osd_buttons_t osd_buttons;
-extern const uint8_t (*osd_font)[8];
+#ifdef OSD_CHARGEN_ENABLE
+extern uint8_t osd_chargen_line[OSD_WIDTH / 2]; // OSD line expanded by osd_chargen_prepare()
+#else
 extern uint8_t osd_buffer[OSD_BUFFER_SIZE];
+#endif
 extern char osd_text_buffer[OSD_TEXT_BUFFER_SIZE];    // Text buffer for content
 extern uint8_t osd_text_colors[OSD_TEXT_BUFFER_SIZE]; // High nibble: fg_color, Low nibble: bg_color
 extern uint8_t osd_text_heights[OSD_ROWS];            // 0 = normal height, 1 = double height (per row)
+extern const uint8_t *osd_blend_keep;                 // OSD byte -> image bits shown under its background pixels
+extern uint8_t osd_scale2[256][2];                    // OSD byte -> 2 image bytes at scale 2
 
 void osd_init();
 void osd_update(); // Main update function - handles both menu and FF OSD
 void osd_set_position();
+void osd_set_blend(uint8_t blend);
+void osd_apply_blend(); // the blend setting again, after the scanlines mode changed
+void osd_set_font(uint8_t font); // osd_font_id_t
+uint8_t osd_get_scale(uint16_t width, uint16_t height);
 void osd_show();
 void osd_hide();
 void osd_update_activity();
 
 void osd_clear_text_buffer();
-void osd_render_text_to_buffer(); // Render text buffer to OSD pixel buffer
+void osd_render_text_to_buffer(); // Render text buffer to OSD pixel buffer (publish it to the character generator)
 
+// pixels of an OSD line for the line renderers
+#ifdef OSD_CHARGEN_ENABLE
+void osd_chargen_prepare(uint16_t scaled_y);
+#define OSD_LINE(line) (osd_chargen_line)
+#else
+#define OSD_LINE(line) (&osd_buffer[(line) * (osd_mode.width / 2)])
+#endif
+
+void osd_draw_cell(uint8_t *buffer, uint16_t stride, uint16_t buf_height, uint16_t x, uint16_t y,
+                   uint8_t c, uint8_t packed_color, uint8_t height);
 void osd_draw_char(uint8_t *buffer, uint16_t buf_width, uint16_t x, uint16_t y,
                    uint8_t c, uint8_t fg_color, uint8_t bg_color, uint8_t height);
 
@@ -0,0 +1,300 @@
+#include <string.h>
+
+#include "hardware/timer.h"
+
+#include "g_config.h"
+#include "osd.h"
+#include "osd_layers.h"
+
+extern video_mode_t video_mode;
+extern int16_t h_visible_area;
+extern int16_t v_margin;
+
+typedef struct
+{
+    bool visible;
+    bool full_width; // black outside the layer on its lines
+    uint8_t scale;
+    uint16_t start_x;
+    uint16_t end_x;
+    uint16_t start_y;
+    uint16_t end_y;
+    uint16_t stride;
+    const uint8_t *buffer;
+} osd_layer_t;
+
+typedef struct
+{
+    uint16_t start_x;
+    uint16_t end_x;
+    uint16_t start_y;
+    uint16_t end_y;
+    const osd_layer_t *layer; // NULL for the black part of a full width layer
+} osd_rect_t;
+
+static osd_layer_t osd_layers[OSD_LAYERS];
+static osd_layer_t osd_layers_built[OSD_LAYERS]; // layers the published span list was built from
+static int16_t osd_layers_built_width;
+
+// span lists are double buffered, the video ISR latches one per frame
+static osd_compose_t osd_compose[2];
+static const osd_compose_t *volatile osd_compose_next = NULL;   // NULL when only the main layer can be visible
+static const osd_compose_t *volatile osd_compose_in_use = NULL; // last one latched by the video ISR
+
+static uint8_t osd_toast_buffer[OSD_TOAST_COLUMNS * OSD_FONT_WIDTH / 2 * OSD_TOAST_HEIGHT];
+static uint16_t osd_toast_width; // bytes
+static uint64_t osd_toast_show_time;
+static uint32_t osd_toast_duration;
+
+const osd_compose_t *__not_in_flash_func(osd_compose_latch)()
+{
+    const osd_compose_t *compose = osd_compose_next;
+    osd_compose_in_use = compose;
+
+    return compose;
+}
+
+void osd_toast_show(const char *text, uint32_t duration_us)
+{
+    uint8_t len = strnlen(text, OSD_TOAST_COLUMNS - 2);
+    uint8_t packed_color = (OSD_COLOR_TOAST_TEXT << 4) | OSD_COLOR_TOAST_BACKGROUND;
+
+    // one empty column on each side of the text
+    osd_toast_width = (len + 2) * OSD_FONT_WIDTH / 2;
+    memset(osd_toast_buffer, OSD_COLOR_TOAST_BACKGROUND * 0x11, osd_toast_width * OSD_TOAST_HEIGHT);
+
+    for (uint8_t i = 0; i < len; i++)
+        osd_draw_cell(osd_toast_buffer, osd_toast_width, OSD_TOAST_HEIGHT,
+                      (i + 1) * OSD_FONT_WIDTH, OSD_TOAST_PADDING, (uint8_t)text[i], packed_color, 0);
+
+    osd_toast_show_time = time_us_64();
+    osd_toast_duration = duration_us;
+    osd_layers[OSD_LAYER_TOAST].visible = true;
+}
+
+void osd_toast_hide()
+{
+    osd_layers[OSD_LAYER_TOAST].visible = false;
+}
+
+static void osd_toast_set_position()
+{
+    osd_layer_t *layer = &osd_layers[OSD_LAYER_TOAST];
+    uint16_t v_display_lines = (video_mode.v_visible_area - 2 * v_margin) / video_mode.div;
+    // same scale as a full size OSD on this mode
+    uint8_t scale = osd_get_scale(OSD_WIDTH, OSD_HEIGHT);
+    uint16_t width = osd_toast_width * scale;
+    uint16_t lines = OSD_TOAST_HEIGHT * scale;
+
+    if (width > h_visible_area)
+        width = h_visible_area;
+
+    layer->scale = scale;
+    layer->buffer = osd_toast_buffer;
+    layer->stride = osd_toast_width;
+    layer->start_x = (h_visible_area - width) / 2;
+    layer->end_x = layer->start_x + width;
+    layer->start_y = v_display_lines > lines + OSD_TOAST_MARGIN ? v_display_lines - lines - OSD_TOAST_MARGIN : 0;
+    layer->end_y = layer->start_y + lines;
+
+    if (layer->end_y > v_display_lines)
+        layer->end_y = v_display_lines;
+}
+
+static void osd_main_layer_set()
+{
+    osd_layer_t *layer = &osd_layers[OSD_LAYER_MAIN];
+
+    // blending is per frame renderer only, the main layer is opaque under a toast
+    layer->visible = osd_state.visible;
+    layer->full_width = osd_mode.full_width && (osd_mode.blend == OSD_BLEND_OPAQUE || osd_mode.scale > 1);
+    layer->scale = osd_mode.scale;
+    layer->start_x = osd_mode.start_x;
+    layer->end_x = osd_mode.end_x;
+    layer->start_y = osd_mode.start_y;
+    layer->end_y = osd_mode.end_y;
+#ifdef OSD_CHARGEN_ENABLE
+    // every line of the layer is expanded to the same buffer
+    layer->stride = 0;
+    layer->buffer = osd_chargen_line;
+#else
+    layer->stride = osd_mode.width / 2;
+    layer->buffer = osd_buffer;
+#endif
+}
+
+static uint8_t osd_sort_unique(uint16_t *values, uint8_t count)
+{ // insertion sort of a few edges, duplicates removed
+    uint8_t unique = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint16_t value = values[i];
+        uint8_t j = unique;
+
+        while (j > 0 && values[j - 1] > value)
+            j--;
+
+        if (j > 0 && values[j - 1] == value)
+            continue;
+
+        memmove(&values[j + 1], &values[j], (unique - j) * sizeof(values[0]));
+        values[j] = value;
+        unique++;
+    }
+
+    return unique;
+}
+
+static void osd_compose_build(osd_compose_t *compose)
+{
+    osd_rect_t rects[OSD_LAYERS + 2];
+    uint8_t rect_count = 0;
+
+    // rectangles in z-order, the last one covering a pixel wins
+    for (uint8_t i = 0; i < OSD_LAYERS; i++)
+    {
+        const osd_layer_t *layer = &osd_layers[i];
+
+        if (!layer->visible || layer->start_x >= layer->end_x || layer->start_y >= layer->end_y)
+            continue;
+
+        if (layer->full_width && layer->start_x > 0)
+            rects[rect_count++] = (osd_rect_t){0, layer->start_x, layer->start_y, layer->end_y, NULL};
+
+        if (layer->full_width && layer->end_x < h_visible_area)
+            rects[rect_count++] = (osd_rect_t){layer->end_x, h_visible_area, layer->start_y, layer->end_y, NULL};
+
+        rects[rect_count++] = (osd_rect_t){layer->start_x, layer->end_x, layer->start_y, layer->end_y, layer};
+    }
+
+    uint16_t edges_y[2 * (OSD_LAYERS + 2)];
+    uint8_t edge_count = 0;
+
+    for (uint8_t i = 0; i < rect_count; i++)
+    {
+        edges_y[edge_count++] = rects[i].start_y;
+        edges_y[edge_count++] = rects[i].end_y;
+    }
+
+    edge_count = osd_sort_unique(edges_y, edge_count);
+
+    memset(compose->line_band, OSD_NO_BAND, sizeof(compose->line_band));
+    compose->band_count = 0;
+
+    for (uint8_t e = 0; e + 1 < edge_count && compose->band_count < OSD_BANDS_MAX; e++)
+    {
+        osd_band_t *band = &compose->bands[compose->band_count];
+        uint16_t edges_x[2 * (OSD_LAYERS + 2)];
+        uint8_t edge_x_count = 0;
+
+        band->start_y = edges_y[e];
+        band->end_y = edges_y[e + 1];
+        band->span_count = 0;
+
+        for (uint8_t i = 0; i < rect_count; i++)
+        {
+            if (rects[i].start_y > band->start_y || rects[i].end_y < band->end_y)
+                continue;
+
+            edges_x[edge_x_count++] = rects[i].start_x;
+            edges_x[edge_x_count++] = rects[i].end_x;
+        }
+
+        if (edge_x_count == 0)
+            continue;
+
+        edge_x_count = osd_sort_unique(edges_x, edge_x_count);
+
+        const osd_rect_t *prev_rect = NULL;
+
+        for (uint8_t x = 0; x + 1 < edge_x_count; x++)
+        {
+            uint16_t start_x = edges_x[x];
+            const osd_rect_t *top = NULL;
+
+            for (uint8_t i = 0; i < rect_count; i++)
+                if (rects[i].start_y <= band->start_y && rects[i].end_y >= band->end_y &&
+                    rects[i].start_x <= start_x && rects[i].end_x > start_x)
+                    top = &rects[i];
+
+            if (top == NULL)
+            {
+                prev_rect = NULL;
+                continue;
+            }
+
+            // neighbouring pieces of one rectangle are one span
+            if (top == prev_rect)
+            {
+                band->spans[band->span_count - 1].end_x = edges_x[x + 1];
+                continue;
+            }
+
+            if (band->span_count == OSD_SPANS_MAX)
+                break;
+
+            osd_span_t *span = &band->spans[band->span_count++];
+            span->start_x = start_x;
+            span->end_x = edges_x[x + 1];
+            span->src_x = start_x - top->start_x;
+            span->src_y = top->start_y;
+            span->stride = 0;
+            span->scale = 1;
+            span->src = NULL;
+
+            if (top->layer != NULL)
+            {
+                span->stride = top->layer->stride;
+                span->scale = top->layer->scale;
+                span->src = top->layer->buffer;
+            }
+
+            prev_rect = top;
+        }
+
+        if (band->span_count == 0)
+            continue;
+
+        for (uint16_t line = band->start_y; line < band->end_y && line < V_BUF_H; line++)
+            compose->line_band[line] = compose->band_count;
+
+        compose->band_count++;
+    }
+}
+
+void osd_layers_update()
+{
+    osd_layer_t *toast = &osd_layers[OSD_LAYER_TOAST];
+
+    if (toast->visible && time_us_64() - osd_toast_show_time >= osd_toast_duration)
+        toast->visible = false;
+
+    osd_main_layer_set();
+    osd_toast_set_position();
+
+    if (memcmp(osd_layers, osd_layers_built, sizeof(osd_layers)) == 0 && osd_layers_built_width == h_visible_area)
+        return;
+
+    if (!toast->visible)
+    { // the main layer alone uses the per frame OSD renderers
+        osd_compose_next = NULL;
+    }
+    else
+    {
+        // build into the buffer the video ISR can't be using
+        const osd_compose_t *in_use = osd_compose_in_use;
+        const osd_compose_t *next = osd_compose_next;
+        osd_compose_t *compose = (in_use == &osd_compose[0] || next == &osd_compose[0]) ? &osd_compose[1] : &osd_compose[0];
+
+        // the ISR hasn't latched the last span list yet, retry on the next update
+        if (compose == in_use || compose == next)
+            return;
+
+        osd_compose_build(compose);
+        osd_compose_next = compose;
+    }
+
+    memcpy(osd_layers_built, osd_layers, sizeof(osd_layers));
+    osd_layers_built_width = h_visible_area;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "osd.h"
+
+// Independent OSD layers in z-order, the last one is on top
+typedef enum
+{
+    OSD_LAYER_MAIN,  // OSD menu or FlashFloppy status (osd_buffer, osd_mode)
+    OSD_LAYER_TOAST, // short notification
+    OSD_LAYERS,
+} osd_layer_id_t;
+
+#define OSD_TOAST_COLUMNS 30
+#define OSD_TOAST_PADDING 2 // lines above and below the text
+#define OSD_TOAST_HEIGHT (OSD_FONT_HEIGHT + 2 * OSD_TOAST_PADDING)
+#define OSD_TOAST_MARGIN 8 // lines between the toast and the bottom of the image
+#define OSD_TOAST_DURATION_US 2000000u
+
+#define OSD_COLOR_TOAST_TEXT 0xF       // Bright white
+#define OSD_COLOR_TOAST_BACKGROUND 0x1 // Blue
+
+// every layer adds up to 2 horizontal edges, plus the image edges used by full width black
+#define OSD_SPANS_MAX (2 * OSD_LAYERS + 1)
+// every layer adds up to 2 vertical edges
+#define OSD_BANDS_MAX (2 * OSD_LAYERS - 1)
+#define OSD_NO_BAND 0xFF
+
+typedef struct
+{
+    uint16_t start_x;   // image bytes (2 pixels per byte)
+    uint16_t end_x;
+    uint16_t src_x;     // image bytes from the left edge of the layer to start_x
+    uint16_t src_y;     // first scaled line of the layer
+    uint16_t stride;    // layer line length in bytes
+    uint8_t scale;      // layer scale, see osd_get_scale()
+    const uint8_t *src; // layer pixels, NULL is black
+} osd_span_t;
+
+typedef struct
+{
+    uint16_t start_y; // scaled lines
+    uint16_t end_y;
+    uint8_t span_count;
+    osd_span_t spans[OSD_SPANS_MAX]; // sorted by start_x, not overlapping, the image shows between them
+} osd_band_t;
+
+typedef struct
+{
+    uint8_t line_band[V_BUF_H]; // scaled line -> bands[] index or OSD_NO_BAND
+    uint8_t band_count;
+    osd_band_t bands[OSD_BANDS_MAX];
+} osd_compose_t;
+
+void osd_layers_update();
+const osd_compose_t *osd_compose_latch();
+
+void osd_toast_show(const char *text, uint32_t duration_us);
+void osd_toast_hide();
\ No newline at end of file
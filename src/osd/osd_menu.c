@@ -2,10 +2,11 @@
 
 #include "g_config.h"
 #include "osd_menu.h"
-#include "font.h"
 #include "osd.h"
+#include "osd_layers.h"
 #include "rgb_capture.h"
 #include "settings.h"
+#include "v_buf.h"
 #include "video_output.h"
 
 #ifdef OSD_FF_ENABLE
@@ -14,47 +15,67 @@
 
 #ifdef KBD_ENABLE
 #include "osd_kbd.h"
+#include "zx_keymap.h"
+#endif
+
+#if defined(USB_KBD_ENABLE) && defined(SPI_KB_ENABLE)
+#include "usb_kbd.h"
 #endif
 
 #ifdef HW_CONFIG_ENABLE
 #include "hw_config.h"
 #endif
 
-// Pin inversion mask bit positions for menu items
-static const uint8_t mask_bit_positions[] = {
-    CAP_F,
-    CAP_HS,
-    CAP_VS,
-    CAP_I,
-    CAP_R,
-    CAP_G,
-    CAP_B,
+#ifdef PERF_STATS_ENABLE
+#include "perf_stats.h"
+#endif
+
+#ifdef KBD_JOURNAL_ENABLE
+#include "kbd_journal.h"
+#endif
+
+// Menu item types
+#define MENU_ITEM_TEXT 0    // static line, skipped by navigation
+#define MENU_ITEM_SUBMENU 1 // SEL opens the menu in arg
+#define MENU_ITEM_BACK 2    // SEL returns to the parent menu
+#define MENU_ITEM_ACTION 3  // SEL calls select(), the menu is left or changed
+#define MENU_ITEM_TOGGLE 4  // SEL steps the value, wrapping from max to min
+#define MENU_ITEM_TUNED 5   // SEL enters/leaves tuning, UP/DOWN adjust the value
+
+typedef struct osd_menu_item_t osd_menu_item_t;
+
+struct osd_menu_item_t
+{
+    const char *label;
+    uint8_t type;
+    uint8_t arg; // submenu for MENU_ITEM_SUBMENU, free for the callbacks otherwise
+    int32_t min;
+    int32_t max;
+    const char *const *names;                                         // value names from min, NULL prints the number
+    int32_t (*get)(const osd_menu_item_t *item);                      // NULL: no value
+    void (*set)(const osd_menu_item_t *item, int32_t value);          // value is within min..max
+    void (*adjust)(const osd_menu_item_t *item, int8_t direction);    // replaces the get/set step
+    const char *(*format)(const osd_menu_item_t *item, char *buffer); // replaces names and numbers
+    bool (*enabled)(const osd_menu_item_t *item);                     // NULL: always, disabled items are dimmed and ignore SEL
+    void (*select)(const osd_menu_item_t *item);                      // ACTION, or TUNED entering/leaving tuning
 };
 
-// Main menu item indices (FF OSD and HARDWARE entries are conditionally included)
-#define MAIN_ITEM_OUTPUT 0
-#define MAIN_ITEM_CAPTURE 1
-#define MAIN_ITEM_IMAGE_ADJ 2
+typedef struct
+{
+    const char *title;
+    const osd_menu_item_t *items;
+    uint8_t count;
+    uint8_t label_width; // value column
+} osd_menu_page_t;
 
-// Compute subsequent indices based on which optional items are enabled
-#ifdef OSD_FF_ENABLE
-#define MAIN_ITEM_FF_OSD 3
-#define _NEXT_AFTER_FF 4
-#else
-#define _NEXT_AFTER_FF 3
-#endif
+// Input events, posted and consumed on core 0
+#define OSD_MENU_EVENTS 8
 
-#ifdef HW_CONFIG_ENABLE
-#define MAIN_ITEM_HARDWARE _NEXT_AFTER_FF
-#define _NEXT_AFTER_HW (_NEXT_AFTER_FF + 1)
-#else
-#define _NEXT_AFTER_HW _NEXT_AFTER_FF
-#endif
+static uint8_t osd_menu_events[OSD_MENU_EVENTS];
+static uint8_t osd_menu_events_head;
+static uint8_t osd_menu_events_tail;
 
-#define MAIN_ITEM_ABOUT _NEXT_AFTER_HW
-#define MAIN_ITEM_SAVE (_NEXT_AFTER_HW + 1)
-#define MAIN_ITEM_EXIT (_NEXT_AFTER_HW + 2)
-#define MAIN_ITEM_COUNT (_NEXT_AFTER_HW + 3)
+static uint16_t osd_menu_dirty_rows; // item rows to re-render, one bit per item
 
 extern settings_t settings;
 extern video_out_type_t active_video_output;
@@ -78,961 +99,1092 @@ static void osd_menu_hide(void)
 #endif
 }
 
-// Navigate back to the parent menu, restoring the previous selection.
-// Returns true if navigation occurred (sets menu_changed in callers).
-static bool osd_menu_go_back(void)
-{
-    if (osd_menu.menu_depth == 0)
-        return false;
+// Item callbacks
 
-    osd_menu.menu_depth--;
-    osd_menu.current_menu = osd_menu.menu_stack[osd_menu.menu_depth];
-    osd_menu_state.selected_item = osd_menu.item_stack[osd_menu.menu_depth];
-    osd_menu_state.tuning_mode = false;
-    osd_state.needs_redraw = true;
-    return true;
-}
+static const char *const names_off_on[] = {"OFF", "ON"};
 
-// Enter a child submenu, saving current position on the stack.
-// Returns true (always sets menu_changed in callers).
-static bool osd_menu_enter_submenu(uint8_t menu_type)
+// Output settings
+typedef struct
 {
-    if (osd_menu.menu_depth >= 4)
-        return false;
+    video_out_mode_t mode;
+    const char *name;
+} osd_video_mode_name_t;
+
+static const osd_video_mode_name_t video_modes_dvi[] = {
+    {MODE_640x480_60Hz, "640X480@60"},
+    {MODE_720x576_50Hz, "720X576@50"},
+#if defined(DVI_HSTX_ENABLE)
+    {MODE_800x600_60Hz, "800X600@60"},
+    {MODE_1024x768_60Hz_d3, "1024X768@60 DIV3"},
+    {MODE_1024x768_60Hz_d4, "1024X768@60 DIV4"},
+    {MODE_1280x720_60Hz, "1280X720@60"},
+#elif defined(DVI_DIRECT_ENABLE)
+    {MODE_800x600_60Hz, "800X600@60"},
+#endif
+};
 
-    osd_menu.menu_stack[osd_menu.menu_depth] = osd_menu.current_menu;
-    osd_menu.item_stack[osd_menu.menu_depth] = osd_menu_state.selected_item;
-    osd_menu.menu_depth++;
-    osd_menu.current_menu = menu_type;
-    osd_menu_state.selected_item = 0;
-    osd_menu_state.tuning_mode = false;
-    osd_state.needs_redraw = true;
-    return true;
-}
+static const osd_video_mode_name_t video_modes_vga[] = {
+    {MODE_640x480_60Hz, "640X480@60"},
+    {MODE_800x600_60Hz, "800X600@60"},
+    {MODE_1024x768_60Hz_d3, "1024X768@60 DIV3"},
+    {MODE_1024x768_60Hz_d4, "1024X768@60 DIV4"},
+    {MODE_1280x1024_60Hz_d3, "1280X1024@60 DIV3"},
+    {MODE_1280x1024_60Hz_d4, "1280X1024@60 DIV4"},
+};
 
-// Flush pending render operations.
-static void osd_flush_render(void)
+static const osd_video_mode_name_t *get_video_modes(uint8_t *count)
 {
-    if (osd_state.needs_redraw)
+    if (settings.video_out_type == DVI)
     {
-        osd_update_text_buffer();
-        osd_state.needs_redraw = false;
-        osd_state.text_updated = true;
+        *count = count_of(video_modes_dvi);
+        return video_modes_dvi;
     }
 
-    if (osd_state.text_updated)
-    {
-        osd_render_text_to_buffer();
-        osd_state.text_updated = false;
-    }
+    *count = count_of(video_modes_vga);
+    return video_modes_vga;
 }
 
-void osd_menu_init()
+static int8_t get_video_mode_index()
 {
-    memset(&osd_menu_state, 0, sizeof(osd_menu_state));
-    memset(&osd_menu, 0, sizeof(osd_menu));
-    osd_menu.current_menu = MENU_TYPE_MAIN;
+    uint8_t count;
+    const osd_video_mode_name_t *modes = get_video_modes(&count);
+
+    for (uint8_t i = 0; i < count; i++)
+        if (settings.video_out_mode == modes[i].mode)
+            return i;
+
+    return -1;
 }
 
-void osd_menu_update()
+static const char *format_video_mode(const osd_menu_item_t *item, char *buffer)
 {
-    if (!osd_state.enabled)
-        return;
+    uint8_t count;
+    const osd_video_mode_name_t *modes = get_video_modes(&count);
+    int8_t index = get_video_mode_index();
 
-    // If menu is not active, only check for activation buttons
-    if (!osd_state.menu_active)
-    {
-#ifdef KBD_ENABLE
-        // Check cross-core menu open request (from keyboard)
-        bool kbd_open = osd_menu_request;
-        if (kbd_open)
-            osd_menu_request = false;
-#endif
-        osd_buttons_update();
+    return index < 0 ? "UNKNOWN" : modes[index].name;
+}
 
-        if (osd_buttons_apply_release_block())
-        {
-#ifdef OSD_FF_ENABLE
-            if (settings.ff_osd_config.enabled && settings.ff_osd_config.i2c_protocol)
-                ff_osd_set_buttons(0);
-#endif
-            return;
-        }
+static void adjust_video_mode(const osd_menu_item_t *item, int8_t direction)
+{
+    uint8_t count;
+    const osd_video_mode_name_t *modes = get_video_modes(&count);
+    int8_t index = get_video_mode_index();
 
-        uint64_t current_time = time_us_64();
-        bool opened_by_long_hold = osd_button_hold_duration_us(2, current_time) > OSD_HOLD_US;
+    // Default to first mode if current mode not found
+    if (index < 0)
+        index = 0;
 
-        bool open_menu = osd_button_pressed(0) || osd_button_pressed(1) || osd_button_pressed(2);
-#ifdef OSD_FF_ENABLE
-        if (settings.ff_osd_config.enabled && settings.ff_osd_config.i2c_protocol)
-            open_menu = opened_by_long_hold;
-#endif
-#ifdef KBD_ENABLE
-        open_menu |= kbd_open;
-#endif
+    // Wrap around the list
+    index += direction;
 
-        if (open_menu)
-        {
-            osd_state.menu_active = true;
-            osd_font = osd_font_style_1;
-            osd_mode.x = 0;
-            osd_mode.y = 0;
-            osd_mode.columns = 30;
-            osd_mode.rows = 15;
-            osd_mode.border_enabled = true;
-            osd_mode.full_width = false;
-            osd_mode.width = osd_mode.columns * OSD_FONT_WIDTH;
-            osd_mode.height = osd_mode.rows * OSD_FONT_HEIGHT;
-            osd_mode.buffer_size = osd_mode.width * osd_mode.height / 2;
+    if (index < 0)
+        index = count - 1;
+    else if (index >= count)
+        index = 0;
 
-            osd_set_position();
+    // Update mode in settings (don't apply yet - wait for SEL press)
+    settings.video_out_mode = modes[index].mode;
+}
 
-            osd_show();
-            // Always require a full release after opening to avoid immediate
-            // repeat navigation or accidental activation in the first frame.
-            osd_block_buttons_until_release();
-#ifdef OSD_FF_ENABLE
-            if (settings.ff_osd_config.enabled && settings.ff_osd_config.i2c_protocol)
-                ff_osd_set_buttons(0);
-#endif
-            // Don't process the button press that opened the menu.
-            // Also clear any virtual button events (e.g. BACK/ESC) that were
-            // queued before the menu opened — otherwise a stale BACK would
-            // fire after the release block and immediately close the menu.
-            osd_clear_pressed_buttons();
-#ifdef KBD_ENABLE
-            osd_virtual_buttons = 0;
-#endif
-        }
+static void select_video_mode(const osd_menu_item_t *item)
+{
+    if (osd_menu_state.tuning_mode)
+    { // Enter tuning mode - store original mode
+        osd_menu_state.original_video_mode = settings.video_out_mode;
         return;
     }
 
-#ifdef KBD_ENABLE
-    // F9 (OSD_HOTKEY_MENU) toggle: close menu if already active
-    if (osd_menu_request)
+    // Exit tuning mode - only restart if mode has changed
+    if (active_video_output == settings.video_out_type &&
+        osd_menu_state.original_video_mode != settings.video_out_mode)
     {
-        osd_menu_request = false;
-        osd_menu_hide();
-        osd_menu_init();
-        return;
+        stop_video_output();
+        start_video_output(active_video_output);
+        // Adjust capture frequency for new system clock
+        set_capture_frequency(settings.frequency);
     }
-#endif
+}
 
-    // Menu is active from here
-    // Update button states
-    osd_buttons_update();
+static int32_t get_scanlines(const osd_menu_item_t *item)
+{
+    return settings.scanlines_mode;
+}
 
-    if (osd_buttons_apply_release_block())
-    {
-#ifdef OSD_FF_ENABLE
-        if (settings.ff_osd_config.enabled && settings.ff_osd_config.i2c_protocol)
-            ff_osd_set_buttons(0);
-#endif
-        // Keep rendering while input is blocked so menu appears immediately.
-        osd_flush_render();
-        return;
-    }
+static void adjust_scanlines(const osd_menu_item_t *item, int8_t direction)
+{
+    // cycle through the modes supported by the current output and resolution
+    settings.scanlines_mode = get_next_scanlines_mode(settings.scanlines_mode);
+    set_scanlines_mode();
+}
 
-    // Check for menu timeout
-    {
-        uint64_t current_time = time_us_64();
+static bool scanlines_available(const osd_menu_item_t *item)
+{
+    return get_next_scanlines_mode(SCANLINES_OFF) != SCANLINES_OFF;
+}
 
-        if ((current_time - osd_state.last_activity_time) > OSD_MENU_TIMEOUT_US)
-        {
-            osd_menu_hide();
-            return;
-        }
-    }
+static int32_t get_buffering(const osd_menu_item_t *item)
+{
+    return settings.buffering_mode;
+}
 
-    // Get menu item count based on current menu
-    {
-        uint8_t max_items;
-        if (osd_menu.current_menu == MENU_TYPE_MAIN)
-            max_items = MAIN_ITEM_COUNT - 1;
-        else if (osd_menu.current_menu == MENU_TYPE_OUTPUT)
-            max_items = 3; // Output menu: 0-3 (4 items: mode, scanlines, buffering, back)
-        else if (osd_menu.current_menu == MENU_TYPE_CAPTURE)
-            max_items = 5; // Capture menu: 0-5 (6 items: freq, mode, divider, sync, mask, back) - divider always shown but dimmed for SELF
-        else if (osd_menu.current_menu == MENU_TYPE_IMAGE_ADJUST)
-            max_items = 4; // Image adjust menu: 0-4 (5 items: H-POS, V-POS, DELAY, RESET, BACK)
-        else if (osd_menu.current_menu == MENU_TYPE_MASK)
-            max_items = 7; // Mask menu: 0-7 (8 items: F, SSI, KSI, I, B, G, R, BACK)
-        else if (osd_menu.current_menu == MENU_TYPE_ABOUT)
-            max_items = 0; // About menu: 0 (1 item: BACK)
-#ifdef MAIN_ITEM_FF_OSD
-        else if (osd_menu.current_menu == MENU_TYPE_FF_OSD)
-            max_items = 6; // FF OSD menu: 0-6 (7 items: ENABLE, PROTOCOL, ROWS, COLUMNS, H_POS, V_POS, BACK)
-#endif
-#ifdef MAIN_ITEM_HARDWARE
-        else if (osd_menu.current_menu == MENU_TYPE_HARDWARE)
-            max_items = 3; // Hardware menu: 0-3 (4 items: ROM BANK, RAM SIZE, GOTEK DRIVE, BACK)
-#endif
-        else
-            max_items = 0;
-
-        // Handle navigation buttons
-        if (osd_button_pressed(0))
-        {                          // UP button
-            osd_update_activity(); // Reset timeout on user interaction
-            if (osd_menu.current_menu == MENU_TYPE_OUTPUT && osd_menu_state.tuning_mode && osd_menu_state.selected_item == 0)
-            { // Video mode adjustment
-                osd_adjust_video_mode(1);
-                osd_state.needs_redraw = true;
-            }
-            else if (osd_menu.current_menu == MENU_TYPE_IMAGE_ADJUST && osd_menu_state.tuning_mode && osd_menu_state.selected_item < 3)
-            { // Parameter adjustment mode - increase parameter value
-                osd_adjust_image_parameter(osd_menu_state.selected_item, 1);
-                osd_state.needs_redraw = true;
-            }
-            else if (osd_menu.current_menu == MENU_TYPE_CAPTURE && osd_menu_state.tuning_mode && osd_menu_state.selected_item != 1 && osd_menu_state.selected_item != 3)
-            { // Capture parameter adjustment (exclude item 1 - MODE, item 3 - SYNC)
-                osd_adjust_capture_parameter(osd_menu_state.selected_item, 1);
-                osd_state.needs_redraw = true;
-            }
-#ifdef MAIN_ITEM_FF_OSD
-            else if (osd_menu.current_menu == MENU_TYPE_FF_OSD && osd_menu_state.tuning_mode && (osd_menu_state.selected_item == 3 || osd_menu_state.selected_item == 4))
-            { // FF OSD columns or H_POS cycling up
-                osd_adjust_ff_osd_parameter(osd_menu_state.selected_item, 1);
-                osd_state.needs_redraw = true;
-            }
-#endif
-#ifdef MAIN_ITEM_HARDWARE
-            else if (osd_menu.current_menu == MENU_TYPE_HARDWARE && osd_menu_state.tuning_mode)
-            {
-                osd_adjust_hardware_parameter(osd_menu_state.selected_item, 1);
-                osd_state.needs_redraw = true;
-            }
-#endif
-            else
-            { // Menu navigation mode - move selection up
-                if (osd_menu_state.selected_item > 0)
-                {
-                    osd_menu_state.selected_item--;
-                    osd_state.needs_redraw = true;
-                }
-            }
+static void set_buffering(const osd_menu_item_t *item, int32_t value)
+{
+    settings.buffering_mode = value;
+    set_buffering_mode(settings.buffering_mode);
+}
 
-            osd_buttons.up_pressed = false;
-        }
-        if (osd_button_pressed(1))
-        {                          // DOWN button
-            osd_update_activity(); // Reset timeout on user interaction
-            if (osd_menu.current_menu == MENU_TYPE_OUTPUT && osd_menu_state.tuning_mode && osd_menu_state.selected_item == 0)
-            { // Video mode adjustment
-                osd_adjust_video_mode(-1);
-                osd_state.needs_redraw = true;
-            }
-            else if (osd_menu.current_menu == MENU_TYPE_IMAGE_ADJUST && osd_menu_state.tuning_mode && osd_menu_state.selected_item < 3)
-            { // Parameter adjustment mode - decrease parameter value
-                osd_adjust_image_parameter(osd_menu_state.selected_item, -1);
-                osd_state.needs_redraw = true;
-            }
-            else if (osd_menu.current_menu == MENU_TYPE_CAPTURE && osd_menu_state.tuning_mode && osd_menu_state.selected_item != 1 && osd_menu_state.selected_item != 3)
-            { // Capture parameter adjustment (exclude item 1 - MODE, item 3 - SYNC)
-                osd_adjust_capture_parameter(osd_menu_state.selected_item, -1);
-                osd_state.needs_redraw = true;
-            }
-#ifdef MAIN_ITEM_FF_OSD
-            else if (osd_menu.current_menu == MENU_TYPE_FF_OSD && osd_menu_state.tuning_mode && (osd_menu_state.selected_item == 3 || osd_menu_state.selected_item == 4))
-            { // FF OSD columns or H_POS cycling down
-                osd_adjust_ff_osd_parameter(osd_menu_state.selected_item, -1);
-                osd_state.needs_redraw = true;
-            }
-#endif
-#ifdef MAIN_ITEM_HARDWARE
-            else if (osd_menu.current_menu == MENU_TYPE_HARDWARE && osd_menu_state.tuning_mode)
-            {
-                osd_adjust_hardware_parameter(osd_menu_state.selected_item, -1);
-                osd_state.needs_redraw = true;
-            }
-#endif
-            else
-            { // Menu navigation mode - move selection down
-                if (osd_menu_state.selected_item < max_items)
-                {
-                    osd_menu_state.selected_item++;
-                    osd_state.needs_redraw = true;
-                }
-            }
+// Capture settings
+static int32_t get_frequency(const osd_menu_item_t *item)
+{
+    return settings.frequency;
+}
 
-            osd_buttons.down_pressed = false;
-        }
+static void adjust_frequency(const osd_menu_item_t *item, int8_t direction)
+{
+    static const uint32_t freq_presets[] = {
+        7000000, // ZX Spectrum 16K/48K
+        7093800, // ZX Spectrum 128/+2/+2A/+3
+    };
+    static const uint8_t freq_presets_count = count_of(freq_presets);
 
-        // Handle selection in different menus
-        if (osd_button_pressed(2))
-        {                          // SEL button for item selection
-            osd_update_activity(); // Reset timeout on user interaction
-            bool menu_changed = false;
+    uint32_t freq_step = 100; // Base step: 100Hz
+    uint64_t current_time = time_us_64();
 
-            if (osd_menu.current_menu == MENU_TYPE_MAIN)
-            {
-                // Main menu selection
-                if (osd_menu_state.selected_item == MAIN_ITEM_OUTPUT)
-                { // Output Settings
-                    menu_changed = osd_menu_enter_submenu(MENU_TYPE_OUTPUT);
-                }
-                else if (osd_menu_state.selected_item == MAIN_ITEM_CAPTURE)
-                { // Capture Settings
-                    menu_changed = osd_menu_enter_submenu(MENU_TYPE_CAPTURE);
-                }
-                else if (osd_menu_state.selected_item == MAIN_ITEM_IMAGE_ADJ)
-                { // Image Adjust
-                    menu_changed = osd_menu_enter_submenu(MENU_TYPE_IMAGE_ADJUST);
-                }
-#ifdef MAIN_ITEM_FF_OSD
-                else if (osd_menu_state.selected_item == MAIN_ITEM_FF_OSD)
-                { // FF OSD Config
-                    menu_changed = osd_menu_enter_submenu(MENU_TYPE_FF_OSD);
-                }
-#endif
-#ifdef MAIN_ITEM_HARDWARE
-                else if (osd_menu_state.selected_item == MAIN_ITEM_HARDWARE)
-                { // Hardware Config
-                    menu_changed = osd_menu_enter_submenu(MENU_TYPE_HARDWARE);
-                }
-#endif
-                else if (osd_menu_state.selected_item == MAIN_ITEM_ABOUT)
-                { // About
-                    menu_changed = osd_menu_enter_submenu(MENU_TYPE_ABOUT);
-                }
-                else if (osd_menu_state.selected_item == MAIN_ITEM_SAVE)
-                { // Save
-                    save_settings(&settings);
-                    osd_menu_hide();
-                    menu_changed = true;
-                }
-                else if (osd_menu_state.selected_item == MAIN_ITEM_EXIT)
-                { // Exit without saving
-                    osd_menu_hide();
-                    menu_changed = true;
-                }
-            }
-            else if (osd_menu.current_menu == MENU_TYPE_OUTPUT)
-            {                                // Output submenu selection
-                uint8_t back_item_index = 3; // 4 items (mode, scanlines, buffering, back)
-
-                if (osd_menu_state.selected_item == back_item_index)
-                { // Back to Main
-                    menu_changed = osd_menu_go_back();
-                }
-                else if (osd_menu_state.selected_item == 0)
-                { // Video mode selection - enter/exit tuning mode
-                    if (osd_menu_state.tuning_mode)
-                    { // Exit tuning mode and apply video mode change
-                        // Only restart if mode has changed
-                        if (active_video_output == settings.video_out_type &&
-                            osd_menu_state.original_video_mode != settings.video_out_mode)
-                        {
-                            stop_video_output();
-                            start_video_output(active_video_output);
-                            // Adjust capture frequency for new system clock
-                            set_capture_frequency(settings.frequency);
-                        }
-                        osd_menu_state.tuning_mode = false;
-                    }
-                    else
-                    { // Enter tuning mode - store original mode
-                        osd_menu_state.original_video_mode = settings.video_out_mode;
-                        osd_menu_state.tuning_mode = true;
-                    }
-                    osd_state.needs_redraw = true;
-                }
-                else if (osd_menu_state.selected_item == 1)
-                { // Scanlines - toggle
-                    // Only allow toggle for VGA and when scanlines are supported
-                    bool scanlines_supported = false;
-
-                    if (settings.video_out_type == VGA)
-                    {
-#ifdef SCANLINES_ENABLE_LOW_RES
-                        // When SCANLINES_ENABLE_LOW_RES is defined, scanlines are supported for all div values
-                        scanlines_supported = true;
-#else
-                        // When SCANLINES_ENABLE_LOW_RES is not defined, only support div 3 and 4
-                        uint8_t div = video_modes[settings.video_out_mode]->div;
-                        scanlines_supported = (div == 3 || div == 4);
-#endif
-                    }
-
-                    if (scanlines_supported)
-                    {
-                        settings.scanlines_mode = !settings.scanlines_mode;
-                        set_scanlines_mode();
-                        osd_state.needs_redraw = true;
-                    }
-                }
-                else if (osd_menu_state.selected_item == 2)
-                { // Buffering - toggle between X1 and X3
-                    settings.buffering_mode = !settings.buffering_mode;
-                    extern void set_buffering_mode(bool);
-                    set_buffering_mode(settings.buffering_mode);
-                    osd_state.needs_redraw = true;
-                }
-            }
-            else if (osd_menu.current_menu == MENU_TYPE_CAPTURE)
-            {                                // Capture submenu selection
-                uint8_t back_item_index = 5; // Always 6 items (freq, mode, divider, sync, mask, back)
-
-                if (osd_menu_state.selected_item == back_item_index)
-                { // Back to Main
-                    menu_changed = osd_menu_go_back();
-                }
-                else if (osd_menu_state.selected_item == 1)
-                { // Capture mode - toggle between SELF and EXT
-                    settings.cap_sync_mode = (settings.cap_sync_mode == SELF) ? EXT : SELF;
-                    restart_capture = true;
-                    osd_state.needs_redraw = true;
-                }
-                else if (osd_menu_state.selected_item == 2)
-                { // Divider
-                    // Only allow tuning mode if EXT mode
-                    if (settings.cap_sync_mode == EXT)
-                    {
-                        osd_menu_state.tuning_mode = !osd_menu_state.tuning_mode;
-                        osd_state.needs_redraw = true;
-                    }
-                }
-                else if (osd_menu_state.selected_item == 3)
-                { // Sync - toggle between COMPOSITE and SEPARATE
-                    settings.video_sync_mode = !settings.video_sync_mode;
-                    set_video_sync_mode(settings.video_sync_mode);
-                    osd_state.needs_redraw = true;
-                }
-                else if (osd_menu_state.selected_item == 4)
-                { // Mask - open mask submenu
-                    menu_changed = osd_menu_enter_submenu(MENU_TYPE_MASK);
-                }
-                else
-                { // Other adjustable parameters (0)
-                    // Toggle tuning mode for adjustable parameters
-                    osd_menu_state.tuning_mode = !osd_menu_state.tuning_mode;
-                    osd_state.needs_redraw = true;
-                }
-            }
-            else if (osd_menu.current_menu == MENU_TYPE_IMAGE_ADJUST)
-            {                                // Image adjust submenu selection
-                uint8_t back_item_index = 4; // 5 items: H-POS, V-POS, DELAY, RESET, BACK
-
-                if (osd_menu_state.selected_item == back_item_index)
-                { // Back to Main
-                    menu_changed = osd_menu_go_back();
-                }
-                else if (osd_menu_state.selected_item == 3)
-                { // Reset to defaults
-                    set_capture_shX(shX_DEF);
-                    set_capture_shY(shY_DEF);
-                    set_capture_delay(DELAY_DEF);
-                    osd_state.needs_redraw = true;
-                    osd_menu_hide(); // Hide menu after resetting to defaults
-                    menu_changed = true;
-                }
-                else if (osd_menu_state.selected_item < 3)
-                { // Adjustable parameters (0-2)
-                    // Toggle tuning mode for adjustable parameters
-                    osd_menu_state.tuning_mode = !osd_menu_state.tuning_mode;
-                    osd_state.needs_redraw = true;
-                }
-            }
-            else if (osd_menu.current_menu == MENU_TYPE_MASK)
-            {                                // Mask submenu selection
-                uint8_t back_item_index = 7; // 8 items: F, SSI, KSI, I, B, G, R, BACK
-
-                if (osd_menu_state.selected_item == back_item_index)
-                { // Back to Capture
-                    menu_changed = osd_menu_go_back();
-                }
-                else
-                { // Toggle the selected mask bit
-                    uint8_t bit_pos = mask_bit_positions[osd_menu_state.selected_item];
-                    uint8_t bit_mask = 1 << bit_pos;
-                    settings.pin_inversion_mask ^= bit_mask;
-                    set_pin_inversion_mask(settings.pin_inversion_mask);
-                    osd_state.needs_redraw = true;
-                }
-            }
-#ifdef MAIN_ITEM_FF_OSD
-            else if (osd_menu.current_menu == MENU_TYPE_FF_OSD)
-            {                                // FF OSD submenu selection
-                uint8_t back_item_index = 6; // 7 items: ENABLE, PROTOCOL, ROWS, COLUMNS, H_POS, V_POS, BACK
-
-                if (osd_menu_state.selected_item == back_item_index)
-                { // Back to Main
-                    menu_changed = osd_menu_go_back();
-                }
-                else if (osd_menu_state.selected_item == 0)
-                { // Enable - toggle
-                    osd_adjust_ff_osd_parameter(0, 0);
-                    osd_state.needs_redraw = true;
-                }
-                else if (osd_menu_state.selected_item == 1)
-                { // Protocol - toggle
-                    osd_adjust_ff_osd_parameter(1, 0);
-                    osd_state.needs_redraw = true;
-                }
-                else if (osd_menu_state.selected_item == 2)
-                { // Rows - toggle 2/4 (only when LCD_HD44780)
-                    if (!settings.ff_osd_config.i2c_protocol)
-                    {
-                        osd_adjust_ff_osd_parameter(2, 0);
-                        osd_state.needs_redraw = true;
-                    }
-                }
-                else if (osd_menu_state.selected_item == 3)
-                { // Columns - enter/exit tuning mode (only when LCD_HD44780)
-                    if (!settings.ff_osd_config.i2c_protocol)
-                    {
-                        osd_menu_state.tuning_mode = !osd_menu_state.tuning_mode;
-                        osd_state.needs_redraw = true;
-                    }
-                }
-                else if (osd_menu_state.selected_item == 4)
-                { // H_POS - enter/exit tuning mode
-                    osd_menu_state.tuning_mode = !osd_menu_state.tuning_mode;
-                    osd_state.needs_redraw = true;
-                }
-                else if (osd_menu_state.selected_item == 5)
-                { // V_POS - toggle top/bottom
-                    osd_adjust_ff_osd_parameter(5, 0);
-                    osd_state.needs_redraw = true;
-                }
-            }
-#endif
-#ifdef MAIN_ITEM_HARDWARE
-            else if (osd_menu.current_menu == MENU_TYPE_HARDWARE)
-            {                                // Hardware submenu selection
-                uint8_t back_item_index = 3; // 4 items: ROM BANK, RAM SIZE, GOTEK DRIVE, BACK
-
-                if (osd_menu_state.selected_item == back_item_index)
-                { // Back to Main
-                    menu_changed = osd_menu_go_back();
-                }
-                else if (osd_menu_state.selected_item == 1)
-                { // RAM SIZE - toggle directly
-                    settings.hw_config.ram_size = !settings.hw_config.ram_size;
-                    hw_set_ram_size(settings.hw_config.ram_size);
-                    osd_state.needs_redraw = true;
-                }
-                else
-                { // ROM BANK / GOTEK DRIVE - enter/exit tuning mode
-                    osd_menu_state.tuning_mode = !osd_menu_state.tuning_mode;
-                    osd_state.needs_redraw = true;
-                }
-            }
-#endif
-            else if (osd_menu.current_menu == MENU_TYPE_ABOUT)
-            { // About submenu - only BACK button
-                if (osd_menu_state.selected_item == 0)
-                { // Back to Main
-                    menu_changed = osd_menu_go_back();
-                }
-            }
-            else
-            { // If we're in an unknown menu or want to close, toggle off
-                osd_menu_toggle();
-                menu_changed = true;
-            }
+    // Determine which button is being used (UP or DOWN)
+    uint8_t button_index = (direction > 0) ? 0 : 1; // 0=UP, 1=DOWN
 
-            if (menu_changed)
-            {
-                osd_block_buttons_until_release();
-#ifdef KBD_ENABLE
-                // Discard any BACK/SEL events that arrived during the action
-                // so they don't fire unexpectedly after the block clears.
-                osd_virtual_buttons = 0;
-#endif
-            }
+    // Calculate step size based on key hold duration
+    if (osd_buttons.key_held[button_index])
+    {
+        uint64_t hold_duration = current_time - osd_buttons.key_hold_start[button_index];
+
+        // Progressive step increase based on hold time and current frequency alignment
+        if (hold_duration > 5000000 && (settings.frequency % 100000 == 0))
+            freq_step = 100000; // After 5 seconds and 100kHz alignment: 100kHz steps
+        else if (hold_duration > 2000000 && (settings.frequency % 10000 == 0))
+            freq_step = 10000; // After 2 seconds and 10kHz alignment: 10kHz steps
+        else if (hold_duration > 1000000 && (settings.frequency % 1000 == 0))
+            freq_step = 1000; // After 1 second and 1kHz alignment: 1kHz steps
+        else
+            freq_step = 100; // First second: 100Hz steps
+    }
 
-            osd_buttons.sel_pressed = false;
-        }
-#ifdef KBD_ENABLE
-        // Handle BACK (ESC key via virtual buttons)
-        uint8_t virt = osd_virtual_buttons;
+    uint32_t new_freq = settings.frequency;
 
-        if (virt & OSD_VIRT_BACK)
-        {
-            osd_virtual_buttons &= ~OSD_VIRT_BACK;
-            osd_update_activity();
+    if (direction > 0 && new_freq <= FREQUENCY_MAX - freq_step)
+        new_freq += freq_step;
+    else if (direction < 0 && new_freq >= FREQUENCY_MIN + freq_step)
+        new_freq -= freq_step;
 
-            if (osd_menu_state.tuning_mode)
+    // Snap to the nearest preset in the direction of travel.
+    // When counting up, pick the lowest preset above current freq;
+    // when counting down, pick the highest preset below current freq.
+    {
+        uint32_t snap = 0;
+        bool found = false;
+        for (uint8_t i = 0; i < freq_presets_count; i++)
+        {
+            uint32_t preset = freq_presets[i];
+            if (settings.frequency == preset)
             {
-                osd_menu_state.tuning_mode = false;
-                osd_state.needs_redraw = true;
+                found = false; // Already at preset, keep counting past it
+                break;
             }
-            else if (osd_menu.menu_depth > 0)
+            if (direction > 0 && settings.frequency < preset && new_freq >= preset - freq_step)
             {
-                osd_menu_go_back();
-                osd_block_buttons_until_release();
+                // Counting up: take the first (lowest) qualifying preset
+                snap = preset;
+                found = true;
+                break;
             }
-            else
-                osd_menu_hide();
-        }
-#endif
-
-#ifdef MAIN_ITEM_FF_OSD
-        // Re-render when Gotek reports a new column count asynchronously (Core 1 update)
-        if (osd_menu.current_menu == MENU_TYPE_FF_OSD && settings.ff_osd_config.i2c_protocol)
-        {
-            static uint8_t last_ff_cols = 0;
-
-            if (ff_osd_display.cols != last_ff_cols)
+            if (direction < 0 && settings.frequency > preset && new_freq <= preset + freq_step)
             {
-                last_ff_cols = ff_osd_display.cols;
-                osd_state.needs_redraw = true;
+                // Counting down: keep updating to find the highest qualifying preset
+                snap = preset;
+                found = true;
             }
         }
-#endif
-
-        osd_flush_render();
+        if (found)
+        {
+            new_freq = snap;
+            osd_block_buttons_until_release();
+        }
     }
+
+    settings.frequency = new_freq;
+    // Apply frequency change immediately
+    set_capture_frequency(settings.frequency);
 }
 
-void osd_menu_toggle()
+static int32_t get_cap_sync_mode(const osd_menu_item_t *item)
 {
-    if (osd_state.menu_active)
-        osd_menu_hide();
-    else
-    {
-        osd_show();
-        osd_state.menu_active = true;
-    }
+    return settings.cap_sync_mode;
 }
 
-// Compute fg/bg colors for a menu row.
-// selected: whether this row is the current selection
-// tuning:   whether this row is in tuning (adjustment) mode
-// color:    the base text color (OSD_COLOR_TEXT or OSD_COLOR_DIMMED)
-static inline void menu_item_colors(bool selected, bool tuning, uint8_t color, uint8_t *fg, uint8_t *bg)
+static void set_cap_sync_mode(const osd_menu_item_t *item, int32_t value)
 {
-    if (selected && tuning)
-    {
-        *fg = OSD_COLOR_BACKGROUND;
-        *bg = OSD_COLOR_SELECTED;
-    }
-    else if (selected)
-    {
-        *fg = OSD_COLOR_BACKGROUND;
-        *bg = color;
-    }
-    else
+    settings.cap_sync_mode = value;
+    restart_capture = true;
+}
+
+static bool ext_sync_mode(const osd_menu_item_t *item)
+{
+    return settings.cap_sync_mode == EXT;
+}
+
+static int32_t get_divider(const osd_menu_item_t *item)
+{
+    return settings.ext_clk_divider;
+}
+
+static void set_divider(const osd_menu_item_t *item, int32_t value)
+{
+    set_ext_clk_divider(value);
+}
+
+static int32_t get_sync_mode(const osd_menu_item_t *item)
+{
+    return settings.video_sync_mode;
+}
+
+static void set_sync_mode(const osd_menu_item_t *item, int32_t value)
+{
+    settings.video_sync_mode = value;
+    set_video_sync_mode(settings.video_sync_mode);
+}
+
+// Image adjust, H_POS is shown mirrored so that UP moves the image right
+static int32_t get_shX(const osd_menu_item_t *item)
+{
+    return shX_MAX - settings.shX;
+}
+
+static void set_shX(const osd_menu_item_t *item, int32_t value)
+{
+    set_capture_shX(shX_MAX - value);
+}
+
+static int32_t get_shY(const osd_menu_item_t *item)
+{
+    return settings.shY;
+}
+
+static void set_shY(const osd_menu_item_t *item, int32_t value)
+{
+    set_capture_shY(value);
+}
+
+static int32_t get_delay(const osd_menu_item_t *item)
+{
+    return settings.delay;
+}
+
+static void set_delay(const osd_menu_item_t *item, int32_t value)
+{
+    set_capture_delay(value);
+}
+
+static void reset_image(const osd_menu_item_t *item)
+{
+    set_capture_shX(shX_DEF);
+    set_capture_shY(shY_DEF);
+    set_capture_delay(DELAY_DEF);
+    osd_menu_hide(); // Hide menu after resetting to defaults
+}
+
+// Pin inversion mask, arg is the bit position
+static int32_t get_mask_bit(const osd_menu_item_t *item)
+{
+    return (settings.pin_inversion_mask >> item->arg) & 1;
+}
+
+static void set_mask_bit(const osd_menu_item_t *item, int32_t value)
+{
+    settings.pin_inversion_mask &= ~(1 << item->arg);
+    settings.pin_inversion_mask |= value << item->arg;
+    set_pin_inversion_mask(settings.pin_inversion_mask);
+}
+
+#ifdef OSD_FF_ENABLE
+static int32_t get_ff_enabled(const osd_menu_item_t *item)
+{
+    return settings.ff_osd_config.enabled;
+}
+
+static void set_ff_enabled(const osd_menu_item_t *item, int32_t value)
+{
+    settings.ff_osd_config.enabled = value;
+
+    if (settings.ff_osd_config.enabled)
+        ff_osd_needs_i2c_init = true;
+}
+
+static int32_t get_ff_protocol(const osd_menu_item_t *item)
+{
+    return settings.ff_osd_config.i2c_protocol;
+}
+
+static void set_ff_protocol(const osd_menu_item_t *item, int32_t value)
+{
+    settings.ff_osd_config.i2c_protocol = value;
+
+    if (settings.ff_osd_config.i2c_protocol)
     {
-        *fg = color;
-        *bg = OSD_COLOR_BACKGROUND;
+        settings.ff_osd_config.cols = ff_osd_display.cols;
+        settings.ff_osd_config.rows = ff_osd_display.rows;
     }
+    else
+        settings.ff_osd_config.rows = 2;
+
+    ff_osd_needs_i2c_init = true;
+}
+
+// ROWS and COLUMNS are set by the Gotek in the FlashFloppy protocol
+static bool ff_lcd_protocol(const osd_menu_item_t *item)
+{
+    return !settings.ff_osd_config.i2c_protocol;
 }
 
-// Menu rendering functions
-static void render_main_menu()
+static int32_t get_ff_rows(const osd_menu_item_t *item)
 {
-    const char *items[] = {
-        "OUTPUT SETTINGS",
-        "CAPTURE SETTINGS",
-        "IMAGE ADJUST",
-#ifdef MAIN_ITEM_FF_OSD
-        "FF OSD CONFIG",
+    return settings.ff_osd_config.i2c_protocol ? ff_osd_display.rows : settings.ff_osd_config.rows;
+}
+
+static void adjust_ff_rows(const osd_menu_item_t *item, int8_t direction)
+{ // toggle 2/4
+    settings.ff_osd_config.rows = (settings.ff_osd_config.rows == 2) ? 4 : 2;
+
+    if (settings.ff_osd_config.rows * settings.ff_osd_config.cols > 80)
+        settings.ff_osd_config.cols = 20; // Adjust columns to max allowed for 4 rows
+
+    ff_osd_display.rows = settings.ff_osd_config.rows;
+    ff_osd_display.cols = settings.ff_osd_config.cols;
+}
+
+static int32_t get_ff_cols(const osd_menu_item_t *item)
+{
+    return settings.ff_osd_config.i2c_protocol ? ff_osd_display.cols : settings.ff_osd_config.cols;
+}
+
+static void adjust_ff_cols(const osd_menu_item_t *item, int8_t direction)
+{
+    settings.ff_osd_config.cols = ff_osd_set_cols(settings.ff_osd_config.cols + direction);
+
+    if (settings.ff_osd_config.rows * settings.ff_osd_config.cols > 80)
+        settings.ff_osd_config.rows = 2;
+
+    ff_osd_display.rows = settings.ff_osd_config.rows;
+    ff_osd_display.cols = settings.ff_osd_config.cols;
+}
+
+static int32_t get_ff_h_position(const osd_menu_item_t *item)
+{
+    return settings.ff_osd_config.h_position;
+}
+
+static void adjust_ff_h_position(const osd_menu_item_t *item, int8_t direction)
+{ // cycle 1-5
+    settings.ff_osd_config.h_position = ff_osd_set_h_position(settings.ff_osd_config.h_position + direction);
+}
+
+static int32_t get_ff_v_position(const osd_menu_item_t *item)
+{
+    return settings.ff_osd_config.v_position;
+}
+
+static void set_ff_v_position(const osd_menu_item_t *item, int32_t value)
+{
+    settings.ff_osd_config.v_position = value;
+}
+
+static int32_t get_ff_blend(const osd_menu_item_t *item)
+{
+    return settings.ff_osd_config.blend;
+}
+
+static void set_ff_blend(const osd_menu_item_t *item, int32_t value)
+{
+    settings.ff_osd_config.blend = value;
+}
+
+static int32_t get_ff_font(const osd_menu_item_t *item)
+{
+    return settings.ff_osd_config.font;
+}
+
+static void set_ff_font(const osd_menu_item_t *item, int32_t value)
+{
+    settings.ff_osd_config.font = value;
+}
 #endif
-#ifdef MAIN_ITEM_HARDWARE
-        "HARDWARE CONFIG",
+
+#ifdef HW_CONFIG_ENABLE
+static int32_t get_rom_bank(const osd_menu_item_t *item)
+{
+    return settings.hw_config.rom_bank;
+}
+
+static void set_rom_bank(const osd_menu_item_t *item, int32_t value)
+{
+    settings.hw_config.rom_bank = value;
+}
+
+static int32_t get_ram_size(const osd_menu_item_t *item)
+{
+    return settings.hw_config.ram_size;
+}
+
+static void set_ram_size(const osd_menu_item_t *item, int32_t value)
+{
+    settings.hw_config.ram_size = value;
+    hw_set_ram_size(settings.hw_config.ram_size);
+}
+
+static int32_t get_gotek_drive(const osd_menu_item_t *item)
+{
+    return settings.hw_config.gotek_drive;
+}
+
+static void set_gotek_drive(const osd_menu_item_t *item, int32_t value)
+{
+    settings.hw_config.gotek_drive = value;
+    hw_set_gotek_drive(settings.hw_config.gotek_drive);
+}
 #endif
-        "ABOUT",
-        "SAVE",
-        "EXIT"};
 
-    for (int i = 0; i < MAIN_ITEM_COUNT; i++)
+#ifdef KBD_ENABLE
+static int32_t get_keymap(const osd_menu_item_t *item)
+{
+    return settings.input_config.keymap;
+}
+
+static void set_keymap(const osd_menu_item_t *item, int32_t value)
+{
+    settings.input_config.keymap = value;
+    zx_keymap_select(settings.input_config.keymap);
+}
+#endif
+
+#ifdef USB_KBD_ENABLE
+static int32_t get_joystick(const osd_menu_item_t *item)
+{
+    return settings.input_config.joystick;
+}
+
+static void set_joystick(const osd_menu_item_t *item, int32_t value)
+{
+    settings.input_config.joystick = value;
+}
+
+#ifdef SPI_KB_ENABLE
+static int32_t get_mouse(const osd_menu_item_t *item)
+{
+    return settings.input_config.mouse;
+}
+
+static void set_mouse(const osd_menu_item_t *item, int32_t value)
+{
+    settings.input_config.mouse = value;
+    usb_mouse_set_profile(settings.input_config.mouse);
+}
+#endif
+#endif
+
+#ifdef PERF_STATS_ENABLE
+// Stats, arg selects the value
+#define STAT_IN_FPS 0
+#define STAT_OUT_FPS 1
+#define STAT_FRAMES 2
+#define STAT_CAPTURE_ISR 3
+#define STAT_OUTPUT_ISR 4
+#define STAT_CORE0_IDLE 5
+#define STAT_CORE1_IDLE 6
+#define STAT_LINE_FREQ 7
+
+static const char *format_stat(const osd_menu_item_t *item, char *buffer)
+{
+    switch (item->arg)
     {
-        uint8_t row = OSD_MENU_START_ROW + i;
-        uint8_t fg_color, bg_color;
-        menu_item_colors(i == osd_menu_state.selected_item, false, OSD_COLOR_TEXT, &fg_color, &bg_color);
+    case STAT_IN_FPS:
+        sprintf(buffer, "%u.%u", perf_stats.in_fps / 10, perf_stats.in_fps % 10);
+        break;
 
-        if (i < MAIN_ITEM_ABOUT)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-16s >", items[i]);
-        else
-            osd_text_print(row, 2, items[i], fg_color, bg_color, 0);
+    case STAT_OUT_FPS:
+        sprintf(buffer, "%u.%u", perf_stats.out_fps / 10, perf_stats.out_fps % 10);
+        break;
+
+    case STAT_FRAMES:
+        sprintf(buffer, "%u/%u", perf_stats.dropped_frames, perf_stats.repeated_frames);
+        break;
+
+    case STAT_CAPTURE_ISR:
+        sprintf(buffer, "%lu/%lu", perf_stats.capture_avg, perf_stats.capture_max);
+        break;
+
+    case STAT_OUTPUT_ISR:
+        sprintf(buffer, "%lu/%lu", perf_stats.output_avg, perf_stats.output_max);
+        break;
+
+    case STAT_CORE0_IDLE:
+        sprintf(buffer, "%u%%", perf_stats.core0_idle);
+        break;
+
+    case STAT_CORE1_IDLE:
+        sprintf(buffer, "%u%%", perf_stats.core1_idle);
+        break;
+
+    case STAT_LINE_FREQ:
+        sprintf(buffer, "%lu HZ", perf_stats.line_freq);
+        break;
     }
+
+    return buffer;
 }
+#endif
 
-static void render_output_menu()
+#ifdef KBD_JOURNAL_ENABLE
+// Key latency, arg = source * KEY_LATENCY_VALUES + value
+#define KEY_LATENCY_EVENTS 0
+#define KEY_LATENCY_P50_P90 1
+#define KEY_LATENCY_P99_MAX 2
+#define KEY_LATENCY_MERGE 3
+#define KEY_LATENCY_VALUES 4
+
+// percentiles of the journal, read again once per second while the page is shown
+static kbd_latency_t key_latency[KBD_SOURCES];
+
+static void update_key_latency()
 {
-    osd_text_print_centered(OSD_SUBTITLE_ROW, "OUTPUT SETTINGS", OSD_COLOR_SELECTED, OSD_COLOR_BACKGROUND, 0);
+    for (int source = 0; source < KBD_SOURCES; source++)
+        kbd_journal_latency((kbd_source_t)source, &key_latency[source]);
+}
 
-    const char *mode_names_dvi[] = {
-        "640X480@60",
-        "720X576@50",
-    };
-    const char *mode_names_vga[] = {
-        "640X480@60",
-        "800X600@60",
-        "1024X768@60 DIV3",
-        "1024X768@60 DIV4",
-        "1280X1024@60 DIV3",
-        "1280X1024@60 DIV4",
-    };
-    const char *current_mode_name = "UNKNOWN";
+static const char *format_key_latency(const osd_menu_item_t *item, char *buffer)
+{
+    const kbd_latency_t *latency = &key_latency[item->arg / KEY_LATENCY_VALUES];
 
-    for (int i = 0; i < 4; i++)
+    switch (item->arg % KEY_LATENCY_VALUES)
     {
-        uint8_t row = OSD_MENU_START_ROW + i;
-        uint8_t color = OSD_COLOR_TEXT;
-        uint8_t fg_color, bg_color;
+    case KEY_LATENCY_EVENTS:
+        sprintf(buffer, "%u", latency->count);
+        break;
 
-        if (i == 1)
-        {
-            if (settings.video_out_type == DVI)
-                color = OSD_COLOR_DIMMED;
-            else if (settings.video_out_type == VGA)
-            {
-#ifndef SCANLINES_ENABLE_LOW_RES
-                uint8_t div = video_modes[settings.video_out_mode]->div;
+    case KEY_LATENCY_P50_P90:
+        sprintf(buffer, "%u/%u", latency->p50, latency->p90);
+        break;
+
+    case KEY_LATENCY_P99_MAX:
+        sprintf(buffer, "%u/%u", latency->p99, latency->max);
+        break;
 
-                if (div != 3 && div != 4)
-                    color = OSD_COLOR_DIMMED;
+    case KEY_LATENCY_MERGE:
+        sprintf(buffer, "%u/%u", latency->dispatch_p50, latency->dispatch_p99);
+        break;
+    }
+
+    return buffer;
+}
+
+#define KEY_LATENCY(source, value) ((source) * KEY_LATENCY_VALUES + (value))
 #endif
-            }
+
+// Main menu
+static void save_and_exit(const osd_menu_item_t *item)
+{
+    save_settings(&settings);
+    osd_menu_hide();
+    osd_toast_show("SETTINGS SAVED", OSD_TOAST_DURATION_US);
+}
+
+static void exit_menu(const osd_menu_item_t *item)
+{ // Exit without saving
+    osd_menu_hide();
+}
+
+// Menu tables
+
+static const char *const names_scanlines[] = {"OFF", "ON", "DIM"};
+static const char *const names_buffering[] = {"X1", "X3"};
+static const char *const names_cap_sync[] = {"SELF-SYNC", "EXTERNAL"};
+static const char *const names_video_sync[] = {"COMPOSITE", "SEPARATE"};
+
+static const osd_menu_item_t menu_main[] = {
+    {"OUTPUT SETTINGS", MENU_ITEM_SUBMENU, MENU_TYPE_OUTPUT},
+    {"CAPTURE SETTINGS", MENU_ITEM_SUBMENU, MENU_TYPE_CAPTURE},
+    {"IMAGE ADJUST", MENU_ITEM_SUBMENU, MENU_TYPE_IMAGE_ADJUST},
+#ifdef OSD_FF_ENABLE
+    {"FF OSD CONFIG", MENU_ITEM_SUBMENU, MENU_TYPE_FF_OSD},
+#endif
+#ifdef KBD_ENABLE
+    {"INPUT SETTINGS", MENU_ITEM_SUBMENU, MENU_TYPE_INPUT},
+#endif
+#ifdef HW_CONFIG_ENABLE
+    {"HARDWARE CONFIG", MENU_ITEM_SUBMENU, MENU_TYPE_HARDWARE},
+#endif
+    {"ABOUT", MENU_ITEM_SUBMENU, MENU_TYPE_ABOUT},
+    {"SAVE", MENU_ITEM_ACTION, .select = save_and_exit},
+    {"EXIT", MENU_ITEM_ACTION, .select = exit_menu},
+};
+
+static const osd_menu_item_t menu_output[] = {
+    {"MODE", MENU_ITEM_TUNED, .adjust = adjust_video_mode, .format = format_video_mode, .select = select_video_mode},
+    {"SCANLINES", MENU_ITEM_TOGGLE, .min = SCANLINES_OFF, .max = SCANLINES_DIM, .names = names_scanlines,
+     .get = get_scanlines, .adjust = adjust_scanlines, .enabled = scanlines_available},
+    {"BUFFERING", MENU_ITEM_TOGGLE, 0, 0, 1, names_buffering, get_buffering, set_buffering},
+    {"< BACK TO MAIN", MENU_ITEM_BACK},
+};
+
+static const osd_menu_item_t menu_capture[] = {
+    {"FREQ", MENU_ITEM_TUNED, .get = get_frequency, .adjust = adjust_frequency},
+    {"MODE", MENU_ITEM_TOGGLE, 0, SELF, EXT, names_cap_sync, get_cap_sync_mode, set_cap_sync_mode},
+    {"DIVIDER", MENU_ITEM_TUNED, 0, EXT_CLK_DIVIDER_MIN, EXT_CLK_DIVIDER_MAX, NULL, get_divider, set_divider,
+     .enabled = ext_sync_mode},
+    {"SYNC", MENU_ITEM_TOGGLE, 0, 0, 1, names_video_sync, get_sync_mode, set_sync_mode},
+    {"MASK", MENU_ITEM_SUBMENU, MENU_TYPE_MASK},
+    {"< BACK TO MAIN", MENU_ITEM_BACK},
+};
+
+static const osd_menu_item_t menu_image_adjust[] = {
+    {"H_POS", MENU_ITEM_TUNED, 0, 0, shX_MAX - shX_MIN, NULL, get_shX, set_shX},
+    {"V_POS", MENU_ITEM_TUNED, 0, shY_MIN, shY_MAX, NULL, get_shY, set_shY},
+    {"DELAY", MENU_ITEM_TUNED, 0, DELAY_MIN, DELAY_MAX, NULL, get_delay, set_delay},
+    {"RESET TO DEFAULTS", MENU_ITEM_ACTION, .select = reset_image},
+    {"< BACK TO MAIN", MENU_ITEM_BACK},
+};
+
+static const osd_menu_item_t menu_mask[] = {
+    {"F   (FREQ)", MENU_ITEM_TOGGLE, CAP_F, 0, 1, names_off_on, get_mask_bit, set_mask_bit},
+    {"SSI (HSYNC)", MENU_ITEM_TOGGLE, CAP_HS, 0, 1, names_off_on, get_mask_bit, set_mask_bit},
+    {"KSI (VSYNC)", MENU_ITEM_TOGGLE, CAP_VS, 0, 1, names_off_on, get_mask_bit, set_mask_bit},
+    {"I   (BRIGHT)", MENU_ITEM_TOGGLE, CAP_I, 0, 1, names_off_on, get_mask_bit, set_mask_bit},
+    {"R   (RED)", MENU_ITEM_TOGGLE, CAP_R, 0, 1, names_off_on, get_mask_bit, set_mask_bit},
+    {"G   (GREEN)", MENU_ITEM_TOGGLE, CAP_G, 0, 1, names_off_on, get_mask_bit, set_mask_bit},
+    {"B   (BLUE)", MENU_ITEM_TOGGLE, CAP_B, 0, 1, names_off_on, get_mask_bit, set_mask_bit},
+    {"< BACK TO CAPTURE", MENU_ITEM_BACK},
+};
+
+#ifdef OSD_FF_ENABLE
+static const char *const names_ff_protocol[] = {"LCD HD44780", "FLASHFLOPPY"};
+static const char *const names_ff_h_position[] = {"LEFT", "LEFT-CENTER", "CENTER", "CENTER-RIGHT", "RIGHT"};
+static const char *const names_ff_v_position[] = {"TOP", "BOTTOM"};
+static const char *const names_ff_blend[] = {"OPAQUE", "KEY", "SHADE"};
+static const char *const names_ff_font[] = {"BOLD", "ZX"};
+
+static const osd_menu_item_t menu_ff_osd[] = {
+    {"ENABLE", MENU_ITEM_TOGGLE, 0, 0, 1, names_off_on, get_ff_enabled, set_ff_enabled},
+    {"PROTOCOL", MENU_ITEM_TOGGLE, 0, 0, 1, names_ff_protocol, get_ff_protocol, set_ff_protocol},
+    {"ROWS", MENU_ITEM_TOGGLE, .get = get_ff_rows, .adjust = adjust_ff_rows, .enabled = ff_lcd_protocol},
+    {"COLUMNS", MENU_ITEM_TUNED, .get = get_ff_cols, .adjust = adjust_ff_cols, .enabled = ff_lcd_protocol},
+    {"H_POS", MENU_ITEM_TUNED, 0, 1, 5, names_ff_h_position, get_ff_h_position, .adjust = adjust_ff_h_position},
+    {"V_POS", MENU_ITEM_TOGGLE, 0, 0, 1, names_ff_v_position, get_ff_v_position, set_ff_v_position},
+    {"BLEND", MENU_ITEM_TOGGLE, 0, OSD_BLEND_MIN, OSD_BLEND_MAX, names_ff_blend, get_ff_blend, set_ff_blend},
+    {"FONT", MENU_ITEM_TOGGLE, 0, 0, OSD_FONTS - 1, names_ff_font, get_ff_font, set_ff_font},
+    {"< BACK TO MAIN", MENU_ITEM_BACK},
+};
+#endif
+
+#ifdef HW_CONFIG_ENABLE
+static const char *const names_ram_size[] = {"128", "1024"};
+static const char *const names_gotek_drive[] = {"OFF", "A", "B"};
+
+static const osd_menu_item_t menu_hardware[] = {
+    {"ROM BANK", MENU_ITEM_TUNED, 0, HW_ROM_BANK_MIN, HW_ROM_BANK_MAX, NULL, get_rom_bank, set_rom_bank},
+    {"RAM (KB)", MENU_ITEM_TOGGLE, 0, 0, 1, names_ram_size, get_ram_size, set_ram_size},
+    {"GOTEK DRIVE", MENU_ITEM_TUNED, 0, HW_GOTEK_DRIVE_MIN, HW_GOTEK_DRIVE_MAX, names_gotek_drive, get_gotek_drive, set_gotek_drive},
+    {"< BACK TO MAIN", MENU_ITEM_BACK},
+};
+#endif
+
+#ifdef KBD_ENABLE
+static const char *const names_keymap[] = {"STANDARD", "USER 1", "USER 2", "USER 3", "USER 4"};
+
+static_assert(count_of(names_keymap) == KEYMAP_USER_MAX + 1, "");
+
+#ifdef USB_KBD_ENABLE
+static const char *const names_joystick[] = {"OFF", "SINCLAIR", "CURSOR", "QAOP"};
+#ifdef SPI_KB_ENABLE
+static const char *const names_mouse[] = {"1:1", "1/2", "1/4", "1/2 ACCEL", "1/4 ACCEL"};
+
+static_assert(count_of(names_mouse) == MOUSE_PROFILES, "");
+#endif
+#endif
+
+static const osd_menu_item_t menu_input[] = {
+    {"KEYMAP", MENU_ITEM_TOGGLE, 0, 0, KEYMAP_USER_MAX, names_keymap, get_keymap, set_keymap},
+#ifdef USB_KBD_ENABLE
+    {"JOYSTICK", MENU_ITEM_TOGGLE, 0, JOYSTICK_OFF, JOYSTICK_PROFILES - 1, names_joystick, get_joystick, set_joystick},
+#ifdef SPI_KB_ENABLE
+    {"MOUSE", MENU_ITEM_TOGGLE, 0, MOUSE_1_1, MOUSE_PROFILES - 1, names_mouse, get_mouse, set_mouse},
+#endif
+#endif
+    {"< BACK TO MAIN", MENU_ITEM_BACK},
+};
+#endif
+
+#ifdef PERF_STATS_ENABLE
+static const osd_menu_item_t menu_stats[] = {
+    {"IN FPS", MENU_ITEM_TEXT, STAT_IN_FPS, .format = format_stat},
+    {"OUT FPS", MENU_ITEM_TEXT, STAT_OUT_FPS, .format = format_stat},
+    {"DROP/REPEAT", MENU_ITEM_TEXT, STAT_FRAMES, .format = format_stat},
+    {"CAP ISR", MENU_ITEM_TEXT, STAT_CAPTURE_ISR, .format = format_stat},
+    {"OUT ISR", MENU_ITEM_TEXT, STAT_OUTPUT_ISR, .format = format_stat},
+    {"CORE0 IDLE", MENU_ITEM_TEXT, STAT_CORE0_IDLE, .format = format_stat},
+    {"CORE1 IDLE", MENU_ITEM_TEXT, STAT_CORE1_IDLE, .format = format_stat},
+    {"LINE FREQ", MENU_ITEM_TEXT, STAT_LINE_FREQ, .format = format_stat},
+#ifdef KBD_JOURNAL_ENABLE
+    {"KEY LATENCY", MENU_ITEM_SUBMENU, MENU_TYPE_KEY_LATENCY},
+#endif
+    {"< BACK TO ABOUT", MENU_ITEM_BACK},
+};
+#endif
+
+#ifdef KBD_JOURNAL_ENABLE
+// input IRQ -> ZX matrix output of the last key events in the journal, MERGE: input IRQ -> key states merged (P50/P99)
+static const osd_menu_item_t menu_key_latency[] = {
+#ifdef PS2_KBD_ENABLE
+    {"PS/2 KEYS", MENU_ITEM_TEXT, KEY_LATENCY(KBD_SOURCE_PS2, KEY_LATENCY_EVENTS), .format = format_key_latency},
+    {"  P50/P90", MENU_ITEM_TEXT, KEY_LATENCY(KBD_SOURCE_PS2, KEY_LATENCY_P50_P90), .format = format_key_latency},
+    {"  P99/MAX", MENU_ITEM_TEXT, KEY_LATENCY(KBD_SOURCE_PS2, KEY_LATENCY_P99_MAX), .format = format_key_latency},
+    {"  MERGE", MENU_ITEM_TEXT, KEY_LATENCY(KBD_SOURCE_PS2, KEY_LATENCY_MERGE), .format = format_key_latency},
+#endif
+#ifdef USB_KBD_ENABLE
+    {"USB KEYS", MENU_ITEM_TEXT, KEY_LATENCY(KBD_SOURCE_USB, KEY_LATENCY_EVENTS), .format = format_key_latency},
+    {"  P50/P90", MENU_ITEM_TEXT, KEY_LATENCY(KBD_SOURCE_USB, KEY_LATENCY_P50_P90), .format = format_key_latency},
+    {"  P99/MAX", MENU_ITEM_TEXT, KEY_LATENCY(KBD_SOURCE_USB, KEY_LATENCY_P99_MAX), .format = format_key_latency},
+    {"  MERGE", MENU_ITEM_TEXT, KEY_LATENCY(KBD_SOURCE_USB, KEY_LATENCY_MERGE), .format = format_key_latency},
+#endif
+    {"< BACK TO STATS", MENU_ITEM_BACK},
+};
+#endif
+
+static const osd_menu_item_t menu_about[] = {
+    {"VERSION   " FW_VERSION, MENU_ITEM_TEXT},
+    {"BOARD     " HW_VERSION, MENU_ITEM_TEXT},
+#ifdef PERF_STATS_ENABLE
+    {"STATS", MENU_ITEM_SUBMENU, MENU_TYPE_STATS}, // the main menu is full on LEO V3 boards
+#else
+    {"", MENU_ITEM_TEXT},
+#endif
+    {GIT_REPO_URL_1, MENU_ITEM_TEXT},
+    {GIT_REPO_URL_2, MENU_ITEM_TEXT},
+    {GIT_REPO_URL_3, MENU_ITEM_TEXT},
+#ifdef GIT_REPO_URL_4
+    {GIT_REPO_URL_4, MENU_ITEM_TEXT},
+#else
+    {"", MENU_ITEM_TEXT},
+#endif
+    {"< BACK TO MAIN", MENU_ITEM_BACK},
+};
+
+#define OSD_MENU_PAGE(title, items, label_width) {title, items, count_of(items), label_width}
+
+static const osd_menu_page_t osd_menu_pages[] = {
+    [MENU_TYPE_MAIN] = OSD_MENU_PAGE("SETUP MENU", menu_main, 16),
+    [MENU_TYPE_OUTPUT] = OSD_MENU_PAGE("OUTPUT SETTINGS", menu_output, 9),
+    [MENU_TYPE_CAPTURE] = OSD_MENU_PAGE("CAPTURE SETTINGS", menu_capture, 9),
+    [MENU_TYPE_IMAGE_ADJUST] = OSD_MENU_PAGE("IMAGE ADJUST", menu_image_adjust, 9),
+    [MENU_TYPE_MASK] = OSD_MENU_PAGE("PIN INVERSION MASK", menu_mask, 12),
+    [MENU_TYPE_ABOUT] = OSD_MENU_PAGE("ABOUT", menu_about, 9),
+#ifdef OSD_FF_ENABLE
+    [MENU_TYPE_FF_OSD] = OSD_MENU_PAGE("FF OSD CONFIG", menu_ff_osd, 9),
+#endif
+#ifdef HW_CONFIG_ENABLE
+    [MENU_TYPE_HARDWARE] = OSD_MENU_PAGE("HARDWARE CONFIG", menu_hardware, 12),
+#endif
+#ifdef PERF_STATS_ENABLE
+    [MENU_TYPE_STATS] = OSD_MENU_PAGE("STATS (ISR AVG/MAX CYCLES)", menu_stats, 11),
+#endif
+#ifdef KBD_JOURNAL_ENABLE
+    [MENU_TYPE_KEY_LATENCY] = OSD_MENU_PAGE("KEY LATENCY (US)", menu_key_latency, 11),
+#endif
+#ifdef KBD_ENABLE
+    [MENU_TYPE_INPUT] = OSD_MENU_PAGE("INPUT SETTINGS", menu_input, 9),
+#endif
+};
+
+// Menu engine
+
+static inline const osd_menu_page_t *osd_menu_current_page()
+{
+    return &osd_menu_pages[osd_menu.current_menu];
+}
+
+static inline bool osd_menu_item_enabled(const osd_menu_item_t *item)
+{
+    return item->enabled == NULL || item->enabled(item);
+}
+
+static inline void osd_menu_mark_row(uint8_t index)
+{
+    osd_menu_dirty_rows |= 1u << index;
+}
+
+static inline void osd_menu_mark_items()
+{ // a value change can dim or change other items
+    osd_menu_dirty_rows = 0xFFFF;
+}
+
+static uint8_t osd_menu_first_item(const osd_menu_page_t *page)
+{
+    for (uint8_t i = 0; i < page->count; i++)
+        if (page->items[i].type != MENU_ITEM_TEXT)
+            return i;
+
+    return 0;
+}
+
+// Navigate back to the parent menu, restoring the previous selection.
+// Returns true if navigation occurred.
+static bool osd_menu_go_back(void)
+{
+    if (osd_menu.menu_depth == 0)
+        return false;
+
+    osd_menu.menu_depth--;
+    osd_menu.current_menu = osd_menu.menu_stack[osd_menu.menu_depth];
+    osd_menu_state.selected_item = osd_menu.item_stack[osd_menu.menu_depth];
+    osd_menu_state.tuning_mode = false;
+    osd_state.needs_redraw = true;
+    return true;
+}
+
+// Enter a child submenu, saving current position on the stack.
+// Returns true if navigation occurred.
+static bool osd_menu_enter_submenu(uint8_t menu_type)
+{
+    if (osd_menu.menu_depth >= 4)
+        return false;
+
+    osd_menu.menu_stack[osd_menu.menu_depth] = osd_menu.current_menu;
+    osd_menu.item_stack[osd_menu.menu_depth] = osd_menu_state.selected_item;
+    osd_menu.menu_depth++;
+    osd_menu.current_menu = menu_type;
+    osd_menu_state.selected_item = osd_menu_first_item(osd_menu_current_page());
+    osd_menu_state.tuning_mode = false;
+    osd_state.needs_redraw = true;
+    return true;
+}
+
+// Move the selection by one selectable item
+static void osd_menu_move(int8_t step)
+{
+    const osd_menu_page_t *page = osd_menu_current_page();
+    int8_t index = osd_menu_state.selected_item;
+
+    do
+        index += step;
+    while (index >= 0 && index < page->count && page->items[index].type == MENU_ITEM_TEXT);
+
+    if (index < 0 || index >= page->count)
+        return;
+
+    osd_menu_mark_row(osd_menu_state.selected_item);
+    osd_menu_mark_row(index);
+    osd_menu_state.selected_item = index;
+}
+
+static void osd_menu_item_adjust(const osd_menu_item_t *item, int8_t direction, bool wrap)
+{
+    if (item->adjust != NULL)
+        item->adjust(item, direction);
+    else if (item->get != NULL && item->set != NULL)
+    {
+        int32_t value = item->get(item) + direction;
+
+        if (value > item->max)
+        {
+            if (!wrap)
+                return;
+
+            value = item->min;
         }
+        else if (value < item->min)
+            return;
+
+        item->set(item, value);
+    }
 
-        menu_item_colors(i == osd_menu_state.selected_item, i == 0 && osd_menu_state.tuning_mode, color, &fg_color, &bg_color);
+    osd_menu_mark_items();
+}
 
-        if (i == 0)
+// Returns true when the menu was left or changed
+static bool osd_menu_select(const osd_menu_item_t *item)
+{
+    switch (item->type)
+    {
+    case MENU_ITEM_SUBMENU:
+        return osd_menu_enter_submenu(item->arg);
+
+    case MENU_ITEM_BACK:
+        return osd_menu_go_back();
+
+    case MENU_ITEM_ACTION:
+        item->select(item);
+        return true;
+
+    case MENU_ITEM_TOGGLE:
+        if (osd_menu_item_enabled(item))
+            osd_menu_item_adjust(item, 1, true);
+
+        break;
+
+    case MENU_ITEM_TUNED:
+        if (osd_menu_item_enabled(item))
         {
-            if (settings.video_out_type == DVI)
-            {
-                if (settings.video_out_mode == MODE_640x480_60Hz)
-                    current_mode_name = mode_names_dvi[0];
-                else if (settings.video_out_mode == MODE_720x576_50Hz)
-                    current_mode_name = mode_names_dvi[1];
-            }
-            else
-            {
-                if (settings.video_out_mode == MODE_640x480_60Hz)
-                    current_mode_name = mode_names_vga[0];
-                else if (settings.video_out_mode == MODE_800x600_60Hz)
-                    current_mode_name = mode_names_vga[1];
-                else if (settings.video_out_mode == MODE_1024x768_60Hz_d3)
-                    current_mode_name = mode_names_vga[2];
-                else if (settings.video_out_mode == MODE_1024x768_60Hz_d4)
-                    current_mode_name = mode_names_vga[3];
-                else if (settings.video_out_mode == MODE_1280x1024_60Hz_d3)
-                    current_mode_name = mode_names_vga[4];
-                else if (settings.video_out_mode == MODE_1280x1024_60Hz_d4)
-                    current_mode_name = mode_names_vga[5];
-            }
+            osd_menu_state.tuning_mode = !osd_menu_state.tuning_mode;
+
+            if (item->select != NULL)
+                item->select(item);
 
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "MODE", current_mode_name);
+            osd_menu_mark_row(osd_menu_state.selected_item);
         }
-        else if (i == 1)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "SCANLINES", settings.scanlines_mode ? "ON" : "OFF");
-        else if (i == 2)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "BUFFERING", settings.buffering_mode ? "X3" : "X1");
-        else if (i == 3)
-            osd_text_print(row, 2, "< BACK TO MAIN", fg_color, bg_color, 0);
-
-        if (i == 0 && i == osd_menu_state.selected_item && osd_menu_state.tuning_mode)
-            osd_text_set_char(row, 1, '>', fg_color, bg_color);
+
+        break;
+    }
+
+    return false;
+}
+
+// Returns true when the menu was left or changed
+static bool osd_menu_handle_event(uint8_t event)
+{
+    const osd_menu_page_t *page = osd_menu_current_page();
+    const osd_menu_item_t *item = &page->items[osd_menu_state.selected_item];
+
+    switch (event)
+    {
+    case OSD_MENU_EVENT_UP:
+    case OSD_MENU_EVENT_DOWN:
+    {
+        int8_t direction = event == OSD_MENU_EVENT_UP ? 1 : -1;
+
+        if (osd_menu_state.tuning_mode)
+            osd_menu_item_adjust(item, direction, false);
+        else
+            osd_menu_move(-direction);
+
+        break;
+    }
+
+    case OSD_MENU_EVENT_SEL:
+        return osd_menu_select(item);
+
+    case OSD_MENU_EVENT_BACK:
+        if (osd_menu_state.tuning_mode)
+        {
+            osd_menu_state.tuning_mode = false;
+            osd_menu_mark_row(osd_menu_state.selected_item);
+            break;
+        }
+
+        if (osd_menu_go_back())
+            return true;
+
+        osd_menu_hide();
+        return true;
     }
+
+    return false;
+}
+
+void osd_menu_post_event(osd_menu_event_t event)
+{
+    uint8_t head = (osd_menu_events_head + 1) % OSD_MENU_EVENTS;
+
+    if (head == osd_menu_events_tail)
+        return; // full, the user is faster than the menu
+
+    osd_menu_events[osd_menu_events_head] = event;
+    osd_menu_events_head = head;
 }
 
-static void render_capture_menu()
+static bool osd_menu_get_event(uint8_t *event)
 {
-    osd_text_print_centered(OSD_SUBTITLE_ROW, "CAPTURE SETTINGS", OSD_COLOR_SELECTED, OSD_COLOR_BACKGROUND, 0);
+    if (osd_menu_events_tail == osd_menu_events_head)
+        return false;
+
+    *event = osd_menu_events[osd_menu_events_tail];
+    osd_menu_events_tail = (osd_menu_events_tail + 1) % OSD_MENU_EVENTS;
+
+    return true;
+}
 
-    for (int i = 0; i < 6; i++)
+static void osd_menu_flush_events()
+{
+    osd_menu_events_tail = osd_menu_events_head;
+}
+
+// Compute fg/bg colors for a menu row.
+// selected: whether this row is the current selection
+// tuning:   whether this row is in tuning (adjustment) mode
+// color:    the base text color (OSD_COLOR_TEXT or OSD_COLOR_DIMMED)
+static inline void menu_item_colors(bool selected, bool tuning, uint8_t color, uint8_t *fg, uint8_t *bg)
+{
+    if (selected && tuning)
     {
-        uint8_t row = OSD_MENU_START_ROW + i;
-        uint8_t color = OSD_COLOR_TEXT;
-        uint8_t fg_color, bg_color;
-
-        if (i == 2 && settings.cap_sync_mode != EXT)
-            color = OSD_COLOR_DIMMED;
-
-        menu_item_colors(i == osd_menu_state.selected_item, i < 5 && i != 1 && i != 3 && osd_menu_state.tuning_mode, color, &fg_color, &bg_color);
-
-        if (i == 0)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %lu", "FREQ", settings.frequency);
-        else if (i == 1)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "MODE", settings.cap_sync_mode == SELF ? "SELF-SYNC" : "EXTERNAL");
-        else if (i == 2)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %d", "DIVIDER", settings.ext_clk_divider);
-        else if (i == 3)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "SYNC", settings.video_sync_mode ? "SEPARATE" : "COMPOSITE");
-        else if (i == 4)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "MASK", ">");
-        else if (i == 5)
-            osd_text_print(row, 2, "< BACK TO MAIN", fg_color, bg_color, 0);
-
-        if (i < 5 && i != 1 && i != 3 && i == osd_menu_state.selected_item && osd_menu_state.tuning_mode)
-            osd_text_set_char(row, 1, '>', fg_color, bg_color);
+        *fg = OSD_COLOR_BACKGROUND;
+        *bg = OSD_COLOR_SELECTED;
     }
-}
-
-static void render_image_adjust_menu()
-{
-    osd_text_print_centered(OSD_SUBTITLE_ROW, "IMAGE ADJUST", OSD_COLOR_SELECTED, OSD_COLOR_BACKGROUND, 0);
-
-    for (int i = 0; i < 5; i++)
+    else if (selected)
     {
-        uint8_t row = OSD_MENU_START_ROW + i;
-        uint8_t color = OSD_COLOR_TEXT;
-        uint8_t fg_color, bg_color;
-
-        menu_item_colors(i == osd_menu_state.selected_item, i < 3 && osd_menu_state.tuning_mode, color, &fg_color, &bg_color);
-
-        if (i == 0)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %d", "H_POS", shX_MAX - settings.shX);
-        else if (i == 1)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %d", "V_POS", settings.shY);
-        else if (i == 2)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %d", "DELAY", settings.delay);
-        else if (i == 3)
-            osd_text_print(row, 2, "RESET TO DEFAULTS", fg_color, bg_color, 0);
-        else if (i == 4)
-            osd_text_print(row, 2, "< BACK TO MAIN", fg_color, bg_color, 0);
-
-        if (i < 3 && i == osd_menu_state.selected_item && osd_menu_state.tuning_mode)
-            osd_text_set_char(row, 1, '>', fg_color, bg_color);
+        *fg = OSD_COLOR_BACKGROUND;
+        *bg = color;
     }
-}
-
-static void render_mask_menu()
-{
-    osd_text_print_centered(OSD_SUBTITLE_ROW, "PIN INVERSION MASK", OSD_COLOR_SELECTED, OSD_COLOR_BACKGROUND, 0);
-
-    const char *mask_items[] = {
-        "F   (FREQ)",
-        "SSI (HSYNC)",
-        "KSI (VSYNC)",
-        "I   (BRIGHT)",
-        "R   (RED)",
-        "G   (GREEN)",
-        "B   (BLUE)",
-    };
-
-    for (int i = 0; i < 8; i++)
+    else
     {
-        uint8_t row = OSD_MENU_START_ROW + i;
-        uint8_t fg_color, bg_color;
-        menu_item_colors(i == osd_menu_state.selected_item, false, OSD_COLOR_TEXT, &fg_color, &bg_color);
-
-        if (i < 7)
-        {
-            uint8_t bit_pos = mask_bit_positions[i];
-            bool bit_value = (settings.pin_inversion_mask >> bit_pos) & 1;
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-12s %s", mask_items[i], bit_value ? "ON" : "OFF");
-        }
-        else
-            osd_text_print(row, 2, "< BACK TO CAPTURE", fg_color, bg_color, 0);
+        *fg = color;
+        *bg = OSD_COLOR_BACKGROUND;
     }
 }
 
-#ifdef MAIN_ITEM_FF_OSD
-static void render_ff_osd_menu()
+static const char *osd_menu_item_value(const osd_menu_item_t *item, char *buffer)
 {
-    osd_text_print_centered(OSD_SUBTITLE_ROW, "FF OSD CONFIG", OSD_COLOR_SELECTED, OSD_COLOR_BACKGROUND, 0);
+    if (item->type == MENU_ITEM_SUBMENU)
+        return ">";
 
-    const char *h_pos_names[] = {
-        "LEFT",
-        "LEFT-CENTER",
-        "CENTER",
-        "CENTER-RIGHT",
-        "RIGHT",
-    };
+    if (item->format != NULL)
+        return item->format(item, buffer);
 
-    for (int i = 0; i < 7; i++)
-    {
-        uint8_t row = OSD_MENU_START_ROW + i;
-        uint8_t color = OSD_COLOR_TEXT;
-        uint8_t fg_color, bg_color;
-
-        // Dim ROWS and COLUMNS when protocol is FlashFloppy (not LCD_HD44780)
-        if ((i == 2 || i == 3) && settings.ff_osd_config.i2c_protocol)
-            color = OSD_COLOR_DIMMED;
-
-        menu_item_colors(i == osd_menu_state.selected_item,
-                         osd_menu_state.tuning_mode && ((i == 3 && !settings.ff_osd_config.i2c_protocol) || i == 4),
-                         color, &fg_color, &bg_color);
-
-        if (i == 0)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "ENABLE", settings.ff_osd_config.enabled ? "ON" : "OFF");
-        else if (i == 1)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "PROTOCOL", settings.ff_osd_config.i2c_protocol ? "FLASHFLOPPY" : "LCD HD44780");
-        else if (i == 2)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %d", "ROWS", settings.ff_osd_config.i2c_protocol ? ff_osd_display.rows : settings.ff_osd_config.rows);
-        else if (i == 3)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %d", "COLUMNS", settings.ff_osd_config.i2c_protocol ? ff_osd_display.cols : settings.ff_osd_config.cols);
-        else if (i == 4)
-        {
-            uint8_t hp = settings.ff_osd_config.h_position;
-            const char *hp_name = (hp >= 1 && hp <= 5) ? h_pos_names[hp - 1] : "CENTER";
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "H_POS", hp_name);
-        }
-        else if (i == 5)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-9s %s", "V_POS", settings.ff_osd_config.v_position ? "BOTTOM" : "TOP");
-        else if (i == 6)
-            osd_text_print(row, 2, "< BACK TO MAIN", fg_color, bg_color, 0);
-
-        if ((i == 3 && !settings.ff_osd_config.i2c_protocol && i == osd_menu_state.selected_item && osd_menu_state.tuning_mode) ||
-            (i == 4 && i == osd_menu_state.selected_item && osd_menu_state.tuning_mode))
-            osd_text_set_char(row, 1, '>', fg_color, bg_color);
-    }
-}
-#endif
+    if (item->get == NULL)
+        return NULL;
 
-#ifdef MAIN_ITEM_HARDWARE
-static void render_hardware_menu()
-{
-    const char *drive_names[] = {
-        "OFF",
-        "A",
-        "B",
-    };
+    int32_t value = item->get(item);
 
-    osd_text_print_centered(OSD_SUBTITLE_ROW, "HARDWARE CONFIG", OSD_COLOR_SELECTED, OSD_COLOR_BACKGROUND, 0);
+    if (item->names != NULL && value >= item->min && value <= item->max)
+        return item->names[value - item->min];
 
-    for (int i = 0; i < 4; i++)
-    {
-        uint8_t row = OSD_MENU_START_ROW + i;
-        uint8_t color = OSD_COLOR_TEXT;
-        uint8_t fg_color, bg_color;
-
-        // item 1 (RAM SIZE) is a direct toggle — never enters tuning mode
-        bool item_in_tuning = (i != 1) && osd_menu_state.tuning_mode;
-        menu_item_colors(i == osd_menu_state.selected_item, item_in_tuning, color, &fg_color, &bg_color);
-
-        if (i == 0)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-12s %d", "ROM BANK", settings.hw_config.rom_bank);
-        else if (i == 1)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-12s %d", "RAM (KB)", settings.hw_config.ram_size ? 1024 : 128);
-        else if (i == 2)
-            osd_text_printf(row, 2, fg_color, bg_color, 0, "%-12s %s", "GOTEK DRIVE", drive_names[settings.hw_config.gotek_drive]);
-        else if (i == 3)
-            osd_text_print(row, 2, "< BACK TO MAIN", fg_color, bg_color, 0);
-
-        if (item_in_tuning && i == osd_menu_state.selected_item)
-            osd_text_set_char(row, 1, '>', fg_color, bg_color);
-    }
+    sprintf(buffer, "%ld", (long)value);
+    return buffer;
 }
-#endif
 
-static void render_about_menu()
+static void osd_menu_render_item(const osd_menu_page_t *page, uint8_t index)
 {
-    osd_text_print_centered(OSD_SUBTITLE_ROW, "ABOUT", OSD_COLOR_SELECTED, OSD_COLOR_BACKGROUND, 0);
-
-    osd_text_printf(OSD_MENU_START_ROW, 2, OSD_COLOR_TEXT, OSD_COLOR_BACKGROUND, 0, "VERSION   %s", FW_VERSION);
-    osd_text_printf(OSD_MENU_START_ROW + 1, 2, OSD_COLOR_TEXT, OSD_COLOR_BACKGROUND, 0, "BOARD     %s", HW_VERSION);
+    const osd_menu_item_t *item = &page->items[index];
+    uint8_t row = OSD_MENU_START_ROW + index;
+    bool selected = index == osd_menu_state.selected_item && item->type != MENU_ITEM_TEXT;
+    bool tuning = selected && osd_menu_state.tuning_mode;
+    uint8_t color = osd_menu_item_enabled(item) ? OSD_COLOR_TEXT : OSD_COLOR_DIMMED;
+    uint8_t fg_color, bg_color;
+    char buffer[24];
+    const char *value = osd_menu_item_value(item, buffer);
 
-    osd_text_print(OSD_MENU_START_ROW + 3, 2, GIT_REPO_URL_1, OSD_COLOR_TEXT, OSD_COLOR_BACKGROUND, 0);
-    osd_text_print(OSD_MENU_START_ROW + 4, 2, GIT_REPO_URL_2, OSD_COLOR_TEXT, OSD_COLOR_BACKGROUND, 0);
-    osd_text_print(OSD_MENU_START_ROW + 5, 2, GIT_REPO_URL_3, OSD_COLOR_TEXT, OSD_COLOR_BACKGROUND, 0);
-#ifdef GIT_REPO_URL_4
-    osd_text_print(OSD_MENU_START_ROW + 6, 2, GIT_REPO_URL_4, OSD_COLOR_TEXT, OSD_COLOR_BACKGROUND, 0);
-#endif
+    menu_item_colors(selected, tuning, color, &fg_color, &bg_color);
 
-    uint8_t fg_color, bg_color;
-    menu_item_colors(osd_menu_state.selected_item == 0, false, OSD_COLOR_TEXT, &fg_color, &bg_color);
+    if (value != NULL)
+        osd_text_printf(row, 2, fg_color, bg_color, 0, "%-*s %s", page->label_width, item->label, value);
+    else
+        osd_text_print(row, 2, item->label, fg_color, bg_color, 0);
 
-    osd_text_print(OSD_MENU_START_ROW + 7, 2, "< BACK TO MAIN", fg_color, bg_color, 0);
+    if (tuning)
+        osd_text_set_char(row, 1, '>', fg_color, bg_color);
 }
 
 void osd_update_text_buffer()
-{ // Clear text buffer
+{
+    const osd_menu_page_t *page = osd_menu_current_page();
+
+    // Clear text buffer
     osd_clear_text_buffer();
 
     // Draw header
@@ -1043,329 +1195,262 @@ void osd_update_text_buffer()
 #endif
 
     osd_text_print_centered(OSD_TITLE_ROW, title, OSD_COLOR_TEXT, OSD_COLOR_BACKGROUND, 0);
-    osd_text_print_centered(OSD_SUBTITLE_ROW, "SETUP MENU", OSD_COLOR_SELECTED, OSD_COLOR_BACKGROUND, 0);
-
-    // Render menu based on current menu type
-    switch (osd_menu.current_menu)
-    {
-    case MENU_TYPE_MAIN:
-        render_main_menu();
-        break;
-
-    case MENU_TYPE_OUTPUT:
-        render_output_menu();
-        break;
-
-    case MENU_TYPE_CAPTURE:
-        render_capture_menu();
-        break;
-
-    case MENU_TYPE_IMAGE_ADJUST:
-        render_image_adjust_menu();
-        break;
-
-    case MENU_TYPE_MASK:
-        render_mask_menu();
-        break;
-
-    case MENU_TYPE_ABOUT:
-        render_about_menu();
-        break;
+    osd_text_print_centered(OSD_SUBTITLE_ROW, page->title, OSD_COLOR_SELECTED, OSD_COLOR_BACKGROUND, 0);
 
-#ifdef MAIN_ITEM_FF_OSD
-    case MENU_TYPE_FF_OSD:
-        render_ff_osd_menu();
-        break;
-#endif
+    for (uint8_t i = 0; i < page->count; i++)
+        osd_menu_render_item(page, i);
 
-#ifdef MAIN_ITEM_HARDWARE
-    case MENU_TYPE_HARDWARE:
-        render_hardware_menu();
-        break;
-#endif
-    }
+    osd_menu_dirty_rows = 0;
 }
 
-void osd_adjust_image_parameter(uint8_t param_index, int8_t direction)
+// Redraw the whole menu after a menu change, otherwise only the dirty rows
+static void osd_menu_render(void)
 {
-    switch (param_index)
+    if (osd_state.needs_redraw)
     {
-    case 0: // Horizontal Position (shX)
-        if (direction > 0 && settings.shX > shX_MIN)
-            set_capture_shX(settings.shX - 1);
-        else if (direction < 0 && settings.shX < shX_MAX)
-            set_capture_shX(settings.shX + 1);
-
-        break;
-
-    case 1: // Vertical Position (shY)
-        if (direction > 0 && settings.shY < shY_MAX)
-            set_capture_shY(settings.shY + 1);
-        else if (direction < 0 && settings.shY > shY_MIN)
-            set_capture_shY(settings.shY - 1);
+        osd_update_text_buffer();
+        osd_state.needs_redraw = false;
+        osd_state.text_updated = true;
+    }
+    else if (osd_menu_dirty_rows)
+    {
+        const osd_menu_page_t *page = osd_menu_current_page();
 
-        break;
+        for (uint8_t i = 0; i < page->count; i++)
+            if (osd_menu_dirty_rows & (1u << i))
+                osd_menu_render_item(page, i);
 
-    case 2: // Delay
-        if (direction > 0 && settings.delay < DELAY_MAX)
-        {
-            settings.delay++;
-            set_capture_delay(settings.delay);
-        }
-        else if (direction < 0 && settings.delay > DELAY_MIN)
-        {
-            settings.delay--;
-            set_capture_delay(settings.delay);
-        }
+        osd_menu_dirty_rows = 0;
+        osd_state.text_updated = true;
+    }
 
-        break;
+    if (osd_state.text_updated)
+    {
+        osd_render_text_to_buffer();
+        osd_state.text_updated = false;
     }
 }
 
-void osd_adjust_capture_parameter(uint8_t param_index, int8_t direction)
+void osd_menu_init()
 {
-    static const uint32_t freq_presets[] = {
-        7000000, // ZX Spectrum 16K/48K
-        7093800, // ZX Spectrum 128/+2/+2A/+3
-    };
-    static const uint8_t freq_presets_count = count_of(freq_presets);
+    memset(&osd_menu_state, 0, sizeof(osd_menu_state));
+    memset(&osd_menu, 0, sizeof(osd_menu));
+    osd_menu.current_menu = MENU_TYPE_MAIN;
+    osd_menu_flush_events();
+}
 
-    switch (param_index)
-    {
-    case 0: // Frequency
-    {
-        uint32_t freq_step = 100; // Base step: 100Hz
-        uint64_t current_time = time_us_64();
+void osd_menu_update()
+{
+    if (!osd_state.enabled)
+        return;
 
-        // Determine which button is being used (UP or DOWN)
-        uint8_t button_index = (direction > 0) ? 0 : 1; // 0=UP, 1=DOWN
+    // If menu is not active, only check for activation buttons
+    if (!osd_state.menu_active)
+    {
+#ifdef KBD_ENABLE
+        // Check cross-core menu open request (from keyboard)
+        bool kbd_open = osd_menu_request;
+        if (kbd_open)
+            osd_menu_request = false;
+#endif
+        osd_buttons_update();
 
-        // Calculate step size based on key hold duration
-        if (osd_buttons.key_held[button_index])
+        if (osd_buttons_apply_release_block())
         {
-            uint64_t hold_duration = current_time - osd_buttons.key_hold_start[button_index];
-
-            // Progressive step increase based on hold time and current frequency alignment
-            if (hold_duration > 5000000 && (settings.frequency % 100000 == 0))
-                freq_step = 100000; // After 5 seconds and 100kHz alignment: 100kHz steps
-            else if (hold_duration > 2000000 && (settings.frequency % 10000 == 0))
-                freq_step = 10000; // After 2 seconds and 10kHz alignment: 10kHz steps
-            else if (hold_duration > 1000000 && (settings.frequency % 1000 == 0))
-                freq_step = 1000; // After 1 second and 1kHz alignment: 1kHz steps
-            else
-                freq_step = 100; // First second: 100Hz steps
+#ifdef OSD_FF_ENABLE
+            if (settings.ff_osd_config.enabled && settings.ff_osd_config.i2c_protocol)
+                ff_osd_set_buttons(0);
+#endif
+            return;
         }
 
-        uint32_t new_freq = settings.frequency;
+        uint64_t current_time = time_us_64();
+        bool opened_by_long_hold = osd_button_hold_duration_us(2, current_time) > OSD_HOLD_US;
 
-        if (direction > 0 && new_freq <= FREQUENCY_MAX - freq_step)
-            new_freq += freq_step;
-        else if (direction < 0 && new_freq >= FREQUENCY_MIN + freq_step)
-            new_freq -= freq_step;
+        bool open_menu = osd_button_pressed(0) || osd_button_pressed(1) || osd_button_pressed(2);
+#ifdef OSD_FF_ENABLE
+        if (settings.ff_osd_config.enabled && settings.ff_osd_config.i2c_protocol)
+            open_menu = opened_by_long_hold;
+#endif
+#ifdef KBD_ENABLE
+        open_menu |= kbd_open;
+#endif
 
-        // Snap to the nearest preset in the direction of travel.
-        // When counting up, pick the lowest preset above current freq;
-        // when counting down, pick the highest preset below current freq.
+        if (open_menu)
         {
-            uint32_t snap = 0;
-            bool found = false;
-            for (uint8_t i = 0; i < freq_presets_count; i++)
-            {
-                uint32_t preset = freq_presets[i];
-                if (settings.frequency == preset)
-                {
-                    found = false; // Already at preset, keep counting past it
-                    break;
-                }
-                if (direction > 0 && settings.frequency < preset && new_freq >= preset - freq_step)
-                {
-                    // Counting up: take the first (lowest) qualifying preset
-                    snap = preset;
-                    found = true;
-                    break;
-                }
-                if (direction < 0 && settings.frequency > preset && new_freq <= preset + freq_step)
-                {
-                    // Counting down: keep updating to find the highest qualifying preset
-                    snap = preset;
-                    found = true;
-                }
-            }
-            if (found)
-            {
-                new_freq = snap;
-                osd_block_buttons_until_release();
-            }
-        }
-
-        settings.frequency = new_freq;
-        // Apply frequency change immediately
-        set_capture_frequency(settings.frequency);
-    }
+            osd_state.menu_active = true;
+            osd_set_font(OSD_FONT_ZX);
+            osd_mode.x = 0;
+            osd_mode.y = 0;
+            osd_mode.columns = 30;
+            osd_mode.rows = 15;
+            osd_mode.border_enabled = true;
+            osd_mode.full_width = false;
+            osd_set_blend(OSD_BLEND_OPAQUE);
+            osd_mode.width = osd_mode.columns * OSD_FONT_WIDTH;
+            osd_mode.height = osd_mode.rows * OSD_FONT_HEIGHT;
+            osd_mode.buffer_size = osd_mode.width * osd_mode.height / 2;
 
-    break;
+            osd_set_position();
 
-    case 2: // External clock divider (only when cap_sync_mode == EXT)
-        if (settings.cap_sync_mode == EXT)
-        {
-            if (direction > 0 && settings.ext_clk_divider < EXT_CLK_DIVIDER_MAX)
-                settings.ext_clk_divider++;
-            else if (direction < 0 && settings.ext_clk_divider > EXT_CLK_DIVIDER_MIN)
-                settings.ext_clk_divider--;
-            // Set the new divider immediately
-            set_ext_clk_divider(settings.ext_clk_divider);
+            osd_show();
+            // Always require a full release after opening to avoid immediate
+            // repeat navigation or accidental activation in the first frame.
+            osd_block_buttons_until_release();
+#ifdef OSD_FF_ENABLE
+            if (settings.ff_osd_config.enabled && settings.ff_osd_config.i2c_protocol)
+                ff_osd_set_buttons(0);
+#endif
+            // Don't process the button press that opened the menu.
+            // Also clear any virtual button events (e.g. BACK/ESC) that were
+            // queued before the menu opened — otherwise a stale BACK would
+            // fire after the release block and immediately close the menu.
+            osd_clear_pressed_buttons();
+            osd_menu_flush_events();
+#ifdef KBD_ENABLE
+            osd_virtual_buttons = 0;
+#endif
         }
-
-        break;
+        return;
     }
-}
 
-void osd_adjust_video_mode(int8_t direction)
-{
-    video_out_mode_t modes_dvi[] = {
-        MODE_640x480_60Hz,
-        MODE_720x576_50Hz,
-    };
-    video_out_mode_t modes_vga[] = {
-        MODE_640x480_60Hz,
-        MODE_800x600_60Hz,
-        MODE_1024x768_60Hz_d3,
-        MODE_1024x768_60Hz_d4,
-        MODE_1280x1024_60Hz_d3,
-        MODE_1280x1024_60Hz_d4,
-    };
+#ifdef KBD_ENABLE
+    // F9 (OSD_HOTKEY_MENU) toggle: close menu if already active
+    if (osd_menu_request)
+    {
+        osd_menu_request = false;
+        osd_menu_hide();
+        osd_menu_init();
+        return;
+    }
+#endif
 
-    video_out_mode_t *modes;
-    uint8_t mode_count;
+    // Menu is active from here
+    // Update button states
+    osd_buttons_update();
 
-    if (settings.video_out_type == DVI)
+    if (osd_buttons_apply_release_block())
     {
-        modes = modes_dvi;
-        mode_count = count_of(modes_dvi);
+#ifdef OSD_FF_ENABLE
+        if (settings.ff_osd_config.enabled && settings.ff_osd_config.i2c_protocol)
+            ff_osd_set_buttons(0);
+#endif
+        // Keep rendering while input is blocked so menu appears immediately.
+        osd_menu_render();
+        return;
     }
-    else
+
+    // Check for menu timeout
+    if ((time_us_64() - osd_state.last_activity_time) > OSD_MENU_TIMEOUT_US)
     {
-        modes = modes_vga;
-        mode_count = count_of(modes_vga);
+        osd_menu_hide();
+        return;
     }
 
-    // Find current mode index
-    int8_t current_index = -1;
-    for (uint8_t i = 0; i < mode_count; i++)
-        if (settings.video_out_mode == modes[i])
-        {
-            current_index = i;
-            break;
-        }
-
-    // Default to first mode if current mode not found
-    if (current_index == -1)
-        current_index = 0;
-
-    // Calculate new index with wrapping
-    int8_t new_index = current_index + direction;
-
-    if (new_index < 0)
-        new_index = mode_count - 1; // Wrap to last mode
-    else if (new_index >= mode_count)
-        new_index = 0; // Wrap to first mode
+    // Buttons (GPIO, keyboard arrows and Enter) become events
+    if (osd_button_pressed(0))
+    {
+        osd_menu_post_event(OSD_MENU_EVENT_UP);
+        osd_buttons.up_pressed = false;
+    }
 
-    // Update mode in settings (don't apply yet - wait for SEL press)
-    settings.video_out_mode = modes[new_index];
-}
+    if (osd_button_pressed(1))
+    {
+        osd_menu_post_event(OSD_MENU_EVENT_DOWN);
+        osd_buttons.down_pressed = false;
+    }
 
-#ifdef MAIN_ITEM_FF_OSD
-void osd_adjust_ff_osd_parameter(uint8_t param_index, int8_t direction)
-{
-    switch (param_index)
+    if (osd_button_pressed(2))
     {
-    case 0: // Enable toggle
-        settings.ff_osd_config.enabled = !settings.ff_osd_config.enabled;
+        osd_menu_post_event(OSD_MENU_EVENT_SEL);
+        osd_buttons.sel_pressed = false;
+    }
 
-        if (settings.ff_osd_config.enabled)
-            ff_osd_needs_i2c_init = true;
+#ifdef KBD_ENABLE
+    // BACK (ESC key via virtual buttons)
+    if (osd_virtual_buttons & OSD_VIRT_BACK)
+    {
+        osd_virtual_buttons &= ~OSD_VIRT_BACK;
+        osd_menu_post_event(OSD_MENU_EVENT_BACK);
+    }
+#endif
 
-        break;
+    uint8_t event;
 
-    case 1: // Protocol toggle
-        settings.ff_osd_config.i2c_protocol = !settings.ff_osd_config.i2c_protocol;
+    while (osd_state.menu_active && osd_menu_get_event(&event))
+    {
+        osd_update_activity(); // Reset timeout on user interaction
 
-        if (settings.ff_osd_config.i2c_protocol)
+        if (osd_menu_handle_event(event))
         {
-            settings.ff_osd_config.cols = ff_osd_display.cols;
-            settings.ff_osd_config.rows = ff_osd_display.rows;
+            osd_block_buttons_until_release();
+            // Discard any events that arrived during the action
+            // so they don't fire unexpectedly after the block clears.
+            osd_menu_flush_events();
+#ifdef KBD_ENABLE
+            osd_virtual_buttons = 0;
+#endif
         }
-        else
-            settings.ff_osd_config.rows = 2;
-
-        ff_osd_needs_i2c_init = true;
-        break;
-
-    case 2: // Rows - toggle 2/4
-        settings.ff_osd_config.rows = (settings.ff_osd_config.rows == 2) ? 4 : 2;
+    }
 
-        if (settings.ff_osd_config.rows * settings.ff_osd_config.cols > 80)
-            settings.ff_osd_config.cols = 20; // Adjust columns to max allowed for 4 rows
+#ifdef OSD_FF_ENABLE
+    // Re-render when Gotek reports a new column count asynchronously (Core 1 update)
+    if (osd_menu.current_menu == MENU_TYPE_FF_OSD && settings.ff_osd_config.i2c_protocol)
+    {
+        static uint8_t last_ff_cols = 0;
 
-        if (!settings.ff_osd_config.i2c_protocol)
+        if (ff_osd_display.cols != last_ff_cols)
         {
-            ff_osd_display.rows = settings.ff_osd_config.rows;
-            ff_osd_display.cols = settings.ff_osd_config.cols;
+            last_ff_cols = ff_osd_display.cols;
+            osd_menu_mark_items();
         }
+    }
+#endif
 
-        break;
-
-    case 3: // Columns - adjust with tuning mode
-        if (direction > 0)
-        {
-            settings.ff_osd_config.cols = ff_osd_set_cols(settings.ff_osd_config.cols + 1);
+#ifdef PERF_STATS_ENABLE
+    // the STATS page follows the once per second snapshot and doesn't time out
+    if (osd_menu.current_menu == MENU_TYPE_STATS && osd_state.menu_active)
+    {
+        static uint32_t last_stats_sequence = 0;
 
-            if (settings.ff_osd_config.rows * settings.ff_osd_config.cols > 80)
-                settings.ff_osd_config.rows = 2;
-        }
-        else
-            settings.ff_osd_config.cols = ff_osd_set_cols(settings.ff_osd_config.cols - 1);
+        osd_update_activity();
 
-        if (!settings.ff_osd_config.i2c_protocol)
+        if (perf_stats.sequence != last_stats_sequence)
         {
-            ff_osd_display.rows = settings.ff_osd_config.rows;
-            ff_osd_display.cols = settings.ff_osd_config.cols;
+            last_stats_sequence = perf_stats.sequence;
+            osd_menu_mark_items();
         }
+    }
+#endif
 
-        break;
+#ifdef KBD_JOURNAL_ENABLE
+    // the KEY LATENCY page reads the journal once per second and doesn't time out
+    if (osd_menu.current_menu == MENU_TYPE_KEY_LATENCY && osd_state.menu_active)
+    {
+        static uint32_t last_latency_sequence = 0;
 
-    case 4: // H_POS - cycle 1-5
-        settings.ff_osd_config.h_position = ff_osd_set_h_position(settings.ff_osd_config.h_position + direction);
-        break;
+        osd_update_activity();
 
-    case 5: // V_POS - toggle top/bottom
-        settings.ff_osd_config.v_position = !settings.ff_osd_config.v_position;
-        break;
+        if (perf_stats.sequence != last_latency_sequence)
+        {
+            last_latency_sequence = perf_stats.sequence;
+            update_key_latency();
+            osd_menu_mark_items();
+        }
     }
-}
 #endif
 
-#ifdef MAIN_ITEM_HARDWARE
-void osd_adjust_hardware_parameter(uint8_t param_index, int8_t direction)
+    if (osd_state.menu_active)
+        osd_menu_render();
+}
+
+void osd_menu_toggle()
 {
-    switch (param_index)
+    if (osd_state.menu_active)
+        osd_menu_hide();
+    else
     {
-    case 0: // ROM BANK - adjust with tuning mode
-        if (direction > 0 && settings.hw_config.rom_bank < HW_ROM_BANK_MAX)
-            settings.hw_config.rom_bank++;
-        else if (direction < 0 && settings.hw_config.rom_bank > HW_ROM_BANK_MIN)
-            settings.hw_config.rom_bank--;
-
-        break;
-
-    case 2: // GOTEK DRIVE - adjust with tuning mode
-        if (direction > 0 && settings.hw_config.gotek_drive < HW_GOTEK_DRIVE_MAX)
-            settings.hw_config.gotek_drive++;
-        else if (direction < 0 && settings.hw_config.gotek_drive > HW_GOTEK_DRIVE_MIN)
-            settings.hw_config.gotek_drive--;
-
-        hw_set_gotek_drive(settings.hw_config.gotek_drive);
-        break;
+        osd_show();
+        osd_state.menu_active = true;
     }
 }
-#endif
\ No newline at end of file
@@ -16,6 +16,18 @@
 #define MENU_TYPE_ABOUT 5
 #define MENU_TYPE_FF_OSD 6
 #define MENU_TYPE_HARDWARE 7
+#define MENU_TYPE_STATS 8
+#define MENU_TYPE_INPUT 9
+#define MENU_TYPE_KEY_LATENCY 10
+
+// Menu input events, see osd_menu_post_event()
+typedef enum
+{
+    OSD_MENU_EVENT_UP,   // previous item, or increase the value in tuning mode
+    OSD_MENU_EVENT_DOWN, // next item, or decrease the value in tuning mode
+    OSD_MENU_EVENT_SEL,  // open, toggle, enter/leave tuning mode
+    OSD_MENU_EVENT_BACK, // leave tuning mode, the submenu or the menu
+} osd_menu_event_t;
 
 // Menu-specific OSD state extension
 typedef struct
@@ -40,11 +52,6 @@ extern osd_menu_state_t osd_menu_state;
 void osd_menu_init();
 void osd_menu_update();
 void osd_menu_toggle();
+void osd_menu_post_event(osd_menu_event_t event); // core 0 only, handled by the next osd_menu_update()
 
-void osd_update_text_buffer(); // Update text buffer based on current menu state
-
-void osd_adjust_image_parameter(uint8_t param_index, int8_t direction);
-void osd_adjust_video_mode(int8_t direction);
-void osd_adjust_capture_parameter(uint8_t param_index, int8_t direction);
-void osd_adjust_ff_osd_parameter(uint8_t param_index, int8_t direction);
-void osd_adjust_hardware_parameter(uint8_t param_index, int8_t direction);
+void osd_update_text_buffer(); // Redraw the whole text buffer of the current menu
\ No newline at end of file
@@ -17,6 +17,26 @@ extern "C"
 #ifdef OSD_FF_ENABLE
 #include "ff_osd.h"
 #endif
+
+#ifdef OSD_ENABLE
+#include "osd_layers.h"
+#endif
+
+#ifdef KBD_JOURNAL_ENABLE
+#include "kbd_journal.h"
+
+#ifndef SPI_KB_ENABLE
+#include "ch446q.h"
+#endif
+#endif
+
+#ifdef KBD_ENABLE
+#include "zx_keymap.h"
+#endif
+
+#ifdef KBD_PASTE_ENABLE
+#include "zx_paste.h"
+#endif
 }
 
 #ifdef SERIAL_MENU_ENABLE // Compile serial menu code only if enabled in the configuration
@@ -61,6 +81,39 @@ char get_menu_input(int timeout_ms)
     return Serial.available() ? (char)(Serial.read()) : 0;
 }
 
+// Reads a line with echo and backspace, returns its length
+int get_menu_line(char *line, int size)
+{
+    int len = 0;
+
+    line[0] = '\0';
+
+    while (1)
+    {
+        char inchar = get_menu_input(10);
+
+        if (inchar == '\r' || inchar == '\n')
+        {
+            Serial.println();
+            return len;
+        }
+        else if (inchar == 8 || inchar == 127) // Backspace
+        {
+            if (len > 0)
+            {
+                line[--len] = '\0';
+                Serial.print("\b \b");
+            }
+        }
+        else if (inchar >= ' ' && len < size - 1)
+        {
+            Serial.print(inchar);
+            line[len++] = inchar;
+            line[len] = '\0';
+        }
+    }
+}
+
 void print_main_menu()
 {
     Serial.print("\n      * ZX RGB(I) to VGA/HDMI ");
@@ -85,6 +138,12 @@ void print_main_menu()
 #ifdef OSD_FF_ENABLE
     Serial.println("  g   configure FlashFloppy OSD");
 #endif
+#ifdef KBD_ENABLE
+    Serial.println("  k   configure key layouts");
+#endif
+#ifdef KBD_PASTE_ENABLE
+    Serial.println("  e   type text on the ZX Spectrum keyboard");
+#endif
 
     Serial.println("\n  p   show configuration");
     Serial.println("  h   show help (this menu)");
@@ -103,6 +162,14 @@ void print_video_out_menu()
     {
     case DVI:
         Serial.println("  2    720x576 @50Hz (div 2)");
+#if defined(DVI_HSTX_ENABLE) || defined(DVI_DIRECT_ENABLE)
+        Serial.println("  3    800x600 @60Hz (div 2)");
+#endif
+#ifdef DVI_HSTX_ENABLE
+        Serial.println("  4   1024x768 @60Hz (div 3)");
+        Serial.println("  5   1024x768 @60Hz (div 4)");
+        Serial.println("  6   1280x720 @60Hz (div 2)");
+#endif
         break;
 
     case VGA:
@@ -232,6 +299,96 @@ void print_pin_inversion_mask_menu()
     Serial.println("  q   exit to main menu\n");
 }
 
+#ifdef KBD_JOURNAL_ENABLE
+void print_kbd_latency()
+{
+    const char *sources[] = {"PS/2", "USB"};
+    kbd_journal_event_t events[8];
+
+    Serial.println("\n      * Keyboard latency (us, last events with an output) *\n");
+
+    for (int source = 0; source < KBD_SOURCES; source++)
+    {
+        kbd_latency_t latency;
+
+        kbd_journal_latency((kbd_source_t)source, &latency);
+
+        Serial.print("  ");
+        Serial.print(sources[source]);
+        Serial.print(": ");
+        Serial.print(latency.count, DEC);
+        Serial.print(" events, p50 ");
+        Serial.print(latency.p50, DEC);
+        Serial.print(", p90 ");
+        Serial.print(latency.p90, DEC);
+        Serial.print(", p99 ");
+        Serial.print(latency.p99, DEC);
+        Serial.print(", max ");
+        Serial.print(latency.max, DEC);
+        Serial.print(" (to dispatch: p50 ");
+        Serial.print(latency.dispatch_p50, DEC);
+        Serial.print(", p99 ");
+        Serial.print(latency.dispatch_p99, DEC);
+        Serial.println(")");
+
+        uint32_t counts[KBD_JOURNAL_BUCKETS];
+
+        kbd_journal_histogram((kbd_source_t)source, counts);
+        Serial.print("    since power on:");
+
+        for (int i = 0; i < KBD_JOURNAL_BUCKETS; i++)
+        {
+            Serial.print(i < KBD_JOURNAL_BUCKETS - 1 ? " <" : " >=");
+            Serial.print((KBD_JOURNAL_BUCKET_US << (i < KBD_JOURNAL_BUCKETS - 1 ? i : i - 1)), DEC);
+            Serial.print(": ");
+            Serial.print(counts[i], DEC);
+        }
+
+        Serial.println("");
+
+        uint16_t count = kbd_journal_read((kbd_source_t)source, events, count_of(events));
+
+        for (uint16_t i = 0; i < count; i++)
+        {
+            Serial.print("    ");
+            Serial.print(events[i].time_us, DEC);
+            Serial.print(" key ");
+            Serial.print(events[i].key, DEC);
+            Serial.print(events[i].pressed ? " down, dispatch " : " up, dispatch ");
+            Serial.print(events[i].dispatch_us, DEC);
+
+            if (events[i].output_us == KBD_JOURNAL_NO_OUTPUT)
+            {
+                Serial.println(", no output (OSD)");
+            }
+            else
+            {
+                Serial.print(", output ");
+                Serial.println(events[i].output_us, DEC);
+            }
+        }
+    }
+
+#ifndef SPI_KB_ENABLE
+    ch446q_stats_t ch446q;
+
+    ch446q_get_stats(&ch446q);
+
+    Serial.print("\n  CH446Q: ");
+    Serial.print(ch446q.batches, DEC);
+    Serial.print(" DMA batches, ");
+    Serial.print(ch446q.commands, DEC);
+    Serial.print(" switch commands, ");
+    Serial.print(ch446q.busy, DEC);
+    Serial.print(" flushes deferred (DMA busy), ");
+    Serial.print(ch446q.fifo_full, DEC);
+    Serial.println(" with the PIO FIFO full");
+#endif
+
+    Serial.println("");
+}
+#endif
+
 void print_test_menu()
 {
     Serial.println("\n      * Tests *\n");
@@ -241,7 +398,10 @@ void print_test_menu()
     Serial.println("  3   draw \"NO SIGNAL\" screen");
     Serial.println("  i   show captured frame count");
 #ifdef OSD_FF_ENABLE
-    Serial.println("  g   show FlashFloppy OSD display data");
+    Serial.println("  g   show FlashFloppy OSD display data and I2C counters");
+#endif
+#ifdef KBD_JOURNAL_ENABLE
+    Serial.println("  k   show keyboard latency");
 #endif
 
     Serial.println("\n  p   show configuration");
@@ -302,6 +462,12 @@ void print_video_out_mode()
         Serial.println("1280x1024 @60Hz (div 4)");
         break;
 
+#ifdef DVI_HSTX_ENABLE
+    case MODE_1280x720_60Hz:
+        Serial.println("1280x720 @60Hz");
+        break;
+#endif
+
     default:
         break;
     }
@@ -311,10 +477,20 @@ void print_scanlines_mode()
 {
     Serial.print("  Scanlines ................... ");
 
-    if (settings.scanlines_mode)
+    switch (settings.scanlines_mode)
+    {
+    case SCANLINES_BLACK:
         Serial.println("enabled");
-    else
+        break;
+
+    case SCANLINES_DIM:
+        Serial.println("dimmed");
+        break;
+
+    default:
         Serial.println("disabled");
+        break;
+    }
 }
 
 void print_buffering_mode()
@@ -452,7 +628,9 @@ void print_ff_osd_menu()
     Serial.println("  z   decrement number of columns");
     Serial.println("  j   shift horizontal position left");
     Serial.println("  l   shift horizontal position right");
-    Serial.println("  k   change vertical position (top/bottom)\n");
+    Serial.println("  k   change vertical position (top/bottom)");
+    Serial.println("  b   change blending (opaque/key/shade)");
+    Serial.println("  f   change font (bold/ZX Spectrum)\n");
 
     Serial.println("  p   show configuration");
     Serial.println("  h   show help (this menu)");
@@ -516,6 +694,27 @@ void print_ff_osd_h_position()
     Serial.println(name);
 }
 
+void print_ff_osd_blend()
+{
+    const char *names[] = {
+        "opaque",
+        "key (background shows the image)",
+        "shade (background shows the image at 50%)",
+    };
+    Serial.print("  Blending ................... ");
+    Serial.println(names[settings.ff_osd_config.blend]);
+}
+
+void print_ff_osd_font()
+{
+    const char *names[] = {
+        "bold",
+        "ZX Spectrum",
+    };
+    Serial.print("  Font ....................... ");
+    Serial.println(names[settings.ff_osd_config.font]);
+}
+
 void print_ff_osd_config()
 {
     print_ff_osd_enabled();
@@ -524,6 +723,266 @@ void print_ff_osd_config()
     print_ff_osd_cols();
     print_ff_osd_h_position();
     print_ff_osd_v_position();
+    print_ff_osd_blend();
+    print_ff_osd_font();
+}
+#endif
+
+#ifdef KBD_ENABLE
+void print_keymap_menu()
+{
+    Serial.println("\n      * Key layouts *\n");
+
+    Serial.println("  0   select the built-in layout");
+    Serial.print("  1-");
+    Serial.print(KEYMAP_USER_MAX, DEC);
+    Serial.println(" select a user layout\n");
+
+    Serial.println("  l   list the keys of the selected user layout");
+    Serial.println("  e   change a key of the selected user layout");
+    Serial.println("  x   restore the preset of the selected user layout");
+    Serial.println("  s   save user layouts\n");
+
+    Serial.println("  p   show configuration");
+    Serial.println("  h   show help (this menu)");
+    Serial.println("  q   exit to main menu\n");
+}
+
+void print_keymap()
+{
+    Serial.print("  Key layout .................. ");
+
+    if (settings.input_config.keymap)
+    {
+        Serial.print("user ");
+        Serial.println(settings.input_config.keymap, DEC);
+    }
+    else
+        Serial.println("built-in");
+}
+
+void print_keymap_keys()
+{
+    const zx_keymap_t *keymap = zx_keymap_get(settings.input_config.keymap);
+
+    if (!keymap)
+    {
+        Serial.println("  The built-in layout has no keys to list");
+        return;
+    }
+
+    Serial.println("");
+
+    for (int i = 0; i < keymap->count; i++)
+    {
+        Serial.print("  key ");
+        Serial.print(keymap->keys[i].key_code, DEC);
+        Serial.print(" -> ");
+        Serial.print(zx_keymap_key_name(keymap->keys[i].zx1));
+
+        if (keymap->keys[i].zx2 != ZX_NONE)
+        {
+            Serial.print(" + ");
+            Serial.print(zx_keymap_key_name(keymap->keys[i].zx2));
+        }
+
+        Serial.println("");
+    }
+
+    Serial.print("\n  ");
+    Serial.print(keymap->count, DEC);
+    Serial.print(" of ");
+    Serial.print(ZX_KEYMAP_KEYS, DEC);
+    Serial.println(" keys changed, the others as in the built-in layout\n");
+}
+
+void edit_keymap_key()
+{
+    char line[24];
+
+    if (!zx_keymap_get(settings.input_config.keymap))
+    {
+        Serial.println("  Select a user layout first");
+        return;
+    }
+
+    Serial.println("  Enter: key code (key_codes.h), ZX key [ZX key] (CS, SS, ENTER, SPACE, A-Z, 0-9)");
+    Serial.println("         a single - disables the key, no ZX key restores the built-in mapping");
+    Serial.print("  Key: ");
+
+    if (!get_menu_line(line, sizeof(line)))
+        return;
+
+    char *key = strtok(line, " ");
+    char *zx1 = strtok(NULL, " ");
+    char *zx2 = strtok(NULL, " ");
+    uint8_t key_code = string_to_int(key);
+
+    if (!zx1)
+    {
+        zx_keymap_clear_key(settings.input_config.keymap, key_code);
+        return;
+    }
+
+    uint8_t zx1_code = strcmp(zx1, "-") ? zx_keymap_parse_key(zx1) : ZX_NONE;
+    uint8_t zx2_code = zx2 ? zx_keymap_parse_key(zx2) : ZX_NONE;
+
+    if ((zx1_code == ZX_NONE && strcmp(zx1, "-")) || (zx2 && zx2_code == ZX_NONE))
+        Serial.println("  Unknown ZX key");
+    else if (!zx_keymap_set_key(settings.input_config.keymap, key_code, zx1_code, zx2_code))
+        Serial.println("  Unknown key code or the layout is full");
+}
+#endif
+
+#ifdef KBD_PASTE_ENABLE
+void print_paste_menu()
+{
+    Serial.println("\n      * Type text on the ZX Spectrum keyboard *\n");
+
+    Serial.println("  b   type a 48K BASIC listing (keywords as keyword keys)");
+    Serial.println("  t   type text as it is");
+    Serial.println("  k   stop typing\n");
+
+    Serial.println("  a   increment key hold time (+10 ms)");
+    Serial.println("  z   decrement key hold time (-10 ms)");
+    Serial.println("  s   increment pause between keys (+10 ms)");
+    Serial.println("  x   decrement pause between keys (-10 ms)");
+    Serial.println("  d   increment pause before the same key (+10 ms)");
+    Serial.println("  c   decrement pause before the same key (-10 ms)");
+    Serial.println("  f   increment pause after ENTER (+50 ms)");
+    Serial.println("  v   decrement pause after ENTER (-50 ms)\n");
+
+    Serial.println("  p   show timing");
+    Serial.println("  h   show help (this menu)");
+    Serial.println("  q   exit to main menu\n");
+}
+
+void print_paste_timing()
+{
+    Serial.print("  Key hold time ............... ");
+    Serial.print(zx_paste_timing.hold_ms, DEC);
+    Serial.println(" ms");
+    Serial.print("  Pause between keys .......... ");
+    Serial.print(zx_paste_timing.release_ms, DEC);
+    Serial.println(" ms");
+    Serial.print("  Pause before the same key ... ");
+    Serial.print(zx_paste_timing.repeat_ms, DEC);
+    Serial.println(" ms");
+    Serial.print("  Pause after ENTER ........... ");
+    Serial.print(zx_paste_timing.enter_ms, DEC);
+    Serial.println(" ms");
+    Serial.print("  Keys left to type ........... ");
+    Serial.println(zx_paste_pending(), DEC);
+}
+
+void adjust_paste_time(uint16_t *ms, int step)
+{
+    int value = *ms + step;
+
+    // the ROM reads the keyboard once per frame, no key is seen if held or released for less
+    if (value >= ZX_PASTE_SCAN_MS && value <= 5000)
+        *ms = value;
+
+    print_paste_timing();
+}
+
+// Pasted text is typed from loop(), outside the configuration mode: handle_paste_text() queues one line
+// at a time and leaves a line for the next loop() while the paste queue has no room for it, so the OSD
+// keeps running and the rest of the text waits in the serial buffers
+struct
+{
+    bool active;
+    zx_paste_mode_t mode;
+    char line[ZX_PASTE_LINE_MAX + 1];
+    int len;
+    bool line_ready; // line complete, not queued yet
+    bool end;        // Ctrl+D: done after the last line
+    bool cr;
+    uint32_t lines;
+    uint32_t skipped;
+} paste_text;
+
+void start_paste_text(zx_paste_mode_t mode)
+{
+    memset(&paste_text, 0, sizeof(paste_text));
+    paste_text.active = true;
+    paste_text.mode = mode;
+
+    Serial.println("  Paste the text, end it with Ctrl+D (Esc cancels)");
+}
+
+// Returns false when no text is being pasted
+bool handle_paste_text()
+{
+    if (!paste_text.active)
+        return false;
+
+    while (1)
+    {
+        if (paste_text.line_ready)
+        {
+            int skipped = zx_paste_line(paste_text.line, paste_text.mode);
+
+            if (skipped == ZX_PASTE_BUSY)
+                return true; // try again from the next loop()
+
+            paste_text.skipped += skipped;
+            paste_text.lines++;
+            paste_text.len = 0;
+            paste_text.line_ready = false;
+            Serial.print(".");
+        }
+
+        if (paste_text.end)
+        {
+            paste_text.active = false;
+
+            Serial.println("");
+            Serial.print("  ");
+            Serial.print(paste_text.lines, DEC);
+            Serial.print(" lines queued, ");
+            Serial.print(paste_text.skipped, DEC);
+            Serial.println(" characters with no ZX key skipped\n");
+            return true;
+        }
+
+        if (!Serial.available())
+            return true;
+
+        char inchar = (char)Serial.read();
+
+        if (inchar == 27) // Esc
+        {
+            zx_paste_cancel();
+            paste_text.active = false;
+            Serial.println("\n  Cancelled\n");
+            return true;
+        }
+
+        if (inchar == '\n' && paste_text.cr) // CR LF
+        {
+            paste_text.cr = false;
+            continue;
+        }
+
+        paste_text.cr = inchar == '\r';
+
+        if (inchar == '\r' || inchar == '\n' || (inchar == 4 && paste_text.len > 0))
+        {
+            paste_text.line[paste_text.len] = '\0';
+            paste_text.line_ready = true;
+        }
+        else if (inchar != 4)
+        {
+            if (paste_text.len < ZX_PASTE_LINE_MAX)
+                paste_text.line[paste_text.len++] = inchar;
+            else
+                paste_text.skipped++;
+        }
+
+        if (inchar == 4) // Ctrl+D
+            paste_text.end = true;
+    }
 }
 #endif
 
@@ -546,11 +1005,19 @@ void print_settings()
     print_y_offset();
     print_pin_inversion_mask();
     print_dividers();
+#ifdef KBD_ENABLE
+    print_keymap();
+#endif
     Serial.println("");
 }
 
 void handle_serial_menu()
 {
+#ifdef KBD_PASTE_ENABLE
+    if (handle_paste_text())
+        return;
+#endif
+
     char inchar = get_menu_input(100);
 
     if (inchar == 0)
@@ -670,6 +1137,13 @@ void handle_serial_menu()
                         settings.video_out_mode = MODE_1024x768_60Hz_d3;
                         print_video_out_mode();
                     }
+#if defined(DVI_HSTX_ENABLE) || defined(DVI_DIRECT_ENABLE)
+                    else
+                    {
+                        settings.video_out_mode = MODE_800x600_60Hz;
+                        print_video_out_mode();
+                    }
+#endif
 
                     break;
 
@@ -679,6 +1153,13 @@ void handle_serial_menu()
                         settings.video_out_mode = MODE_1024x768_60Hz_d4;
                         print_video_out_mode();
                     }
+#ifdef DVI_HSTX_ENABLE
+                    else
+                    {
+                        settings.video_out_mode = MODE_1024x768_60Hz_d3;
+                        print_video_out_mode();
+                    }
+#endif
 
                     break;
 
@@ -688,6 +1169,13 @@ void handle_serial_menu()
                         settings.video_out_mode = MODE_1280x1024_60Hz_d3;
                         print_video_out_mode();
                     }
+#ifdef DVI_HSTX_ENABLE
+                    else
+                    {
+                        settings.video_out_mode = MODE_1024x768_60Hz_d4;
+                        print_video_out_mode();
+                    }
+#endif
 
                     break;
 
@@ -697,6 +1185,13 @@ void handle_serial_menu()
                         settings.video_out_mode = MODE_1280x1024_60Hz_d4;
                         print_video_out_mode();
                     }
+#ifdef DVI_HSTX_ENABLE
+                    else
+                    {
+                        settings.video_out_mode = MODE_1280x720_60Hz;
+                        print_video_out_mode();
+                    }
+#endif
 
                     break;
 
@@ -750,7 +1245,7 @@ void handle_serial_menu()
                     break;
 
                 case 's':
-                    settings.scanlines_mode = !settings.scanlines_mode;
+                    settings.scanlines_mode = get_next_scanlines_mode(settings.scanlines_mode);
                     print_scanlines_mode();
                     set_scanlines_mode();
                     break;
@@ -1336,7 +1831,160 @@ void handle_serial_menu()
                     print_ff_osd_v_position();
                     break;
 
+                case 'b':
+                    settings.ff_osd_config.blend = (settings.ff_osd_config.blend >= OSD_BLEND_MAX) ? OSD_BLEND_MIN : settings.ff_osd_config.blend + 1;
+                    print_ff_osd_blend();
+                    break;
+
+                case 'f':
+                    settings.ff_osd_config.font = (settings.ff_osd_config.font + 1) % OSD_FONTS;
+                    print_ff_osd_font();
+                    break;
+
+                default:
+                    break;
+                }
+
+                if (inchar == 'q')
+                {
+                    inchar = 'h';
+                    break;
+                }
+
+                inchar = 0;
+            }
+
+            break;
+        }
+#endif
+
+#ifdef KBD_PASTE_ENABLE
+        case 'e':
+        {
+            inchar = 'h';
+
+            while (1)
+            {
+                if (inchar != 'h')
+                    inchar = get_menu_input(10);
+
+                switch (inchar)
+                {
+                case 'p':
+                    print_paste_timing();
+                    break;
+
+                case 'h':
+                    print_paste_menu();
+                    break;
+
+                case 'b':
+                case 't':
+                    // typing runs from loop(), outside the configuration mode
+                    start_paste_text(inchar == 'b' ? ZX_PASTE_BASIC48 : ZX_PASTE_TEXT);
+                    Serial.println(" Leaving the configuration mode\n");
+                    return;
+
+                case 'k':
+                    zx_paste_cancel();
+                    Serial.println("  Typing stopped");
+                    break;
+
+                case 'a':
+                    adjust_paste_time(&zx_paste_timing.hold_ms, 10);
+                    break;
+
+                case 'z':
+                    adjust_paste_time(&zx_paste_timing.hold_ms, -10);
+                    break;
+
+                case 's':
+                    adjust_paste_time(&zx_paste_timing.release_ms, 10);
+                    break;
+
+                case 'x':
+                    adjust_paste_time(&zx_paste_timing.release_ms, -10);
+                    break;
+
+                case 'd':
+                    adjust_paste_time(&zx_paste_timing.repeat_ms, 10);
+                    break;
+
+                case 'c':
+                    adjust_paste_time(&zx_paste_timing.repeat_ms, -10);
+                    break;
+
+                case 'f':
+                    adjust_paste_time(&zx_paste_timing.enter_ms, 50);
+                    break;
+
+                case 'v':
+                    adjust_paste_time(&zx_paste_timing.enter_ms, -50);
+                    break;
+
+                default:
+                    break;
+                }
+
+                if (inchar == 'q')
+                {
+                    inchar = 'h';
+                    break;
+                }
+
+                inchar = 0;
+            }
+
+            break;
+        }
+#endif
+
+#ifdef KBD_ENABLE
+        case 'k':
+        {
+            inchar = 'h';
+
+            while (1)
+            {
+                if (inchar != 'h')
+                    inchar = get_menu_input(10);
+
+                switch (inchar)
+                {
+                case 'p':
+                    print_keymap();
+                    break;
+
+                case 'h':
+                    print_keymap_menu();
+                    break;
+
+                case 'l':
+                    print_keymap_keys();
+                    break;
+
+                case 'e':
+                    edit_keymap_key();
+                    break;
+
+                case 'x':
+                    zx_keymap_reset(settings.input_config.keymap);
+                    print_keymap_keys();
+                    break;
+
+                case 's':
+                    Serial.println("  Saving key layouts...");
+                    zx_keymap_save();
+                    break;
+
                 default:
+                    if (inchar >= '0' && inchar <= '0' + KEYMAP_USER_MAX)
+                    {
+                        settings.input_config.keymap = inchar - '0';
+                        zx_keymap_select(settings.input_config.keymap);
+                        print_keymap();
+                    }
+
                     break;
                 }
 
@@ -1400,6 +2048,12 @@ void handle_serial_menu()
                     Serial.println(frame_count, DEC);
                     break;
 
+#ifdef KBD_JOURNAL_ENABLE
+                case 'k':
+                    print_kbd_latency();
+                    break;
+#endif
+
 #ifdef OSD_FF_ENABLE
                 case 'g':
                 {
@@ -1411,6 +2065,22 @@ void handle_serial_menu()
                     Serial.print("  Columns ..................... ");
                     Serial.println(ff_osd_display.cols, DEC);
 
+                    Serial.println("\n      I2C receive\n");
+                    Serial.print("  Transactions ................ ");
+                    Serial.println(ff_osd_i2c_stats.transactions, DEC);
+                    Serial.print("  Dropped (ring full) ......... ");
+                    Serial.println(ff_osd_i2c_stats.transaction_overflows, DEC);
+                    Serial.print("  Cut short (data ring full) .. ");
+                    Serial.println(ff_osd_i2c_stats.data_overflows, DEC);
+                    Serial.print("  Dropped bytes ............... ");
+                    Serial.println(ff_osd_i2c_stats.dropped_bytes, DEC);
+                    Serial.print("  Skipped by the decoder ...... ");
+                    Serial.println(ff_osd_i2c_stats.discarded, DEC);
+                    Serial.print("  Data ring peak .............. ");
+                    Serial.print(ff_osd_i2c_stats.data_peak, DEC);
+                    Serial.print(" of ");
+                    Serial.println(FF_OSD_DATA_RING_SIZE, DEC);
+
                     Serial.println("\n      Text content\n");
 
                     for (int row = 0; row < ff_osd_display.rows && row < 4; row++)
@@ -1459,6 +2129,9 @@ void handle_serial_menu()
         case 'w':
             Serial.println("  Saving settings...");
             save_settings(&settings);
+#ifdef OSD_ENABLE
+            osd_toast_show("SETTINGS SAVED", OSD_TOAST_DURATION_US);
+#endif
             inchar = 0;
             break;
 
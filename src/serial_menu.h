@@ -39,4 +39,5 @@ void handle_serial_menu();
 void print_byte_hex(uint8_t);
 void binary_to_string(uint8_t, bool, char *);
 uint32_t string_to_int(const char *);
-char get_menu_input(int);
\ No newline at end of file
+char get_menu_input(int);
+int get_menu_line(char *, int);
\ No newline at end of file
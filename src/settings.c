@@ -15,7 +15,7 @@ extern settings_t settings;
 settings_t default_settings = {
     .video_out_type = VIDEO_OUT_TYPE_DEF,
     .video_out_mode = VIDEO_OUT_MODE_DEF,
-    .scanlines_mode = false,
+    .scanlines_mode = SCANLINES_OFF,
     .buffering_mode = false,
     .cap_sync_mode = CAP_SYNC_MODE_DEF,
     .frequency = FREQUENCY_DEF,
@@ -46,6 +46,8 @@ settings_t default_settings = {
         .rows = 3,
         .h_position = 3,
         .v_position = false,
+        .blend = OSD_BLEND_OPAQUE,
+        .font = OSD_FONT_BOLD,
     },
 #endif
 
@@ -57,6 +59,16 @@ settings_t default_settings = {
     },
 #endif
 
+#ifdef KBD_ENABLE
+    .input_config = {
+        .keymap = 0,
+#ifdef USB_KBD_ENABLE
+        .joystick = JOYSTICK_SINCLAIR,
+        .mouse = MOUSE_1_1,
+#endif
+    },
+#endif
+
     .crc = 0,
 };
 
@@ -68,9 +80,15 @@ void check_settings(settings_t *settings)
 
   if (settings->video_out_mode > VIDEO_OUT_MODE_MAX ||
       (settings->video_out_type == DVI && settings->video_out_mode > VIDEO_MODE_DVI_MAX) || // DVI mode supports resolutions up to VIDEO_MODE_DVI_MAX
+#ifdef DVI_HSTX_ENABLE
+      (settings->video_out_type == VGA && settings->video_out_mode == MODE_1280x720_60Hz) || // 1280x720 is DVI only
+#endif
       settings->video_out_mode < VIDEO_OUT_MODE_MIN)
     settings->video_out_mode = VIDEO_OUT_MODE_DEF;
 
+  if (settings->scanlines_mode > SCANLINES_MODE_MAX)
+    settings->scanlines_mode = SCANLINES_OFF;
+
   if (settings->cap_sync_mode > CAP_SYNC_MODE_MAX ||
       settings->cap_sync_mode < CAP_SYNC_MODE_MIN)
     settings->cap_sync_mode = CAP_SYNC_MODE_DEF;
@@ -98,7 +116,7 @@ void check_settings(settings_t *settings)
   if (settings->pin_inversion_mask & ~PIN_INVERSION_MASK)
   {
     settings->pin_inversion_mask = PIN_INVERSION_MASK_DEF;
-    settings->scanlines_mode = false;
+    settings->scanlines_mode = SCANLINES_OFF;
     settings->buffering_mode = false;
     settings->video_sync_mode = false;
   }
@@ -121,6 +139,12 @@ void check_settings(settings_t *settings)
 
   if (settings->ff_osd_config.h_position > 5)
     settings->ff_osd_config.h_position = 5;
+
+  if (settings->ff_osd_config.blend > OSD_BLEND_MAX)
+    settings->ff_osd_config.blend = OSD_BLEND_OPAQUE;
+
+  if (settings->ff_osd_config.font >= OSD_FONTS)
+    settings->ff_osd_config.font = OSD_FONT_BOLD;
 #endif
 
 #if defined(BOARD_LEO_V3) || defined(BOARD_LEO_V3_2040BT)
@@ -132,6 +156,19 @@ void check_settings(settings_t *settings)
     settings->hw_config.gotek_drive = HW_GOTEK_DRIVE_DEF;
 #endif
 
+#ifdef KBD_ENABLE
+  if (settings->input_config.keymap > KEYMAP_USER_MAX)
+    settings->input_config.keymap = 0;
+#endif
+
+#ifdef USB_KBD_ENABLE
+  if (settings->input_config.joystick >= JOYSTICK_PROFILES)
+    settings->input_config.joystick = JOYSTICK_SINCLAIR;
+
+  if (settings->input_config.mouse >= MOUSE_PROFILES)
+    settings->input_config.mouse = MOUSE_1_1;
+#endif
+
   settings->crc = calculate_settings_crc(settings);
 }
 
@@ -173,10 +210,8 @@ void load_settings(settings_t *settings)
   check_settings(settings);
 }
 
-void save_settings(settings_t *settings)
+void write_flash_sector(uint32_t flash_offs, const void *data, size_t len)
 {
-  check_settings(settings);
-
   stop_core1 = true;
 
   __dmb();
@@ -186,8 +221,8 @@ void save_settings(settings_t *settings)
 
   uint32_t ints = save_and_disable_interrupts();
 
-  flash_range_erase((PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE), FLASH_SECTOR_SIZE);
-  flash_range_program((PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE), (uint8_t *)settings, FLASH_PAGE_SIZE);
+  flash_range_erase(flash_offs, FLASH_SECTOR_SIZE);
+  flash_range_program(flash_offs, (const uint8_t *)data, (len + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1));
 
   restore_interrupts_from_disabled(ints);
 
@@ -198,4 +233,11 @@ void save_settings(settings_t *settings)
 
   stop_core1 = false;
   core1_inactive = false;
-}
\ No newline at end of file
+}
+
+void save_settings(settings_t *settings)
+{
+  check_settings(settings);
+
+  write_flash_sector(PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE, settings, FLASH_PAGE_SIZE);
+}
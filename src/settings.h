@@ -4,4 +4,7 @@ uint32_t calculate_settings_crc(const settings_t *);
 void reset_settings_to_defaults(settings_t *);
 void check_settings(settings_t *);
 void load_settings(settings_t *);
-void save_settings(settings_t *);
\ No newline at end of file
+void save_settings(settings_t *);
+
+// Erases a flash sector and programs it with data (rounded up to whole flash pages), core 1 is stopped meanwhile
+void write_flash_sector(uint32_t, const void *, size_t);
\ No newline at end of file
@@ -52,19 +52,21 @@ extern "C"
     // --- HOST MODE ---
     //--------------------------------------------------------------------
 
-#define CFG_TUH_DEVICE_MAX 5 // Hub + 4 devices (arbitrary, can be increased if needed)
+#define CFG_TUH_DEVICE_MAX 6 // 2 hubs + 4 devices, e.g. two keyboards and a mouse behind a hub
 
 #ifndef CFG_TUH_ENDPOINT_MAX
 #define CFG_TUH_ENDPOINT_MAX 8
 #endif
 
+// Also holds the HID report descriptor: a longer one is not fetched and the interface mounts
+// without it (boot protocol). NKRO keyboards, receivers and combo devices often exceed 256 bytes.
 #ifndef CFG_TUH_ENUMERATION_BUFSIZE
-#define CFG_TUH_ENUMERATION_BUFSIZE 256
+#define CFG_TUH_ENUMERATION_BUFSIZE 1024
 #endif
 
 // Host classes
-#define CFG_TUH_HUB 1
-#define CFG_TUH_HID 2
+#define CFG_TUH_HUB 2 // an external hub and one built into a keyboard
+#define CFG_TUH_HID 8 // interfaces: keyboards often have 2 (boot + NKRO / media keys)
 #define CFG_TUH_HID_EPIN_BUFSIZE 64
 #define CFG_TUH_HID_EPOUT_BUFSIZE 64
 #define CFG_TUH_CDC 0
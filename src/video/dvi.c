@@ -7,43 +7,73 @@
 #include "dvi.h"
 #include "video.pio.h"
 #include "v_buf.h"
+#include "video_output.h"
 
 #ifdef OSD_ENABLE
 #include "osd.h"
+#include "osd_layers.h"
+#endif
+
+#ifdef PERF_STATS_ENABLE
+#include "perf_stats.h"
 #endif
 
 extern settings_t settings;
 
-static int dma_ch0; // data line → conv PIO TX
+static int dma_ch0; // data line → conv PIO TX (direct path: → output PIO TX)
 static int dma_ch1; // control: reloads ch0 read addr, fires IRQ
+#ifndef DVI_DIRECT_ENABLE
 static int dma_ch2; // out_data: reads palette data → sends to output PIO TX
 static int dma_ch3; // set_addr: reads address from conv RX → sets ch2 read addr
+#endif
 static uint offset;
+#ifndef DVI_DIRECT_ENABLE
 static uint offset_conv;
+#endif
 
 extern video_mode_t video_mode;
 extern int16_t h_visible_area;
 
-static uint32_t *v_out_dma_buf[2];
-static uint32_t *v_out_sync_hblank; // pre-filled H-blank line (NO_SYNC + H_SYNC + NO_SYNC)
-static uint32_t *v_out_sync_vsync;  // pre-filled V-sync line (V_SYNC + VH_SYNC + V_SYNC)
+#ifdef DVI_DIRECT_ENABLE
+// one input byte (2 packed 4-bit pixels) → 4 output pixels × 2 serializer words,
+// copied to the line buffer with a single struct assignment (ldm/stm)
+typedef struct dvi_pixels_t
+{
+  uint32_t data[8];
+} dvi_pixels_t;
+
+#define DVI_WORDS_PER_PIXEL 2
+#else
+// one input byte (2 packed 4-bit pixels) → 2 palette indices for the conv PIO
+typedef uint32_t dvi_pixels_t;
+#endif
 
-static uint32_t pixels[256];
+static dvi_pixels_t *v_out_dma_buf[2];
+static dvi_pixels_t *v_out_dma_buf_dim; // dimmed scanline (SCANLINES_DIM)
+static dvi_pixels_t *v_out_sync_hblank; // pre-filled H-blank line (NO_SYNC + H_SYNC + NO_SYNC)
+static dvi_pixels_t *v_out_sync_vsync;  // pre-filled V-sync line (V_SYNC + VH_SYNC + V_SYNC)
+
+static dvi_pixels_t pixels[256];
+static dvi_pixels_t pixels_dim[256]; // SCANLINES_DIM_LEVEL brightness
+
+static uint8_t scanlines_mode = SCANLINES_OFF;
 
 // ISR state (file-scope for reset in stop_dvi)
 static uint16_t y = 0;
 static uint8_t *scr_buffer = NULL;
 static uint32_t active_buf_idx = 0;
 
-// 4KB-aligned palette: 20 entries × 16 bytes (4 × uint32_t each)
+// 4KB-aligned palette: 36 entries × 16 bytes (4 × uint32_t each)
 // Each entry: {normal_lo, normal_hi, inverted_lo, inverted_hi}
-// Entries 0-15: colors, 16-19: sync patterns
-static uint32_t palette[20 * 4] __attribute__((aligned(4096)));
+// Entries 0-15: colors, 16-19: sync patterns, 20-35: dimmed colors
+static uint32_t palette[36 * 4] __attribute__((aligned(4096)));
 // sync pulse pattern indexes (after 16 color entries)
 static const uint8_t NO_SYNC = 16;
 static const uint8_t H_SYNC = 17;
 static const uint8_t V_SYNC = 18;
 static const uint8_t VH_SYNC = 19;
+// dimmed color entries (SCANLINES_DIM)
+static const uint8_t DIM_COLORS = 20;
 
 static uint64_t get_ser_diff_data(uint16_t dataR, uint16_t dataG, uint16_t dataB)
 {
@@ -113,6 +143,7 @@ static uint tmds_encoder(uint8_t d8)
   return d_out;
 }
 
+#ifndef DVI_DIRECT_ENABLE
 // Load a 32-bit value into PIO X register (SM must be stopped or idle)
 static void pio_set_x(PIO pio, int sm, uint32_t v)
 {
@@ -126,6 +157,296 @@ static void pio_set_x(PIO pio, int sm, uint32_t v)
   }
   pio_sm_exec(pio, sm, instr_mov);
 }
+#else
+// fill output pixels [start, start + count) of a line with a sync palette entry
+static void fill_sync(dvi_pixels_t *buf, int start, int count, uint8_t index)
+{
+  uint32_t *data = (uint32_t *)buf + start * DVI_WORDS_PER_PIXEL;
+
+  for (int i = 0; i < count; i++)
+  {
+    *data++ = palette[index * 4 + 0];
+    *data++ = palette[index * 4 + 1];
+  }
+}
+#endif
+
+typedef void (*render_image_t)(dvi_pixels_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_pixels_t *pix);
+
+static void __not_in_flash_func(render_image)(dvi_pixels_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_pixels_t *pix)
+{
+  int x = 0;
+
+  for (; (x + 4) <= h_visible_area; x += 4)
+  {
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+  }
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pix[*scr_line++];
+}
+
+#ifdef OSD_ENABLE
+static void __not_in_flash_func(render_image_osd)(dvi_pixels_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_pixels_t *pix)
+{ // calculate OSD buffer line offset using scaled coordinates (2 pixels per byte)
+  const uint8_t *osd_line = OSD_LINE(scaled_y - osd_mode.start_y);
+
+  int x = 0;
+
+  for (; (x + 4) <= osd_mode.start_x; x += 4)
+  {
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+  }
+
+  for (; x < osd_mode.start_x; x++)
+    *line_buf++ = pix[*scr_line++];
+
+  for (; (x + 4) <= osd_mode.end_x; x += 4)
+  {
+    scr_line += 4;
+
+    *line_buf++ = pix[*osd_line++];
+    *line_buf++ = pix[*osd_line++];
+    *line_buf++ = pix[*osd_line++];
+    *line_buf++ = pix[*osd_line++];
+  }
+
+  for (; x < osd_mode.end_x; x++)
+  {
+    scr_line++;
+    *line_buf++ = pix[*osd_line++];
+  }
+
+  for (; (x + 4) <= h_visible_area; x += 4)
+  {
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+  }
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pix[*scr_line++];
+}
+
+static void __not_in_flash_func(render_image_osd_full_width)(dvi_pixels_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_pixels_t *pix)
+{ // the image is hidden, OSD on black
+  const uint8_t *osd_line = OSD_LINE(scaled_y - osd_mode.start_y);
+
+  int x = 0;
+
+  for (; x < osd_mode.start_x; x++)
+    *line_buf++ = pix[0]; // black pixels
+
+  for (; (x + 4) <= osd_mode.end_x; x += 4)
+  {
+    *line_buf++ = pix[*osd_line++];
+    *line_buf++ = pix[*osd_line++];
+    *line_buf++ = pix[*osd_line++];
+    *line_buf++ = pix[*osd_line++];
+  }
+
+  for (; x < osd_mode.end_x; x++)
+    *line_buf++ = pix[*osd_line++];
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pix[0]; // black pixels
+}
+
+static void __not_in_flash_func(render_image_osd_blend)(dvi_pixels_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_pixels_t *pix)
+{ // OSD background pixels show the image bits osd_blend_keep[] keeps, one table load per byte
+  const uint8_t *osd_line = OSD_LINE(scaled_y - osd_mode.start_y);
+  const uint8_t *keep = osd_blend_keep;
+
+  int x = 0;
+
+  for (; (x + 4) <= osd_mode.start_x; x += 4)
+  {
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+  }
+
+  for (; x < osd_mode.start_x; x++)
+    *line_buf++ = pix[*scr_line++];
+
+  for (; (x + 4) <= osd_mode.end_x; x += 4)
+  {
+    *line_buf++ = pix[osd_line[0] | (scr_line[0] & keep[osd_line[0]])];
+    *line_buf++ = pix[osd_line[1] | (scr_line[1] & keep[osd_line[1]])];
+    *line_buf++ = pix[osd_line[2] | (scr_line[2] & keep[osd_line[2]])];
+    *line_buf++ = pix[osd_line[3] | (scr_line[3] & keep[osd_line[3]])];
+
+    osd_line += 4;
+    scr_line += 4;
+  }
+
+  for (; x < osd_mode.end_x; x++)
+  {
+    *line_buf++ = pix[*osd_line | (*scr_line++ & keep[*osd_line])];
+    osd_line++;
+  }
+
+  for (; (x + 4) <= h_visible_area; x += 4)
+  {
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+    *line_buf++ = pix[*scr_line++];
+  }
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pix[*scr_line++];
+}
+
+static void __not_in_flash_func(render_image_osd_scaled)(dvi_pixels_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_pixels_t *pix)
+{ // OSD pixels doubled in both directions (osd_mode.scale 2), always opaque
+  const uint8_t *osd_line = OSD_LINE((scaled_y - osd_mode.start_y) / 2);
+
+  int x = 0;
+
+  if (osd_mode.full_width)
+  {
+    for (; x < osd_mode.start_x; x++)
+      *line_buf++ = pix[0]; // black pixels
+  }
+  else
+  {
+    for (; x < osd_mode.start_x; x++)
+      *line_buf++ = pix[*scr_line++];
+  }
+
+  scr_line += osd_mode.end_x - x;
+
+  for (; x < osd_mode.end_x; x += 2)
+  {
+    const uint8_t *pair = osd_scale2[*osd_line++];
+
+    *line_buf++ = pix[pair[0]];
+    *line_buf++ = pix[pair[1]];
+  }
+
+  if (osd_mode.full_width)
+  {
+    for (; x < h_visible_area; x++)
+      *line_buf++ = pix[0]; // black pixels
+  }
+  else
+  {
+    for (; x < h_visible_area; x++)
+      *line_buf++ = pix[*scr_line++];
+  }
+}
+
+// renderer for the lines covered by the OSD, latched once per frame so OSD show/hide never tears a frame
+static render_image_t render_image_osd_rows = render_image;
+// span list of all visible OSD layers, latched once per frame, NULL when only the main layer can be visible
+static const osd_compose_t *osd_frame = NULL;
+
+static void __not_in_flash_func(render_image_osd_spans)(dvi_pixels_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_pixels_t *pix)
+{ // the image with the topmost OSD layer pixels on each span of the line
+  uint8_t band_index = osd_frame->line_band[scaled_y];
+
+  if (band_index == OSD_NO_BAND)
+  {
+    render_image(line_buf, scr_line, scaled_y, pix);
+    return;
+  }
+
+  const osd_band_t *band = &osd_frame->bands[band_index];
+  int x = 0;
+
+  for (int i = 0; i < band->span_count; i++)
+  {
+    const osd_span_t *span = &band->spans[i];
+
+    for (; x < span->start_x; x++)
+      *line_buf++ = pix[*scr_line++];
+
+    scr_line += span->end_x - x;
+
+    if (span->src == NULL)
+    {
+      for (; x < span->end_x; x++)
+        *line_buf++ = pix[0]; // black pixels
+
+      continue;
+    }
+
+    uint16_t line = (scaled_y - span->src_y) / span->scale;
+
+    if (span->scale > 1)
+    { // one OSD byte -> 2 image bytes, see osd_scale2[]
+      const uint8_t *osd_line = span->src + line * span->stride;
+
+      for (uint16_t col = span->src_x; x < span->end_x; x++, col++)
+        *line_buf++ = pix[osd_scale2[osd_line[col >> 1]][col & 1]];
+
+      continue;
+    }
+
+    const uint8_t *osd_line = span->src + line * span->stride + span->src_x;
+
+    for (; x < span->end_x; x++)
+      *line_buf++ = pix[*osd_line++];
+  }
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pix[*scr_line++];
+}
+#endif
+
+// palette entry for a 4-bit IRGB color with the channel levels scaled to percent
+static void set_palette_color(uint8_t index, uint8_t c, uint8_t percent)
+{
+  uint8_t Y = (c >> 3) & 1;
+  uint8_t R = ((c >> 2) & 1) ? (Y ? 255 : 170) * percent / 100 : 0;
+  uint8_t G = ((c >> 1) & 1) ? (Y ? 255 : 170) * percent / 100 : 0;
+  uint8_t B = ((c >> 0) & 1) ? (Y ? 255 : 170) * percent / 100 : 0;
+  uint64_t normal = get_ser_diff_data(tmds_encoder(R), tmds_encoder(G), tmds_encoder(B));
+  uint64_t inverted = normal ^ 0x0003ffffffffffffl;
+  palette[index * 4 + 0] = (uint32_t)(normal);
+  palette[index * 4 + 1] = (uint32_t)(normal >> 32);
+  palette[index * 4 + 2] = (uint32_t)(inverted);
+  palette[index * 4 + 3] = (uint32_t)(inverted >> 32);
+}
+
+// pixels lookup for the 16 palette colors starting at first_color
+static void set_pixels(dvi_pixels_t *pix, uint8_t first_color)
+{
+#ifdef DVI_DIRECT_ENABLE
+  // each input byte (2 packed 4-bit pixels) → both palette entries (norm+inv each)
+  // byte order (LSB first): p1_color, p2_color
+  for (int i = 0; i < 256; i++)
+  {
+    uint8_t p1 = first_color + (i & 0x0f);
+    uint8_t p2 = first_color + ((i >> 4) & 0x0f);
+
+    for (int j = 0; j < 4; j++)
+    {
+      pix[i].data[j] = palette[p1 * 4 + j];
+      pix[i].data[j + 4] = palette[p2 * 4 + j];
+    }
+  }
+#else
+  // each input byte (2 packed 4-bit pixels) → 2 palette indices
+  // byte order (LSB first): p1_color, p2_color (each palette entry has norm+inv)
+  for (int i = 0; i < 256; i++)
+  {
+    uint8_t p1 = first_color + (i & 0x0f);
+    uint8_t p2 = first_color + ((i >> 4) & 0x0f);
+
+    pix[i] = (p2 << 8) | p1;
+  }
+#endif
+}
 
 static void __not_in_flash_func(dma_handler_dvi)()
 {
@@ -138,6 +459,21 @@ static void __not_in_flash_func(dma_handler_dvi)()
     y = 0;
     scr_buffer = get_v_buf_out();
     active_buf_idx = 0;
+
+#ifdef OSD_ENABLE
+    osd_frame = osd_compose_latch();
+
+    if (!osd_state.visible)
+      render_image_osd_rows = render_image;
+    else if (osd_mode.scale > 1)
+      render_image_osd_rows = render_image_osd_scaled;
+    else if (osd_mode.blend != OSD_BLEND_OPAQUE)
+      render_image_osd_rows = render_image_osd_blend;
+    else if (osd_mode.full_width)
+      render_image_osd_rows = render_image_osd_full_width;
+    else
+      render_image_osd_rows = render_image_osd;
+#endif
   }
 
   if (y < video_mode.v_visible_area)
@@ -146,98 +482,58 @@ static void __not_in_flash_func(dma_handler_dvi)()
     {
       active_buf_idx++;
 
-      uint32_t *active_buf = v_out_dma_buf[active_buf_idx & 1];
+      dvi_pixels_t *active_buf = v_out_dma_buf[active_buf_idx & 1];
 
       if (scr_buffer != NULL)
       {
         uint16_t scaled_y = y / video_mode.div;
         uint8_t *scr_line = &scr_buffer[scaled_y * (V_BUF_W / 2)];
-        uint32_t *line_buf = active_buf;
 
 #ifdef OSD_ENABLE
-        // check if OSD is visible and overlaps with current scaled scanline
-        bool osd_active = osd_state.visible && (scaled_y >= osd_mode.start_y && scaled_y < osd_mode.end_y);
-
-        if (osd_active)
-        { // calculate OSD buffer line offset using scaled coordinates (2 pixels per byte)
-          uint8_t *osd_line = &osd_buffer[(scaled_y - osd_mode.start_y) * (osd_mode.width / 2)];
-
-          int x = 0;
-
-          if (!osd_mode.full_width)
-          {
-            for (; (x + 4) <= osd_mode.start_x; x += 4)
-            {
-              *line_buf++ = pixels[*scr_line++];
-              *line_buf++ = pixels[*scr_line++];
-              *line_buf++ = pixels[*scr_line++];
-              *line_buf++ = pixels[*scr_line++];
-            }
-
-            for (; x < osd_mode.start_x; x++)
-              *line_buf++ = pixels[*scr_line++];
-          }
-          else
-            for (; x < osd_mode.start_x; x++)
-            {
-              scr_line++;
-              *line_buf++ = pixels[0]; // black pixels
-            }
-
-          for (; (x + 4) <= osd_mode.end_x; x += 4)
-          {
-            scr_line += 4;
-
-            *line_buf++ = pixels[*osd_line++];
-            *line_buf++ = pixels[*osd_line++];
-            *line_buf++ = pixels[*osd_line++];
-            *line_buf++ = pixels[*osd_line++];
-          }
-
-          for (; x < osd_mode.end_x; x++)
-          {
-            scr_line++;
-            *line_buf++ = pixels[*osd_line++];
-          }
-
-          if (!osd_mode.full_width)
-          {
-            for (; (x + 4) <= h_visible_area; x += 4)
-            {
-              *line_buf++ = pixels[*scr_line++];
-              *line_buf++ = pixels[*scr_line++];
-              *line_buf++ = pixels[*scr_line++];
-              *line_buf++ = pixels[*scr_line++];
-            }
-
-            for (; x < h_visible_area; x++)
-              *line_buf++ = pixels[*scr_line++];
-          }
-          else
-            for (; x < h_visible_area; x++)
-            {
-              scr_line++;
-              *line_buf++ = pixels[0]; // black pixels
-            }
-        }
+#ifdef OSD_CHARGEN_ENABLE
+        osd_chargen_prepare(scaled_y);
+#endif
+
+        if (osd_frame != NULL)
+          render_image_osd_spans(active_buf, scr_line, scaled_y, pixels);
+        else if (scaled_y >= osd_mode.start_y && scaled_y < osd_mode.end_y)
+          render_image_osd_rows(active_buf, scr_line, scaled_y, pixels);
         else
 #endif
-        {
-          int x = 0;
-
-          for (; (x + 4) <= h_visible_area; x += 4)
-          {
-            *line_buf++ = pixels[*scr_line++];
-            *line_buf++ = pixels[*scr_line++];
-            *line_buf++ = pixels[*scr_line++];
-            *line_buf++ = pixels[*scr_line++];
-          }
-
-          for (; x < h_visible_area; x++)
-            *line_buf++ = pixels[*scr_line++];
-        }
+          render_image(active_buf, scr_line, scaled_y, pixels);
       }
     }
+    else if (scanlines_mode == SCANLINES_DIM)
+    { // odd line — the same image line with the dimmed palette
+      if (scr_buffer != NULL)
+      {
+        uint16_t scaled_y = y / video_mode.div;
+        uint8_t *scr_line = &scr_buffer[scaled_y * (V_BUF_W / 2)];
+
+#ifdef OSD_ENABLE
+#ifdef OSD_CHARGEN_ENABLE
+        osd_chargen_prepare(scaled_y);
+#endif
+
+        if (osd_frame != NULL)
+          render_image_osd_spans(v_out_dma_buf_dim, scr_line, scaled_y, pixels_dim);
+        else if (scaled_y >= osd_mode.start_y && scaled_y < osd_mode.end_y)
+          render_image_osd_rows(v_out_dma_buf_dim, scr_line, scaled_y, pixels_dim);
+        else
+#endif
+          render_image(v_out_dma_buf_dim, scr_line, scaled_y, pixels_dim);
+      }
+
+      dma_channel_set_read_addr(dma_ch1, &v_out_dma_buf_dim, false);
+      return;
+    }
+#ifdef SCANLINES_ENABLE_LOW_RES
+    else if (scanlines_mode == SCANLINES_BLACK)
+    { // odd line — blank
+      dma_channel_set_read_addr(dma_ch1, &v_out_sync_hblank, false);
+      return;
+    }
+#endif
 
     dma_channel_set_read_addr(dma_ch1, &v_out_dma_buf[active_buf_idx & 1], false);
   }
@@ -251,22 +547,35 @@ static void __not_in_flash_func(dma_handler_dvi)()
   }
 }
 
-void start_dvi()
+#ifdef PERF_STATS_ENABLE
+static void __not_in_flash_func(dma_handler_dvi_timed)()
 {
-  int whole_line = video_mode.whole_line;
+  uint32_t start = perf_cycles();
 
-  set_sys_clock_khz(video_mode.sys_freq, true);
-  sleep_ms(10);
+  dma_handler_dvi();
+  perf_isr_end(&perf_counters.output_isr, start);
+}
 
-  // pixels[] lookup: each input byte (2 packed 4-bit pixels) → 2 palette indices
-  // byte order (LSB first): p1_color, p2_color (each palette entry has norm+inv)
-  for (int i = 0; i < 256; i++)
-  {
-    uint8_t p1 = i & 0x0f;
-    uint8_t p2 = (i >> 4) & 0x0f;
+#define DMA_HANDLER_DVI dma_handler_dvi_timed
+#else
+#define DMA_HANDLER_DVI dma_handler_dvi
+#endif
 
-    pixels[i] = (p2 << 8) | p1;
-  }
+void set_dvi_scanlines_mode(uint8_t sl_mode)
+{
+  scanlines_mode = sl_mode;
+}
+
+void start_dvi()
+{
+  int whole_line = video_mode.whole_line;
+
+#ifdef DVI_DIRECT_ENABLE
+  // serializer takes 10 system clocks per pixel (400MHz for 800x600), video_mode.sys_freq is tuned for VGA
+  set_video_sys_clock((uint32_t)(video_mode.pixel_freq / 100));
+#else
+  set_video_sys_clock(video_mode.sys_freq);
+#endif
 
   // TMDS control character constants
   const uint16_t b0 = 0b1101010100;
@@ -297,21 +606,16 @@ void start_dvi()
   palette[VH_SYNC * 4 + 2] = (uint32_t)(sync_val);
   palette[VH_SYNC * 4 + 3] = (uint32_t)(sync_val >> 32);
 
-  // color palette: 16 entries × 16 bytes {norm_lo, norm_hi, inv_lo, inv_hi}
+  // color palette: 16 entries × 16 bytes {norm_lo, norm_hi, inv_lo, inv_hi}, then the same colors dimmed
   for (int c = 0; c < 16; c++)
   {
-    uint8_t Y = (c >> 3) & 1;
-    uint8_t R = ((c >> 2) & 1) ? (Y ? 255 : 170) : 0;
-    uint8_t G = ((c >> 1) & 1) ? (Y ? 255 : 170) : 0;
-    uint8_t B = ((c >> 0) & 1) ? (Y ? 255 : 170) : 0;
-    uint64_t normal = get_ser_diff_data(tmds_encoder(R), tmds_encoder(G), tmds_encoder(B));
-    uint64_t inverted = normal ^ 0x0003ffffffffffffl;
-    palette[c * 4 + 0] = (uint32_t)(normal);
-    palette[c * 4 + 1] = (uint32_t)(normal >> 32);
-    palette[c * 4 + 2] = (uint32_t)(inverted);
-    palette[c * 4 + 3] = (uint32_t)(inverted >> 32);
+    set_palette_color(c, c, 100);
+    set_palette_color(DIM_COLORS + c, c, SCANLINES_DIM_LEVEL);
   }
 
+  set_pixels(pixels, 0);
+  set_pixels(pixels_dim, DIM_COLORS);
+
   // set DVI data pins
   for (int i = DVI_PIN_D0; i < DVI_PIN_D0 + 6; i++)
   {
@@ -328,20 +632,54 @@ void start_dvi()
     gpio_set_slew_rate(i, GPIO_SLEW_RATE_FAST);
   }
 
+  int h_sync_start = video_mode.h_visible_area + video_mode.h_front_porch;
+
+#ifdef DVI_DIRECT_ENABLE
+  // allocate sync line buffers (pre-filled, never modified)
+  v_out_sync_hblank = calloc(whole_line, DVI_WORDS_PER_PIXEL * sizeof(uint32_t));
+  if (!v_out_sync_hblank)
+    watchdog_reboot(0, 0, 0);
+  fill_sync(v_out_sync_hblank, 0, h_sync_start, NO_SYNC);
+  fill_sync(v_out_sync_hblank, h_sync_start, video_mode.h_sync_pulse, H_SYNC);
+  fill_sync(v_out_sync_hblank, h_sync_start + video_mode.h_sync_pulse, video_mode.h_back_porch, NO_SYNC);
+
+  v_out_sync_vsync = calloc(whole_line, DVI_WORDS_PER_PIXEL * sizeof(uint32_t));
+  if (!v_out_sync_vsync)
+    watchdog_reboot(0, 0, 0);
+  fill_sync(v_out_sync_vsync, 0, h_sync_start, V_SYNC);
+  fill_sync(v_out_sync_vsync, h_sync_start, video_mode.h_sync_pulse, VH_SYNC);
+  fill_sync(v_out_sync_vsync, h_sync_start + video_mode.h_sync_pulse, video_mode.h_back_porch, V_SYNC);
+
+  // allocate image line buffers (ping-pong, pre-filled with H-blank sync pattern)
+  v_out_dma_buf[0] = calloc(whole_line, DVI_WORDS_PER_PIXEL * sizeof(uint32_t));
+  if (!v_out_dma_buf[0])
+    watchdog_reboot(0, 0, 0);
+  memcpy(v_out_dma_buf[0], v_out_sync_hblank, whole_line * DVI_WORDS_PER_PIXEL * sizeof(uint32_t));
+
+  v_out_dma_buf[1] = calloc(whole_line, DVI_WORDS_PER_PIXEL * sizeof(uint32_t));
+  if (!v_out_dma_buf[1])
+    watchdog_reboot(0, 0, 0);
+  memcpy(v_out_dma_buf[1], v_out_sync_hblank, whole_line * DVI_WORDS_PER_PIXEL * sizeof(uint32_t));
+
+  v_out_dma_buf_dim = calloc(whole_line, DVI_WORDS_PER_PIXEL * sizeof(uint32_t));
+  if (!v_out_dma_buf_dim)
+    watchdog_reboot(0, 0, 0);
+  memcpy(v_out_dma_buf_dim, v_out_sync_hblank, whole_line * DVI_WORDS_PER_PIXEL * sizeof(uint32_t));
+#else
   // allocate sync line buffers (pre-filled, never modified)
   v_out_sync_hblank = calloc(whole_line, sizeof(uint8_t));
   if (!v_out_sync_hblank)
     watchdog_reboot(0, 0, 0);
-  memset((uint8_t *)v_out_sync_hblank, NO_SYNC, video_mode.h_visible_area + video_mode.h_front_porch);
-  memset((uint8_t *)v_out_sync_hblank + video_mode.h_visible_area + video_mode.h_front_porch, H_SYNC, video_mode.h_sync_pulse);
-  memset((uint8_t *)v_out_sync_hblank + video_mode.h_visible_area + video_mode.h_front_porch + video_mode.h_sync_pulse, NO_SYNC, video_mode.h_back_porch);
+  memset((uint8_t *)v_out_sync_hblank, NO_SYNC, h_sync_start);
+  memset((uint8_t *)v_out_sync_hblank + h_sync_start, H_SYNC, video_mode.h_sync_pulse);
+  memset((uint8_t *)v_out_sync_hblank + h_sync_start + video_mode.h_sync_pulse, NO_SYNC, video_mode.h_back_porch);
 
   v_out_sync_vsync = calloc(whole_line, sizeof(uint8_t));
   if (!v_out_sync_vsync)
     watchdog_reboot(0, 0, 0);
-  memset((uint8_t *)v_out_sync_vsync, V_SYNC, video_mode.h_visible_area + video_mode.h_front_porch);
-  memset((uint8_t *)v_out_sync_vsync + video_mode.h_visible_area + video_mode.h_front_porch, VH_SYNC, video_mode.h_sync_pulse);
-  memset((uint8_t *)v_out_sync_vsync + video_mode.h_visible_area + video_mode.h_front_porch + video_mode.h_sync_pulse, V_SYNC, video_mode.h_back_porch);
+  memset((uint8_t *)v_out_sync_vsync, V_SYNC, h_sync_start);
+  memset((uint8_t *)v_out_sync_vsync + h_sync_start, VH_SYNC, video_mode.h_sync_pulse);
+  memset((uint8_t *)v_out_sync_vsync + h_sync_start + video_mode.h_sync_pulse, V_SYNC, video_mode.h_back_porch);
 
   // allocate image line buffers (ping-pong, pre-filled with H-blank sync pattern)
   v_out_dma_buf[0] = calloc(whole_line, sizeof(uint8_t));
@@ -354,6 +692,12 @@ void start_dvi()
     watchdog_reboot(0, 0, 0);
   memcpy((uint8_t *)v_out_dma_buf[1], (uint8_t *)v_out_sync_hblank, whole_line);
 
+  v_out_dma_buf_dim = calloc(whole_line, sizeof(uint8_t));
+  if (!v_out_dma_buf_dim)
+    watchdog_reboot(0, 0, 0);
+  memcpy((uint8_t *)v_out_dma_buf_dim, (uint8_t *)v_out_sync_hblank, whole_line);
+#endif
+
   // === Output PIO (SM0): TMDS serializer ===
   pio_sm_config c = pio_get_default_sm_config();
 
@@ -375,6 +719,44 @@ void start_dvi()
   pio_sm_init(PIO_DVI, SM_DVI, offset, &c);
   pio_sm_set_enabled(PIO_DVI, SM_DVI, true);
 
+#ifdef DVI_DIRECT_ENABLE
+  // === DMA initialization (2 channels) ===
+  dma_ch0 = dma_claim_unused_channel(true);
+  dma_ch1 = dma_claim_unused_channel(true);
+
+  // ch0: data line → output PIO TX (pre-serialised TMDS words)
+  dma_channel_config c0 = dma_channel_get_default_config(dma_ch0);
+  channel_config_set_transfer_data_size(&c0, DMA_SIZE_32);
+  channel_config_set_read_increment(&c0, true);
+  channel_config_set_write_increment(&c0, false);
+  channel_config_set_dreq(&c0, DREQ_PIO_DVI + SM_DVI); // output SM TX
+  channel_config_set_chain_to(&c0, dma_ch1);
+
+  dma_channel_configure(
+      dma_ch0,
+      &c0,
+      &PIO_DVI->txf[SM_DVI],            // write: output PIO TX FIFO
+      v_out_dma_buf[0],                 // read: line buffer
+      whole_line * DVI_WORDS_PER_PIXEL, // transfer count: 2 words per pixel
+      false                             // don't start yet
+  );
+
+  // ch1: control — reloads ch0 read addr, fires IRQ
+  dma_channel_config c1 = dma_channel_get_default_config(dma_ch1);
+  channel_config_set_transfer_data_size(&c1, DMA_SIZE_32);
+  channel_config_set_read_increment(&c1, false);
+  channel_config_set_write_increment(&c1, false);
+  channel_config_set_chain_to(&c1, dma_ch0);
+
+  dma_channel_configure(
+      dma_ch1,
+      &c1,
+      &dma_hw->ch[dma_ch0].read_addr, // write: ch0's read addr
+      &v_out_dma_buf[0],              // read: pointer to buffer
+      1,
+      false // don't start yet
+  );
+#else
   // === Conv PIO (SM1): index → palette address converter ===
   pio_sm_config c_conv = pio_get_default_sm_config();
 
@@ -465,14 +847,15 @@ void start_dvi()
       1,
       true // start immediately — ch2 is already configured
   );
+#endif
 
   // IRQ setup
   dma_channel_set_irq0_enabled(dma_ch1, true);
-  irq_set_exclusive_handler(DMA_IRQ_0, dma_handler_dvi);
+  irq_set_exclusive_handler(DMA_IRQ_0, DMA_HANDLER_DVI);
   irq_set_priority(DMA_IRQ_0, PICO_HIGHEST_IRQ_PRIORITY);
   irq_set_enabled(DMA_IRQ_0, true);
 
-  // start the line DMA (ch3↔ch2 loop is already running)
+  // start the line DMA (ch3↔ch2 loop is already running in the conv path)
   dma_start_channel_mask((1u << dma_ch0));
 }
 
@@ -480,18 +863,29 @@ void stop_dvi()
 {
   // disable IRQ first to prevent handlers from running during cleanup
   irq_set_enabled(DMA_IRQ_0, false);
-  irq_remove_handler(DMA_IRQ_0, dma_handler_dvi);
+  irq_remove_handler(DMA_IRQ_0, DMA_HANDLER_DVI);
 
   // reset ISR state for clean restart
   y = 0;
   scr_buffer = NULL;
   active_buf_idx = 0;
+#ifdef OSD_ENABLE
+  render_image_osd_rows = render_image;
+  osd_frame = NULL;
+#endif
 
   // stop output PIO (SM0)
   pio_sm_set_enabled(PIO_DVI, SM_DVI, false);
   pio_sm_init(PIO_DVI, SM_DVI, offset, NULL);
   pio_remove_program(PIO_DVI, &pio_dvi_program, offset);
 
+#ifdef DVI_DIRECT_ENABLE
+  // cleanup and free both DMA channels
+  dma_channel_cleanup(dma_ch0);
+  dma_channel_cleanup(dma_ch1);
+  dma_channel_unclaim(dma_ch0);
+  dma_channel_unclaim(dma_ch1);
+#else
   // stop conv PIO (SM1)
   pio_sm_set_enabled(PIO_DVI, SM_DVI_CONV, false);
   pio_sm_init(PIO_DVI, SM_DVI_CONV, offset_conv, NULL);
@@ -506,6 +900,7 @@ void stop_dvi()
   dma_channel_unclaim(dma_ch1);
   dma_channel_unclaim(dma_ch2);
   dma_channel_unclaim(dma_ch3);
+#endif
 
   // free index buffers
   if (v_out_dma_buf[0] != NULL)
@@ -520,6 +915,12 @@ void stop_dvi()
     v_out_dma_buf[1] = NULL;
   }
 
+  if (v_out_dma_buf_dim != NULL)
+  {
+    free(v_out_dma_buf_dim);
+    v_out_dma_buf_dim = NULL;
+  }
+
   // free sync buffers
   if (v_out_sync_hblank != NULL)
   {
@@ -1,4 +1,5 @@
 #pragma once
 
+void set_dvi_scanlines_mode(uint8_t);
 void start_dvi();
 void stop_dvi();
\ No newline at end of file
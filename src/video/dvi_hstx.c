@@ -0,0 +1,742 @@
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/watchdog.h"
+#include "hardware/structs/bus_ctrl.h"
+#include "hardware/structs/hstx_ctrl.h"
+#include "hardware/structs/hstx_fifo.h"
+
+#include "g_config.h"
+#include "dvi_hstx.h"
+#include "v_buf.h"
+#include "video_output.h"
+
+#ifdef OSD_ENABLE
+#include "osd.h"
+#include "osd_layers.h"
+#endif
+
+#ifdef PERF_STATS_ENABLE
+#include "perf_stats.h"
+#endif
+
+#ifdef DVI_HSTX_ENABLE
+
+// HSTX command expander opcodes
+#define HSTX_CMD_RAW_REPEAT (0x1u << 12)
+#define HSTX_CMD_TMDS (0x2u << 12)
+#define HSTX_CMD_TMDS_REPEAT (0x3u << 12)
+#define HSTX_CMD_NOP (0xfu << 12)
+
+// TMDS control symbols (c1 = V sync, c0 = H sync)
+#define TMDS_CTRL_00 0x354u
+#define TMDS_CTRL_01 0x0abu
+#define TMDS_CTRL_10 0x154u
+#define TMDS_CTRL_11 0x2abu
+
+// HSTX outputs 0-7 are GPIO 12-19
+#define HSTX_PIN_BASE 12
+
+// command list header of an active line: front porch, sync, back porch, then TMDS data
+#define LINE_HEADER_SIZE 9
+// a source byte writes 4 words whatever the div, the last 4 - div words are overwritten by the next byte
+#define LINE_TAIL_SIZE 4
+
+extern settings_t settings;
+
+static int dma_ch0; // ping: line command list → HSTX FIFO, chains to ch1
+static int dma_ch1; // pong: line command list → HSTX FIFO, chains to ch0
+
+extern video_mode_t video_mode;
+extern int16_t h_visible_area;
+extern int16_t h_margin;
+extern int16_t v_visible_area;
+extern int16_t v_margin;
+
+// one input byte (2 packed 4-bit pixels) → 2 × div RGB565 output pixels (div words)
+typedef struct dvi_hstx_pixels_t
+{
+  uint32_t data[4];
+} dvi_hstx_pixels_t;
+
+static dvi_hstx_pixels_t pixels[256];
+static dvi_hstx_pixels_t pixels_dim[256]; // SCANLINES_DIM_LEVEL brightness
+static uint8_t pixel_words;
+
+static uint8_t scanlines_mode = SCANLINES_OFF;
+
+// output line of a scaled line (line % div), see set_line_map()
+enum
+{
+  LINE_RENDER,     // first line, the scaled line is rendered
+  LINE_REPEAT,     // the rendered line again
+  LINE_BLACK,      // scanline slot, SCANLINES_BLACK
+  LINE_DIM_RENDER, // first scanline slot, the scaled line is rendered with the dimmed pixels
+  LINE_DIM_REPEAT, // the dimmed line again
+};
+
+static uint8_t line_map[4];
+
+static uint32_t *v_out_dma_buf[2];                 // active lines (ping-pong by scaled line)
+static uint32_t *v_out_dma_buf_dim;                // dimmed scanline (SCANLINES_DIM)
+static uint32_t v_out_black[LINE_HEADER_SIZE + 1]; // active line without image (vertical margins)
+static uint32_t v_out_sync_vblank[6];              // V blank line (front/back porch)
+static uint32_t v_out_sync_vsync[6];               // V sync line
+static uint32_t v_out_dma_buf_size;                // active line command list length in words
+
+// ISR state (file-scope for reset in stop_dvi_hstx)
+static uint16_t y = 0;
+static uint8_t *scr_buffer = NULL;
+
+static uint32_t get_sync_symbol(bool v_sync, bool h_sync)
+{
+  static const uint32_t ctrl[4] = {TMDS_CTRL_00, TMDS_CTRL_01, TMDS_CTRL_10, TMDS_CTRL_11};
+
+  // sync_polarity bits: 7 - V sync inverted, 6 - H sync inverted
+  uint8_t v = v_sync ^ ((video_mode.sync_polarity >> 7) & 1);
+  uint8_t h = h_sync ^ ((video_mode.sync_polarity >> 6) & 1);
+
+  // sync is carried by lane 0 (blue), lanes 1 and 2 send CTRL_00
+  return ctrl[(v << 1) | h] | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20);
+}
+
+// fill a horizontal blanking command list, returns the number of words written
+static int set_line_header(uint32_t *buf, bool v_sync)
+{
+  buf[0] = HSTX_CMD_RAW_REPEAT | video_mode.h_front_porch;
+  buf[1] = get_sync_symbol(v_sync, false);
+  buf[2] = HSTX_CMD_NOP;
+  buf[3] = HSTX_CMD_RAW_REPEAT | video_mode.h_sync_pulse;
+  buf[4] = get_sync_symbol(v_sync, true);
+  buf[5] = HSTX_CMD_NOP;
+  buf[6] = HSTX_CMD_RAW_REPEAT | video_mode.h_back_porch;
+  buf[7] = get_sync_symbol(v_sync, false);
+
+  return 8;
+}
+
+static void set_vblank_line(uint32_t *buf, bool v_sync)
+{
+  buf[0] = HSTX_CMD_RAW_REPEAT | video_mode.h_front_porch;
+  buf[1] = get_sync_symbol(v_sync, false);
+  buf[2] = HSTX_CMD_RAW_REPEAT | video_mode.h_sync_pulse;
+  buf[3] = get_sync_symbol(v_sync, true);
+  buf[4] = HSTX_CMD_RAW_REPEAT | (video_mode.h_back_porch + video_mode.h_visible_area);
+  buf[5] = get_sync_symbol(v_sync, false);
+}
+
+static inline uint32_t *__not_in_flash_func(put_pixels)(uint32_t *line_buf, uint8_t c, const dvi_hstx_pixels_t *pix)
+{
+  *(dvi_hstx_pixels_t *)line_buf = pix[c];
+
+  return line_buf + pixel_words;
+}
+
+typedef uint32_t *(*render_image_t)(uint32_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_hstx_pixels_t *pix);
+
+static uint32_t *__not_in_flash_func(render_image)(uint32_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_hstx_pixels_t *pix)
+{
+  int x = 0;
+
+  for (; (x + 4) <= h_visible_area; x += 4)
+  {
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+  }
+
+  for (; x < h_visible_area; x++)
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+
+  return line_buf;
+}
+
+#ifdef OSD_ENABLE
+static uint32_t *__not_in_flash_func(render_image_osd)(uint32_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_hstx_pixels_t *pix)
+{ // calculate OSD buffer line offset using scaled coordinates (2 pixels per byte)
+  const uint8_t *osd_line = OSD_LINE(scaled_y - osd_mode.start_y);
+
+  int x = 0;
+
+  for (; x < osd_mode.start_x; x++)
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+
+  for (; x < osd_mode.end_x; x++)
+  {
+    scr_line++;
+    line_buf = put_pixels(line_buf, *osd_line++, pix);
+  }
+
+  for (; x < h_visible_area; x++)
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+
+  return line_buf;
+}
+
+static uint32_t *__not_in_flash_func(render_image_osd_full_width)(uint32_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_hstx_pixels_t *pix)
+{ // the image is hidden, OSD on black
+  const uint8_t *osd_line = OSD_LINE(scaled_y - osd_mode.start_y);
+
+  int x = 0;
+
+  for (; x < osd_mode.start_x; x++)
+    line_buf = put_pixels(line_buf, 0, pix); // black pixels
+
+  for (; x < osd_mode.end_x; x++)
+    line_buf = put_pixels(line_buf, *osd_line++, pix);
+
+  for (; x < h_visible_area; x++)
+    line_buf = put_pixels(line_buf, 0, pix); // black pixels
+
+  return line_buf;
+}
+
+static uint32_t *__not_in_flash_func(render_image_osd_blend)(uint32_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_hstx_pixels_t *pix)
+{ // OSD background pixels show the image bits osd_blend_keep[] keeps, one table load per byte
+  const uint8_t *osd_line = OSD_LINE(scaled_y - osd_mode.start_y);
+  const uint8_t *keep = osd_blend_keep;
+
+  int x = 0;
+
+  for (; x < osd_mode.start_x; x++)
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+
+  for (; (x + 4) <= osd_mode.end_x; x += 4)
+  {
+    line_buf = put_pixels(line_buf, osd_line[0] | (scr_line[0] & keep[osd_line[0]]), pix);
+    line_buf = put_pixels(line_buf, osd_line[1] | (scr_line[1] & keep[osd_line[1]]), pix);
+    line_buf = put_pixels(line_buf, osd_line[2] | (scr_line[2] & keep[osd_line[2]]), pix);
+    line_buf = put_pixels(line_buf, osd_line[3] | (scr_line[3] & keep[osd_line[3]]), pix);
+
+    osd_line += 4;
+    scr_line += 4;
+  }
+
+  for (; x < osd_mode.end_x; x++)
+  {
+    line_buf = put_pixels(line_buf, *osd_line | (*scr_line++ & keep[*osd_line]), pix);
+    osd_line++;
+  }
+
+  for (; x < h_visible_area; x++)
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+
+  return line_buf;
+}
+
+static uint32_t *__not_in_flash_func(render_image_osd_scaled)(uint32_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_hstx_pixels_t *pix)
+{ // OSD pixels doubled in both directions (osd_mode.scale 2), always opaque
+  const uint8_t *osd_line = OSD_LINE((scaled_y - osd_mode.start_y) / 2);
+
+  int x = 0;
+
+  if (osd_mode.full_width)
+  {
+    for (; x < osd_mode.start_x; x++)
+      line_buf = put_pixels(line_buf, 0, pix); // black pixels
+  }
+  else
+  {
+    for (; x < osd_mode.start_x; x++)
+      line_buf = put_pixels(line_buf, *scr_line++, pix);
+  }
+
+  scr_line += osd_mode.end_x - x;
+
+  for (; x < osd_mode.end_x; x += 2)
+  {
+    const uint8_t *pair = osd_scale2[*osd_line++];
+
+    line_buf = put_pixels(line_buf, pair[0], pix);
+    line_buf = put_pixels(line_buf, pair[1], pix);
+  }
+
+  if (osd_mode.full_width)
+  {
+    for (; x < h_visible_area; x++)
+      line_buf = put_pixels(line_buf, 0, pix); // black pixels
+  }
+  else
+  {
+    for (; x < h_visible_area; x++)
+      line_buf = put_pixels(line_buf, *scr_line++, pix);
+  }
+
+  return line_buf;
+}
+
+// renderer for the lines covered by the OSD, latched once per frame so OSD show/hide never tears a frame
+static render_image_t render_image_osd_rows = render_image;
+// span list of all visible OSD layers, latched once per frame, NULL when only the main layer can be visible
+static const osd_compose_t *osd_frame = NULL;
+
+static uint32_t *__not_in_flash_func(render_image_osd_spans)(uint32_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const dvi_hstx_pixels_t *pix)
+{ // the image with the topmost OSD layer pixels on each span of the line
+  uint8_t band_index = osd_frame->line_band[scaled_y];
+
+  if (band_index == OSD_NO_BAND)
+    return render_image(line_buf, scr_line, scaled_y, pix);
+
+  const osd_band_t *band = &osd_frame->bands[band_index];
+  int x = 0;
+
+  for (int i = 0; i < band->span_count; i++)
+  {
+    const osd_span_t *span = &band->spans[i];
+
+    for (; x < span->start_x; x++)
+      line_buf = put_pixels(line_buf, *scr_line++, pix);
+
+    scr_line += span->end_x - x;
+
+    if (span->src == NULL)
+    {
+      for (; x < span->end_x; x++)
+        line_buf = put_pixels(line_buf, 0, pix); // black pixels
+
+      continue;
+    }
+
+    uint16_t line = (scaled_y - span->src_y) / span->scale;
+
+    if (span->scale > 1)
+    { // one OSD byte -> 2 image bytes, see osd_scale2[]
+      const uint8_t *osd_line = span->src + line * span->stride;
+
+      for (uint16_t col = span->src_x; x < span->end_x; x++, col++)
+        line_buf = put_pixels(line_buf, osd_scale2[osd_line[col >> 1]][col & 1], pix);
+
+      continue;
+    }
+
+    const uint8_t *osd_line = span->src + line * span->stride + span->src_x;
+
+    for (; x < span->end_x; x++)
+      line_buf = put_pixels(line_buf, *osd_line++, pix);
+  }
+
+  for (; x < h_visible_area; x++)
+    line_buf = put_pixels(line_buf, *scr_line++, pix);
+
+  return line_buf;
+}
+#endif
+
+static void __not_in_flash_func(render_line)(uint32_t *line_buf, uint16_t scaled_y, const dvi_hstx_pixels_t *pix)
+{
+  uint8_t *scr_line = &scr_buffer[scaled_y * (V_BUF_W / 2)];
+
+  // left margin
+  for (int x = h_margin; x--;)
+    line_buf = put_pixels(line_buf, 0, pix);
+
+#ifdef OSD_ENABLE
+#ifdef OSD_CHARGEN_ENABLE
+  osd_chargen_prepare(scaled_y);
+#endif
+
+  if (osd_frame != NULL)
+    line_buf = render_image_osd_spans(line_buf, scr_line, scaled_y, pix);
+  else if (scaled_y >= osd_mode.start_y && scaled_y < osd_mode.end_y)
+    line_buf = render_image_osd_rows(line_buf, scr_line, scaled_y, pix);
+  else
+#endif
+    line_buf = render_image(line_buf, scr_line, scaled_y, pix);
+
+  // right margin
+  for (int x = h_margin; x--;)
+    line_buf = put_pixels(line_buf, 0, pix);
+}
+
+static void __not_in_flash_func(dma_handler_dvi_hstx)()
+{
+  // the other channel is sending the previous line, queue line y on the finished one
+  uint ch = (dma_hw->ints0 & (1u << dma_ch0)) ? dma_ch0 : dma_ch1;
+  dma_hw->ints0 = 1u << ch;
+
+  if (y == 0)
+  {
+    scr_buffer = get_v_buf_out();
+
+#ifdef OSD_ENABLE
+    osd_frame = osd_compose_latch();
+
+    if (!osd_state.visible)
+      render_image_osd_rows = render_image;
+    else if (osd_mode.scale > 1)
+      render_image_osd_rows = render_image_osd_scaled;
+    else if (osd_mode.blend != OSD_BLEND_OPAQUE)
+      render_image_osd_rows = render_image_osd_blend;
+    else if (osd_mode.full_width)
+      render_image_osd_rows = render_image_osd_full_width;
+    else
+      render_image_osd_rows = render_image_osd;
+#endif
+  }
+
+  if (y < video_mode.v_visible_area)
+  {
+    if (scr_buffer == NULL || y < v_margin || y >= (v_visible_area + v_margin))
+    { // top and bottom black bars
+      dma_channel_set_read_addr(ch, v_out_black, false);
+      dma_channel_set_trans_count(ch, count_of(v_out_black), false);
+    }
+    else
+    {
+      uint16_t line = y - v_margin;
+      uint16_t scaled_y = line / video_mode.div;
+      uint32_t *active_buf = v_out_dma_buf[scaled_y & 1];
+      uint32_t count = v_out_dma_buf_size;
+
+      // render once per scaled line (and once more for its dimmed scanline), the line before is still being sent
+      switch (line_map[line % video_mode.div])
+      {
+      case LINE_RENDER:
+        render_line(active_buf + LINE_HEADER_SIZE, scaled_y, pixels);
+        break;
+
+      case LINE_BLACK:
+        active_buf = v_out_black;
+        count = count_of(v_out_black);
+        break;
+
+      case LINE_DIM_RENDER:
+        active_buf = v_out_dma_buf_dim;
+        render_line(active_buf + LINE_HEADER_SIZE, scaled_y, pixels_dim);
+        break;
+
+      case LINE_DIM_REPEAT:
+        active_buf = v_out_dma_buf_dim;
+        break;
+
+      default:
+        break;
+      }
+
+      dma_channel_set_read_addr(ch, active_buf, false);
+      dma_channel_set_trans_count(ch, count, false);
+    }
+  }
+  else if (y >= (video_mode.v_visible_area + video_mode.v_front_porch) && y < (video_mode.v_visible_area + video_mode.v_front_porch + video_mode.v_sync_pulse))
+  { // V sync
+    dma_channel_set_read_addr(ch, v_out_sync_vsync, false);
+    dma_channel_set_trans_count(ch, count_of(v_out_sync_vsync), false);
+  }
+  else
+  { // V blank (front/back porch)
+    dma_channel_set_read_addr(ch, v_out_sync_vblank, false);
+    dma_channel_set_trans_count(ch, count_of(v_out_sync_vblank), false);
+  }
+
+  if (++y == video_mode.whole_frame)
+    y = 0;
+}
+
+#ifdef PERF_STATS_ENABLE
+static void __not_in_flash_func(dma_handler_dvi_hstx_timed)()
+{
+  uint32_t start = perf_cycles();
+
+  dma_handler_dvi_hstx();
+  perf_isr_end(&perf_counters.output_isr, start);
+}
+
+#define DMA_HANDLER_DVI_HSTX dma_handler_dvi_hstx_timed
+#else
+#define DMA_HANDLER_DVI_HSTX dma_handler_dvi_hstx
+#endif
+
+// precompute the line type for each output line of a scaled line, so the ISR doesn't branch on div and scanlines
+static void set_line_map()
+{
+  uint8_t scanlines = 0; // scanline slots at the end of each scaled line
+
+  if (video_mode.div == 2)
+  {
+#ifdef SCANLINES_ENABLE_LOW_RES
+    if (scanlines_mode)
+#else
+    if (scanlines_mode == SCANLINES_DIM)
+#endif
+      scanlines = 1;
+  }
+  else if (scanlines_mode)
+  {
+#ifdef SCANLINES_USE_THIN
+    scanlines = 1;
+#else
+    scanlines = (video_mode.div == 4) ? 2 : 1;
+#endif
+  }
+
+  for (int i = 0; i < video_mode.div && i < (int)count_of(line_map); i++)
+  {
+    int slot = i - (video_mode.div - scanlines); // scanline slot, negative for the image lines
+
+    if (slot < 0)
+      line_map[i] = (i == 0) ? LINE_RENDER : LINE_REPEAT;
+    else if (scanlines_mode == SCANLINES_DIM)
+      line_map[i] = (slot == 0) ? LINE_DIM_RENDER : LINE_DIM_REPEAT;
+    else
+      line_map[i] = LINE_BLACK;
+  }
+}
+
+void set_dvi_hstx_scanlines_mode(uint8_t sl_mode)
+{
+  scanlines_mode = sl_mode;
+  set_line_map();
+}
+
+// RGB565 color of a 4-bit pixel (Y R G B) at level percent brightness
+static uint16_t get_color(uint8_t c, uint8_t level)
+{
+  uint8_t Y = (c >> 3) & 1;
+  uint16_t R = ((c >> 2) & 1) ? (Y ? 0x1f : 0x15) : 0; // 255 : 170
+  uint16_t G = ((c >> 1) & 1) ? (Y ? 0x3f : 0x2a) : 0;
+  uint16_t B = ((c >> 0) & 1) ? (Y ? 0x1f : 0x15) : 0;
+
+  R = (R * level + 50) / 100;
+  G = (G * level + 50) / 100;
+  B = (B * level + 50) / 100;
+
+  return (R << 11) | (G << 5) | B;
+}
+
+// each input byte (2 packed 4-bit pixels) → 2 × div RGB565 pixels, LSB first;
+// no edge softening here: an entry only sees its own 2 pixels, the edge to the next byte would need
+// the neighbour nibble (16 × 256 entries, 64KB) or a second load and store per byte
+static void set_pixels(dvi_hstx_pixels_t *pix, uint8_t level)
+{
+  for (int i = 0; i < 256; i++)
+  {
+    uint8_t p1 = i & 0x0f;
+    uint8_t p2 = (i >> 4) & 0x0f;
+
+    for (int j = 0; j < 4; j++)
+    {
+      uint16_t lo = get_color((2 * j) < video_mode.div ? p1 : p2, level);
+      uint16_t hi = get_color((2 * j + 1) < video_mode.div ? p1 : p2, level);
+
+      pix[i].data[j] = ((uint32_t)hi << 16) | lo;
+    }
+  }
+}
+
+// nearest system clock (kHz) the PLL can generate
+static uint32_t get_nearest_sys_freq(uint32_t sys_freq)
+{
+  uint vco_freq, post_div1, post_div2;
+
+  sys_freq = (sys_freq + 500) / 1000 * 1000;
+
+  for (uint32_t delta = 0; delta <= 10000; delta += 1000)
+  {
+    if (check_sys_clock_khz(sys_freq + delta, &vco_freq, &post_div1, &post_div2))
+      return sys_freq + delta;
+
+    if (check_sys_clock_khz(sys_freq - delta, &vco_freq, &post_div1, &post_div2))
+      return sys_freq - delta;
+  }
+
+  return sys_freq;
+}
+
+void start_dvi_hstx()
+{
+  // HSTX shifts out 2 bits per clock, so its clock is 5 × pixel clock;
+  // below 150MHz run the system at twice the HSTX clock to keep capture and OSD fast
+  uint32_t hstx_freq = (uint32_t)(video_mode.pixel_freq / 200);
+  uint8_t hstx_div = (hstx_freq < 150000) ? 2 : 1;
+  uint32_t sys_freq = get_nearest_sys_freq(hstx_freq * hstx_div);
+
+  set_video_sys_clock(sys_freq);
+  clock_configure(clk_hstx, 0, CLOCKS_CLK_HSTX_CTRL_AUXSRC_VALUE_CLK_SYS, sys_freq * 1000, sys_freq * 1000 / hstx_div);
+
+  // pixels[] lookup and its dimmed copy for SCANLINES_DIM
+  pixel_words = video_mode.div;
+  set_pixels(pixels, 100);
+  set_pixels(pixels_dim, SCANLINES_DIM_LEVEL);
+  set_line_map();
+
+  // blanking command lists
+  set_vblank_line(v_out_sync_vblank, false);
+  set_vblank_line(v_out_sync_vsync, true);
+
+  int header_size = set_line_header(v_out_black, false);
+  v_out_black[header_size] = HSTX_CMD_TMDS_REPEAT | video_mode.h_visible_area;
+  v_out_black[header_size + 1] = 0;
+
+  // allocate active line buffers: command list header + RGB565 pixel pairs + tail for the last 4-word store
+  v_out_dma_buf_size = LINE_HEADER_SIZE + video_mode.h_visible_area / 2;
+
+  for (int i = 0; i < 2; i++)
+  {
+    v_out_dma_buf[i] = calloc(v_out_dma_buf_size + LINE_TAIL_SIZE, sizeof(uint32_t));
+    if (!v_out_dma_buf[i])
+      watchdog_reboot(0, 0, 0);
+
+    header_size = set_line_header(v_out_dma_buf[i], false);
+    v_out_dma_buf[i][header_size] = HSTX_CMD_TMDS | video_mode.h_visible_area;
+  }
+
+  // dimmed scanline buffer (same layout)
+  v_out_dma_buf_dim = calloc(v_out_dma_buf_size + LINE_TAIL_SIZE, sizeof(uint32_t));
+  if (!v_out_dma_buf_dim)
+    watchdog_reboot(0, 0, 0);
+
+  header_size = set_line_header(v_out_dma_buf_dim, false);
+  v_out_dma_buf_dim[header_size] = HSTX_CMD_TMDS | video_mode.h_visible_area;
+
+  // serial output: 10 bit TMDS symbols, 2 bits per HSTX clock, clock period of 5 HSTX clocks
+  hstx_ctrl_hw->csr = 0;
+  hstx_ctrl_hw->csr =
+      HSTX_CTRL_CSR_EXPAND_EN_BITS |
+      5u << HSTX_CTRL_CSR_CLKDIV_LSB |
+      5u << HSTX_CTRL_CSR_N_SHIFTS_LSB |
+      2u << HSTX_CTRL_CSR_SHIFT_LSB |
+      HSTX_CTRL_CSR_EN_BITS;
+
+  // TMDS encoder input is RGB565: each lane takes NBITS + 1 MSBs of the data rotated right by ROT
+  // red (bits 15-11) rotated by 8, green (bits 10-5) by 3, blue (bits 4-0) by 29
+  hstx_ctrl_hw->expand_tmds =
+      4 << HSTX_CTRL_EXPAND_TMDS_L2_NBITS_LSB |
+      8 << HSTX_CTRL_EXPAND_TMDS_L2_ROT_LSB |
+      5 << HSTX_CTRL_EXPAND_TMDS_L1_NBITS_LSB |
+      3 << HSTX_CTRL_EXPAND_TMDS_L1_ROT_LSB |
+      4 << HSTX_CTRL_EXPAND_TMDS_L0_NBITS_LSB |
+      29 << HSTX_CTRL_EXPAND_TMDS_L0_ROT_LSB;
+
+  // pixels come in 2 16-bit chunks, control symbols (RAW) are a whole 32-bit word
+  hstx_ctrl_hw->expand_shift =
+      2 << HSTX_CTRL_EXPAND_SHIFT_ENC_N_SHIFTS_LSB |
+      16 << HSTX_CTRL_EXPAND_SHIFT_ENC_SHIFT_LSB |
+      1 << HSTX_CTRL_EXPAND_SHIFT_RAW_N_SHIFTS_LSB |
+      0 << HSTX_CTRL_EXPAND_SHIFT_RAW_SHIFT_LSB;
+
+  // same pin order as the PIO serializer, lanes: blue, green, red
+#ifndef DVI_PINS_REVERSED
+  const uint8_t lane_pin_p[3] = {DVI_PIN_D0 + 4, DVI_PIN_D0 + 2, DVI_PIN_D0};
+  const uint8_t lane_pin_n[3] = {DVI_PIN_D0 + 5, DVI_PIN_D0 + 3, DVI_PIN_D0 + 1};
+#else
+  const uint8_t lane_pin_p[3] = {DVI_PIN_D0 + 1, DVI_PIN_D0 + 3, DVI_PIN_D0 + 5};
+  const uint8_t lane_pin_n[3] = {DVI_PIN_D0, DVI_PIN_D0 + 2, DVI_PIN_D0 + 4};
+#endif
+
+  hstx_ctrl_hw->bit[DVI_PIN_CLK0 - HSTX_PIN_BASE] = HSTX_CTRL_BIT0_CLK_BITS;
+  hstx_ctrl_hw->bit[DVI_PIN_CLK0 + 1 - HSTX_PIN_BASE] = HSTX_CTRL_BIT0_CLK_BITS | HSTX_CTRL_BIT0_INV_BITS;
+
+  for (int lane = 0; lane < 3; lane++)
+  {
+    // even bits in the first half of each HSTX clock, odd bits in the second half
+    uint32_t lane_data_sel_bits = (lane * 10) << HSTX_CTRL_BIT0_SEL_P_LSB |
+                                  (lane * 10 + 1) << HSTX_CTRL_BIT0_SEL_N_LSB;
+
+    hstx_ctrl_hw->bit[lane_pin_p[lane] - HSTX_PIN_BASE] = lane_data_sel_bits;
+    hstx_ctrl_hw->bit[lane_pin_n[lane] - HSTX_PIN_BASE] = lane_data_sel_bits | HSTX_CTRL_BIT0_INV_BITS;
+  }
+
+  // set DVI data and clock pins
+  for (int i = HSTX_PIN_BASE; i < HSTX_PIN_BASE + 8; i++)
+  {
+    gpio_set_function(i, GPIO_FUNC_HSTX);
+    gpio_set_drive_strength(i, GPIO_DRIVE_STRENGTH_12MA);
+    gpio_set_slew_rate(i, GPIO_SLEW_RATE_FAST);
+  }
+
+  // DMA has priority over the CPUs, the HSTX FIFO is only 8 words deep
+  bus_ctrl_hw->priority = BUSCTRL_BUS_PRIORITY_DMA_W_BITS | BUSCTRL_BUS_PRIORITY_DMA_R_BITS;
+
+  // === DMA initialization (2 channels, each sends a whole line and chains to the other) ===
+  dma_ch0 = dma_claim_unused_channel(true);
+  dma_ch1 = dma_claim_unused_channel(true);
+
+  dma_channel_config c0 = dma_channel_get_default_config(dma_ch0);
+  channel_config_set_transfer_data_size(&c0, DMA_SIZE_32);
+  channel_config_set_read_increment(&c0, true);
+  channel_config_set_write_increment(&c0, false);
+  channel_config_set_dreq(&c0, DREQ_HSTX);
+  channel_config_set_chain_to(&c0, dma_ch1);
+
+  dma_channel_configure(
+      dma_ch0,
+      &c0,
+      &hstx_fifo_hw->fifo,   // write: HSTX FIFO
+      v_out_black,           // read: line 0
+      count_of(v_out_black), // transfer count: whole command list
+      false                  // don't start yet
+  );
+
+  dma_channel_config c1 = dma_channel_get_default_config(dma_ch1);
+  channel_config_set_transfer_data_size(&c1, DMA_SIZE_32);
+  channel_config_set_read_increment(&c1, true);
+  channel_config_set_write_increment(&c1, false);
+  channel_config_set_dreq(&c1, DREQ_HSTX);
+  channel_config_set_chain_to(&c1, dma_ch0);
+
+  dma_channel_configure(
+      dma_ch1,
+      &c1,
+      &hstx_fifo_hw->fifo,   // write: HSTX FIFO
+      v_out_black,           // read: line 1
+      count_of(v_out_black), // transfer count: whole command list
+      false                  // don't start yet
+  );
+
+  // lines 0 and 1 are queued, the IRQ of each finished line queues the line after the next one
+  y = 2;
+
+  // IRQ setup
+  dma_channel_set_irq0_enabled(dma_ch0, true);
+  dma_channel_set_irq0_enabled(dma_ch1, true);
+  irq_set_exclusive_handler(DMA_IRQ_0, DMA_HANDLER_DVI_HSTX);
+  irq_set_priority(DMA_IRQ_0, PICO_HIGHEST_IRQ_PRIORITY);
+  irq_set_enabled(DMA_IRQ_0, true);
+
+  dma_start_channel_mask((1u << dma_ch0));
+}
+
+void stop_dvi_hstx()
+{
+  // disable IRQ first to prevent handlers from running during cleanup
+  irq_set_enabled(DMA_IRQ_0, false);
+  irq_remove_handler(DMA_IRQ_0, DMA_HANDLER_DVI_HSTX);
+
+  // reset ISR state for clean restart
+  y = 0;
+  scr_buffer = NULL;
+#ifdef OSD_ENABLE
+  render_image_osd_rows = render_image;
+  osd_frame = NULL;
+#endif
+
+  // cleanup and free both DMA channels
+  dma_channel_cleanup(dma_ch0);
+  dma_channel_cleanup(dma_ch1);
+  dma_channel_unclaim(dma_ch0);
+  dma_channel_unclaim(dma_ch1);
+
+  // stop HSTX and release the pins
+  hstx_ctrl_hw->csr = 0;
+
+  for (int i = HSTX_PIN_BASE; i < HSTX_PIN_BASE + 8; i++)
+    gpio_set_function(i, GPIO_FUNC_NULL);
+
+  // free line buffers
+  for (int i = 0; i < 2; i++)
+    if (v_out_dma_buf[i] != NULL)
+    {
+      free(v_out_dma_buf[i]);
+      v_out_dma_buf[i] = NULL;
+    }
+
+  if (v_out_dma_buf_dim != NULL)
+  {
+    free(v_out_dma_buf_dim);
+    v_out_dma_buf_dim = NULL;
+  }
+}
+
+#endif
@@ -0,0 +1,5 @@
+#pragma once
+
+void start_dvi_hstx();
+void stop_dvi_hstx();
+void set_dvi_hstx_scanlines_mode(uint8_t);
@@ -0,0 +1,77 @@
+#include "hardware/clocks.h"
+#include "hardware/timer.h"
+
+#include "g_config.h"
+#include "perf_stats.h"
+#include "rgb_capture.h"
+
+#ifdef PERF_STATS_ENABLE // counters and snapshots are compiled only when the stats are enabled
+
+volatile perf_counters_t perf_counters;
+perf_stats_t perf_stats;
+
+static perf_counters_t perf_last;
+static uint32_t perf_last_frame_count;
+static uint64_t perf_last_time;
+
+void perf_stats_init()
+{
+  systick_hw->csr = 0;
+  systick_hw->rvr = PERF_CYCLES_MASK;
+  systick_hw->cvr = 0;
+  systick_hw->csr = 0x5; // processor clock, no interrupt, enabled
+}
+
+static uint32_t perf_isr_avg(uint32_t cycles, uint32_t count)
+{
+  return count ? cycles / count : 0;
+}
+
+static uint8_t perf_idle(uint32_t busy_cycles, uint64_t elapsed_cycles)
+{
+  if (busy_cycles >= elapsed_cycles)
+    return 0;
+
+  return 100 - (uint8_t)(busy_cycles * 100ull / elapsed_cycles);
+}
+
+void perf_stats_update()
+{
+  uint64_t time = time_us_64();
+  uint32_t elapsed = time - perf_last_time;
+
+  if (elapsed < 1000000)
+    return;
+
+  perf_counters_t counters = perf_counters;
+  uint32_t frames = frame_count;
+
+  // the maximums restart every second, an ISR between the copy and the reset is lost from them
+  perf_counters.capture_isr.max = 0;
+  perf_counters.output_isr.max = 0;
+
+  uint64_t elapsed_cycles = (uint64_t)elapsed * clock_get_hz(clk_sys) / 1000000;
+  uint32_t capture_count = counters.capture_isr.count - perf_last.capture_isr.count;
+  uint32_t capture_cycles = counters.capture_isr.cycles - perf_last.capture_isr.cycles;
+  uint32_t output_count = counters.output_isr.count - perf_last.output_isr.count;
+  uint32_t output_cycles = counters.output_isr.cycles - perf_last.output_isr.cycles;
+
+  perf_stats.in_fps = (uint64_t)(frames - perf_last_frame_count) * 10000000 / elapsed;
+  perf_stats.out_fps = (uint64_t)(counters.out_frames - perf_last.out_frames) * 10000000 / elapsed;
+  perf_stats.dropped_frames = counters.dropped_frames - perf_last.dropped_frames;
+  perf_stats.repeated_frames = counters.repeated_frames - perf_last.repeated_frames;
+  perf_stats.capture_avg = perf_isr_avg(capture_cycles, capture_count);
+  perf_stats.capture_max = counters.capture_isr.max;
+  perf_stats.output_avg = perf_isr_avg(output_cycles, output_count);
+  perf_stats.output_max = counters.output_isr.max;
+  perf_stats.core0_idle = perf_idle(output_cycles, elapsed_cycles);
+  perf_stats.core1_idle = perf_idle(capture_cycles, elapsed_cycles);
+  perf_stats.line_freq = (uint64_t)(counters.cap_lines - perf_last.cap_lines) * 1000000 / elapsed;
+  perf_stats.sequence++;
+
+  perf_last = counters;
+  perf_last_frame_count = frames;
+  perf_last_time = time;
+}
+
+#endif // PERF_STATS_ENABLE
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "hardware/structs/systick.h"
+
+// SysTick of each core runs free at clk_sys, it counts down and wraps at 24 bits
+#define PERF_CYCLES_MASK 0x00FFFFFF
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t cycles;
+  uint32_t max; // since the last perf_stats_update()
+} perf_isr_t;
+
+// running counters, written by the ISRs
+typedef struct
+{
+  perf_isr_t capture_isr; // core 1
+  perf_isr_t output_isr;  // core 0
+  uint32_t out_frames;
+  uint32_t dropped_frames;  // captured frames without a free buffer (x3 buffering)
+  uint32_t repeated_frames; // output frames without a new captured frame (x3 buffering)
+  uint32_t cap_lines;       // source lines
+} perf_counters_t;
+
+// last one second snapshot
+typedef struct
+{
+  uint32_t sequence; // incremented by every snapshot
+  uint16_t in_fps;   // 0.1 fps
+  uint16_t out_fps;  // 0.1 fps
+  uint16_t dropped_frames;
+  uint16_t repeated_frames;
+  uint32_t capture_avg; // cycles
+  uint32_t capture_max;
+  uint32_t output_avg;
+  uint32_t output_max;
+  uint8_t core0_idle; // % of time outside the output ISR
+  uint8_t core1_idle; // % of time outside the capture ISR
+  uint32_t line_freq; // Hz
+} perf_stats_t;
+
+extern volatile perf_counters_t perf_counters;
+extern perf_stats_t perf_stats;
+
+void perf_stats_init(); // call on each core, starts its cycle counter
+void perf_stats_update();
+
+static inline uint32_t perf_cycles()
+{
+  return systick_hw->cvr;
+}
+
+static inline void perf_isr_end(volatile perf_isr_t *isr, uint32_t start)
+{
+  uint32_t cycles = (start - systick_hw->cvr) & PERF_CYCLES_MASK;
+
+  isr->count++;
+  isr->cycles += cycles;
+
+  if (cycles > isr->max)
+    isr->max = cycles;
+}
\ No newline at end of file
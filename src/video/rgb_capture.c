@@ -7,6 +7,10 @@
 #include "video.pio.h"
 #include "v_buf.h"
 
+#ifdef PERF_STATS_ENABLE
+#include "perf_stats.h"
+#endif
+
 // Ring buffer configuration
 #define CAP_LINE_LENGTH 1024
 #define CAP_DMA_BUF_COUNT 16     // 16 line buffers for better granularity
@@ -190,6 +194,9 @@ void __attribute__((hot)) __not_in_flash_func(dma_handler_capture())
     if (CS_idx == h_sync_pulse_2)
     {
       y++;
+#ifdef PERF_STATS_ENABLE
+      perf_counters.cap_lines++;
+#endif
 
       // Set the pointer to the beginning of a new line.
       if ((y >= 0) && cap_buf)
@@ -229,6 +236,20 @@ void __attribute__((hot)) __not_in_flash_func(dma_handler_capture())
   cap_CS_idx_s = CS_idx;
 }
 
+#ifdef PERF_STATS_ENABLE
+static void __not_in_flash_func(dma_handler_capture_timed)()
+{
+  uint32_t start = perf_cycles();
+
+  dma_handler_capture();
+  perf_isr_end(&perf_counters.capture_isr, start);
+}
+
+#define DMA_HANDLER_CAPTURE dma_handler_capture_timed
+#else
+#define DMA_HANDLER_CAPTURE dma_handler_capture
+#endif
+
 void start_capture()
 {
   // Reset capture handler state (video buffers cleared later at frame_count == 5)
@@ -357,7 +378,7 @@ void start_capture()
   dma_channel_set_irq1_enabled(dma_ch1, true);
 
   // configure the processor to run dma_handler() when DMA IRQ 0 is asserted
-  irq_set_exclusive_handler(DMA_IRQ_1, dma_handler_capture);
+  irq_set_exclusive_handler(DMA_IRQ_1, DMA_HANDLER_CAPTURE);
   irq_set_enabled(DMA_IRQ_1, true);
 
   dma_start_channel_mask((1u << dma_ch0));
@@ -369,7 +390,7 @@ void stop_capture()
   irq_set_enabled(DMA_IRQ_1, false);
 
   // clear the IRQ handler to prevent conflicts with restarting capture
-  irq_remove_handler(DMA_IRQ_1, dma_handler_capture);
+  irq_remove_handler(DMA_IRQ_1, DMA_HANDLER_CAPTURE);
 
   // stop PIO
   pio_sm_set_enabled(PIO_CAP, SM_CAP, false);
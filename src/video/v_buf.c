@@ -2,6 +2,10 @@
 #include "v_buf.h"
 #include "hardware/sync.h"
 
+#ifdef PERF_STATS_ENABLE
+#include "perf_stats.h"
+#endif
+
 extern settings_t settings;
 
 uint8_t *v_bufs[3] = {
@@ -28,6 +32,10 @@ static inline uint8_t next_buf_idx(uint8_t idx)
 
 void *__not_in_flash_func(get_v_buf_out)()
 {
+#ifdef PERF_STATS_ENABLE
+  perf_counters.out_frames++;
+#endif
+
   if (!buffering_mode || first_frame)
     return v_bufs[0];
 
@@ -59,6 +67,10 @@ void *__not_in_flash_func(get_v_buf_out)()
   }
 
   // No new buffer available, keep current
+#ifdef PERF_STATS_ENABLE
+  perf_counters.repeated_frames++;
+#endif
+
   return v_bufs[v_buf_out_idx];
 }
 
@@ -93,6 +105,10 @@ void *__not_in_flash_func(get_v_buf_in)()
 
   // No free buffer available (display hasn't consumed any buffers yet)
   // This is normal during heavy load - capture will skip this frame
+#ifdef PERF_STATS_ENABLE
+  perf_counters.dropped_frames++;
+#endif
+
   return NULL;
 }
 
@@ -7,9 +7,15 @@
 #include "vga.h"
 #include "video.pio.h"
 #include "v_buf.h"
+#include "video_output.h"
 
 #ifdef OSD_ENABLE
 #include "osd.h"
+#include "osd_layers.h"
+#endif
+
+#ifdef PERF_STATS_ENABLE
+#include "perf_stats.h"
 #endif
 
 // RGB color patterns for different board variants
@@ -41,9 +47,10 @@ extern int16_t h_margin;
 extern int16_t v_visible_area;
 extern int16_t v_margin;
 
-static bool scanlines_mode = false;
+static uint8_t scanlines_mode = SCANLINES_OFF;
 
 static uint32_t *v_out_dma_buf[2];
+static uint32_t *v_out_dma_buf_dim; // dimmed scanline (SCANLINES_DIM)
 static uint32_t *v_out_sync_hblank; // pre-filled H-blank line (H sync only)
 static uint32_t *v_out_sync_vsync;  // pre-filled V-sync line (VH sync)
 
@@ -52,6 +59,264 @@ static uint16_t y = 0;
 static uint8_t *scr_buffer = NULL;
 // 2KB-aligned palette for better cache performance (compile-time alignment)
 static uint16_t palette[256] __attribute__((aligned(2048)));
+static uint16_t palette_dim[256] __attribute__((aligned(512))); // SCANLINES_DIM_LEVEL brightness
+
+// line buffer to output for each line of a pair of scaled lines (y % (2 * div)), see set_line_map()
+enum
+{
+  LINE_RENDER_BUF0,
+  LINE_REPEAT_BUF0,
+  LINE_BLANK0,
+  LINE_RENDER_BUF1,
+  LINE_REPEAT_BUF1,
+  LINE_BLANK1,
+  LINE_SKIP,
+  LINE_DIM, // scanline slot (LINE_BLANK0/1) rendered with the dimmed palette
+};
+
+static uint8_t line_map[8];
+
+typedef uint16_t *(*render_image_t)(uint16_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const uint16_t *pal);
+
+static uint16_t *__not_in_flash_func(render_image)(uint16_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const uint16_t *pal)
+{ // ultra-fast direct byte processing for non-OSD area with loop unrolling
+  int x = 0;
+
+  for (; (x + 4) <= h_visible_area; x += 4)
+  {
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+  }
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pal[*scr_line++];
+
+  return line_buf;
+}
+
+#ifdef OSD_ENABLE
+static uint16_t *__not_in_flash_func(render_image_osd)(uint16_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const uint16_t *pal)
+{ // calculate OSD buffer line offset using scaled coordinates (2 pixels per byte)
+  const uint8_t *osd_line = OSD_LINE(scaled_y - osd_mode.start_y);
+
+  int x = 0;
+
+  for (; (x + 4) <= osd_mode.start_x; x += 4)
+  { // ultra-fast direct byte processing for pre-OSD area with loop unrolling
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+  }
+
+  for (; x < osd_mode.start_x; x++)
+    *line_buf++ = pal[*scr_line++];
+
+  for (; (x + 4) <= osd_mode.end_x; x += 4)
+  { // ultra-simplified OSD compositing with optimized unrolling
+    scr_line += 4;
+
+    *line_buf++ = pal[*osd_line++];
+    *line_buf++ = pal[*osd_line++];
+    *line_buf++ = pal[*osd_line++];
+    *line_buf++ = pal[*osd_line++];
+  }
+
+  for (; x < osd_mode.end_x; x++)
+  { // handle remaining bytes (0-3 bytes)
+    scr_line++;
+
+    *line_buf++ = pal[*osd_line++];
+  }
+
+  for (; (x + 4) <= h_visible_area; x += 4)
+  {
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+  }
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pal[*scr_line++];
+
+  return line_buf;
+}
+
+static uint16_t *__not_in_flash_func(render_image_osd_full_width)(uint16_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const uint16_t *pal)
+{ // the image is hidden, OSD on black
+  const uint8_t *osd_line = OSD_LINE(scaled_y - osd_mode.start_y);
+
+  int x = 0;
+
+  for (; x < osd_mode.start_x; x++)
+    *line_buf++ = pal[0];
+
+  for (; (x + 4) <= osd_mode.end_x; x += 4)
+  {
+    *line_buf++ = pal[*osd_line++];
+    *line_buf++ = pal[*osd_line++];
+    *line_buf++ = pal[*osd_line++];
+    *line_buf++ = pal[*osd_line++];
+  }
+
+  for (; x < osd_mode.end_x; x++)
+    *line_buf++ = pal[*osd_line++];
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pal[0];
+
+  return line_buf;
+}
+
+static uint16_t *__not_in_flash_func(render_image_osd_blend)(uint16_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const uint16_t *pal)
+{ // OSD background pixels show the image bits osd_blend_keep[] keeps, one table load per byte
+  const uint8_t *osd_line = OSD_LINE(scaled_y - osd_mode.start_y);
+  const uint8_t *keep = osd_blend_keep;
+
+  int x = 0;
+
+  for (; (x + 4) <= osd_mode.start_x; x += 4)
+  {
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+  }
+
+  for (; x < osd_mode.start_x; x++)
+    *line_buf++ = pal[*scr_line++];
+
+  for (; (x + 4) <= osd_mode.end_x; x += 4)
+  {
+    *line_buf++ = pal[osd_line[0] | (scr_line[0] & keep[osd_line[0]])];
+    *line_buf++ = pal[osd_line[1] | (scr_line[1] & keep[osd_line[1]])];
+    *line_buf++ = pal[osd_line[2] | (scr_line[2] & keep[osd_line[2]])];
+    *line_buf++ = pal[osd_line[3] | (scr_line[3] & keep[osd_line[3]])];
+
+    osd_line += 4;
+    scr_line += 4;
+  }
+
+  for (; x < osd_mode.end_x; x++)
+  {
+    *line_buf++ = pal[*osd_line | (*scr_line++ & keep[*osd_line])];
+    osd_line++;
+  }
+
+  for (; (x + 4) <= h_visible_area; x += 4)
+  {
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+    *line_buf++ = pal[*scr_line++];
+  }
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pal[*scr_line++];
+
+  return line_buf;
+}
+
+static uint16_t *__not_in_flash_func(render_image_osd_scaled)(uint16_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const uint16_t *pal)
+{ // OSD pixels doubled in both directions (osd_mode.scale 2), always opaque
+  const uint8_t *osd_line = OSD_LINE((scaled_y - osd_mode.start_y) / 2);
+
+  int x = 0;
+
+  if (osd_mode.full_width)
+  {
+    for (; x < osd_mode.start_x; x++)
+      *line_buf++ = pal[0];
+  }
+  else
+  {
+    for (; x < osd_mode.start_x; x++)
+      *line_buf++ = pal[*scr_line++];
+  }
+
+  scr_line += osd_mode.end_x - x;
+
+  for (; x < osd_mode.end_x; x += 2)
+  {
+    const uint8_t *pair = osd_scale2[*osd_line++];
+
+    *line_buf++ = pal[pair[0]];
+    *line_buf++ = pal[pair[1]];
+  }
+
+  if (osd_mode.full_width)
+  {
+    for (; x < h_visible_area; x++)
+      *line_buf++ = pal[0];
+  }
+  else
+  {
+    for (; x < h_visible_area; x++)
+      *line_buf++ = pal[*scr_line++];
+  }
+
+  return line_buf;
+}
+
+// renderer for the lines covered by the OSD, latched once per frame so OSD show/hide never tears a frame
+static render_image_t render_image_osd_rows = render_image;
+// span list of all visible OSD layers, latched once per frame, NULL when only the main layer can be visible
+static const osd_compose_t *osd_frame = NULL;
+
+static uint16_t *__not_in_flash_func(render_image_osd_spans)(uint16_t *line_buf, uint8_t *scr_line, uint16_t scaled_y, const uint16_t *pal)
+{ // the image with the topmost OSD layer pixels on each span of the line
+  uint8_t band_index = osd_frame->line_band[scaled_y];
+
+  if (band_index == OSD_NO_BAND)
+    return render_image(line_buf, scr_line, scaled_y, pal);
+
+  const osd_band_t *band = &osd_frame->bands[band_index];
+  int x = 0;
+
+  for (int i = 0; i < band->span_count; i++)
+  {
+    const osd_span_t *span = &band->spans[i];
+
+    for (; x < span->start_x; x++)
+      *line_buf++ = pal[*scr_line++];
+
+    scr_line += span->end_x - x;
+
+    if (span->src == NULL)
+    {
+      for (; x < span->end_x; x++)
+        *line_buf++ = pal[0];
+
+      continue;
+    }
+
+    uint16_t line = (scaled_y - span->src_y) / span->scale;
+
+    if (span->scale > 1)
+    { // one OSD byte -> 2 image bytes, see osd_scale2[]
+      const uint8_t *osd_line = span->src + line * span->stride;
+
+      for (uint16_t col = span->src_x; x < span->end_x; x++, col++)
+        *line_buf++ = pal[osd_scale2[osd_line[col >> 1]][col & 1]];
+
+      continue;
+    }
+
+    const uint8_t *osd_line = span->src + line * span->stride + span->src_x;
+
+    for (; x < span->end_x; x++)
+      *line_buf++ = pal[*osd_line++];
+  }
+
+  for (; x < h_visible_area; x++)
+    *line_buf++ = pal[*scr_line++];
+
+  return line_buf;
+}
+#endif
 
 static void __not_in_flash_func(dma_handler_vga)()
 {
@@ -63,6 +328,21 @@ static void __not_in_flash_func(dma_handler_vga)()
   {
     y = 0;
     scr_buffer = get_v_buf_out();
+
+#ifdef OSD_ENABLE
+    osd_frame = osd_compose_latch();
+
+    if (!osd_state.visible)
+      render_image_osd_rows = render_image;
+    else if (osd_mode.scale > 1)
+      render_image_osd_rows = render_image_osd_scaled;
+    else if (osd_mode.blend != OSD_BLEND_OPAQUE)
+      render_image_osd_rows = render_image_osd_blend;
+    else if (osd_mode.full_width)
+      render_image_osd_rows = render_image_osd_full_width;
+    else
+      render_image_osd_rows = render_image_osd;
+#endif
   }
 
   if (y >= video_mode.v_visible_area && y < (video_mode.v_visible_area + video_mode.v_front_porch))
@@ -98,95 +378,34 @@ static void __not_in_flash_func(dma_handler_vga)()
   }
 
   // image area
-  uint8_t line = y % (2 * video_mode.div);
-
-  switch (video_mode.div)
-  {
-  case 2:
-#ifdef SCANLINES_ENABLE_LOW_RES
-    if (scanlines_mode)
-    {
-      if (line > 0)
-        line++;
-
-      if (line == 4)
-        line++;
-    }
-    else if (line > 1)
-      line++;
-
-#else
-    if (line > 1)
-      line++;
-
-#endif
-    break;
-
-  case 3:
-    if (!scanlines_mode && ((line == 2) || (line == 5)))
-      line--;
-    break;
+  uint32_t **active_buf;
+  const uint16_t *pal = palette;
 
-  case 4:
-    if (scanlines_mode)
-    {
-#ifdef SCANLINES_USE_THIN
-      if (line > 1)
-        line--;
-
-      if (line >= 5)
-        line--;
-#else
-      if (line > 2)
-        line--;
-
-      if (line == 6)
-        line--;
-#endif
-    }
-    else
-    {
-      if (line > 2)
-        line--;
-
-      if (line == 6)
-        line--;
-
-      if ((line == 2) || (line == 5))
-        line--;
-    }
-
-    break;
-
-  default:
-    break;
-  }
-
-  int active_buf_idx;
-
-  switch (line)
+  switch (line_map[y % (2 * video_mode.div)])
   {
-  case 0:
-    active_buf_idx = 0;
+  case LINE_RENDER_BUF0:
+    active_buf = &v_out_dma_buf[0];
     break;
 
-  case 1:
+  case LINE_REPEAT_BUF0:
     dma_channel_set_read_addr(dma_ch1, &v_out_dma_buf[0], false);
     return;
 
-  case 2:
-    dma_channel_set_read_addr(dma_ch1, &v_out_sync_hblank, false);
-    return;
+  case LINE_RENDER_BUF1:
+    active_buf = &v_out_dma_buf[1];
+    break;
 
-  case 3:
-    active_buf_idx = 1;
+  case LINE_DIM:
+    active_buf = &v_out_dma_buf_dim;
+    pal = palette_dim;
     break;
 
-  case 4:
+  case LINE_REPEAT_BUF1:
     dma_channel_set_read_addr(dma_ch1, &v_out_dma_buf[1], false);
     return;
 
-  case 5:
+  case LINE_BLANK0:
+  case LINE_BLANK1:
     dma_channel_set_read_addr(dma_ch1, &v_out_sync_hblank, false);
     return;
 
@@ -196,110 +415,141 @@ static void __not_in_flash_func(dma_handler_vga)()
 
   uint16_t scaled_y = (y - v_margin) / video_mode.div; // represents the line in the original captured image
   uint8_t *scr_line = &scr_buffer[scaled_y * (V_BUF_W / 2)];
-  uint16_t *line_buf = (uint16_t *)v_out_dma_buf[active_buf_idx];
+  uint16_t *line_buf = (uint16_t *)*active_buf;
 
   // left margin
   for (int x = h_margin; x--;)
     *line_buf++ = palette[0];
 
 #ifdef OSD_ENABLE
-  // main image area with OSD compositing
-  bool osd_active = osd_state.visible && (scaled_y >= osd_mode.start_y && scaled_y < osd_mode.end_y);
+#ifdef OSD_CHARGEN_ENABLE
+  osd_chargen_prepare(scaled_y);
+#endif
 
-  if (osd_active)
-  { // calculate OSD buffer line offset using scaled coordinates (2 pixels per byte)
-    uint8_t *osd_line = &osd_buffer[(scaled_y - osd_mode.start_y) * (osd_mode.width / 2)];
+  if (osd_frame != NULL)
+    line_buf = render_image_osd_spans(line_buf, scr_line, scaled_y, pal);
+  else if (scaled_y >= osd_mode.start_y && scaled_y < osd_mode.end_y)
+    line_buf = render_image_osd_rows(line_buf, scr_line, scaled_y, pal);
+  else
+#endif
+    line_buf = render_image(line_buf, scr_line, scaled_y, pal);
 
-    int x = 0;
+  // right margin
+  for (int x = h_margin; x--;)
+    *line_buf++ = palette[0];
 
-    if (!osd_mode.full_width)
-    {
-      for (; (x + 4) <= osd_mode.start_x; x += 4)
-      { // ultra-fast direct byte processing for pre-OSD area with loop unrolling
-        *line_buf++ = palette[*scr_line++];
-        *line_buf++ = palette[*scr_line++];
-        *line_buf++ = palette[*scr_line++];
-        *line_buf++ = palette[*scr_line++];
-      }
+  dma_channel_set_read_addr(dma_ch1, active_buf, false);
+}
 
-      for (; x < osd_mode.start_x; x++)
-        *line_buf++ = palette[*scr_line++];
-    }
-    else
-      for (; x < osd_mode.start_x; x++)
+#ifdef PERF_STATS_ENABLE
+static void __not_in_flash_func(dma_handler_vga_timed)()
+{
+  uint32_t start = perf_cycles();
+
+  dma_handler_vga();
+  perf_isr_end(&perf_counters.output_isr, start);
+}
+
+#define DMA_HANDLER_VGA dma_handler_vga_timed
+#else
+#define DMA_HANDLER_VGA dma_handler_vga
+#endif
+
+// precompute the line type for each line of a pair of scaled lines, so the ISR doesn't branch on div and scanlines
+static void set_line_map()
+{
+  for (int i = 0; i < 2 * video_mode.div && i < (int)count_of(line_map); i++)
+  {
+    uint8_t line = i;
+
+    switch (video_mode.div)
+    {
+    case 2:
+#ifdef SCANLINES_ENABLE_LOW_RES
+      if (scanlines_mode)
+#else
+      if (scanlines_mode == SCANLINES_DIM)
+#endif
       {
-        scr_line++;
+        if (line > 0)
+          line++;
 
-        *line_buf++ = palette[0];
+        if (line == 4)
+          line++;
       }
+      else if (line > 1)
+        line++;
 
-    for (; (x + 4) <= osd_mode.end_x; x += 4)
-    { // ultra-simplified OSD compositing with optimized unrolling
-      scr_line += 4;
+      break;
 
-      *line_buf++ = palette[*osd_line++];
-      *line_buf++ = palette[*osd_line++];
-      *line_buf++ = palette[*osd_line++];
-      *line_buf++ = palette[*osd_line++];
-    }
+    case 3:
+      if (!scanlines_mode && ((line == 2) || (line == 5)))
+        line--;
+      break;
 
-    for (; x < osd_mode.end_x; x++)
-    { // handle remaining bytes (0-3 bytes)
-      scr_line++;
+    case 4:
+      if (scanlines_mode)
+      {
+#ifdef SCANLINES_USE_THIN
+        if (line > 1)
+          line--;
 
-      *line_buf++ = palette[*osd_line++];
-    }
+        if (line >= 5)
+          line--;
+#else
+        if (line > 2)
+          line--;
 
-    if (!osd_mode.full_width)
-    {
-      for (; (x + 4) <= h_visible_area; x += 4)
-      {
-        *line_buf++ = palette[*scr_line++];
-        *line_buf++ = palette[*scr_line++];
-        *line_buf++ = palette[*scr_line++];
-        *line_buf++ = palette[*scr_line++];
+        if (line == 6)
+          line--;
+#endif
       }
-
-      for (; x < h_visible_area; x++)
-        *line_buf++ = palette[*scr_line++];
-    }
-    else
-      for (; x < h_visible_area; x++)
+      else
       {
-        scr_line++;
+        if (line > 2)
+          line--;
+
+        if (line == 6)
+          line--;
 
-        *line_buf++ = palette[0];
+        if ((line == 2) || (line == 5))
+          line--;
       }
-  }
-  else
-  { // ultra-fast direct byte processing for non-OSD area with loop unrolling
-#endif
-    int x = 0;
 
-    for (; (x + 4) <= h_visible_area; x += 4)
-    {
-      *line_buf++ = palette[*scr_line++];
-      *line_buf++ = palette[*scr_line++];
-      *line_buf++ = palette[*scr_line++];
-      *line_buf++ = palette[*scr_line++];
+      break;
+
+    default:
+      break;
     }
 
-    for (; x < h_visible_area; x++)
-      *line_buf++ = palette[*scr_line++];
-#ifdef OSD_ENABLE
+    if ((line == LINE_BLANK0 || line == LINE_BLANK1) && scanlines_mode == SCANLINES_DIM)
+      line_map[i] = LINE_DIM;
+    else
+      line_map[i] = (line <= LINE_BLANK1) ? line : LINE_SKIP;
   }
-#endif
+}
 
-  // right margin
-  for (int x = h_margin; x--;)
-    *line_buf++ = palette[0];
+// scale the 2-bit DAC level of each color channel to SCANLINES_DIM_LEVEL, sync bits are kept
+static uint8_t get_dim_color(uint8_t color)
+{
+  static const uint8_t channels[3] = {R_HIGH, G_HIGH, B_HIGH};
+  uint8_t dim = color & ~(R_HIGH | G_HIGH | B_HIGH);
 
-  dma_channel_set_read_addr(dma_ch1, &v_out_dma_buf[active_buf_idx], false);
+  for (int i = 0; i < 3; i++)
+  {
+    uint8_t step = channels[i] / 3; // lowest DAC level of the channel
+    uint8_t level = (color & channels[i]) / step;
+
+    dim |= ((level * SCANLINES_DIM_LEVEL + 50) / 100) * step;
+  }
+
+  return dim;
 }
 
-void set_vga_scanlines_mode(bool sl_mode)
+void set_vga_scanlines_mode(uint8_t sl_mode)
 {
   scanlines_mode = sl_mode;
+  set_line_map();
 }
 
 void start_vga()
@@ -308,8 +558,9 @@ void start_vga()
   int h_sync_pulse_front = (video_mode.h_visible_area + video_mode.h_front_porch) / video_mode.div;
   int h_sync_pulse = video_mode.h_sync_pulse / video_mode.div;
 
-  set_sys_clock_khz(video_mode.sys_freq, true);
-  sleep_ms(10);
+  set_video_sys_clock(video_mode.sys_freq);
+
+  set_line_map();
 
   // sync pulse patterns (positive polarity)
   static const uint8_t NO_SYNC = 0b00000000;
@@ -336,6 +587,10 @@ void start_vga()
     }
   }
 
+  // dimmed palette for SCANLINES_DIM
+  for (int i = 0; i < 256; i++)
+    palette_dim[i] = ((uint16_t)get_dim_color(palette[i] >> 8) << 8) | get_dim_color(palette[i] & 0xff);
+
   // set VGA pins
   for (int i = VGA_PIN_D0; i < VGA_PIN_D0 + 8; i++)
   {
@@ -368,6 +623,11 @@ void start_vga()
     watchdog_reboot(0, 0, 0);
   memcpy((uint8_t *)v_out_dma_buf[1], (uint8_t *)v_out_sync_hblank, whole_line);
 
+  v_out_dma_buf_dim = calloc(whole_line, sizeof(uint8_t));
+  if (!v_out_dma_buf_dim)
+    watchdog_reboot(0, 0, 0);
+  memcpy((uint8_t *)v_out_dma_buf_dim, (uint8_t *)v_out_sync_hblank, whole_line);
+
   // PIO initialization
   pio_sm_config c = pio_get_default_sm_config();
 
@@ -428,7 +688,7 @@ void start_vga()
   dma_channel_set_irq0_enabled(dma_ch1, true);
 
   // configure the processor to run dma_handler_vga() when DMA IRQ 0 is asserted
-  irq_set_exclusive_handler(DMA_IRQ_0, dma_handler_vga);
+  irq_set_exclusive_handler(DMA_IRQ_0, DMA_HANDLER_VGA);
   irq_set_priority(DMA_IRQ_0, PICO_HIGHEST_IRQ_PRIORITY);
   irq_set_enabled(DMA_IRQ_0, true);
 
@@ -439,11 +699,15 @@ void stop_vga()
 {
   // disable IRQ first to prevent handlers from running during cleanup
   irq_set_enabled(DMA_IRQ_0, false);
-  irq_remove_handler(DMA_IRQ_0, dma_handler_vga);
+  irq_remove_handler(DMA_IRQ_0, DMA_HANDLER_VGA);
 
   // reset ISR state for clean restart
   y = 0;
   scr_buffer = NULL;
+#ifdef OSD_ENABLE
+  render_image_osd_rows = render_image;
+  osd_frame = NULL;
+#endif
 
   // stop PIO
   pio_sm_set_enabled(PIO_VGA, SM_VGA, false);
@@ -469,6 +733,12 @@ void stop_vga()
     v_out_dma_buf[1] = NULL;
   }
 
+  if (v_out_dma_buf_dim != NULL)
+  {
+    free(v_out_dma_buf_dim);
+    v_out_dma_buf_dim = NULL;
+  }
+
   // free sync buffers
   if (v_out_sync_hblank != NULL)
   {
@@ -1,5 +1,5 @@
 #pragma once
 
-void set_vga_scanlines_mode(bool);
+void set_vga_scanlines_mode(uint8_t);
 void start_vga();
 void stop_vga();
\ No newline at end of file
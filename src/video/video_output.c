@@ -1,8 +1,17 @@
+#include "hardware/clocks.h"
 #include "hardware/gpio.h"
 
+#if PICO_RP2350
+#include "hardware/structs/qmi.h"
+#include "hardware/vreg.h"
+#endif
+
 #include "g_config.h"
 #include "video_output.h"
 #include "dvi.h"
+#ifdef DVI_HSTX_ENABLE
+#include "dvi_hstx.h"
+#endif
 #include "v_buf.h"
 #include "vga.h"
 
@@ -10,6 +19,10 @@
 #include "osd.h"
 #endif
 
+#ifdef KBD_ENABLE
+#include "kbd.h"
+#endif
+
 extern settings_t settings;
 video_out_type_t active_video_output = VIDEO_OUT_TYPE_DEF;
 
@@ -79,6 +92,48 @@ video_out_type_t detect_video_output_type()
   return (high_count >= 2) ? DVI : VGA;
 }
 
+#if PICO_RP2350
+// QMI clock divider must be changed while running from RAM
+static void __no_inline_not_in_flash_func(set_flash_clkdiv)(uint32_t clkdiv)
+{
+  qmi_hw->m[0].timing = (qmi_hw->m[0].timing & ~QMI_M0_TIMING_CLKDIV_BITS) | (clkdiv << QMI_M0_TIMING_CLKDIV_LSB);
+}
+
+static uint32_t get_flash_clkdiv()
+{
+  return (qmi_hw->m[0].timing & QMI_M0_TIMING_CLKDIV_BITS) >> QMI_M0_TIMING_CLKDIV_LSB;
+}
+#endif
+
+void set_video_sys_clock(uint32_t sys_freq)
+{
+#if PICO_RP2350
+  // flash clock divider as set up at boot, nothing else changes it
+  static uint32_t boot_flash_clkdiv = 0;
+
+  if (!boot_flash_clkdiv)
+    boot_flash_clkdiv = get_flash_clkdiv();
+
+  if (sys_freq > 300000)
+  { // raise core voltage and keep the flash clock at or below 133MHz before the clock goes up
+    vreg_set_voltage(VREG_VOLTAGE_1_30);
+    sleep_ms(10);
+    set_flash_clkdiv(3);
+  }
+#endif
+
+  set_sys_clock_khz(sys_freq, true);
+  sleep_ms(10);
+
+#if PICO_RP2350
+  if (sys_freq <= 300000)
+  { // back to the boot flash clock and the core voltage of setup() once the clock is down
+    set_flash_clkdiv(boot_flash_clkdiv);
+    vreg_set_voltage(VREG_VOLTAGE_1_25);
+  }
+#endif
+}
+
 void set_video_mode_params(video_mode_t v_mode)
 {
   video_mode = v_mode;
@@ -111,7 +166,11 @@ void start_video_output(video_out_type_t output_type)
   switch (output_type)
   {
   case DVI:
+#ifdef DVI_HSTX_ENABLE
+    start_dvi_hstx();
+#else
     start_dvi();
+#endif
     break;
 
   case VGA:
@@ -121,6 +180,11 @@ void start_video_output(video_out_type_t output_type)
   default:
     break;
   }
+
+#ifdef KBD_ENABLE
+  // keyboard PIO clocks and the EPM3256 refresh timer are derived from clk_sys, which the output may have changed
+  kbd_set_sys_clock();
+#endif
 }
 
 void stop_video_output()
@@ -128,7 +192,11 @@ void stop_video_output()
   switch (active_video_output)
   {
   case DVI:
+#ifdef DVI_HSTX_ENABLE
+    stop_dvi_hstx();
+#else
     stop_dvi();
+#endif
     break;
 
   case VGA:
@@ -142,8 +210,32 @@ void stop_video_output()
 
 void set_scanlines_mode()
 {
-  if (settings.video_out_type == VGA)
-    set_vga_scanlines_mode(settings.scanlines_mode);
+  // both outputs keep the mode, the active one may differ from settings.video_out_type after auto detection
+  set_vga_scanlines_mode(settings.scanlines_mode);
+#ifdef DVI_HSTX_ENABLE
+  set_dvi_hstx_scanlines_mode(settings.scanlines_mode);
+#else
+  set_dvi_scanlines_mode(settings.scanlines_mode);
+#endif
+
+#ifdef OSD_ENABLE
+  // the dimmed scanlines may leave no time for OSD blending
+  osd_apply_blend();
+#endif
+}
+
+// next scanlines mode after sl_mode supported by the running output type and mode
+uint8_t get_next_scanlines_mode(uint8_t sl_mode)
+{
+  sl_mode = (sl_mode >= SCANLINES_MODE_MAX) ? SCANLINES_MODE_MIN : sl_mode + 1;
+
+#ifndef SCANLINES_ENABLE_LOW_RES
+  // black scanlines on div 2 modes halve the brightness, only the dimmed ones are offered
+  if (sl_mode == SCANLINES_BLACK && video_modes[settings.video_out_mode]->div == 2)
+    sl_mode = SCANLINES_DIM;
+#endif
+
+  return sl_mode;
 }
 
 void draw_welcome_screen(video_mode_t video_mode)
@@ -3,7 +3,9 @@
 video_out_type_t detect_video_output_type();
 void start_video_output(video_out_type_t);
 void stop_video_output();
+void set_video_sys_clock(uint32_t sys_freq);
 void set_scanlines_mode();
+uint8_t get_next_scanlines_mode(uint8_t sl_mode);
 void draw_welcome_screen(video_mode_t);
 void draw_welcome_screen_h(video_mode_t);
 void draw_no_signal(video_mode_t);
\ No newline at end of file
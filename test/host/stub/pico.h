@@ -0,0 +1,262 @@
+/**
+ * pico.h - host stand-in for the pico SDK
+ *
+ * Just enough of the SDK for the hardware independent sources under test
+ * to compile with the host compiler. Hardware functions are declared only;
+ * a test defines the ones its code under test calls.
+ */
+
+#pragma once
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned int uint;
+
+#define __not_in_flash_func(f) f
+#define __no_inline_not_in_flash_func(f) f
+#define __scratch_x(n)
+#define __scratch_y(n)
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#define PICO_DEFAULT_IRQ_PRIORITY 0x80
+#define PICO_LOWEST_IRQ_PRIORITY 0xc0
+#define PICO_HIGHEST_IRQ_PRIORITY 0x00
+
+#define XIP_BASE 0x10000000
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#define FLASH_SECTOR_SIZE 4096
+#define FLASH_PAGE_SIZE 256
+
+// single threaded tests: barriers and critical sections are no-ops
+static inline void __dmb(void) {}
+static inline void __compiler_memory_barrier(void) {}
+static inline void tight_loop_contents(void) {}
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+// peripherals: referenced by the board configuration in g_config.h, the I2C slave address is set directly
+typedef struct pio_hw
+{
+    uint32_t txf[4];
+    uint32_t rxf[4];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t pio0_hw, pio1_hw;
+#define pio0 (&pio0_hw)
+#define pio1 (&pio1_hw)
+
+typedef struct i2c_hw
+{
+    uint32_t sar;
+} i2c_hw_t;
+
+typedef struct i2c_inst
+{
+    i2c_hw_t *hw;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst, i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+#define I2C0_IRQ 23
+
+// irq
+typedef void (*irq_handler_t)(void);
+void irq_set_enabled(uint num, bool enabled);
+void irq_set_pending(uint num);
+void irq_set_priority(uint num, uint8_t hardware_priority);
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+int user_irq_claim_unused(bool required);
+
+// time
+typedef int32_t alarm_id_t;
+typedef uint64_t absolute_time_t;
+typedef void (*hardware_alarm_callback_t)(uint alarm_num);
+void sleep_ms(uint32_t ms);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+absolute_time_t make_timeout_time_us(uint64_t us);
+int hardware_alarm_claim_unused(bool required);
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback);
+uint hardware_alarm_get_irq_num(uint alarm_num);
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t);
+void hardware_alarm_force_irq(uint alarm_num);
+
+// i2c
+uint8_t i2c_read_byte_raw(i2c_inst_t *i2c);
+void i2c_write_byte_raw(i2c_inst_t *i2c, uint8_t value);
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+static inline uint i2c_hw_index(i2c_inst_t *i2c) { return i2c == i2c1; }
+
+// gpio
+enum gpio_dir
+{
+    GPIO_OUT = 1,
+    GPIO_IN = 0
+};
+
+enum gpio_override
+{
+    GPIO_OVERRIDE_NORMAL = 0,
+    GPIO_OVERRIDE_INVERT = 1,
+    GPIO_OVERRIDE_LOW = 2,
+    GPIO_OVERRIDE_HIGH = 3
+};
+
+#define GPIO_FUNC_I2C 3
+
+void gpio_init(uint gpio);
+void gpio_set_function(uint gpio, uint fn);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_pull_up(uint gpio);
+void gpio_set_inover(uint gpio, uint value);
+bool gpio_get(uint gpio);
+
+enum gpio_drive_strength
+{
+    GPIO_DRIVE_STRENGTH_2MA = 0,
+    GPIO_DRIVE_STRENGTH_4MA = 1,
+    GPIO_DRIVE_STRENGTH_8MA = 2,
+    GPIO_DRIVE_STRENGTH_12MA = 3
+};
+
+enum gpio_slew_rate
+{
+    GPIO_SLEW_RATE_SLOW = 0,
+    GPIO_SLEW_RATE_FAST = 1
+};
+
+void gpio_set_drive_strength(uint gpio, enum gpio_drive_strength drive);
+void gpio_set_slew_rate(uint gpio, enum gpio_slew_rate slew);
+
+// video output: the line renderers run on the host, the peripherals they are started with are declared only
+typedef enum clock_handle
+{
+    clk_sys = 5
+} clock_handle_t;
+
+uint32_t clock_get_hz(clock_handle_t clock);
+bool check_sys_clock_khz(uint32_t freq_khz, uint *vco_freq_out, uint *post_div1_out, uint *post_div2_out);
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms);
+void irq_remove_handler(uint num, irq_handler_t handler);
+
+#define DMA_IRQ_0 10
+#define DREQ_PIO0_TX0 0
+#define DREQ_PIO0_RX0 4
+#define DREQ_PIO1_RX0 12
+
+typedef struct dma_channel_hw
+{
+    volatile const void *read_addr;
+    volatile void *write_addr;
+    uint32_t transfer_count;
+    uint32_t ctrl_trig;
+} dma_channel_hw_t;
+
+typedef struct dma_hw
+{
+    dma_channel_hw_t ch[16];
+    uint32_t ints0;
+} dma_hw_t;
+
+extern dma_hw_t dma_hw_inst;
+#define dma_hw (&dma_hw_inst)
+
+enum dma_channel_transfer_size
+{
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+typedef struct
+{
+    uint32_t ctrl;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+void dma_channel_cleanup(uint channel);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger);
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+void dma_start_channel_mask(uint32_t chan_mask);
+
+struct pio_program
+{
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+    uint8_t pio_version;
+};
+
+typedef struct
+{
+    uint32_t clkdiv;
+    uint32_t execctrl;
+    uint32_t shiftctrl;
+    uint32_t pinctrl;
+} pio_sm_config;
+
+enum pio_src_dest
+{
+    pio_pins = 0,
+    pio_x = 1,
+    pio_y = 2,
+    pio_null = 3,
+    pio_pindirs = 4,
+    pio_exec_mov = 4,
+    pio_status = 5,
+    pio_pc = 5,
+    pio_isr = 6,
+    pio_osr = 7
+};
+
+uint pio_encode_in(enum pio_src_dest src, uint count);
+uint pio_encode_mov(enum pio_src_dest dest, enum pio_src_dest src);
+uint pio_encode_set(enum pio_src_dest dest, uint value);
+
+enum pio_fifo_join
+{
+    PIO_FIFO_JOIN_NONE = 0,
+    PIO_FIFO_JOIN_TX = 1,
+    PIO_FIFO_JOIN_RX = 2
+};
+
+pio_sm_config pio_get_default_sm_config(void);
+void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap);
+void sm_config_set_sideset(pio_sm_config *c, uint bit_count, bool optional, bool pindirs);
+void sm_config_set_sideset_pins(pio_sm_config *c, uint sideset_base);
+void sm_config_set_out_pins(pio_sm_config *c, uint out_base, uint out_count);
+void sm_config_set_in_pins(pio_sm_config *c, uint in_base);
+void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold);
+void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, uint push_threshold);
+void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join);
+void sm_config_set_clkdiv(pio_sm_config *c, float div);
+uint pio_add_program(PIO pio, const struct pio_program *program);
+void pio_remove_program(PIO pio, const struct pio_program *program, uint loaded_offset);
+void pio_gpio_init(PIO pio, uint pin);
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_put(PIO pio, uint sm, uint32_t data);
+void pio_sm_exec(PIO pio, uint sm, uint instr);
+void pio_sm_clear_fifos(PIO pio, uint sm);
+void pio_sm_restart(PIO pio, uint sm);
+void pio_sm_set_pins_with_mask(PIO pio, uint sm, uint32_t pin_values, uint32_t pin_mask);
+void pio_sm_set_pindirs_with_mask(PIO pio, uint sm, uint32_t pin_dirs, uint32_t pin_mask);
@@ -0,0 +1,39 @@
+/**
+ * test.h - minimal checks for the host tests
+ *
+ * Each test is one program: the firmware sources it covers plus a main()
+ * that runs the checks and returns non-zero if any failed.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+static int test_failures;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                                         \
+    do                                                                                                     \
+    {                                                                                                      \
+        long long actual_ = (long long)(actual), expected_ = (long long)(expected);                        \
+        if (actual_ != expected_)                                                                          \
+        {                                                                                                  \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, actual_, expected_); \
+            test_failures++;                                                                               \
+        }                                                                                                  \
+    } while (0)
+
+static inline int test_result(const char *name)
+{
+    printf("%s: %s\n", name, test_failures ? "FAILED" : "ok");
+    return test_failures ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * test_dvi_budget.c - Direct DVI path: DMA words and render time per line for each mode
+ *
+ * Built with the RP2350 configuration (DVI_DIRECT_ENABLE) against the video
+ * modes of g_config.c. For each mode the line is simulated as the direct path
+ * runs it: the serializer takes 2 words per pixel every 10 system clocks, the
+ * 2 DMA channels move them from the line buffer, and dma_handler_dvi() renders
+ * the next line buffer (8 words per input byte) while the current one is sent.
+ *
+ * A mode fits if its system clock can be set and the render leaves core 0
+ * enough of the line. The modes up to VIDEO_MODE_DVI_MAX have to fit, the ones
+ * above it must not. Run with -v for the table (docs/VGA_TIMINGS.md).
+ */
+
+#include "test.h"
+#include "g_config.h"
+
+#define SERIALIZER_CLOCKS_PER_PIXEL 10 // pio_dvi: 10 out instructions per pixel
+#define WORDS_PER_PIXEL 2              // 60 bits, 30 per word (autopull threshold)
+#define FIFO_DEPTH 8                   // TX FIFO joined
+#define CHAIN_CLOCKS 8                 // DMA chain hand over and read address reload, generous
+
+// The highest system clock set_video_sys_clock() runs, at VREG_VOLTAGE_1_30
+#define SYS_FREQ_MAX_KHZ 400000
+
+// Cortex-M33 estimate for one input byte of render_image(): ldrb of the byte, address of its
+// entry, ldm + stm of 8 words (1 + 8 cycles each) with zero wait state SRAM
+#define RENDER_CLOCKS_PER_BYTE 21
+#define ISR_CLOCKS 120 // entry, exit, y/buffer bookkeeping and the ch1 read address
+
+// Part of each line the output ISR may take from core 0 (OSD, menus and the main loop run there),
+// with SCANLINES_DIM every line is rendered
+#define RENDER_SHARE_MAX 60
+
+typedef struct
+{
+    uint32_t sys_khz;
+    uint32_t line_clocks;
+    uint32_t dma_words;
+    uint32_t serializer_words; // the serializer takes in a line time
+    uint32_t underruns;        // serializer found the FIFO empty
+    uint32_t render_bytes;
+    uint32_t render_clocks;
+    uint32_t buffers_bytes;
+    uint32_t render_share; // %
+    bool clock_ok;
+    bool render_ok;
+} budget_t;
+
+static budget_t simulate(const video_mode_t *mode)
+{
+    budget_t b = {0};
+
+    b.sys_khz = (uint32_t)(mode->pixel_freq / 100); // start_dvi(): 10 system clocks per pixel
+    b.line_clocks = mode->whole_line * SERIALIZER_CLOCKS_PER_PIXEL;
+
+    // ch0 moves the line, ch1 reloads its read address once
+    b.dma_words = mode->whole_line * WORDS_PER_PIXEL + 1;
+
+    // 2 lines clock by clock: the serializer takes a word from the joined TX FIFO every 5 clocks,
+    // ch0 refills it at up to 1 word per clock and hands over to ch1 once per line
+    uint32_t fifo = FIFO_DEPTH;
+    uint32_t line_words = mode->whole_line * WORDS_PER_PIXEL;
+    uint32_t left = line_words;
+    uint32_t stall = 0;
+
+    for (uint32_t clock = 0; clock < 2 * b.line_clocks; clock++)
+    {
+        if (clock % (SERIALIZER_CLOCKS_PER_PIXEL / WORDS_PER_PIXEL) == 0)
+        {
+            if (fifo)
+                fifo--;
+            else
+                b.underruns++;
+
+            if (clock < b.line_clocks)
+                b.serializer_words++;
+        }
+
+        if (stall)
+            stall--;
+        else if (fifo < FIFO_DEPTH)
+        {
+            fifo++;
+
+            if (--left == 0)
+            { // ch0 -> ch1 -> ch0 with the next read address
+                left = line_words;
+                stall = CHAIN_CLOCKS;
+            }
+        }
+    }
+
+    // set_video_mode_params(): input bytes of a line, without capture margins
+    b.render_bytes = (mode->h_visible_area / (mode->div * 4)) * 2;
+    b.render_clocks = ISR_CLOCKS + b.render_bytes * RENDER_CLOCKS_PER_BYTE;
+    b.render_share = b.render_clocks * 100 / b.line_clocks;
+
+    // 2 ping-pong + dim + H blank + V sync lines
+    b.buffers_bytes = 5 * mode->whole_line * WORDS_PER_PIXEL * 4;
+
+    b.clock_ok = b.sys_khz <= SYS_FREQ_MAX_KHZ;
+    b.render_ok = b.render_share <= RENDER_SHARE_MAX;
+
+    return b;
+}
+
+static void print_row(const char *name, const video_mode_t *const *modes, int count, uint32_t (*value)(const budget_t *))
+{
+    printf("| %-30s |", name);
+
+    for (int i = 0; i < count; i++)
+    {
+        budget_t b = simulate(modes[i]);
+        printf(" %12u |", value(&b));
+    }
+
+    printf("\n");
+}
+
+static uint32_t sys_mhz(const budget_t *b) { return b->sys_khz / 1000; }
+static uint32_t line_clocks(const budget_t *b) { return b->line_clocks; }
+static uint32_t dma_words(const budget_t *b) { return b->dma_words; }
+static uint32_t render_bytes(const budget_t *b) { return b->render_bytes; }
+static uint32_t render_clocks(const budget_t *b) { return b->render_clocks; }
+static uint32_t render_share(const budget_t *b) { return b->render_share; }
+static uint32_t buffers_bytes(const budget_t *b) { return b->buffers_bytes; }
+
+static void print_table(void)
+{
+    static const video_mode_t *const modes[] = {&mode_640x480_60Hz, &mode_720x576_50Hz, &mode_800x600_60Hz,
+                                                &mode_1024x768_60Hz_d3, &mode_1280x1024_60Hz_d3};
+    int count = count_of(modes);
+
+    printf("| %-30s |", "Mode");
+
+    for (int i = 0; i < count; i++)
+        printf(" %5u x %-4u |", modes[i]->h_visible_area, modes[i]->v_visible_area);
+
+    printf("\n");
+    print_row("System clock (MHz)", modes, count, sys_mhz);
+    print_row("Line time (system clocks)", modes, count, line_clocks);
+    print_row("DMA words per line", modes, count, dma_words);
+    print_row("Input bytes rendered per line", modes, count, render_bytes);
+    print_row("Render (system clocks, est.)", modes, count, render_clocks);
+    print_row("Render share of the line (%)", modes, count, render_share);
+    print_row("Line buffers (bytes)", modes, count, buffers_bytes);
+}
+
+static void test_modes(void)
+{
+    for (int i = VIDEO_MODE_MIN; i <= MODE_1280x1024_60Hz_d4; i++)
+    {
+        const video_mode_t *mode = video_modes[i];
+        budget_t b = simulate(mode);
+        bool fits = b.clock_ok && b.render_ok;
+
+        // DMA moves what the serializer takes in a line and keeps up with it
+        CHECK_EQ(b.dma_words - 1, b.serializer_words);
+        CHECK_EQ(b.underruns, 0);
+
+        if (fits != (i <= VIDEO_MODE_DVI_MAX))
+        {
+            printf("%s:%d: %ux%u (div %u): %s, %u MHz, render %u%% of the line\n", __FILE__, __LINE__,
+                   mode->h_visible_area, mode->v_visible_area, mode->div,
+                   fits ? "fits but is not offered" : "offered but does not fit",
+                   b.sys_khz / 1000, b.render_share);
+            test_failures++;
+        }
+    }
+
+    // 1024x768: the system clock, not the render, is what rules it out
+    budget_t b = simulate(&mode_1024x768_60Hz_d4);
+    CHECK(!b.clock_ok);
+    CHECK(b.render_ok);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "-v") == 0)
+        print_table();
+
+    test_modes();
+
+    return test_result("dvi_budget");
+}
@@ -0,0 +1,485 @@
+/**
+ * test_ff_osd.c - FF OSD I2C receive and decode
+ *
+ * Includes ff_osd.c and drives i2c_slave_handler() the way the I2C slave
+ * library does: one RECEIVE per byte written, one REQUEST per byte read,
+ * FINISH at the stop. Time is simulated: bytes arrive at the bus rate
+ * (9 bit times each) and the decode IRQ runs a set latency after it was
+ * made pending, standing for the higher priority capture/video ISRs it
+ * waits for. Its runs can be taken as atomic: a byte that arrives while it
+ * decodes is left for the next run, as one arriving just after it.
+ *
+ * - replay: FlashFloppy protocol refreshes (header, FF_OSD_DATA and the
+ *   text, then the 4 byte info read) and HD44780 refreshes through a
+ *   PCF8574 at 100 and 400 kHz, the last snapshot has to be the last frame
+ * - fuzz: random bytes and bus events, ring and decoder state have to stay
+ *   in bounds (built with the address and UB sanitizers) and a clean frame
+ *   afterwards has to be shown as sent
+ */
+
+#include "test.h"
+#include "ff_osd.c"
+
+settings_t settings;
+video_mode_t video_mode;
+int16_t h_visible_area;
+int16_t v_margin;
+i2c_inst_t i2c0_inst, i2c1_inst;
+
+// SDK stand-ins, the I2C peripheral and the OSD are not used
+
+void osd_layers_update() {}
+bool gpio_get(uint gpio) { return true; }
+void gpio_set_dir(uint gpio, bool out) {}
+void gpio_set_inover(uint gpio, uint value) {}
+void i2c_slave_init(i2c_inst_t *i2c, uint8_t address, i2c_slave_handler_t handler) {}
+void i2c_slave_deinit(i2c_inst_t *i2c) {}
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) { return baudrate; }
+void gpio_init(uint gpio) {}
+void gpio_set_function(uint gpio, uint fn) {}
+void gpio_pull_up(uint gpio) {}
+void irq_set_priority(uint num, uint8_t hardware_priority) {}
+void irq_set_enabled(uint num, bool enabled) {}
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {}
+int user_irq_claim_unused(bool required) { return 31; }
+uint64_t time_us_64(void) { return 0; }
+
+// Simulated bus and decode IRQ
+
+#define NEVER UINT64_MAX
+
+static uint32_t bus_hz;
+static uint64_t decode_latency_ns;
+static uint64_t now_ns;
+static uint64_t decode_at_ns = NEVER;
+
+static uint8_t rx_byte; // the byte the RECEIVE being handled returns
+static uint8_t tx_bytes[8];
+static int tx_count;
+
+uint8_t i2c_read_byte_raw(i2c_inst_t *i2c)
+{
+    return rx_byte;
+}
+
+void i2c_write_byte_raw(i2c_inst_t *i2c, uint8_t value)
+{
+    if (tx_count < (int)sizeof(tx_bytes))
+        tx_bytes[tx_count] = value;
+
+    tx_count++;
+}
+
+void irq_set_pending(uint num)
+{
+    if (decode_at_ns == NEVER)
+        decode_at_ns = now_ns + decode_latency_ns;
+}
+
+// Every snapshot the decoder published, checked by the caller of run_until()
+typedef void (*publish_check_t)(void);
+static publish_check_t publish_check;
+static uint32_t published_sequence;
+
+static void decode(void)
+{
+    decode_at_ns = NEVER;
+    ff_osd_decode_irq_handler();
+
+    if (ff_osd_sequence != published_sequence)
+    {
+        published_sequence = ff_osd_sequence;
+
+        if (publish_check)
+            publish_check();
+    }
+}
+
+static void run_until(uint64_t end_ns)
+{
+    while (decode_at_ns <= end_ns)
+    {
+        if (decode_at_ns > now_ns)
+            now_ns = decode_at_ns;
+
+        decode();
+    }
+
+    if (end_ns > now_ns)
+        now_ns = end_ns;
+}
+
+static void bus_bits(uint32_t bits)
+{
+    run_until(now_ns + bits * 1000000000ull / bus_hz);
+}
+
+static void bus_write(const uint8_t *data, int len)
+{
+    bus_bits(10); // start and address
+
+    for (int i = 0; i < len; i++)
+    {
+        bus_bits(9);
+        rx_byte = data[i];
+        i2c_slave_handler(I2C_INST, I2C_SLAVE_RECEIVE);
+    }
+
+    bus_bits(1);
+    i2c_slave_handler(I2C_INST, I2C_SLAVE_FINISH);
+}
+
+static void bus_read(int len)
+{
+    bus_bits(10);
+    tx_count = 0;
+
+    for (int i = 0; i < len; i++)
+    {
+        bus_bits(9);
+        i2c_slave_handler(I2C_INST, I2C_SLAVE_REQUEST);
+    }
+
+    bus_bits(1);
+    i2c_slave_handler(I2C_INST, I2C_SLAVE_FINISH);
+}
+
+static void reset(bool i2c_protocol)
+{
+    run_until(NEVER - 1);
+    now_ns = 0;
+    decode_at_ns = NEVER;
+    publish_check = NULL;
+
+    d_cons = d_prod = 0;
+    t_cons = t_prod = 0;
+    t_dropping = false;
+    ff_osd_x = ff_osd_y = 0;
+    memset((void *)&ff_osd_i2c_stats, 0, sizeof(ff_osd_i2c_stats));
+
+    settings.ff_osd_config.i2c_protocol = i2c_protocol;
+    settings.ff_osd_config.cols = 20;
+    settings.ff_osd_config.rows = 2;
+    ff_osd_display.rows = 2;
+    ff_osd_display.cols = 20;
+    lcd_display_update();
+}
+
+// Frames as the host sent them
+
+typedef struct
+{
+    char text[4][FF_OSD_COLUMNS_MAX];
+    uint8_t cols, rows, heights;
+    bool on;
+} frame_t;
+
+#define FRAMES 300
+
+static frame_t frames[FRAMES];
+static int frames_sent;
+static bool frames_complete; // each snapshot is a whole frame
+static int torn_snapshots;
+
+static void make_frame(frame_t *frame, int n, bool i2c_protocol)
+{
+    char line[FF_OSD_COLUMNS_MAX + 1];
+
+    frame->cols = i2c_protocol ? ((n / 50) % 2 ? 40 : 24) : 20;
+    frame->rows = i2c_protocol ? 2 + (n / 25) % 3 : 2;
+    frame->heights = i2c_protocol ? (n % 7 == 0) : 0;
+    frame->on = n % 40 != 39;
+
+    for (int row = 0; row < 4; row++)
+    {
+        snprintf(line, sizeof(line), "%d:%04d T%02d.%d %-20s", row, n, n % 80, n & 1, row ? "DSK_0123.HFE" : "FlashFloppy");
+        memset(frame->text[row], ' ', FF_OSD_COLUMNS_MAX);
+        memcpy(frame->text[row], line, strlen(line) < FF_OSD_COLUMNS_MAX ? strlen(line) : FF_OSD_COLUMNS_MAX);
+    }
+}
+
+static bool shows_frame(const ff_osd_display_t *display, const frame_t *frame)
+{
+    if (display->cols != frame->cols || display->rows != frame->rows ||
+        display->heights != frame->heights || display->on != frame->on)
+        return false;
+
+    for (int row = 0; row < frame->rows; row++)
+        if (memcmp(display->text[row], frame->text[row], frame->cols) != 0)
+            return false;
+
+    return true;
+}
+
+static void check_snapshot(void)
+{
+    if (!frames_complete)
+        return;
+
+    // the frame just sent, or the one before it when the decoder ran late
+    for (int i = frames_sent - 1; i >= 0 && i >= frames_sent - 2; i--)
+        if (shows_frame(&ff_osd_snapshot.display, &frames[i]))
+            return;
+
+    torn_snapshots++;
+}
+
+// FlashFloppy protocol: header commands, then FF_OSD_DATA and rows x cols text bytes
+static int ff_frame_bytes(const frame_t *frame, uint8_t *out)
+{
+    int len = 0;
+
+    out[len++] = FF_OSD_BACKLIGHT | frame->on;
+    out[len++] = FF_OSD_COLUMNS | frame->cols;
+    out[len++] = FF_OSD_ROWS | frame->rows;
+    out[len++] = FF_OSD_HEIGHTS | frame->heights;
+    out[len++] = FF_OSD_BUTTONS | 0;
+    out[len++] = FF_OSD_DATA;
+
+    for (int row = 0; row < frame->rows; row++)
+        for (int col = 0; col < frame->cols; col++)
+            out[len++] = frame->text[row][col];
+
+    return len;
+}
+
+// HD44780 through a PCF8574: each nibble written with EN low, high and low again
+static int lcd_nibble(uint8_t *out, uint8_t nibble, bool rs, bool on)
+{
+    uint8_t x = (nibble << 4) | (on ? _BL : 0) | (rs ? _RS : 0);
+
+    out[0] = x;
+    out[1] = x | _EN;
+    out[2] = x;
+    return 3;
+}
+
+static int lcd_byte(uint8_t *out, uint8_t value, bool rs, bool on)
+{
+    int len = lcd_nibble(out, value >> 4, rs, on);
+
+    return len + lcd_nibble(out + len, value & 0x0F, rs, on);
+}
+
+static int lcd_frame_bytes(const frame_t *frame, uint8_t *out)
+{
+    static const uint8_t row_address[4] = {0x00, 0x40, 0x14, 0x54};
+    int len = 0;
+
+    for (int row = 0; row < frame->rows; row++)
+    {
+        len += lcd_byte(out + len, 0x80 | row_address[row], false, frame->on); // Set DDR Address
+
+        for (int col = 0; col < frame->cols; col++)
+            len += lcd_byte(out + len, frame->text[row][col], true, frame->on);
+    }
+
+    return len;
+}
+
+static void replay(bool i2c_protocol, uint32_t hz, uint32_t latency_us, uint32_t period_us)
+{
+    static uint8_t bytes[2048];
+    char name[64];
+
+    snprintf(name, sizeof(name), "%s %u kHz, decode after %u us, %u us period",
+             i2c_protocol ? "FlashFloppy" : "LCD", hz / 1000, latency_us, period_us);
+
+    reset(i2c_protocol);
+    bus_hz = hz;
+    decode_latency_ns = latency_us * 1000ull;
+    frames_sent = 0;
+    torn_snapshots = 0;
+
+    // the decoder sees whole frames if it runs before the next one starts
+    uint32_t frame_us = (uint32_t)((i2c_protocol ? 6 + 4 * 40 : 2 * 21 * 6) * 9 * 1000000ull / hz);
+    frames_complete = latency_us + frame_us < period_us;
+    publish_check = check_snapshot;
+
+    for (int n = 0; n < FRAMES; n++)
+    {
+        uint64_t start_ns = now_ns;
+
+        make_frame(&frames[n], n, i2c_protocol);
+        int len = i2c_protocol ? ff_frame_bytes(&frames[n], bytes) : lcd_frame_bytes(&frames[n], bytes);
+
+        bus_write(bytes, len);
+        frames_sent = n + 1;
+
+        if (i2c_protocol)
+        { // FlashFloppy reads the buttons back after each refresh
+            ff_osd_info.buttons = n & 7;
+            bus_bits(20);
+            bus_read(sizeof(ff_osd_info));
+
+            if (tx_count != 4 || tx_bytes[0] != 0 || tx_bytes[1] != '1' || tx_bytes[2] != '9' || tx_bytes[3] != (n & 7))
+            {
+                printf("%s:%d: %s, frame %d: info read back wrong\n", __FILE__, __LINE__, name, n);
+                test_failures++;
+            }
+        }
+
+        run_until(start_ns + period_us * 1000ull);
+    }
+
+    run_until(now_ns + decode_latency_ns + 1000000);
+
+    if (!shows_frame(&ff_osd_snapshot.display, &frames[FRAMES - 1]))
+    {
+        printf("%s:%d: %s: the last frame is not shown\n", __FILE__, __LINE__, name);
+        test_failures++;
+    }
+
+    if (torn_snapshots)
+    {
+        printf("%s:%d: %s: %d snapshots were not a whole frame\n", __FILE__, __LINE__, name, torn_snapshots);
+        test_failures++;
+    }
+
+    CHECK_EQ(ff_osd_i2c_stats.transactions, FRAMES); // reads are not counted
+    CHECK_EQ(ff_osd_i2c_stats.transaction_overflows, 0);
+    CHECK_EQ(ff_osd_i2c_stats.data_overflows, 0);
+    CHECK_EQ(ff_osd_i2c_stats.dropped_bytes, 0);
+}
+
+static void test_replay(void)
+{
+    static const uint32_t speeds[] = {100000, 400000};
+
+    for (int protocol = 0; protocol < 2; protocol++)
+        for (int speed = 0; speed < 2; speed++)
+        {
+            // FlashFloppy refreshes the display at most every 20 ms
+            replay(protocol, speeds[speed], 0, 20000);
+            replay(protocol, speeds[speed], 200, 20000);
+            replay(protocol, speeds[speed], 2000, 20000);
+            // back to back frames, the decoder running behind
+            replay(protocol, speeds[speed], 0, 1);
+            replay(protocol, speeds[speed], 5000, 1);
+        }
+}
+
+// Fuzz
+
+static uint32_t rng_state;
+
+static uint32_t rng(void)
+{ // xorshift32
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void check_state(void)
+{
+    CHECK((uint16_t)(d_prod - d_cons) <= FF_OSD_DATA_RING_SIZE);
+    CHECK((uint16_t)(t_prod - t_cons) <= FF_OSD_TRANSACTION_RING_SIZE);
+    CHECK(ff_osd_display.cols <= FF_OSD_COLUMNS_MAX);
+    CHECK(ff_osd_display.rows <= FF_OSD_ROWS_MAX);
+    CHECK(ff_osd_x < FF_OSD_COLUMNS_MAX);
+    CHECK(ff_osd_y <= FF_OSD_ROWS_MAX);
+}
+
+static void fuzz_receive(void)
+{
+    static const uint8_t commands[] = {FF_OSD_BACKLIGHT, FF_OSD_DATA, FF_OSD_ROWS, FF_OSD_HEIGHTS,
+                                       FF_OSD_BUTTONS, FF_OSD_COLUMNS};
+    uint32_t r = rng();
+
+    // half commands with random arguments, half any byte
+    rx_byte = (r & 1) ? commands[(r >> 1) % count_of(commands)] | ((r >> 8) & 0x3F) : r >> 16;
+    i2c_slave_handler(I2C_INST, I2C_SLAVE_RECEIVE);
+}
+
+static void fuzz(bool i2c_protocol, uint32_t seed, int events)
+{
+    int failures = test_failures;
+
+    reset(i2c_protocol);
+    rng_state = seed;
+
+    for (int i = 0; i < events; i++)
+    {
+        uint32_t r = rng() % 100;
+
+        if (r < 70)
+            fuzz_receive();
+        else if (r < 80)
+            i2c_slave_handler(I2C_INST, I2C_SLAVE_FINISH);
+        else if (r < 85)
+            i2c_slave_handler(I2C_INST, I2C_SLAVE_REQUEST);
+        else if (r < 95)
+            decode();
+        else if (r < 97)
+        { // long transaction, fills the data ring
+            for (int n = rng() % 1500; n > 0; n--)
+                fuzz_receive();
+        }
+        else
+        { // short transactions, fill the transaction ring
+            for (int n = rng() % 12; n > 0; n--)
+            {
+                fuzz_receive();
+                i2c_slave_handler(I2C_INST, I2C_SLAVE_FINISH);
+            }
+        }
+
+        check_state();
+
+        if (test_failures != failures)
+        {
+            printf("%s:%d: %s fuzz, seed %u, event %d\n", __FILE__, __LINE__, i2c_protocol ? "FlashFloppy" : "LCD", seed, i);
+            return;
+        }
+    }
+
+    // a clean frame afterwards is shown as sent
+    static uint8_t bytes[2048];
+    frame_t frame;
+
+    i2c_slave_handler(I2C_INST, I2C_SLAVE_FINISH);
+    decode();
+
+    bus_hz = 400000;
+    decode_latency_ns = 0;
+    make_frame(&frame, seed, i2c_protocol);
+
+    if (!i2c_protocol)
+    { // a half byte left by the fuzz is dropped when RS changes, the columns are set again as at init
+        int len = lcd_nibble(bytes, 0, false, frame.on);
+
+        bus_write(bytes, len + lcd_nibble(bytes + len, 0, true, frame.on));
+        run_until(now_ns + 1000000);
+        lcd_display_update();
+    }
+
+    bus_write(bytes, i2c_protocol ? ff_frame_bytes(&frame, bytes) : lcd_frame_bytes(&frame, bytes));
+    run_until(now_ns + 1000000);
+
+    if (!shows_frame(&ff_osd_snapshot.display, &frame))
+    {
+        printf("%s:%d: %s fuzz, seed %u: the frame after it is not shown\n", __FILE__, __LINE__,
+               i2c_protocol ? "FlashFloppy" : "LCD", seed);
+        test_failures++;
+    }
+}
+
+static void test_fuzz(void)
+{
+    for (uint32_t seed = 1; seed <= 40 && !test_failures; seed++)
+    {
+        fuzz(true, seed * 2654435761u, 20000);
+        fuzz(false, seed * 2246822519u, 20000);
+    }
+}
+
+int main(void)
+{
+    ff_osd_decode_irq = 31;
+
+    test_replay();
+    test_fuzz();
+
+    return test_result("ff_osd");
+}
@@ -0,0 +1,162 @@
+/**
+ * test_osd_chargen.c - Character generator lines against the pixel buffer renderer
+ *
+ * Includes osd.c built with OSD_CHARGEN_ENABLE: every line osd_chargen_expand()
+ * makes from the published text grid has to match the same line of a pixel
+ * buffer drawn cell by cell with osd_draw_cell(), as the renderer without the
+ * character generator does.
+ */
+
+#include "test.h"
+#include "osd.c"
+
+settings_t settings;
+video_mode_t video_mode;
+int16_t h_visible_area;
+int16_t v_margin;
+
+uint64_t time_us_64(void)
+{
+    return 0;
+}
+
+void osd_layers_update()
+{
+}
+
+// the OSD buttons are not used
+void gpio_init(uint gpio) {}
+void gpio_set_dir(uint gpio, bool out) {}
+void gpio_pull_up(uint gpio) {}
+void gpio_set_inover(uint gpio, uint value) {}
+bool gpio_get(uint gpio) { return true; }
+
+static uint8_t reference[OSD_BUFFER_SIZE];
+
+// The pixel buffer of the text grid, laid out as osd_render_text_to_buffer() does without the character generator
+static void draw_reference(void)
+{
+    uint16_t stride = osd_mode.width / 2;
+    uint16_t y_offset = 0;
+
+    memset(reference, OSD_COLOR_BACKGROUND * 0x11, sizeof(reference));
+
+    for (uint8_t row = 0; row < osd_mode.rows; row++)
+    {
+        for (uint8_t col = 0; col < osd_mode.columns; col++)
+        {
+            uint16_t pos = row * osd_mode.columns + col;
+
+            osd_draw_cell(reference, stride, osd_mode.height, col * OSD_FONT_WIDTH, row * OSD_FONT_HEIGHT + y_offset,
+                          (uint8_t)osd_text_buffer[pos], osd_text_colors[pos], osd_text_heights[row]);
+        }
+
+        if (osd_text_heights[row])
+            y_offset += OSD_FONT_HEIGHT;
+    }
+}
+
+static void check_lines(const char *name)
+{
+    uint16_t stride = osd_mode.width / 2;
+    int mismatches = 0;
+
+    draw_reference();
+    osd_render_text_to_buffer();
+
+    for (uint16_t line = 0; line < osd_mode.height; line++)
+    {
+        osd_chargen_expand(line);
+
+        if (memcmp(osd_chargen_line, &reference[line * stride], stride) != 0 && mismatches++ < 4)
+            printf("%s:%d: %s, line %u differs\n", __FILE__, __LINE__, name, line);
+    }
+
+    CHECK_EQ(mismatches, 0);
+}
+
+static void set_mode(uint8_t columns, uint8_t rows)
+{
+    osd_mode.columns = columns;
+    osd_mode.rows = rows;
+    osd_mode.width = columns * OSD_FONT_WIDTH;
+    osd_mode.height = rows * OSD_FONT_HEIGHT;
+    osd_mode.text_buffer_size = columns * rows;
+}
+
+// Every character code in every colour pair, some rows double height
+static void fill_grid(uint8_t seed)
+{
+    for (uint16_t pos = 0; pos < osd_mode.text_buffer_size; pos++)
+    {
+        osd_text_buffer[pos] = (char)(pos * 7 + seed);
+        osd_text_colors[pos] = (uint8_t)(pos * 13 + seed * 3);
+    }
+
+    for (uint8_t row = 0; row < osd_mode.rows; row++)
+        osd_text_heights[row] = (row % 5) == 2;
+}
+
+static void test_grid(void)
+{
+    set_mode(OSD_COLUMNS, OSD_ROWS);
+
+    for (uint8_t seed = 0; seed < 8; seed++)
+    {
+        fill_grid(seed);
+        check_lines("full grid");
+    }
+
+    // no double height rows: all rows shown
+    memset(osd_text_heights, 0, sizeof(osd_text_heights));
+    check_lines("single height");
+
+    // narrower OSD: the line is shorter than osd_chargen_line
+    set_mode(20, 6);
+    fill_grid(1);
+    check_lines("20 columns");
+}
+
+static void test_fonts(void)
+{
+    set_mode(OSD_COLUMNS, OSD_ROWS);
+    fill_grid(3);
+
+    osd_set_font(OSD_FONT_BOLD);
+    check_lines("bold font");
+
+    // the next font goes to the other cache, the one the video ISR may be reading is left alone
+    static uint8_t shown[256][OSD_FONT_HEIGHT];
+    memcpy(shown, osd_font, sizeof(shown));
+
+    osd_set_font(OSD_FONT_ZX);
+    CHECK(memcmp(shown, osd_font_caches[(osd_font_cache + 1) % OSD_FONT_CACHES], sizeof(shown)) == 0);
+    CHECK(memcmp(shown, osd_font, sizeof(shown)) != 0);
+    check_lines("zx font");
+}
+
+static void test_outside(void)
+{
+    set_mode(OSD_COLUMNS, OSD_ROWS);
+    fill_grid(0);
+    osd_render_text_to_buffer();
+
+    // lines past the OSD are background
+    osd_chargen_expand(OSD_HEIGHT);
+
+    for (uint16_t x = 0; x < sizeof(osd_chargen_line); x++)
+        CHECK_EQ(osd_chargen_line[x], OSD_COLOR_BACKGROUND * 0x11);
+}
+
+int main(void)
+{
+    osd_set_font(OSD_FONT_ZX);
+    osd_init_glyph_masks();
+    osd_init_chargen_pairs();
+
+    test_grid();
+    test_fonts();
+    test_outside();
+
+    return test_result("osd_chargen");
+}
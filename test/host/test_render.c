@@ -0,0 +1,569 @@
+/**
+ * test_render.c - Line renderer variants against a pixel model, and their time per line
+ *
+ * Includes vga.c (RENDER_VGA) or dvi.c, the build picks the platform. Every
+ * renderer the output ISR can latch for the OSD rows (image only, OSD window,
+ * full width, colour key and shade blending, scale 2) draws the lines of a
+ * random image and OSD, and each line buffer entry is checked against the
+ * input byte the model puts there. The palette is the identity, an entry of
+ * the line buffer is the index it was looked up with.
+ *
+ * Run with -v for the host time of each variant per line in every mode of the
+ * output, and of the whole output ISR over a frame (avg/max per call, what the
+ * OUT ISR counter of the STATS page shows with PERF_STATS_ENABLE). These are
+ * host numbers: they rank the variants.
+ *
+ * On the device the blend renderer has to fit the line time: with the render
+ * estimate below, exactly the modes up to VIDEO_MODE_BLEND_MAX may fit, and
+ * osd_set_blend() keeps the OSD opaque above them.
+ */
+
+#include <time.h>
+
+#include "test.h"
+
+#ifdef RENDER_VGA
+#include "vga.c"
+
+typedef uint16_t line_entry_t;
+#define RENDER_NAME "render_vga"
+#define DMA_HANDLER dma_handler_vga
+#define RENDER_PALETTE palette
+#define ENTRY_INDEX(entry) (entry)
+#define OUTPUT_MODE_MAX VIDEO_MODE_MAX
+#else
+#include "dvi.c"
+
+typedef dvi_pixels_t line_entry_t;
+#define DMA_HANDLER dma_handler_dvi
+#define RENDER_PALETTE pixels
+#define OUTPUT_MODE_MAX VIDEO_MODE_DVI_MAX
+#ifdef DVI_DIRECT_ENABLE
+#define RENDER_NAME "render_dvi_direct"
+#define ENTRY_INDEX(entry) ((entry).data[0])
+#else
+#define RENDER_NAME "render_dvi"
+#define ENTRY_INDEX(entry) (entry)
+#endif
+#endif
+
+#define RENDER(render, line_buf, scr_line, scaled_y) render(line_buf, scr_line, scaled_y, RENDER_PALETTE)
+
+settings_t settings;
+video_mode_t video_mode;
+int16_t h_visible_area;
+int16_t h_margin;
+int16_t v_visible_area;
+int16_t v_margin;
+
+// SDK and firmware parts the renderers and the ISR use
+
+dma_hw_t dma_hw_inst;
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger) {}
+uint64_t time_us_64(void) { return 0; }
+void osd_layers_update() {}
+void gpio_init(uint gpio) {}
+void gpio_set_dir(uint gpio, bool out) {}
+void gpio_pull_up(uint gpio) {}
+void gpio_set_inover(uint gpio, uint value) {}
+bool gpio_get(uint gpio) { return true; }
+
+static uint8_t image[V_BUF_H * V_BUF_W / 2];
+
+void *get_v_buf_out()
+{
+    return image;
+}
+
+// one OSD layer: the ISR takes the OSD rows renderer
+const osd_compose_t *osd_compose_latch()
+{
+    return NULL;
+}
+
+typedef struct
+{
+    const char *name;
+    render_image_t render;
+    uint8_t blend;
+    uint8_t scale;
+    bool full_width;
+} variant_t;
+
+static const variant_t variants[] = {
+    {"image", render_image, OSD_BLEND_OPAQUE, 1, false},
+    {"osd", render_image_osd, OSD_BLEND_OPAQUE, 1, false},
+    {"osd full width", render_image_osd_full_width, OSD_BLEND_OPAQUE, 1, true},
+    {"osd blend key", render_image_osd_blend, OSD_BLEND_KEY, 1, false},
+    {"osd blend shade", render_image_osd_blend, OSD_BLEND_SHADE, 1, false},
+    {"osd scale 2", render_image_osd_scaled, OSD_BLEND_OPAQUE, 2, false},
+    {"osd scale 2 full width", render_image_osd_scaled, OSD_BLEND_OPAQUE, 2, true},
+};
+
+#define LINE_ENTRIES 1024 // a line of the widest mode and a guard
+
+static line_entry_t line[LINE_ENTRIES];
+
+static uint32_t random_state = 1;
+
+static uint32_t random_next(void)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return random_state >> 8;
+}
+
+// Random image, OSD pixels background half of the time
+static void fill_buffers(void)
+{
+    for (size_t i = 0; i < sizeof(image); i++)
+        image[i] = (uint8_t)random_next();
+
+    for (size_t i = 0; i < sizeof(osd_buffer); i++)
+    {
+        uint8_t lo = (random_next() & 1) ? OSD_COLOR_BACKGROUND : random_next() & 0x0f;
+        uint8_t hi = (random_next() & 1) ? OSD_COLOR_BACKGROUND : random_next() & 0x0f;
+
+        osd_buffer[i] = (hi << 4) | lo;
+    }
+}
+
+static void set_palette(void)
+{
+    for (int i = 0; i < 256; i++)
+        ENTRY_INDEX(RENDER_PALETTE[i]) = i;
+}
+
+// The OSD of width x height pixels at (start_x, start_y) in image bytes and lines, as osd_set_position() lays it out
+static void set_osd(const variant_t *v, uint16_t start_x, uint16_t start_y, uint16_t width, uint16_t height)
+{
+    osd_mode.width = width;
+    osd_mode.height = height;
+    osd_mode.scale = v->scale;
+    osd_mode.full_width = v->full_width;
+    osd_mode.start_x = start_x;
+    osd_mode.end_x = start_x + (width / 2) * v->scale;
+    osd_mode.start_y = start_y;
+    osd_mode.end_y = start_y + height * v->scale;
+    osd_set_blend(v->blend);
+}
+
+// The input byte a line buffer entry of an OSD row shows
+static uint8_t model(const variant_t *v, uint16_t x, uint16_t scaled_y)
+{
+    uint8_t pixel = image[scaled_y * (V_BUF_W / 2) + x];
+
+    if (v->render == render_image)
+        return pixel;
+
+    if (x < osd_mode.start_x || x >= osd_mode.end_x)
+        return v->full_width ? 0 : pixel;
+
+    uint16_t col = x - osd_mode.start_x;
+    const uint8_t *osd_line = &osd_buffer[((scaled_y - osd_mode.start_y) / v->scale) * (osd_mode.width / 2)];
+
+    if (v->scale > 1)
+    { // the low pixel of the OSD byte for an even byte, the high one for an odd byte
+        uint8_t osd = osd_line[col / 2];
+        uint8_t nibble = (col & 1) ? osd >> 4 : osd & 0x0f;
+
+        return nibble * 0x11;
+    }
+
+    uint8_t osd = osd_line[col];
+
+    if (v->blend == OSD_BLEND_OPAQUE)
+        return osd;
+
+    uint8_t out = 0;
+
+    for (int shift = 0; shift < 8; shift += 4)
+    {
+        uint8_t nibble = (osd >> shift) & 0x0f;
+
+        if (nibble == OSD_COLOR_BACKGROUND)
+            nibble = (v->blend == OSD_BLEND_SHADE && shift) ? 0 : (pixel >> shift) & 0x0f;
+
+        out |= nibble << shift;
+    }
+
+    return out;
+}
+
+static void check_variant(const variant_t *v, uint16_t start_x, uint16_t width)
+{
+    int mismatches = 0;
+
+    set_osd(v, start_x, 10, width, 40);
+
+    // the ISR takes the variant for the OSD rows only
+    for (uint16_t scaled_y = osd_mode.start_y; scaled_y < osd_mode.end_y; scaled_y++)
+    {
+        ENTRY_INDEX(line[h_visible_area]) = 0x5a5;
+        RENDER(v->render, line, &image[scaled_y * (V_BUF_W / 2)], scaled_y);
+
+        for (uint16_t x = 0; x < h_visible_area; x++)
+            if (ENTRY_INDEX(line[x]) != model(v, x, scaled_y) && mismatches++ < 4)
+                printf("%s:%d: %s, start %u, line %u, byte %u: %u, expected %u\n", __FILE__, __LINE__, v->name,
+                       start_x, scaled_y, x, (uint)ENTRY_INDEX(line[x]), model(v, x, scaled_y));
+
+        // nothing past the line
+        CHECK_EQ(ENTRY_INDEX(line[h_visible_area]), 0x5a5);
+    }
+
+    CHECK_EQ(mismatches, 0);
+}
+
+static void test_variants(void)
+{
+    h_visible_area = 200;
+
+    for (size_t i = 0; i < count_of(variants); i++)
+    {
+        // OSD edges on and off the unrolled groups of 4, an OSD width not a multiple of 8 bytes
+        check_variant(&variants[i], 8, 160);
+        check_variant(&variants[i], 7, 160);
+        check_variant(&variants[i], 13, 84);
+        check_variant(&variants[i], 0, 160);
+    }
+}
+
+// Device line budget: render estimate in system clocks per input byte, from the loop bodies
+#ifdef DVI_DIRECT_ENABLE
+// Cortex-M33: ldrb, address of the entry, ldm + stm of 8 words; the blend adds the OSD byte, its keep entry, and + orr
+#define IMAGE_CLOCKS_PER_BYTE 21
+#define BLEND_CLOCKS_PER_BYTE 26
+#define LINE_CLOCKS(mode) ((mode)->whole_line * 10)
+#else
+// Cortex-M0+, 2 clocks a load or store, unrolled by 4: ldrb, lsls, ldrh/ldr, strh/str and a quarter of the loop;
+// the blend adds ldrb of the OSD byte and of its keep entry, ands, orrs and a pointer
+#define IMAGE_CLOCKS_PER_BYTE 9
+#define BLEND_CLOCKS_PER_BYTE 15
+#define LINE_CLOCKS(mode) ((uint32_t)((uint64_t)(mode)->whole_line * (mode)->sys_freq * 1000 / (mode)->pixel_freq))
+#endif
+#define ISR_CLOCKS 150 // entry, exit, line selection and the DMA read address
+
+// Part of each line the output ISR may take from core 0, a line is rendered every line with SCANLINES_DIM
+#define RENDER_SHARE_MAX 60
+
+static void set_mode(const video_mode_t *mode);
+
+typedef struct
+{
+    uint32_t line_clocks;
+    uint32_t image_share; // %
+    uint32_t blend_share; // %, the widest OSD blended
+} budget_t;
+
+static budget_t get_budget(int mode)
+{
+    budget_t b;
+
+    set_mode(video_modes[mode]);
+
+    uint16_t osd_bytes = (OSD_WIDTH / 2 < h_visible_area) ? OSD_WIDTH / 2 : h_visible_area;
+    uint32_t image_clocks = ISR_CLOCKS + h_visible_area * IMAGE_CLOCKS_PER_BYTE;
+    uint32_t blend_clocks = ISR_CLOCKS + (h_visible_area - osd_bytes) * IMAGE_CLOCKS_PER_BYTE +
+                            osd_bytes * BLEND_CLOCKS_PER_BYTE;
+
+    b.line_clocks = LINE_CLOCKS(&video_mode);
+    b.image_share = image_clocks * 100 / b.line_clocks;
+    b.blend_share = blend_clocks * 100 / b.line_clocks;
+
+    return b;
+}
+
+static void test_blend_budget(void)
+{
+    for (int mode = VIDEO_MODE_MIN; mode <= OUTPUT_MODE_MAX; mode++)
+    {
+        budget_t b = get_budget(mode);
+        bool fits = b.blend_share <= RENDER_SHARE_MAX;
+
+        // the image alone fits every mode of the output
+        CHECK(b.image_share <= RENDER_SHARE_MAX);
+
+        if (fits != (mode <= VIDEO_MODE_BLEND_MAX))
+        {
+            printf("%s:%d: %ux%u (div %u): blend %s, %u%% of the line\n", __FILE__, __LINE__,
+                   video_mode.h_visible_area, video_mode.v_visible_area, video_mode.div,
+                   fits ? "fits but is not offered" : "offered but does not fit", b.blend_share);
+            test_failures++;
+        }
+    }
+}
+
+// osd_set_blend() and a mode change keep the OSD opaque above VIDEO_MODE_BLEND_MAX
+static void test_blend_modes(void)
+{
+    set_mode(video_modes[VIDEO_MODE_MIN]);
+    settings.video_out_mode = VIDEO_MODE_MIN;
+    osd_set_blend(OSD_BLEND_SHADE);
+    CHECK_EQ(osd_mode.blend, OSD_BLEND_SHADE);
+
+#if VIDEO_MODE_BLEND_MAX < VIDEO_MODE_MAX
+    settings.video_out_mode = VIDEO_MODE_BLEND_MAX + 1;
+    set_mode(video_modes[settings.video_out_mode]);
+    osd_set_position();
+    CHECK_EQ(osd_mode.blend, OSD_BLEND_OPAQUE);
+
+    osd_set_blend(OSD_BLEND_KEY);
+    CHECK_EQ(osd_mode.blend, OSD_BLEND_OPAQUE);
+
+    // back in a mode it fits, the setting is kept
+    settings.video_out_mode = VIDEO_MODE_BLEND_MAX;
+    set_mode(video_modes[settings.video_out_mode]);
+    osd_set_position();
+    CHECK_EQ(osd_mode.blend, OSD_BLEND_KEY);
+#endif
+
+    settings.video_out_mode = VIDEO_MODE_MIN;
+    osd_set_blend(OSD_BLEND_OPAQUE);
+}
+
+// Host time
+
+// as set_video_mode_params() sets it up at the highest capture frequency: the widest line
+static void set_mode(const video_mode_t *mode)
+{
+    video_mode = *mode;
+
+    h_visible_area = (uint16_t)(video_mode.h_visible_area / (video_mode.div * 4)) * 2;
+    h_margin = (h_visible_area - (uint16_t)(FREQUENCY_MAX / 1000000) * (ACTIVE_VIDEO_TIME / 2)) / 2;
+
+    if (h_margin < 0)
+        h_margin = 0;
+
+    h_visible_area -= h_margin * 2;
+
+    v_visible_area = V_BUF_H * video_mode.div;
+    v_margin = ((int16_t)((video_mode.v_visible_area - v_visible_area) / (video_mode.div * 2) + 0.5)) * video_mode.div;
+
+    if (v_margin < 0)
+        v_margin = 0;
+}
+
+// the widest OSD the mode has room for at the scale of the variant, in the middle of the image
+static void set_osd_centered(const variant_t *v)
+{
+    uint16_t width = OSD_WIDTH;
+
+    if ((width / 2) * v->scale > h_visible_area)
+        width = (h_visible_area * 2 / v->scale) & ~(OSD_FONT_WIDTH - 1);
+
+    set_osd(v, (h_visible_area - (width / 2) * v->scale) / 2, 0, width, OSD_HEIGHT);
+    osd_state.visible = v->render != render_image;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+#define TIME_BATCH_LINES 16
+#define TIME_BATCHES 4000
+#define TIME_FRAMES 25
+
+// ns per line of the fastest batch, a batch the host preempted does not count
+static uint32_t time_variant(const variant_t *v)
+{
+    uint64_t best = UINT64_MAX;
+
+    for (int batch = 0; batch < TIME_BATCHES; batch++)
+    {
+        uint64_t start = now_ns();
+
+        for (int i = 0; i < TIME_BATCH_LINES; i++)
+        {
+            uint16_t scaled_y = (batch * TIME_BATCH_LINES + i) % (osd_mode.end_y - osd_mode.start_y);
+
+            RENDER(v->render, line, &image[scaled_y * (V_BUF_W / 2)], scaled_y);
+            __asm__ volatile("" ::: "memory");
+        }
+
+        uint64_t ns = now_ns() - start;
+
+        if (ns < best)
+            best = ns;
+    }
+
+    return (uint32_t)(best / TIME_BATCH_LINES);
+}
+
+static void print_modes(const char *title)
+{
+    printf("| %-24s |", title);
+
+    for (int mode = VIDEO_MODE_MIN; mode <= OUTPUT_MODE_MAX; mode++)
+        printf(" %4u x %-4u d%u |", video_modes[mode]->h_visible_area, video_modes[mode]->v_visible_area,
+               video_modes[mode]->div);
+
+    printf("\n");
+}
+
+static void print_variants(void)
+{
+    uint32_t image_ns[VIDEO_MODE_MAX + 1];
+
+    printf("\n%s: host ns per OSD line, x image only\n\n", RENDER_NAME);
+    print_modes("Variant");
+    printf("| %-24s |", "Input bytes per line");
+
+    for (int mode = VIDEO_MODE_MIN; mode <= OUTPUT_MODE_MAX; mode++)
+    {
+        set_mode(video_modes[mode]);
+        set_osd_centered(&variants[0]);
+        image_ns[mode] = time_variant(&variants[0]);
+        printf(" %14u |", h_visible_area);
+    }
+
+    printf("\n");
+
+    for (size_t i = 0; i < count_of(variants); i++)
+    {
+        printf("| %-24s |", variants[i].name);
+
+        for (int mode = VIDEO_MODE_MIN; mode <= OUTPUT_MODE_MAX; mode++)
+        {
+            set_mode(video_modes[mode]);
+            set_osd_centered(&variants[i]);
+
+            uint32_t ns = time_variant(&variants[i]);
+
+            printf(" %5u ns x%-4.2f |", ns, image_ns[mode] ? (double)ns / image_ns[mode] : 0.0);
+        }
+
+        printf("\n");
+    }
+}
+
+static void print_budget(void)
+{
+    printf("\n%s: device render estimate, share of the line (%%), widest OSD\n\n", RENDER_NAME);
+    print_modes("Render");
+    printf("| %-24s |", "Line (system clocks)");
+
+    for (int mode = VIDEO_MODE_MIN; mode <= OUTPUT_MODE_MAX; mode++)
+        printf(" %14u |", get_budget(mode).line_clocks);
+
+    printf("\n| %-24s |", "image");
+
+    for (int mode = VIDEO_MODE_MIN; mode <= OUTPUT_MODE_MAX; mode++)
+        printf(" %13u%% |", get_budget(mode).image_share);
+
+    printf("\n| %-24s |", "osd blend key/shade");
+
+    for (int mode = VIDEO_MODE_MIN; mode <= OUTPUT_MODE_MAX; mode++)
+        printf(" %13u%% |", get_budget(mode).blend_share);
+
+    printf("\n");
+}
+
+static void alloc_lines(void)
+{
+    static line_entry_t buffers[3][LINE_ENTRIES];
+    static line_entry_t sync_lines[2][LINE_ENTRIES];
+
+    v_out_dma_buf[0] = (void *)buffers[0];
+    v_out_dma_buf[1] = (void *)buffers[1];
+    v_out_dma_buf_dim = (void *)buffers[2];
+    v_out_sync_hblank = (void *)sync_lines[0];
+    v_out_sync_vsync = (void *)sync_lines[1];
+}
+
+// the output ISR over a frame, avg/max ns per call
+static void time_frame(uint32_t *avg_ns, uint32_t *max_ns)
+{
+    uint64_t total = 0;
+    uint64_t max = 0;
+
+    y = video_mode.whole_frame - 1;
+
+    for (uint16_t i = 0; i < video_mode.whole_frame; i++)
+    {
+        uint64_t start = now_ns();
+
+        DMA_HANDLER();
+
+        uint64_t ns = now_ns() - start;
+
+        total += ns;
+
+        if (ns > max)
+            max = ns;
+    }
+
+    *avg_ns = (uint32_t)(total / video_mode.whole_frame);
+    *max_ns = (uint32_t)max;
+}
+
+static void print_frames(void)
+{
+    static const uint8_t shown[] = {0, 1, 3}; // image only, osd, osd blend key
+
+    printf("\n%s: host ns per output ISR call over a frame (avg / max), scanlines dim\n\n", RENDER_NAME);
+    print_modes("OSD");
+
+    alloc_lines();
+
+    for (size_t i = 0; i < count_of(shown); i++)
+    {
+        const variant_t *v = &variants[shown[i]];
+
+        printf("| %-24s |", v->name);
+
+        for (int mode = VIDEO_MODE_MIN; mode <= OUTPUT_MODE_MAX; mode++)
+        {
+            uint32_t avg_ns = UINT32_MAX;
+            uint32_t max_ns = UINT32_MAX;
+
+            set_mode(video_modes[mode]);
+            set_osd_centered(v);
+            scanlines_mode = SCANLINES_DIM;
+#ifdef RENDER_VGA
+            set_line_map();
+#endif
+
+            for (int run = 0; run < TIME_FRAMES; run++)
+            {
+                uint32_t run_avg, run_max;
+
+                time_frame(&run_avg, &run_max);
+
+                if (run_avg < avg_ns)
+                    avg_ns = run_avg;
+
+                if (run_max < max_ns)
+                    max_ns = run_max;
+            }
+
+            printf(" %5u / %-6u |", avg_ns, max_ns);
+        }
+
+        printf("\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    osd_init();
+    set_palette();
+    fill_buffers();
+
+    test_variants();
+    test_blend_budget();
+    test_blend_modes();
+
+    if (argc > 1 && strcmp(argv[1], "-v") == 0)
+    {
+        print_variants();
+        print_frames();
+        print_budget();
+    }
+
+    return test_result(RENDER_NAME);
+}
@@ -0,0 +1,280 @@
+/**
+ * test_usb_hid.c - usb_hid_parse() on captured report descriptors
+ *
+ * The descriptors are the ones the devices return, byte for byte. Each test
+ * checks the fields the USB driver decodes and a report read through them.
+ */
+
+#include "test.h"
+#include "usb_hid.h"
+
+// Boot keyboard (HID 1.11 appendix B.1 layout): modifiers, reserved byte, LEDs out, 6 key array
+static const uint8_t boot_keyboard[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01,                   // Generic Desktop, Keyboard, Application
+    0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, //   Keyboard page, LeftControl..Right GUI, 0..1
+    0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,             //   8 x 1 bit, Input (Data, Var, Abs)
+    0x95, 0x01, 0x75, 0x08, 0x81, 0x01,                   //   1 x 8 bits, Input (Const)
+    0x95, 0x05, 0x75, 0x01, 0x05, 0x08, 0x19, 0x01, 0x29, //   LED page, Num Lock..Kana
+    0x05, 0x91, 0x02,                                     //   5 x 1 bit, Output
+    0x95, 0x01, 0x75, 0x03, 0x91, 0x01,                   //   1 x 3 bits, Output (Const)
+    0x95, 0x06, 0x75, 0x08, 0x15, 0x00, 0x25, 0x65, 0x05, //   6 x 8 bits, 0..101
+    0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00,             //   Keyboard page, Input (Data, Array)
+    0xC0,                                                 // End Collection
+};
+
+// NKRO keyboard: modifiers, reserved byte, then one bit per usage 0x04..0x73 (112 bits)
+static const uint8_t nkro_keyboard[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01,                   // Generic Desktop, Keyboard, Application
+    0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, //   Keyboard page, LeftControl..Right GUI, 0..1
+    0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,             //   8 x 1 bit, Input (Data, Var, Abs)
+    0x75, 0x08, 0x95, 0x01, 0x81, 0x03,                   //   1 x 8 bits, Input (Const)
+    0x05, 0x07, 0x19, 0x04, 0x29, 0x73, 0x15, 0x00, 0x25, //   Keyboard page, a..F24, 0..1
+    0x01, 0x75, 0x01, 0x95, 0x70, 0x81, 0x02,             //   112 x 1 bit, Input (Data, Var, Abs)
+    0xC0,                                                 // End Collection
+};
+
+// Keyboard + mouse receiver: report 1 keyboard, report 2 mouse with 16-bit moves and a wheel
+static const uint8_t combo[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x01,       // Keyboard, Application, Report ID 1
+    0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, //   modifiers
+    0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,             //
+    0x95, 0x01, 0x75, 0x08, 0x81, 0x01,                   //   reserved
+    0x95, 0x06, 0x75, 0x08, 0x15, 0x00, 0x26, 0xFF, 0x00, //   6 x 8 bits, 0..255
+    0x05, 0x07, 0x19, 0x00, 0x2A, 0xFF, 0x00, 0x81, 0x00, //   Input (Data, Array)
+    0xC0,                                                 // End Collection
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x02,       // Mouse, Application, Report ID 2
+    0x09, 0x01, 0xA1, 0x00,                               //   Pointer, Physical
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x05, 0x15, 0x00, 0x25, //     Button page, 1..5, 0..1
+    0x01, 0x95, 0x05, 0x75, 0x01, 0x81, 0x02,             //     5 x 1 bit
+    0x95, 0x01, 0x75, 0x03, 0x81, 0x01,                   //     1 x 3 bits (Const)
+    0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x16, 0x01, 0x80, //     X, Y, -32767..32767
+    0x26, 0xFF, 0x7F, 0x75, 0x10, 0x95, 0x02, 0x81, 0x06, //     2 x 16 bits, Input (Data, Var, Rel)
+    0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, //     Wheel, -127..127
+    0x01, 0x81, 0x06,                                     //     1 x 8 bits, Input (Data, Var, Rel)
+    0xC0, 0xC0,                                           //   End Collection, End Collection
+};
+
+// Gamepad (common DragonRise/"USB Gamepad" layout): X, Y 0..255, hat 0..7, 12 buttons
+static const uint8_t gamepad[] = {
+    0x05, 0x01, 0x09, 0x05, 0xA1, 0x01,                   // Generic Desktop, Game Pad, Application
+    0x09, 0x01, 0xA1, 0x00,                               //   Pointer, Physical
+    0x09, 0x30, 0x09, 0x31, 0x15, 0x00, 0x26, 0xFF, 0x00, //     X, Y, 0..255
+    0x75, 0x08, 0x95, 0x02, 0x81, 0x02,                   //     2 x 8 bits
+    0xC0,                                                 //   End Collection
+    0x05, 0x01, 0x09, 0x39, 0x15, 0x00, 0x25, 0x07, 0x35, //   Hat switch, 0..7
+    0x00, 0x46, 0x3B, 0x01, 0x65, 0x14, 0x75, 0x04, 0x95, //   0..315 degrees
+    0x01, 0x81, 0x42,                                     //   1 x 4 bits, Input (Data, Var, Abs, Null)
+    0x65, 0x00, 0x75, 0x04, 0x95, 0x01, 0x81, 0x01,       //   1 x 4 bits (Const)
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x0C, 0x15, 0x00, 0x25, //   Button page, 1..12, 0..1
+    0x01, 0x75, 0x01, 0x95, 0x0C, 0x81, 0x02,             //   12 x 1 bit
+    0x75, 0x01, 0x95, 0x04, 0x81, 0x01,                   //   4 x 1 bit (Const)
+    0xC0,                                                 // End Collection
+};
+
+// Gaming mouse with 12-bit moves packed into 3 bytes (X in bits 8..19, Y in 20..31)
+static const uint8_t mouse_12bit[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x09, 0x01, 0xA1, // Mouse, Application, Pointer, Physical
+    0x00,                                                 //
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x08, 0x15, 0x00, 0x25, //   Button page, 1..8, 0..1
+    0x01, 0x95, 0x08, 0x75, 0x01, 0x81, 0x02,             //   8 x 1 bit
+    0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x16, 0x01, 0xF8, //   X, Y, -2047..2047
+    0x26, 0xFF, 0x07, 0x75, 0x0C, 0x95, 0x02, 0x81, 0x06, //   2 x 12 bits, Input (Data, Var, Rel)
+    0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, //   Wheel, -127..127
+    0x01, 0x81, 0x06,                                     //   1 x 8 bits
+    0xC0, 0xC0,                                           // End Collection, End Collection
+};
+
+static void test_boot_keyboard(void)
+{
+    usb_hid_layout_t layout;
+
+    CHECK(usb_hid_parse(boot_keyboard, sizeof(boot_keyboard), &layout));
+    CHECK(usb_hid_is_keyboard(&layout));
+    CHECK(!usb_hid_is_mouse(&layout));
+    CHECK(!layout.report_ids);
+
+    // same fields as the boot protocol layout
+    CHECK_EQ(layout.modifiers.bit, usb_hid_boot_keyboard.modifiers.bit);
+    CHECK_EQ(layout.modifiers.size, 1);
+    CHECK_EQ(layout.modifiers.count, 8);
+    CHECK_EQ(layout.keys.bit, usb_hid_boot_keyboard.keys.bit);
+    CHECK_EQ(layout.keys.size, 8);
+    CHECK_EQ(layout.keys.count, 6);
+    CHECK_EQ(layout.bitmap.size, 0);
+
+    // left shift + 'a' + 'z'
+    static const uint8_t report[] = {0x02, 0x00, 0x04, 0x1D, 0x00, 0x00, 0x00, 0x00};
+
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.modifiers, 1), 1);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.modifiers, 0), 0);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.keys, 0), 0x04);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.keys, 1), 0x1D);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.keys, 2), 0);
+
+    // short report: keys past its end read as 0
+    CHECK_EQ(usb_hid_get(report, 3, &layout.keys, 0), 0x04);
+    CHECK_EQ(usb_hid_get(report, 3, &layout.keys, 1), 0);
+}
+
+static void test_nkro_keyboard(void)
+{
+    usb_hid_layout_t layout;
+
+    CHECK(usb_hid_parse(nkro_keyboard, sizeof(nkro_keyboard), &layout));
+    CHECK(usb_hid_is_keyboard(&layout));
+    CHECK_EQ(layout.keys.size, 0);
+    CHECK_EQ(layout.modifiers.bit, 0);
+    CHECK_EQ(layout.bitmap.bit, 16);
+    CHECK_EQ(layout.bitmap.size, 1);
+    CHECK_EQ(layout.bitmap.count, 112);
+    CHECK_EQ(layout.bitmap_first, 0x04);
+
+    // right alt + 'a' (usage 0x04, bit 0) + F12 (usage 0x45) + F24 (usage 0x73, the last bit)
+    uint8_t report[16] = {0x40};
+
+    report[2 + (0x04 - 0x04) / 8] |= 1 << ((0x04 - 0x04) % 8);
+    report[2 + (0x45 - 0x04) / 8] |= 1 << ((0x45 - 0x04) % 8);
+    report[2 + (0x73 - 0x04) / 8] |= 1 << ((0x73 - 0x04) % 8);
+
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.modifiers, 6), 1);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.bitmap, 0x04 - 0x04), 1);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.bitmap, 0x05 - 0x04), 0);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.bitmap, 0x45 - 0x04), 1);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.bitmap, 0x73 - 0x04), 1);
+}
+
+static void test_combo(void)
+{
+    usb_hid_layout_t layout;
+
+    CHECK(usb_hid_parse(combo, sizeof(combo), &layout));
+    CHECK(usb_hid_is_keyboard(&layout));
+    CHECK(usb_hid_is_mouse(&layout));
+    CHECK(layout.report_ids);
+
+    // bit offsets count from the byte after the report ID, per report
+    CHECK_EQ(layout.modifiers.report_id, 1);
+    CHECK_EQ(layout.keys.report_id, 1);
+    CHECK_EQ(layout.keys.bit, 16);
+    CHECK_EQ(layout.buttons.report_id, 2);
+    CHECK_EQ(layout.buttons.bit, 0);
+    CHECK_EQ(layout.buttons.count, 5);
+    CHECK_EQ(layout.x.report_id, 2);
+    CHECK_EQ(layout.x.bit, 8);
+    CHECK_EQ(layout.x.size, 16);
+    CHECK_EQ(layout.y.bit, 24);
+    CHECK_EQ(layout.wheel.bit, 40);
+    CHECK_EQ(layout.wheel.size, 8);
+    CHECK(layout.x.is_signed && layout.y.is_signed && layout.wheel.is_signed);
+
+    // mouse report after its ID: buttons 1 and 3, X -300, Y +1000, wheel -2
+    static const uint8_t report[] = {0x05, 0xD4, 0xFE, 0xE8, 0x03, 0xFE};
+
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.buttons, 0), 1);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.buttons, 1), 0);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.buttons, 2), 1);
+    CHECK_EQ(usb_hid_get_signed(report, sizeof(report), &layout.x), -300);
+    CHECK_EQ(usb_hid_get_signed(report, sizeof(report), &layout.y), 1000);
+    CHECK_EQ(usb_hid_get_signed(report, sizeof(report), &layout.wheel), -2);
+}
+
+static void test_gamepad(void)
+{
+    usb_hid_layout_t layout;
+
+    CHECK(usb_hid_parse(gamepad, sizeof(gamepad), &layout));
+    CHECK(usb_hid_is_gamepad(&layout));
+    CHECK(!usb_hid_is_keyboard(&layout));
+    CHECK(!usb_hid_is_mouse(&layout));
+
+    CHECK_EQ(layout.pad_x.bit, 0);
+    CHECK_EQ(layout.pad_x.size, 8);
+    CHECK(!layout.pad_x.is_signed);
+    CHECK_EQ(layout.pad_x.logical_max, 255);
+    CHECK_EQ(layout.pad_y.bit, 8);
+    CHECK_EQ(layout.pad_hat.bit, 16);
+    CHECK_EQ(layout.pad_hat.size, 4);
+    CHECK_EQ(layout.pad_hat.logical_min, 0);
+    CHECK_EQ(layout.pad_hat.logical_max, 7);
+    CHECK_EQ(layout.pad_buttons.bit, 24);
+    CHECK_EQ(layout.pad_buttons.count, 12);
+
+    // stick left, centre; hat down-right (3); buttons 1 and 12
+    static const uint8_t report[] = {0x00, 0x7F, 0x03, 0x01, 0x08};
+
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.pad_x, 0), 0);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.pad_y, 0), 0x7F);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.pad_hat, 0), 3);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.pad_buttons, 0), 1);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.pad_buttons, 1), 0);
+    CHECK_EQ(usb_hid_get(report, sizeof(report), &layout.pad_buttons, 11), 1);
+
+    // hat released: the null state (15) is out of the logical range
+    static const uint8_t released[] = {0x7F, 0x7F, 0x0F, 0x00, 0x00};
+
+    CHECK_EQ(usb_hid_get(released, sizeof(released), &layout.pad_hat, 0), 15);
+}
+
+static void test_get_signed(void)
+{
+    usb_hid_layout_t layout;
+
+    // 8 bits: the boot mouse
+    static const uint8_t boot[] = {0x00, 0x80, 0x7F};
+
+    CHECK_EQ(usb_hid_get_signed(boot, sizeof(boot), &usb_hid_boot_mouse.x), -128);
+    CHECK_EQ(usb_hid_get_signed(boot, sizeof(boot), &usb_hid_boot_mouse.y), 127);
+
+    // 12 bits, not byte aligned
+    CHECK(usb_hid_parse(mouse_12bit, sizeof(mouse_12bit), &layout));
+    CHECK(usb_hid_is_mouse(&layout));
+    CHECK_EQ(layout.x.bit, 8);
+    CHECK_EQ(layout.x.size, 12);
+    CHECK_EQ(layout.y.bit, 20);
+    CHECK_EQ(layout.wheel.bit, 32);
+
+    static const uint8_t moves[][5] = {
+        {0x00, 0xFF, 0xFF, 0xFF, 0x01}, // X -1, Y -1, wheel 1
+        {0x00, 0x00, 0x08, 0x80, 0x00}, // X -2048, Y 2048 - 2048 = -2048
+        {0x00, 0xFF, 0xF7, 0x7F, 0x81}, // X 2047, Y 2047, wheel -127
+        {0x00, 0x05, 0xA0, 0x00, 0x00}, // X 5, Y 10
+    };
+
+    CHECK_EQ(usb_hid_get_signed(moves[0], 5, &layout.x), -1);
+    CHECK_EQ(usb_hid_get_signed(moves[0], 5, &layout.y), -1);
+    CHECK_EQ(usb_hid_get_signed(moves[0], 5, &layout.wheel), 1);
+    CHECK_EQ(usb_hid_get_signed(moves[1], 5, &layout.x), -2048);
+    CHECK_EQ(usb_hid_get_signed(moves[1], 5, &layout.y), -2048);
+    CHECK_EQ(usb_hid_get_signed(moves[2], 5, &layout.x), 2047);
+    CHECK_EQ(usb_hid_get_signed(moves[2], 5, &layout.y), 2047);
+    CHECK_EQ(usb_hid_get_signed(moves[2], 5, &layout.wheel), -127);
+    CHECK_EQ(usb_hid_get_signed(moves[3], 5, &layout.x), 5);
+    CHECK_EQ(usb_hid_get_signed(moves[3], 5, &layout.y), 10);
+
+    // 16 bits: the combo receiver
+    CHECK(usb_hid_parse(combo, sizeof(combo), &layout));
+
+    static const uint8_t wide[] = {0x00, 0x01, 0x80, 0xFF, 0x7F, 0x00};
+
+    CHECK_EQ(usb_hid_get_signed(wide, sizeof(wide), &layout.x), -32767);
+    CHECK_EQ(usb_hid_get_signed(wide, sizeof(wide), &layout.y), 32767);
+
+    // unsigned fields are not sign extended
+    CHECK(usb_hid_parse(gamepad, sizeof(gamepad), &layout));
+
+    static const uint8_t pad[] = {0xFF, 0x80, 0x00, 0x00, 0x00};
+
+    CHECK_EQ(usb_hid_get_signed(pad, sizeof(pad), &layout.pad_x), 255);
+    CHECK_EQ(usb_hid_get_signed(pad, sizeof(pad), &layout.pad_y), 128);
+}
+
+int main(void)
+{
+    test_boot_keyboard();
+    test_nkro_keyboard();
+    test_combo();
+    test_gamepad();
+    test_get_signed();
+
+    return test_result("usb_hid");
+}
@@ -0,0 +1,295 @@
+/**
+ * test_zx_paste.c - Text to ZX key chords and their playback
+ *
+ * Includes zx_paste.c to read the chord queue: each line is checked as the
+ * chords it queues, written as ZX key names ("SS+P", "CS+SS" for E mode).
+ * The alarm is stubbed, the test fires it to play the chords back.
+ */
+
+#include "test.h"
+#include "zx_paste.c"
+
+static const char *const zx_names[8][5] = {
+    {"CS", "Z", "X", "C", "V"},
+    {"A", "S", "D", "F", "G"},
+    {"Q", "W", "E", "R", "T"},
+    {"1", "2", "3", "4", "5"},
+    {"0", "9", "8", "7", "6"},
+    {"P", "O", "I", "U", "Y"},
+    {"ENTER", "L", "K", "J", "H"},
+    {"SP", "SS", "M", "N", "B"},
+};
+
+// Hardware alarm stand-in: the test fires the callback
+
+static hardware_alarm_callback_t alarm_callback;
+static bool alarm_set;
+
+int hardware_alarm_claim_unused(bool required)
+{
+    return 0;
+}
+
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback)
+{
+    alarm_callback = callback;
+}
+
+uint hardware_alarm_get_irq_num(uint alarm_num)
+{
+    return 0;
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us)
+{
+    return us;
+}
+
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t)
+{
+    alarm_set = true;
+    return false;
+}
+
+void hardware_alarm_force_irq(uint alarm_num)
+{
+    alarm_set = true;
+}
+
+void irq_set_priority(uint num, uint8_t hardware_priority)
+{
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+}
+
+uint32_t time_us_32(void)
+{
+    return 0;
+}
+
+// Chords
+
+static void append_key(char *text, uint8_t zx)
+{
+    strcat(text, zx_names[zx >> 5][__builtin_ctz(zx & 0x1F)]);
+}
+
+// Chords queued and not typed yet, then drops them
+static const char *queued(void)
+{
+    static char text[4096];
+
+    text[0] = '\0';
+
+    for (uint32_t i = zx_paste_tail; i != zx_paste_head; i++)
+    {
+        const zx_paste_chord_t *chord = &zx_paste_queue[i & (ZX_PASTE_QUEUE_SIZE - 1)];
+
+        if (text[0])
+            strcat(text, " ");
+
+        if (chord->shift != ZX_NONE)
+        {
+            append_key(text, chord->shift);
+            strcat(text, "+");
+        }
+
+        append_key(text, chord->key);
+    }
+
+    zx_paste_tail = zx_paste_head;
+    zx_paste_running = false;
+
+    return text;
+}
+
+#define CHECK_LINE(line, mode, expected)                                                                          \
+    do                                                                                                            \
+    {                                                                                                             \
+        CHECK_EQ(zx_paste_line(line, mode), 0);                                                                   \
+        const char *chords_ = queued();                                                                           \
+        if (strcmp(chords_, expected) != 0)                                                                       \
+        {                                                                                                         \
+            printf("%s:%d: \"%s\"\n  typed    %s\n  expected %s\n", __FILE__, __LINE__, line, chords_, expected); \
+            test_failures++;                                                                                      \
+        }                                                                                                         \
+    } while (0)
+
+static void test_cursor_modes(void)
+{
+    // K mode after the line number and ':', keyword keys; L mode letters, upper case with CAPS SHIFT
+    CHECK_LINE("10 PRINT \"Hello\": GO TO 10", ZX_PASTE_BASIC48,
+               "1 0 P SS+P CS+H E L L O SS+P SS+Z G 1 0 ENTER");
+
+    // the statement keyword in any case, the keywords after it upper case only
+    CHECK_LINE("20 print a", ZX_PASTE_BASIC48, "2 0 P A ENTER");
+    CHECK_LINE("30 LET sin=SIN x", ZX_PASTE_BASIC48, "3 0 L S I N SS+L CS+SS Q X ENTER");
+
+    // E mode function, THEN returns to K mode
+    CHECK_LINE("40 IF INKEY$=\"\" THEN GO TO 40", ZX_PASTE_BASIC48,
+               "4 0 U CS+SS N SS+L SS+P SS+P SS+G G 4 0 ENTER");
+
+    // SYMBOL SHIFT and E mode + SYMBOL SHIFT statements are taken in K mode
+    CHECK_LINE("50 STOP", ZX_PASTE_BASIC48, "5 0 SS+A ENTER");
+    CHECK_LINE("60 INK 2: BEEP 1,0", ZX_PASTE_BASIC48, "6 0 CS+SS SS+X 2 SS+Z CS+SS SS+Z 1 SS+N 0 ENTER");
+
+    // REM: the rest as it is, spaces included
+    CHECK_LINE("70 REM GO TO it", ZX_PASTE_BASIC48, "7 0 E CS+G CS+O SP CS+T CS+O SP I T ENTER");
+}
+
+static void test_quotes(void)
+{
+    // no keywords and all spaces inside strings
+    CHECK_LINE("10 PRINT \"TO GO\";TO", ZX_PASTE_BASIC48, "1 0 P SS+P CS+T CS+O SP CS+G CS+O SS+P SS+O SS+F ENTER");
+
+    // ':' inside a string does not start a statement
+    CHECK_LINE("20 PRINT \":PRINT\"", ZX_PASTE_BASIC48, "2 0 P SS+P SS+Z CS+P CS+R CS+I CS+N CS+T SS+P ENTER");
+}
+
+static void test_comparisons(void)
+{
+    CHECK_LINE("10 IF A<>B THEN STOP", ZX_PASTE_BASIC48, "1 0 U CS+A SS+W CS+B SS+G SS+A ENTER");
+    CHECK_LINE("20 IF A<=B OR A>=C THEN CLS", ZX_PASTE_BASIC48, "2 0 U CS+A SS+Q CS+B SS+U CS+A SS+E CS+C SS+G V ENTER");
+
+    // single characters
+    CHECK_LINE("30 IF A<B AND A>C THEN CLS", ZX_PASTE_BASIC48, "3 0 U CS+A SS+R CS+B SS+Y CS+A SS+T CS+C SS+G V ENTER");
+}
+
+static void test_longest_match(void)
+{
+    // INKEY$, not INK or IN
+    CHECK_LINE("10 LET K$=INKEY$", ZX_PASTE_BASIC48, "1 0 L CS+K SS+4 SS+L CS+SS N ENTER");
+    CHECK_LINE("20 INK 7", ZX_PASTE_BASIC48, "2 0 CS+SS SS+X 7 ENTER");
+    CHECK_LINE("30 PRINT IN 254", ZX_PASTE_BASIC48, "3 0 P CS+SS SS+I 2 5 4 ENTER");
+
+    // TO is a keyword on its own, not inside TOTAL or after a letter
+    CHECK_LINE("40 LET TOTAL=0", ZX_PASTE_BASIC48, "4 0 L CS+T CS+O CS+T CS+A CS+L SS+L 0 ENTER");
+    CHECK_LINE("50 FOR I=1 TO TOTAL", ZX_PASTE_BASIC48, "5 0 F CS+I SS+L 1 SS+F CS+T CS+O CS+T CS+A CS+L ENTER");
+    CHECK_LINE("60 LET ATO=1", ZX_PASTE_BASIC48, "6 0 L CS+A CS+T CS+O SS+L 1 ENTER");
+
+    // GO TO with or without the space
+    CHECK_LINE("70 GOTO 10", ZX_PASTE_BASIC48, "7 0 G 1 0 ENTER");
+}
+
+static void test_text(void)
+{
+    CHECK_LINE("Hi, 10 TO go!", ZX_PASTE_TEXT, "CS+H I SS+N SP 1 0 SP CS+T CS+O SP G O SS+1 ENTER");
+
+    // no ZX key: skipped and counted
+    CHECK_EQ(zx_paste_line("a\x01" "b", ZX_PASTE_TEXT), 1);
+    CHECK(strcmp(queued(), "A B ENTER") == 0);
+}
+
+static void test_queue_full(void)
+{
+    char line[ZX_PASTE_LINE_MAX + 46];
+
+    // 200 chords + ENTER per line, the queue takes 2
+    memset(line, 'x', 200);
+    line[200] = '\0';
+
+    CHECK_EQ(zx_paste_line(line, ZX_PASTE_TEXT), 0);
+    CHECK_EQ(zx_paste_line(line, ZX_PASTE_TEXT), 0);
+    CHECK_EQ(zx_paste_pending(), 402);
+
+    // no room: nothing queued, the caller tries again
+    CHECK_EQ(zx_paste_line(line, ZX_PASTE_TEXT), ZX_PASTE_BUSY);
+    CHECK_EQ(zx_paste_pending(), 402);
+
+    // room after a line was typed
+    zx_paste_tail += 201;
+    CHECK_EQ(zx_paste_line(line, ZX_PASTE_TEXT), 0);
+    CHECK_EQ(zx_paste_pending(), 402);
+    queued();
+
+    // the longest line fits an empty queue, the rest of a longer one is skipped
+    memset(line, '[', sizeof(line) - 1); // E mode + SYMBOL SHIFT: 2 chords each
+    line[sizeof(line) - 1] = '\0';
+
+    CHECK_EQ(zx_paste_line(line, ZX_PASTE_TEXT), 45);
+    CHECK_EQ(zx_paste_pending(), 2 * ZX_PASTE_LINE_MAX + 1);
+    queued();
+}
+
+// Playback: the matrix after each change, as key names
+
+static char playback[1024];
+
+static void on_paste_event(uint32_t time_us)
+{
+    const zx_kbd_state_t *state = zx_paste_get_state();
+    char keys[64] = "-";
+
+    for (int row = 0; row < 8; row++)
+        for (int col = 0; col < 5; col++)
+            if (state->a[row] & (1 << col))
+            {
+                if (keys[0] == '-')
+                    keys[0] = '\0';
+                else
+                    strcat(keys, "+");
+
+                append_key(keys, ZX(row, col));
+            }
+
+    if (playback[0])
+        strcat(playback, " ");
+
+    strcat(playback, keys);
+}
+
+static void play(void)
+{
+    playback[0] = '\0';
+
+    for (int i = 0; i < 1000 && alarm_set; i++)
+    {
+        alarm_set = false;
+        alarm_callback(0);
+    }
+
+    CHECK(!alarm_set);
+    CHECK(!zx_paste_running);
+}
+
+static void test_playback(void)
+{
+    zx_paste_init();
+    zx_paste_set_event_callback(on_paste_event);
+
+    // the shift alone for a keyboard read before and after its key, all up after each chord
+    CHECK_EQ(zx_paste_line("Ab", ZX_PASTE_TEXT), 0);
+    CHECK(alarm_set);
+    play();
+    CHECK(strcmp(playback, "CS CS+A CS - B - ENTER -") == 0);
+    CHECK_EQ(zx_paste_pending(), 0);
+
+    // E mode: CAPS + SYMBOL SHIFT, then the SYMBOL SHIFT chord
+    CHECK_EQ(zx_paste_line("[", ZX_PASTE_TEXT), 0);
+    play();
+    CHECK(strcmp(playback, "CS CS+SS CS - SS Y+SS SS - ENTER -") == 0);
+
+    // cancel drops the queue and releases the keys
+    CHECK_EQ(zx_paste_line("ABC", ZX_PASTE_TEXT), 0);
+    alarm_set = false;
+    alarm_callback(0);
+    zx_paste_cancel();
+    play();
+    CHECK(strcmp(playback, "-") == 0);
+    CHECK_EQ(zx_paste_pending(), 0);
+}
+
+int main(void)
+{
+    test_cursor_modes();
+    test_quotes();
+    test_comparisons();
+    test_longest_match();
+    test_text();
+    test_queue_full();
+    test_playback();
+
+    return test_result("zx_paste");
+}